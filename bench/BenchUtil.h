@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+namespace Bench {
+
+// Keeps the compiler from discarding a benchmarked result
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+struct rep_BenchResult {
+    std::string Name;
+    dp MeanNs;       // mean time per item
+    dp HalfWidthNs;  // half width of the 95% confidence interval
+    int32_t Samples;
+    int64_t ItemsPerSample;
+};
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+inline dp TQuantile95(int32_t df)
+{
+    static const dp t[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                           2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                           2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df < 1) return 0.0;
+    if (df <= 30) return t[df - 1];
+    return 1.960;
+}
+
+// Times Body(Items) Samples times after one warm-up call and returns the
+// per-item mean with its 95% confidence interval.
+template <typename F>
+rep_BenchResult Measure(const std::string& Name, int32_t Samples, int64_t Items, F&& Body)
+{
+    using clock = std::chrono::steady_clock;
+    std::vector<dp> PerItem;
+    PerItem.reserve(Samples);
+
+    Body(Items);
+    for (int32_t i = 0; i < Samples; ++i) {
+        auto t0 = clock::now();
+        Body(Items);
+        auto t1 = clock::now();
+        dp ns = std::chrono::duration<dp, std::nano>(t1 - t0).count();
+        PerItem.push_back(ns / static_cast<dp>(Items));
+    }
+
+    dp Mean = 0.0;
+    for (dp v : PerItem) Mean += v;
+    Mean /= static_cast<dp>(Samples);
+    dp Var = 0.0;
+    for (dp v : PerItem) Var += (v - Mean) * (v - Mean);
+    if (Samples > 1) Var /= static_cast<dp>(Samples - 1);
+
+    rep_BenchResult R;
+    R.Name = Name;
+    R.MeanNs = Mean;
+    R.HalfWidthNs = TQuantile95(Samples - 1) * std::sqrt(Var / static_cast<dp>(Samples));
+    R.Samples = Samples;
+    R.ItemsPerSample = Items;
+    return R;
+}
+
+// Prints one result line; Unit names what an item is (call, day, run)
+inline void Report(const rep_BenchResult& R, const char* Unit)
+{
+    dp PerSec = (R.MeanNs > 0.0) ? 1.0e9 / R.MeanNs : 0.0;
+    dp RelHW = (R.MeanNs > 0.0) ? 100.0 * R.HalfWidthNs / R.MeanNs : 0.0;
+    std::printf("%-40s %12.2f ns/%-5s +- %5.1f%%  %14.0f %s/s  (n=%d)\n",
+                R.Name.c_str(), R.MeanNs, Unit, RelHW, PerSec, Unit, R.Samples);
+}
+
+} // namespace Bench
+} // namespace AquaCrop
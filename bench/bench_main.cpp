@@ -0,0 +1,362 @@
+// Benchmarks for AquaCrop C++
+#include "BenchUtil.h"
+
+#include "AquaCrop/CropCalendar.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/InitialSettings.h"
+#include "AquaCrop/PrepareFertilitySalinity.h"
+#include "AquaCrop/RunConstants.h"
+#include "AquaCrop/Simd.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/Synthetic.h"
+#include "AquaCrop/Utils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+using namespace AquaCrop::Bench;
+
+namespace {
+
+constexpr int32_t NrSamples = 20;
+constexpr int32_t SeasonDays = 150;
+constexpr int32_t NrProfiles = 16;
+
+void SetupRunConstantInputs()
+{
+    crop.WP = 17.0;
+    crop.AdaptedToCO2 = 50;
+    crop.CCx = 0.90;
+    Soil.CNvalue = 72;
+    Soil.REW = 9;
+    Management.CNcorrection = 0;
+    Management.Mulch = 30;
+    Management.EffectMulchInS = 50;
+    Management.WeedRC = 0;
+    Management.WeedShape = -0.01;
+    simulparam.EvapDeclineFactor = 4;
+    simulparam.EffectiveRain.RootNrEvap = 5;
+}
+
+// Season-invariant work that the daily loop did before the RunConstants stage
+void BenchRunConstants()
+{
+    const dp CO2i = 412.5;
+    SetupRunConstantInputs();
+    DetermineRunConstants(CO2i);
+
+    Report(Measure("run_constants/recomputed_per_day", NrSamples, 100000, [&](int64_t NrDays) {
+        dp Acc = 0.0;
+        for (int64_t d = 0; d < NrDays; ++d) {
+            dp Wrel = static_cast<dp>(d % 100) / 100.0;
+            int8_t CN1, CN3;
+            int8_t CN2 = static_cast<int8_t>(roundc(static_cast<dp>(Soil.CNvalue) * (100.0 + static_cast<dp>(Management.CNcorrection)) / 100.0, 1));
+            DetermineCNIandIII(CN2, CN1, CN3);
+            dp fMulch = 1.0 - (static_cast<dp>(Management.Mulch) / 100.0) * (static_cast<dp>(Management.EffectMulchInS) / 100.0);
+            dp fRootNr = std::exp((1.0/static_cast<dp>(simulparam.EffectiveRain.RootNrEvap)) * std::log((Soil.REW+1.0)/20.0));
+            dp Kr = SoilEvaporationReductionCoefficient(Wrel, static_cast<dp>(simulparam.EvapDeclineFactor));
+            dp WPi = crop.WP * fAdjustedForCO2(CO2i, crop.WP, crop.AdaptedToCO2);
+            Acc += CN1 + CN3 + fMulch * fRootNr * Kr + WPi;
+        }
+        DoNotOptimize(Acc);
+    }), "day");
+
+    Report(Measure("run_constants/hoisted", NrSamples, 100000, [&](int64_t NrDays) {
+        dp Acc = 0.0;
+        for (int64_t d = 0; d < NrDays; ++d) {
+            dp Wrel = static_cast<dp>(d % 100) / 100.0;
+            dp Kr = SoilEvaporationReductionCoefficient(Wrel, RunConst.EvapDecline, RunConst.ExpEvapDeclineMin1);
+            dp WPi = crop.WP * fAdjustedForCO2Run(CO2i, crop.WP, crop.AdaptedToCO2);
+            Acc += RunConst.CN1 + RunConst.CN3 + RunConst.fMulch * RunConst.fEvapRootNr * Kr + WPi;
+        }
+        DoNotOptimize(Acc);
+    }), "day");
+}
+
+// Whole-season GDD series: per-day DegreesDay against the batch kernels
+void BenchDegreesDaySeries()
+{
+    const int32_t NrDays = 365;
+    std::vector<sp> Tmin(NrDays), Tmax(NrDays);
+    std::vector<dp> GDD(NrDays);
+    for (int32_t i = 0; i < NrDays; ++i) {
+        Tmin[i] = static_cast<sp>(5.0 + 10.0 * std::sin(i / 58.0));
+        Tmax[i] = Tmin[i] + static_cast<sp>(8.0 + 4.0 * std::cos(i / 13.0));
+    }
+
+    for (int8_t Method = 1; Method <= 3; ++Method) {
+        std::string Prefix = "degreesday/method" + std::to_string(Method) + "/";
+        Report(Measure(Prefix + "per_day", NrSamples, 200, [&](int64_t NrSeasons) {
+            for (int64_t s = 0; s < NrSeasons; ++s) {
+                for (int32_t i = 0; i < NrDays; ++i) {
+                    GDD[i] = DegreesDay(8.0, 30.0, Tmin[i], Tmax[i], Method);
+                }
+                DoNotOptimize(GDD.data());
+            }
+        }), "season");
+        for (SimdLevel Level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (!SimdLevelAvailable(Level)) continue;
+            Report(Measure(Prefix + SimdLevelName(Level), NrSamples, 200, [&](int64_t NrSeasons) {
+                for (int64_t s = 0; s < NrSeasons; ++s) {
+                    DegreesDaySeriesAt(Level, 8.0, 30.0, Tmin.data(), Tmax.data(), NrDays, Method, GDD.data());
+                    DoNotOptimize(GDD.data());
+                }
+            }), "season");
+        }
+    }
+}
+
+
+// Soil water and salt kernels on synthetic profiles. Every call starts from a
+// saved compartment state; restore_profile times that copy on its own.
+void BenchSoilKernels()
+{
+    std::vector<std::vector<CompartmentIndividual>> Profiles;
+    std::vector<std::vector<CompartmentSaltIndividual>> Salts;
+    std::vector<std::vector<SoilLayerIndividual>> Layers;
+    std::vector<int8_t> NrLayers;
+    for (int32_t p = 0; p < NrProfiles; ++p) {
+        SetupSyntheticSeason(1000 + p, 0, SeasonDays);
+        Profiles.push_back(Compartment);
+        Salts.push_back(CompartmentSalt);
+        Layers.push_back(soillayer);
+        NrLayers.push_back(Soil.NrSoilLayers);
+    }
+    auto Restore = [&](int64_t i) {
+        int32_t p = static_cast<int32_t>(i % NrProfiles);
+        Compartment = Profiles[p];
+        CompartmentSalt = Salts[p];
+        soillayer = Layers[p];
+        Soil.NrSoilLayers = NrLayers[p];
+    };
+
+    Report(Measure("kernel/restore_profile", NrSamples, 20000, [&](int64_t NrCalls) {
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            Restore(i);
+            DoNotOptimize(Compartment[0].theta);
+        }
+    }), "call");
+
+    // drainage function on the layer parameters against the cached coefficients
+    Report(Measure("kernel/delta_theta_recomputed", NrSamples, 1000000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            const SoilLayerIndividual& Layer = soillayer[0];
+            dp theta_sat = Layer.SAT / 100.0;
+            dp theta_fc = Layer.FC / 100.0;
+            dp theta = theta_fc + (theta_sat - theta_fc) * static_cast<dp>(i % 100) / 100.0;
+            dp DeltaX = 0.0;
+            if (theta > theta_fc) {
+                DeltaX = Layer.tau * (theta_sat - theta_fc) * (std::exp(theta - theta_fc) - 1.0) / (std::exp(theta_sat - theta_fc) - 1.0);
+                if ((theta - DeltaX) < theta_fc) DeltaX = theta - theta_fc;
+            }
+            Acc += DeltaX;
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    Report(Measure("kernel/delta_theta_cached", NrSamples, 1000000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            const SoilLayerIndividual& Layer = soillayer[0];
+            dp theta = Layer.ThetaFC + (Layer.ThetaSat - Layer.ThetaFC) * static_cast<dp>(i % 100) / 100.0;
+            Acc += calculate_delta_theta(theta, Layer.ThetaFC, 1);
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    Report(Measure("kernel/calculate_drainage", NrSamples, 20000, [&](int64_t NrCalls) {
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            Restore(i);
+            calculate_drainage();
+            DoNotOptimize(Drain);
+        }
+    }), "call");
+
+    RainRecord.DataType = datatype::daily;
+    Report(Measure("kernel/calculate_infiltration", NrSamples, 20000, [&](int64_t NrCalls) {
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            Restore(i);
+            calculate_drainage();
+            dp InfiltratedRain = 5.0 + static_cast<dp>(i % 40);
+            dp InfiltratedIrrigation = 0.0, InfiltratedStorage = 0.0, SubDrain = 0.0;
+            calculate_infiltration(InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, SubDrain);
+            DoNotOptimize(InfiltratedRain);
+        }
+    }), "call");
+
+    Report(Measure("kernel/calculate_saltcontent", NrSamples, 20000, [&](int64_t NrCalls) {
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            Restore(i);
+            calculate_drainage();
+            calculate_saltcontent(0.0, 10.0, 0.0, 0.0, 0.0, 1);
+            DoNotOptimize(CompartmentSalt[0].Salt[0]);
+        }
+    }), "call");
+}
+
+// Scalar helpers evaluated once or more per simulated day
+void BenchScalarKernels()
+{
+    InitializeSettings(false, false);
+
+    Report(Measure("kernel/KsAny", NrSamples, 1000000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            dp Wrel = static_cast<dp>(i % 1000) / 1000.0;
+            Acc += KsAny(Wrel, crop.pLeafDefUL, crop.pLeafDefLL, crop.KsShapeFactorLeaf);
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    Report(Measure("kernel/DegreesDay", NrSamples, 1000000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            dp Tmin = -5.0 + static_cast<dp>(i % 25);
+            Acc += DegreesDay(crop.Tbase, crop.Tupper, Tmin, Tmin + 12.0, 3);
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    Report(Measure("kernel/CCiNoWaterStressSF", NrSamples, 200000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            int32_t Dayi = 1 + static_cast<int32_t>(i % crop.DaysToHarvest);
+            Acc += CCiNoWaterStressSF(Dayi, crop.DaysToGermination, crop.DaysToFullCanopySF,
+                crop.DaysToSenescence, crop.DaysToHarvest, crop.GDDaysToGermination,
+                crop.GDDaysToFullCanopySF, crop.GDDaysToSenescence, crop.GDDaysToHarvest,
+                crop.CCo, crop.CCx, crop.CGC, crop.GDDCGC, crop.CDC, crop.GDDCDC, 0.0, 1.0,
+                10, 10, 0.5, modeCycle::CalendarDays);
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    // the reference canopy cover of DetermineCCi, computed or from the crop calendar
+    Report(Measure("kernel/CanopyCoverNoStressSF", NrSamples, 1000000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            int32_t Dayi = 1 + static_cast<int32_t>(i % crop.DaysToHarvest);
+            Acc += CanopyCoverNoStressSF(Dayi, crop.DaysToGermination, crop.DaysToSenescence, crop.DaysToHarvest,
+                crop.GDDaysToGermination, crop.GDDaysToSenescence, crop.GDDaysToHarvest, crop.CCo, crop.CCx,
+                crop.CGC, crop.CDC, crop.GDDCGC, crop.GDDCDC, 0.0, modeCycle::CalendarDays, 10, 10);
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    DetermineCropCalendar();
+    Report(Measure("kernel/CanopyCoverNoStressSF_calendar", NrSamples, 1000000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            int32_t Dayi = 1 + static_cast<int32_t>(i % crop.DaysToHarvest);
+            Acc += CanopyCoverNoStressSFRun(Dayi, crop.DaysToGermination, crop.DaysToSenescence, crop.DaysToHarvest,
+                crop.GDDaysToGermination, crop.GDDaysToSenescence, crop.GDDaysToHarvest, crop.CCo, crop.CCx,
+                crop.CGC, crop.CDC, crop.GDDCGC, crop.GDDCDC, 0.0, modeCycle::CalendarDays, 10, 10);
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    Report(Measure("kernel/DetermineDate", NrSamples, 1000000, [&](int64_t NrCalls) {
+        int32_t Acc = 0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            int32_t Dayi, Monthi, Yeari;
+            DetermineDate(static_cast<int32_t>(i % 60000), Dayi, Monthi, Yeari);
+            Acc += Dayi + Monthi + Yeari;
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+}
+
+// Salinity reference relationship of the default crop, fitted on the
+// reference seasons or taken from the in-process cache
+void BenchReferenceRelationships()
+{
+    InitializeSettings(false, false);
+    auto SaltRelationship = [] {
+        dp b0, b1, b2, X10, X20, X30, X40, X50, X60, X70, X80, X90;
+        ReferenceCCxSaltStressRelationship(crop.DaysToCCini, crop.GDDaysToCCini, crop.DaysToGermination,
+            crop.DaysToFullCanopy, crop.DaysToSenescence, crop.DaysToHarvest, crop.DaysToFlowering,
+            crop.LengthFlowering, crop.GDDaysToFlowering, crop.GDDLengthFlowering, crop.GDDaysToGermination,
+            crop.GDDaysToFullCanopy, crop.GDDaysToSenescence, crop.GDDaysToHarvest, crop.WPy, crop.HI, crop.CCo,
+            crop.CCx, crop.CGC, crop.GDDCGC, crop.CDC, crop.GDDCDC, crop.KcTop, crop.KcDecline,
+            static_cast<dp>(crop.CCEffectEvapLate), crop.Tbase, crop.Tupper, simulparam.Tmin, simulparam.Tmax,
+            crop.GDtranspLow, crop.WP, crop.dHIdt, crop.Day1, crop.DeterminancyLinked, crop.CropSubkind,
+            crop.ModeCycle, crop.CCsaltDistortion, b0, b1, b2, X10, X20, X30, X40, X50, X60, X70, X80, X90,
+            crop.GDDaysToHIo, crop.Planting, crop.DaysToHIo);
+        return b0 + b1 + b2;
+    };
+
+    Report(Measure("reference/salt_relationship_fitted", NrSamples, 200, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) {
+            ClearReferenceRelationshipCache();
+            Acc += SaltRelationship();
+        }
+        DoNotOptimize(Acc);
+    }), "call");
+
+    Report(Measure("reference/salt_relationship_cached", NrSamples, 100000, [&](int64_t NrCalls) {
+        dp Acc = 0.0;
+        for (int64_t i = 0; i < NrCalls; ++i) Acc += SaltRelationship();
+        DoNotOptimize(Acc);
+    }), "call");
+}
+
+// Whole seasons of the daily water balance on synthetic soils and weather,
+// reported per simulated day and per run
+void BenchSeasons()
+{
+    auto Season = [](uint64_t Seed, int32_t Yeari) {
+        int32_t DayNr1;
+        DetermineDayNr(1, 4, Yeari, DayNr1);
+        SetupSyntheticSeason(Seed, DayNr1, SeasonDays);
+        return RunSyntheticSeason(Seed, DayNr1, SeasonDays);
+    };
+    auto ReportDaysAndRuns = [](rep_BenchResult R) {
+        Report(R, "day");
+        R.MeanNs *= SeasonDays;
+        R.HalfWidthNs *= SeasonDays;
+        Report(R, "run");
+    };
+
+    ReportDaysAndRuns(Measure("season/single", NrSamples, SeasonDays, [&](int64_t) {
+        int32_t Days = Season(7, 2001);
+        DoNotOptimize(Days);
+    }));
+
+    // 30-year project: one run per year, re-initialised as for a PRM run
+    const int32_t NrYears = 30;
+    ReportDaysAndRuns(Measure("season/prm_30_years", NrSamples, NrYears * SeasonDays, [&](int64_t) {
+        for (int32_t y = 0; y < NrYears; ++y) {
+            int32_t Days = Season(11, 1991 + y);
+            DoNotOptimize(Days);
+        }
+    }));
+
+    // batch of independent projects, each with its own soil, crop and weather
+    const int32_t NrProjects = 1000;
+    ReportDaysAndRuns(Measure("season/batch_1000_projects", 5, NrProjects * SeasonDays, [&](int64_t) {
+        for (int32_t p = 0; p < NrProjects; ++p) {
+            int32_t Days = Season(100000 + static_cast<uint64_t>(p), 2001 + p % 20);
+            DoNotOptimize(Days);
+        }
+    }));
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("AquaCrop benchmarks (mean per item, 95%% confidence interval)\n\n");
+    BenchRunConstants();
+    BenchDegreesDaySeries();
+    std::printf("\n");
+    BenchSoilKernels();
+    BenchScalarKernels();
+    BenchReferenceRelationships();
+    std::printf("\n");
+    BenchSeasons();
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Atmospheric CO2 of a .CO2 file, interpolated to one value per year.
+// Parsed once per file and shared (read-only) by all runs and threads.
+struct rep_CO2Series {
+    int32_t FirstYear;       // (rounded) year of the first record
+    int32_t LastYear;        // last year covered by the records
+    dp FirstCO2;             // CO2 of the first record, used up to FirstYear
+    dp LastCO2;              // CO2 of the last record, used after LastYear
+    std::vector<dp> YearCO2; // CO2 for FirstYear..LastYear
+
+    dp CO2ForYear(int32_t Year) const;
+};
+
+// Series for CO2FileFull, nullptr if the file cannot be read. The file is
+// parsed again only if its modification time changed.
+std::shared_ptr<const rep_CO2Series> GetCO2Series(const std::string& CO2FileFull);
+
+} // namespace AquaCrop
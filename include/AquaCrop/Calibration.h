@@ -0,0 +1,99 @@
+#pragma once
+
+#include "AquaCrop/Evaluation.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Optimize.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Crop or soil parameter that calibration can vary. Set and Get act on the
+// loaded crop / Soil of the calling thread.
+struct rep_ParamBinding {
+    const char* Name;          // e.g. "crop.CGC"
+    const char* Description;
+    void (*Set)(dp Value);
+    dp (*Get)();
+};
+
+const std::vector<rep_ParamBinding>& ParameterBindings();
+// nullptr when Name is not a known parameter
+const rep_ParamBinding* FindParameterBinding(const std::string& Name);
+
+struct rep_CalibParameter {
+    const rep_ParamBinding* Binding;
+    dp Lower, Upper;
+};
+
+// NAME:LOWER:UPPER, e.g. "crop.CGC:0.05:0.2"
+bool ParseCalibParameter(const std::string& Spec, rep_CalibParameter& Parameter);
+// Maps a point of the unit cube linearly on the parameter ranges
+std::vector<dp> ParameterValues(const std::vector<rep_CalibParameter>& Parameters, const std::vector<dp>& X);
+
+// Values replacing the file values of the parameters in every run of the
+// calling thread (NaN: keep the file value). ApplyRunOverrides is called by
+// RunSimulation once the run is loaded; it records the file values first.
+void SetRunOverrides(const std::vector<rep_CalibParameter>& Parameters, const std::vector<dp>& Values);
+void ClearRunOverrides();
+void ApplyRunOverrides();
+// File values seen by the last ApplyRunOverrides of the calling thread
+const std::vector<dp>& LoadedParameterValues();
+
+// Reads the program settings for the calling thread and turns its console
+// output off; does nothing after the first call on a thread
+void PrepareSimulationThread();
+// Simulates the project (in the LIST directory of the working directory) on
+// the calling thread with the given parameter values (NaN: file value), after
+// PrepareSimulationThread. OnlyRun >= 1 simulates that run of a PRM only,
+// starting from its own initial conditions.
+std::vector<rep_RunResult> SimulateProject(const std::string& TheProjectFile, typeproject TheProjectType,
+                                           const std::vector<rep_CalibParameter>& Parameters,
+                                           const std::vector<dp>& Values, int32_t OnlyRun = 0);
+
+enum class FitMetric : intEnum {
+    RMSE = 0,
+    NRMSE = 1,
+    OneMinusD = 2,
+    OneMinusEF = 3
+};
+
+const char* FitMetricName(FitMetric Metric);
+// Accepts "rmse", "nrmse", "1-d" and "1-ef"
+bool ParseFitMetric(const std::string& Name, FitMetric& Metric);
+
+struct rep_CalibObjective {
+    FitMetric Metric = FitMetric::NRMSE;
+    dp Weight[NrObsSim] = {1.0, 1.0, 1.0};  // indexed by typeObsSim
+};
+
+// Weighted mean of the metric over the runs and variables with observations;
+// HUGE_VAL if there are none
+dp ObjectiveValue(const std::vector<rep_RunResult>& Results, const rep_CalibObjective& Objective);
+
+struct rep_CalibSettings {
+    rep_OptimSettings Optim;
+    rep_CalibObjective Objective;
+    int32_t NrThreads = 0;  // 0: one per hardware thread
+};
+
+struct rep_CalibResult {
+    std::vector<dp> StartValues;  // file values
+    dp StartObjective;
+    std::vector<dp> BestValues;
+    dp BestObjective;
+    int32_t NrEvaluations;
+    int32_t NrIterations;
+};
+
+// Calibrates the parameters of the project file (in the LIST directory of the
+// working directory) against its observations. Every candidate is a full
+// simulation of the project on a worker of the thread pool; the optimizer
+// runs in the unit cube mapped linearly on [Lower, Upper]. Returns false when
+// the file values could not be evaluated.
+bool CalibrateProject(const std::string& TheProjectFile, const std::vector<rep_CalibParameter>& Parameters,
+                      const rep_CalibSettings& Settings, rep_CalibResult& Result);
+
+} // namespace AquaCrop
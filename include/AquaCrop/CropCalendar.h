@@ -0,0 +1,36 @@
+#pragma once
+
+#include "AquaCrop/Global.h"
+#include <array>
+#include <vector>
+
+namespace AquaCrop {
+
+// Canopy cover without water stress of a calendar-day crop for every day of
+// the cycle, for one set of curve parameters
+struct rep_CCCurve {
+    bool Filled;
+    int32_t L0, L123, LMaturity;
+    dp CCo, CCx, CGC, CDC;
+    int8_t SFRedCGC, SFRedCCx;
+    std::vector<dp> CC;    // CC[t] for the days t = DAP - DelayedDays, 0..LMaturity
+};
+
+constexpr int32_t NrCalendarCurves = 4;
+
+// No-stress curves of the crop of a run, one per set of parameters the daily
+// loop asks for (the reference curve under soil fertility stress and the
+// potential curve without it). Cleared by DetermineCropCalendar at the start
+// of a run; a curve is filled the first time its parameters are used.
+struct rep_CropCalendar {
+    std::array<rep_CCCurve, NrCalendarCurves> Curves;
+};
+
+extern thread_local rep_CropCalendar CropCalendar;
+
+void DetermineCropCalendar();
+// CanopyCoverNoStressSF from the calendar for calendar days (the same bits),
+// computed as before for GDD or when all curves hold other parameters
+dp CanopyCoverNoStressSFRun(int32_t DAP, int32_t L0, int32_t L123, int32_t LMaturity, int32_t GDDL0, int32_t GDDL123, int32_t GDDLMaturity, dp CCo, dp CCx, dp CGC, dp CDC, dp GDDCGC, dp GDDCDC, dp SumGDD, modeCycle TypeDays, int8_t SFRedCGC, int8_t SFRedCCx);
+
+} // namespace AquaCrop
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "AquaCrop/Global.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace AquaCrop {
+
+constexpr int32_t NrObsSim = 3; // typeObsSim: canopy cover, biomass, soil water
+
+// Goodness of fit of the simulated against the observed values of a run
+struct rep_FitStats {
+    int32_t N;   // number of observed days
+    dp RMSE;     // root mean square error, unit of the variable
+    dp NRMSE;    // RMSE / observed mean (%)
+    dp d;        // Willmott index of agreement (0..1)
+    dp EF;       // Nash-Sutcliffe model efficiency (-inf..1)
+    dp Bias;     // mean of simulated - observed
+};
+
+// Sums from which the statistics follow. The observed mean is known before
+// the run, so the Willmott denominator is summed on the fly as well.
+struct rep_FitAccumulator {
+    dp ObsMean;
+    int32_t N;
+    dp SumDiff;      // sum (S - O)
+    dp SumDiff2;     // sum (S - O)^2
+    dp SumObsDev2;   // sum (O - Omean)^2
+    dp SumPotErr2;   // sum (|S - Omean| + |O - Omean|)^2
+
+    void Reset(dp ObsMeanIN);
+    void Add(dp Obs, dp Sim);
+    rep_FitStats Stats() const;
+};
+
+// Result of one run of a project
+struct rep_RunResult {
+    int8_t NrRun;
+    int32_t FromDayNr, ToDayNr;
+    std::array<rep_FitStats, NrObsSim> Fit; // indexed by typeObsSim
+    rep_sum Sums;                           // SumWaBal at the end of the run
+};
+
+// Observations of the run indexed on the day (DayNr - FromDayNr), with the
+// accumulators of the current run
+struct rep_RunEvaluation {
+    int32_t FromDayNr;
+    std::vector<int32_t> ObsOfDay;  // index in EventTimeline.Observations, -1 if none
+    std::array<rep_FitAccumulator, NrObsSim> Fit;
+};
+
+extern thread_local rep_RunEvaluation RunEvaluation;
+
+// Indexes the observations read by BuildEventTimeline for FromDayNr..ToDayNr
+// and resets the accumulators
+void BeginRunEvaluation(int32_t FromDayNr, int32_t ToDayNr);
+// Adds the simulated state at the end of DayNr when it has observations
+void EvaluateDay(int32_t DayNr);
+void EndRunEvaluation(rep_RunResult& Result);
+
+// Soil water content (mm) of the top Zsoil m of the profile
+dp SWCZsoil(dp Zsoil);
+
+const char* ObsSimName(typeObsSim Kind);
+
+} // namespace AquaCrop
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+#include <cstddef>
+#include <vector>
+
+namespace AquaCrop {
+
+// Kinds of dated events, in the order they are handled on the same day
+enum class EventKind : intEnum {
+    Groundwater = 0,       // start of a groundwater table segment
+    IrrigationOutSeason = 1,
+    Irrigation = 2,        // manual irrigation in the growing period
+    Cutting = 3,
+    Observation = 4,
+    IrrigationRule = 5     // start of a row of a generated schedule (IrriGenerateRules)
+};
+
+struct rep_DayEvent {
+    int32_t DayNr;
+    EventKind Kind;
+    int32_t Index; // in the payload array of its kind
+};
+
+struct rep_IrriEvent {
+    dp Depth;  // mm
+    dp ECw;    // dS/m
+};
+
+struct rep_GwtPoint {
+    int32_t DayNr;
+    int32_t Zcm;
+    dp ECdSm;
+};
+
+struct rep_ObsEvent {
+    int32_t DayNr;
+    dp CCmean, CCstd;   // canopy cover (%)
+    dp Bmean, Bstd;     // dry biomass (ton/ha)
+    dp SWCmean, SWCstd; // soil water content (mm)
+    dp Zeval;           // depth of the sampled soil profile (m)
+};
+
+// All dated inputs of a run, read once at initialization and sorted on
+// (DayNr, Kind). The daily loop only advances the cursor: a day without
+// events costs one comparison and no file I/O.
+struct rep_EventTimeline {
+    std::vector<rep_DayEvent> Events;
+    std::vector<rep_IrriEvent> Irrigations; // manual and out-of-season
+    std::vector<rep_GwtPoint> GwtPoints;    // all points of the groundwater file
+    std::vector<rep_ObsEvent> Observations;
+
+    size_t Cursor;   // first event not before the current day
+    size_t DayEnd;   // end of the events of the current day
+
+    void Clear();
+    // Moves the cursor to DayNr (days are visited in increasing order)
+    void AdvanceTo(int32_t DayNr);
+    // Event of the given kind on the current day, nullptr if none
+    const rep_DayEvent* Today(EventKind Kind) const;
+};
+
+extern thread_local rep_EventTimeline EventTimeline;
+
+// Reads the irrigation, off-season, management (cuttings), groundwater and
+// observation tables for the run period FromDayNr..ToDayNr, and places the
+// rows of a generated irrigation schedule
+void BuildEventTimeline(int32_t FromDayNr, int32_t ToDayNr);
+
+// Groundwater table segment around DayNr (DNr1 <= DayNr <= DNr2 inside the table)
+bool GetGwtSegment(int32_t DayNr, int32_t& DNr1, int32_t& DNr2, int32_t& Z1, int32_t& Z2, dp& EC1, dp& EC2);
+
+} // namespace AquaCrop
@@ -2,6 +2,7 @@
 
 #include "AquaCrop/Kinds.h"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,8 @@ namespace AquaCrop {
 constexpr dp equiv = 0.64;
 constexpr int32_t max_SoilLayers = 5;
 constexpr int32_t max_No_compartments = 12;
+constexpr int32_t max_SaltCells = 11;     // salt cells of a compartment (SCP1)
+constexpr int32_t SaltCellStride = 12;    // max_SaltCells padded to whole AVX2 vectors
 constexpr dp undef_double = -9.9;
 constexpr int32_t undef_int = -9;
 constexpr dp PI = 3.1415926535;
@@ -133,6 +136,15 @@ struct rep_DayEventInt {
     int32_t param;
 };
 
+// Row of a generated irrigation schedule (IrriMode::Generate), applied from
+// day FromDay of the growing cycle until the next row
+struct rep_IrriRule {
+    int32_t FromDay;
+    int32_t TimeInfo;   // GenerateTimeMode: interval (days), depletion (mm), RAW (%) or water between bunds (mm)
+    int32_t DepthInfo;  // GenerateDepthMode: fixed depth, or mm above field capacity (mm)
+    dp ECw;             // dS/m
+};
+
 struct CompartmentIndividual {
     dp Thickness;
     dp theta;
@@ -142,8 +154,16 @@ struct CompartmentIndividual {
     dp FCadj;
     int32_t DayAnaero;
     dp WFactor;
-    std::vector<dp> Salt = std::vector<dp>(11);
-    std::vector<dp> Depo = std::vector<dp>(11);
+};
+
+// Salt in solution and deposited in the cells of a compartment (g/m2), kept
+// apart from the water of the compartment: a run without salt leaves it
+// untouched.
+// CompartmentSalt holds the rows of all compartments in one aligned block;
+// the cells after SCP1 stay zero.
+struct alignas(32) CompartmentSaltIndividual {
+    std::array<dp, SaltCellStride> Salt{};
+    std::array<dp, SaltCellStride> Depo{};
 };
 
 struct SoilLayerIndividual {
@@ -159,13 +179,17 @@ struct SoilLayerIndividual {
     dp GravelVol;
     dp WaterContent;
     int8_t Macro;
-    std::vector<dp> SaltMobility = std::vector<dp>(11);
+    std::array<dp, SaltCellStride> SaltMobility{};
     int8_t SC;
     int8_t SCP1;
     dp UL;
     dp Dx;
     int8_t SoilClass;
     dp CRa, CRb;
+    // coefficients of the drainage function, see DetermineDrainageCoefficients
+    dp ThetaSat, ThetaFC;   // SAT and FC as fractions
+    dp TauRange;            // tau * (ThetaSat - ThetaFC)
+    dp ExpRangeMin1;        // exp(ThetaSat - ThetaFC) - 1
 };
 
 struct rep_Shapes {
@@ -545,163 +569,173 @@ struct rep_FileOK {
 
 void GlobalZero(rep_sum& SumWaBal);
 
-// Global variables (extern declarations)
-extern std::string RainFile;
-extern std::string RainFileFull;
-extern std::string RainDescription;
-extern std::string EToFile;
-extern std::string EToFileFull;
-extern std::string EToDescription;
-extern std::string CalendarFile;
-extern std::string CalendarFileFull;
-extern std::string CalendarDescription;
-extern std::string CO2File;
-extern std::string CO2FileFull;
-extern std::string CO2Description;
-extern std::string IrriFile;
-extern std::string IrriFileFull;
-extern std::string CropFile;
-extern std::string CropFileFull;
-extern std::string CropDescription;
-extern std::string PathNameProg;
-extern std::string PathNameOutp;
-extern std::string PathNameSimul;
-extern std::string ProfFile;
-extern std::string ProfFilefull;
-extern std::string ProfDescription;
-extern std::string ManFile;
-extern std::string ManFilefull;
-extern std::string ObservationsFile;
-extern std::string ObservationsFilefull;
-extern std::string ObservationsDescription;
-extern std::string OffSeasonFile;
-extern std::string OffSeasonFilefull;
-extern std::string OutputName;
-extern std::string GroundWaterFile;
-extern std::string GroundWaterFilefull;
-extern std::string ClimateFile;
-extern std::string ClimateFileFull;
-extern std::string ClimateDescription;
-extern std::string IrriDescription;
-extern std::string ClimFile;
-extern std::string SWCiniFile;
-extern std::string SWCiniFileFull;
-extern std::string SWCiniDescription;
-extern std::string ProjectDescription;
-extern std::string ProjectFile;
-extern std::string ProjectFileFull;
-extern std::string MultipleProjectDescription;
-extern std::string MultipleProjectFile;
-extern std::string TemperatureFile;
-extern std::string TemperatureFileFull;
-extern std::string TemperatureDescription;
-extern std::string MultipleProjectFileFull;
-extern std::string FullFileNameProgramParameters;
-extern std::string ManDescription;
-extern std::string ClimDescription;
-extern std::string OffSeasonDescription;
-extern std::string GroundwaterDescription;
-extern std::string TnxReferenceFile;
-extern std::string TnxReferenceFileFull;
-extern std::string TnxReference365DaysFile;
-extern std::string TnxReference365DaysFileFull;
-
-extern rep_IrriECw IrriECw;
-extern rep_Manag Management;
-extern rep_PerennialPeriod perennialperiod;
-extern rep_param simulparam;
-extern rep_Cuttings Cuttings;
-extern rep_Onset onset;
-extern rep_EndSeason endseason;
-extern rep_Crop crop;
-extern rep_Content TotalSaltContent;
-extern rep_Content TotalWaterContent;
-extern rep_EffectiveRain effectiverain;
-extern rep_soil Soil;
-extern rep_RootZoneWC RootZoneWC;
-extern rep_CropFileSet CropFileSet;
-extern rep_sum SumWaBal;
-extern rep_RootZoneSalt RootZoneSalt;
-extern rep_clim TemperatureRecord, ClimRecord, RainRecord, EToRecord;
-extern rep_sim Simulation;
-
-extern GenerateTimeMode GenerateTimeMode_Val;
-extern GenerateDepthMode GenerateDepthMode_Val;
-extern IrriMode IrriMode_Val;
-extern IrriMethod IrriMethod_Val;
-
-extern int32_t TnxReferenceYear;
-extern int32_t DaySubmerged;
-extern int32_t MaxPlotNew;
-extern int32_t NrCompartments;
-extern int32_t IrriFirstDayNr;
-extern dp ZiAqua;
-
-extern int8_t IniPercTAW;
-extern int8_t MaxPlotTr;
-extern int8_t OutputAggregate;
-
-extern int fTnxReference;
-extern int fTnxReference_iostat;
-extern int fTnxReference365Days;
-extern int fTnxReference365Days_iostat;
-
-extern dp CCiActual;
-extern dp CCiprev;
-extern dp CCiTopEarlySen;
-extern dp CRsalt;
-extern dp CRwater;
-extern dp ECdrain;
-extern dp ECiAqua;
-extern dp ECstorage;
-extern dp Eact;
-extern dp Epot;
-extern dp ETo;
-extern dp Drain;
-extern dp Infiltrated;
-extern dp Irrigation;
-extern dp Rain;
-extern dp RootingDepth;
-extern dp Runoff;
-extern dp SaltInfiltr;
-extern dp Surf0;
-extern dp SurfaceStorage;
-extern dp Tact;
-extern dp Tpot;
-extern dp TactWeedInfested;
-extern dp Tmax;
-extern dp Tmin;
-extern dp TmaxCropReference;
-extern dp TminCropReference;
-extern dp TmaxTnxReference365Days;
-extern dp TminTnxReference365Days;
-extern std::vector<sp> TmaxRun;
-extern std::vector<sp> TminRun;
-extern std::vector<sp> TmaxTnxReference12MonthsRun;
-extern std::vector<sp> TminTnxReference12MonthsRun;
-extern std::vector<sp> TmaxCropReferenceRun;
-extern std::vector<sp> TminCropReferenceRun;
-extern std::vector<sp> TmaxTnxReference365DaysRun;
-extern std::vector<sp> TminTnxReference365DaysRun;
-
-extern bool EvapoEntireSoilSurface;
-extern bool PreDay, OutDaily, Out8Irri;
-extern bool Out1Wabal;
-extern bool Out2Crop;
-extern bool Out3Prof;
-extern bool Out4Salt;
-extern bool Out5CompWC;
-extern bool Out6CompEC;
-extern bool Out7Clim;
-extern bool Part1Mult, Part2Eval;
-
-extern std::string PathNameList, PathNameParam;
-
-extern std::vector<CompartmentIndividual> Compartment;
-extern std::vector<SoilLayerIndividual> soillayer;
-
-extern std::vector<rep_DayEventInt> IrriBeforeSeason;
-extern std::vector<rep_DayEventInt> IrriAfterSeason;
+// Global variables (extern declarations). The simulation state is per
+// thread, so independent runs can be simulated concurrently (ThreadPool.h).
+// A thread other than the main thread calls InitializeThreadState before
+// it enters the library; the ThreadPool workers and the Python entry
+// points do so.
+void InitializeThreadState();
+
+extern thread_local std::string RainFile;
+extern thread_local std::string RainFileFull;
+extern thread_local std::string RainDescription;
+extern thread_local std::string EToFile;
+extern thread_local std::string EToFileFull;
+extern thread_local std::string EToDescription;
+extern thread_local std::string CalendarFile;
+extern thread_local std::string CalendarFileFull;
+extern thread_local std::string CalendarDescription;
+extern thread_local std::string CO2File;
+extern thread_local std::string CO2FileFull;
+extern thread_local std::string CO2Description;
+extern thread_local std::string IrriFile;
+extern thread_local std::string IrriFileFull;
+extern thread_local std::string CropFile;
+extern thread_local std::string CropFileFull;
+extern thread_local std::string CropDescription;
+extern thread_local std::string PathNameProg;
+extern thread_local std::string PathNameOutp;
+extern thread_local std::string PathNameSimul;
+extern thread_local std::string ProfFile;
+extern thread_local std::string ProfFilefull;
+extern thread_local std::string ProfDescription;
+extern thread_local std::string ManFile;
+extern thread_local std::string ManFilefull;
+extern thread_local std::string ObservationsFile;
+extern thread_local std::string ObservationsFilefull;
+extern thread_local std::string ObservationsDescription;
+extern thread_local std::string OffSeasonFile;
+extern thread_local std::string OffSeasonFilefull;
+extern thread_local std::string OutputName;
+extern thread_local std::string GroundWaterFile;
+extern thread_local std::string GroundWaterFilefull;
+extern thread_local std::string ClimateFile;
+extern thread_local std::string ClimateFileFull;
+extern thread_local std::string ClimateDescription;
+extern thread_local std::string IrriDescription;
+extern thread_local std::string ClimFile;
+extern thread_local std::string SWCiniFile;
+extern thread_local std::string SWCiniFileFull;
+extern thread_local std::string SWCiniDescription;
+extern thread_local std::string ProjectDescription;
+extern thread_local std::string ProjectFile;
+extern thread_local std::string ProjectFileFull;
+extern thread_local std::string MultipleProjectDescription;
+extern thread_local std::string MultipleProjectFile;
+extern thread_local std::string TemperatureFile;
+extern thread_local std::string TemperatureFileFull;
+extern thread_local std::string TemperatureDescription;
+extern thread_local std::string MultipleProjectFileFull;
+extern thread_local std::string FullFileNameProgramParameters;
+extern thread_local std::string ManDescription;
+extern thread_local std::string ClimDescription;
+extern thread_local std::string OffSeasonDescription;
+extern thread_local std::string GroundwaterDescription;
+extern thread_local std::string TnxReferenceFile;
+extern thread_local std::string TnxReferenceFileFull;
+extern thread_local std::string TnxReference365DaysFile;
+extern thread_local std::string TnxReference365DaysFileFull;
+
+extern thread_local rep_IrriECw IrriECw;
+extern thread_local rep_Manag Management;
+extern thread_local rep_PerennialPeriod perennialperiod;
+extern thread_local rep_param simulparam;
+extern thread_local rep_Cuttings Cuttings;
+extern thread_local rep_Onset onset;
+extern thread_local rep_EndSeason endseason;
+extern thread_local rep_Crop crop;
+extern thread_local rep_Content TotalSaltContent;
+extern thread_local rep_Content TotalWaterContent;
+extern thread_local rep_EffectiveRain effectiverain;
+extern thread_local rep_soil Soil;
+extern thread_local rep_RootZoneWC RootZoneWC;
+extern thread_local rep_CropFileSet CropFileSet;
+extern thread_local rep_sum SumWaBal;
+extern thread_local rep_RootZoneSalt RootZoneSalt;
+extern thread_local rep_clim TemperatureRecord, ClimRecord, RainRecord, EToRecord;
+extern thread_local rep_sim Simulation;
+
+extern thread_local GenerateTimeMode GenerateTimeMode_Val;
+extern thread_local GenerateDepthMode GenerateDepthMode_Val;
+extern thread_local IrriMode IrriMode_Val;
+extern thread_local IrriMethod IrriMethod_Val;
+
+extern thread_local int32_t TnxReferenceYear;
+extern thread_local int32_t DaySubmerged;
+extern thread_local int32_t MaxPlotNew;
+extern thread_local int32_t NrCompartments;
+extern thread_local int32_t IrriFirstDayNr;
+extern thread_local dp ZiAqua;
+
+extern thread_local int8_t IniPercTAW;
+extern thread_local int8_t MaxPlotTr;
+extern thread_local int8_t OutputAggregate;
+
+extern thread_local int fTnxReference;
+extern thread_local int fTnxReference_iostat;
+extern thread_local int fTnxReference365Days;
+extern thread_local int fTnxReference365Days_iostat;
+
+extern thread_local dp CCiActual;
+extern thread_local dp CCiprev;
+extern thread_local dp CCiTopEarlySen;
+extern thread_local dp CRsalt;
+extern thread_local dp CRwater;
+extern thread_local dp ECdrain;
+extern thread_local dp ECiAqua;
+extern thread_local dp ECstorage;
+extern thread_local dp Eact;
+extern thread_local dp Epot;
+extern thread_local dp ETo;
+extern thread_local dp Drain;
+extern thread_local dp Infiltrated;
+extern thread_local dp Irrigation;
+extern thread_local dp Rain;
+extern thread_local dp RootingDepth;
+extern thread_local dp Runoff;
+extern thread_local dp SaltInfiltr;
+extern thread_local dp Surf0;
+extern thread_local dp SurfaceStorage;
+extern thread_local dp Tact;
+extern thread_local dp Tpot;
+extern thread_local dp TactWeedInfested;
+extern thread_local dp Tmax;
+extern thread_local dp Tmin;
+extern thread_local dp TmaxCropReference;
+extern thread_local dp TminCropReference;
+extern thread_local dp TmaxTnxReference365Days;
+extern thread_local dp TminTnxReference365Days;
+extern thread_local std::vector<sp> TmaxRun;
+extern thread_local std::vector<sp> TminRun;
+extern thread_local std::vector<sp> TmaxTnxReference12MonthsRun;
+extern thread_local std::vector<sp> TminTnxReference12MonthsRun;
+extern thread_local std::vector<sp> TmaxCropReferenceRun;
+extern thread_local std::vector<sp> TminCropReferenceRun;
+extern thread_local std::vector<sp> TmaxTnxReference365DaysRun;
+extern thread_local std::vector<sp> TminTnxReference365DaysRun;
+
+extern thread_local bool EvapoEntireSoilSurface;
+extern thread_local bool PreDay, OutDaily, Out8Irri;
+extern thread_local bool ConsoleOutput; // progress and daily lines on std::cout
+extern thread_local bool Out1Wabal;
+extern thread_local bool Out2Crop;
+extern thread_local bool Out3Prof;
+extern thread_local bool Out4Salt;
+extern thread_local bool Out5CompWC;
+extern thread_local bool Out6CompEC;
+extern thread_local bool Out7Clim;
+extern thread_local bool Part1Mult, Part2Eval;
+
+extern thread_local std::string PathNameList, PathNameParam;
+
+extern thread_local std::vector<CompartmentIndividual> Compartment;
+extern thread_local std::vector<CompartmentSaltIndividual> CompartmentSalt;   // max_No_compartments rows
+extern thread_local std::vector<SoilLayerIndividual> soillayer;
+
+extern thread_local std::vector<rep_DayEventInt> IrriBeforeSeason;
+extern thread_local std::vector<rep_DayEventInt> IrriAfterSeason;
+extern thread_local std::vector<rep_IrriRule> IrriGenerateRules;
+extern thread_local dp IrriSeasonCap; // mm of irrigation in the run, undef_double: none
 
 // Function declarations
 dp DeduceAquaCropVersion(const std::string& FullNameXXFile);
@@ -730,6 +764,7 @@ dp KsTemperature(dp T0, dp T1, dp Tin);
 dp KsSalinity(bool SalinityResponsConsidered, int8_t ECeN, int8_t ECeX, dp ECeVAR, dp KsShapeSalinity);
 void TimeToMaxCanopySF(dp CCo, dp CGC, dp CCx, int32_t L0, int32_t L12, int32_t L123, int32_t LToFlor, int32_t LFlor, bool DeterminantCrop, int32_t& L12SF, int8_t& RedCGC, int8_t& RedCCx, int32_t& ClassSF);
 dp SoilEvaporationReductionCoefficient(dp Wrel, dp Edecline);
+dp SoilEvaporationReductionCoefficient(dp Wrel, dp Edecline, dp ExpEdeclineMin1);
 dp MaxCRatDepth(dp ParamCRa, dp ParamCRb, dp Ksat, dp Zi, dp DepthGWT);
 dp CCmultiplierWeed(int8_t ProcentWeedCover, dp CCxCrop, dp FshapeWeed);
 dp CCmultiplierWeedAdjusted(int8_t ProcentWeedCover, dp CCxCrop, dp& FshapeWeed, dp fCCx, int8_t Yeari, int8_t MWeedAdj, int8_t& RCadj);
@@ -740,11 +775,17 @@ dp CCatTime(int32_t Dayi, dp CCoIN, dp CGCIN, dp CCxIN);
 void DetermineDayNr(int32_t Dayi, int32_t Monthi, int32_t Yeari, int32_t& DayNr);
 void DetermineDate(int32_t DayNr, int32_t& Dayi, int32_t& Monthi, int32_t& Yeari);
 dp DegreesDay(dp Tbase, dp Tupper, dp TDayMin, dp TDayMax, int8_t GDDSelectedMethod);
+// DegreesDay for a whole series of days (vectorized, see Simd.h)
+void DegreesDaySeries(dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax, int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD);
 void DetermineCNIandIII(int8_t CN2, int8_t& CN1, int8_t& CN3);
 void DetermineCN_default(dp Infiltr, int8_t& CN2);
-dp ECeComp(const CompartmentIndividual& Comp);
-dp ECswComp(const CompartmentIndividual& Comp, bool atFC);
+dp ECeComp(const CompartmentIndividual& Comp, const CompartmentSaltIndividual& CompSalt);
+dp ECswComp(const CompartmentIndividual& Comp, const CompartmentSaltIndividual& CompSalt, bool atFC);
 void SaltSolutionDeposit(dp mm, dp& SaltSolution, dp& SaltDeposit);
+// SaltSolutionDeposit for the first NrCells cells of a compartment row, and
+// the Mixing of the NrPairs neighbouring cell pairs of a row (vectorized, see Simd.h)
+void SaltSolutionDepositCells(dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells);
+void MixSaltCells(int32_t NrPairs, const dp* Dif, dp mm1, const dp* mm2, dp* Salt, dp* Depo);
 dp MultiplierCCoSelfThinning(int32_t Yeari, int32_t Yearx, dp ShapeFactor);
 dp KsAny(dp Wrel, dp pULActual, dp pLLActual, dp ShapeFactor);
 dp CCatGDD(dp GDDi, dp CCoIN, dp GDDCGCIN, dp CCxIN);
@@ -776,7 +817,7 @@ void DetermineRootZoneSaltContent(dp RootingDepth, dp& ZrECe, dp& ZrECsw, dp& Zr
 void CalculateAdjustedFC(dp DepthAquifer, std::vector<CompartmentIndividual>& CompartAdj);
 void AdjustOnsetSearchPeriod();
 int32_t ActiveCells(const CompartmentIndividual& Comp);
-void DetermineSaltContent(dp ECe, CompartmentIndividual& Comp);
+void DetermineSaltContent(dp ECe, const CompartmentIndividual& Comp, CompartmentSaltIndividual& CompSalt);
 void SetClimData();
 std::string DayString(int32_t DNr);
 void AdjustYearPerennials(int8_t TheYearSeason, bool Sown1stYear, modeCycle TheCycleMode, dp Zmax, dp ZminYear1, dp TheCCo, dp TheSizeSeedling, dp TheCGC, dp TheCCx, dp TheGDDCGC, int32_t ThePlantingDens, plant& TypeOfPlanting, dp& Zmin, dp& TheSizePlant, dp& TheCCini, int32_t& TheDaysToCCini, int32_t& TheGDDaysToCCini);
@@ -815,7 +856,11 @@ void CompleteClimateDescription(rep_clim& ClimateRecord);
 int32_t SumCalendarDaysReferenceTnx(int32_t ValGDDays, int32_t RefCropDay1, int32_t StartDayNr, dp Tbase, dp Tupper, dp TDayMin, dp TDayMax);
 void DesignateSoilLayerToCompartments(int32_t NrCompartments, int32_t NrSoilLayers, std::vector<CompartmentIndividual>& Compartment);
 void specify_soil_layer(int32_t NrCompartments, int32_t NrSoilLayers, std::vector<SoilLayerIndividual>& SoilLayer, std::vector<CompartmentIndividual>& Compartment, rep_Content& TotalWaterContent);
-void Calculate_Saltmobility(int32_t layer, int8_t SaltDiffusion, int8_t Macro, std::vector<dp>& Mobil);
+void Calculate_Saltmobility(int32_t layer, int8_t SaltDiffusion, int8_t Macro, std::array<dp, SaltCellStride>& Mobil);
+// Caches the parts of the drainage function (calculate_delta_theta and its
+// inverse) that only depend on SAT, FC and tau of the layer; called whenever
+// one of them is set
+void DetermineDrainageCoefficients(SoilLayerIndividual& Layer);
 void CompleteProfileDescription();
 extern std::string GetProjectFileName(int32_t iproject);
 
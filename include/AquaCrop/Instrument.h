@@ -0,0 +1,7 @@
+#pragma once
+
+// Region markers shared by the --perf counters and the --trace timeline
+#include "AquaCrop/PerfCounters.h"
+#include "AquaCrop/Trace.h"
+
+#define AQUACROP_REGION(Name) AQUACROP_PERF_REGION(Name); AQUACROP_TRACE_SPAN(Name)
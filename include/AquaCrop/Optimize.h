@@ -0,0 +1,47 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Derivative-free minimizers over the unit cube [0,1]^n. Every method hands
+// its candidates to the objective in batches (a simplex step, a generation)
+// so that the objective can evaluate them in parallel.
+
+enum class OptimMethod : intEnum {
+    NelderMead = 0,
+    DifferentialEvolution = 1,
+    CMAES = 2
+};
+
+// Fills Values[i] with the objective at Points[i]
+using BatchObjective = std::function<void(const std::vector<std::vector<dp>>& Points, std::vector<dp>& Values)>;
+
+struct rep_OptimSettings {
+    OptimMethod Method = OptimMethod::CMAES;
+    int32_t MaxEvaluations = 2000;
+    int32_t PopulationSize = 0;  // DE and CMA-ES; 0: default for the dimension
+    uint64_t Seed = 1;
+    dp Tolerance = 1.0e-8;       // stop when the values of a step differ less (relative)
+    std::vector<dp> Start;       // start point in the unit cube; empty: centre
+};
+
+struct rep_OptimResult {
+    std::vector<dp> Best;        // in the unit cube
+    dp BestValue;
+    int32_t NrEvaluations;
+    int32_t NrIterations;        // simplex steps or generations
+};
+
+rep_OptimResult MinimizeInUnitCube(int32_t NrDim, const BatchObjective& Objective, const rep_OptimSettings& Settings);
+
+const char* OptimMethodName(OptimMethod Method);
+// Accepts "nelder-mead", "de" and "cmaes"
+bool ParseOptimMethod(const std::string& Name, OptimMethod& Method);
+
+} // namespace AquaCrop
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+#include "AquaCrop/StageProfile.h"
+#include <cstdint>
+#include <string>
+
+namespace AquaCrop {
+
+// Hardware counters read as one perf_event group per thread (Linux only)
+enum class PerfCounter : intEnum {
+    Cycles = 0,
+    Instructions,
+    CacheMisses,
+    BranchMisses,
+    NrCounters
+};
+
+constexpr int32_t NrPerfCounters = static_cast<int32_t>(PerfCounter::NrCounters);
+
+struct rep_PerfSample {
+    uint64_t Value[NrPerfCounters]; // raw counts (0 for counters not opened)
+    uint64_t TimeEnabled;
+    uint64_t TimeRunning;
+};
+
+extern bool PerfCountersRequested;
+
+// Requests the counters for all threads (--perf). Returns false, after a
+// message on std::cerr, if perf events cannot be opened (no kernel support,
+// perf_event_paranoid, containers); the run then continues without them.
+bool EnablePerfCounters();
+inline bool PerfCountersEnabled() { return PerfCountersRequested; }
+
+// Counters of the calling thread; false if they are not available
+bool ReadPerfCounters(rep_PerfSample& Sample);
+void AddPerfRegion(const char* Name, const rep_PerfSample& Begin, const rep_PerfSample& End);
+// Closes the perf interval of Stage (NrStages: none) and opens the next one
+void PerfStageMark(BudgetStage Stage);
+// Report on std::cerr and <PathName>PerfCounters.json
+void WritePerfReport(const std::string& PathName);
+
+// Counters around a named region (input loaders, daily loop, ...)
+class PerfScope {
+public:
+    explicit PerfScope(const char* Name) : Name_(Name), Active_(false) {
+        if (PerfCountersEnabled()) Active_ = ReadPerfCounters(Begin_);
+    }
+    ~PerfScope() {
+        rep_PerfSample End;
+        if (Active_ && ReadPerfCounters(End)) AddPerfRegion(Name_, Begin_, End);
+    }
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+private:
+    const char* Name_;
+    bool Active_;
+    rep_PerfSample Begin_;
+};
+
+#define AQUACROP_PERF_CONCAT_(a, b) a##b
+#define AQUACROP_PERF_CONCAT(a, b) AQUACROP_PERF_CONCAT_(a, b)
+#define AQUACROP_PERF_REGION(Name) ::AquaCrop::PerfScope AQUACROP_PERF_CONCAT(AquaCropPerfScope_, __LINE__)(Name)
+
+} // namespace AquaCrop
@@ -3,6 +3,13 @@
 
 namespace AquaCrop {
 
+// Soil fertility stress (%) as a quadratic of the relative biomass (%), fitted
+// on reference seasons (constant ETo, the Tmin/Tmax given, reference CO2) at
+// fertility stress 0, 10 .. 70 %; X10..X70 is the relative biomass at those
+// levels. Coefficients are undef_double when the stress has no effect.
+// The reference seasons run in parallel and the fit is cached per set of
+// inputs: in the process, and in the directory AQUACROP_REFERENCE_CACHE when
+// that is set.
 void ReferenceStressBiomassRelationship(
     int32_t DaysToCCini, int32_t GDDaysToCCini, int32_t DaysToGermination,
     int32_t DaysToFullCanopy, int32_t DaysToSenescence, int32_t DaysToHarvest,
@@ -19,6 +26,9 @@ void ReferenceStressBiomassRelationship(
     int32_t GDDaysToFlowering, int32_t GDDLengthFlowering,
     int32_t GDDaysToHIo, plant Planting, int32_t DaysToHIo);
 
+// Reduction of CCx (%) as a quadratic of the salt stress (%), the biomass
+// reduction of reference seasons with CCx reduced by 0, 10 .. 90 %; X10..X90
+// is the relative biomass at those reductions. Cached as above.
 void ReferenceCCxSaltStressRelationship(
     int32_t DaysToCCini, int32_t GDDaysToCCini, int32_t DaysToGermination,
     int32_t DaysToFullCanopy, int32_t DaysToSenescence, int32_t DaysToHarvest,
@@ -35,4 +45,9 @@ void ReferenceCCxSaltStressRelationship(
     dp& X10, dp& X20, dp& X30, dp& X40, dp& X50, dp& X60, dp& X70, dp& X80, dp& X90,
     int32_t GDDaysToHIo, plant Planting, int32_t DaysToHIo);
 
+// Drops the fits kept in the process (not the on-disk cache)
+void ClearReferenceRelationshipCache();
+// Relationships fitted by simulation so far, i.e. not taken from a cache
+int64_t NrReferenceRelationshipFits();
+
 }
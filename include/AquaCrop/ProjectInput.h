@@ -60,10 +60,13 @@ struct ProjectInput_type {
     void read_project_file(const std::string& filename, int32_t NrRun);
 };
 
-extern std::vector<ProjectInput_type> ProjectInput;
+extern thread_local std::vector<ProjectInput_type> ProjectInput;
 
 void allocate_project_input(int32_t NrRuns);
+// Reads the runs of the project file. The parsed runs are shared by all
+// threads and parsed again only if the modification time of the file changed.
 void initialize_project_input(const std::string& filename, int32_t NrRuns = -1);
+void ClearProjectInputCache();
 void ReadNumberSimulationRuns(const std::string& TempFileNameFull, int32_t& NrRuns);
 int32_t GetNumberSimulationRuns();
 
@@ -1,9 +1,29 @@
 #pragma once
 
+#include "AquaCrop/Evaluation.h"
 #include "AquaCrop/Global.h"
 
+#include <memory>
+#include <vector>
+
 namespace AquaCrop {
 
-void RunSimulation(const std::string& TheProjectFile, typeproject TheProjectType);
+// Runs all runs of the project; returns the seasonal sums of each run and
+// its goodness of fit against the observations of its observation file
+std::vector<rep_RunResult> RunSimulation(const std::string& TheProjectFile, typeproject TheProjectType);
+
+// A run can be simulated in segments, so that runs which only differ from a
+// given day on share the simulation of the days before it. The daily loop of
+// the next run of the thread stops at the start of day StopDayNr and keeps
+// its state instead of finishing the run (no result is returned for it). A
+// run given a kept state continues the daily loop from that state; the state
+// must come from the same run with the same inputs up to its day.
+struct rep_RunState;
+
+void SetRunStop(int32_t StopDayNr);   // undef_int: to the end of the run
+void SetRunResume(std::shared_ptr<const rep_RunState> State);
+// State of the last run that stopped, nullptr when it ran to the end
+std::shared_ptr<const rep_RunState> TakeRunState();
+int32_t RunStateDayNr(const rep_RunState& State);   // first day still to simulate
 
 } // namespace AquaCrop
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "AquaCrop/Global.h"
+
+namespace AquaCrop {
+
+// Quantities that are constant for a run but are needed every day.
+// Filled once by DetermineRunConstants after InitializeRunPart2 and
+// consumed by the daily kernels instead of recomputing them.
+struct rep_RunConstants {
+    bool Filled;
+
+    // CO2 correction of the water productivity
+    dp CO2i;
+    dp WP;
+    int8_t AdaptedToCO2;
+    dp fCO2;
+
+    // curve numbers (soil CN corrected with the management CN correction)
+    int8_t CN1, CN2, CN3;
+
+    // soil evaporation
+    dp EvapDecline;
+    dp ExpEvapDeclineMin1; // exp(EvapDecline) - 1
+    dp fMulch;
+    dp fEvapRootNr;        // Epot multiplier for 10-day and monthly rainfall
+};
+
+extern thread_local rep_RunConstants RunConst;
+
+void DetermineRunConstants(dp CO2i);
+dp fAdjustedForCO2Run(dp CO2i, dp WPi, int8_t PercentA);
+
+} // namespace AquaCrop
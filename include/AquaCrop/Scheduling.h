@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/Evaluation.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Sensitivity.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Generated irrigation (IrriMode::Generate) with a schedule given per growth
+// stage of the crop instead of read from the irrigation file
+constexpr int32_t NrIrriStages = 4;   // initial, development, mid-season, late
+
+struct rep_IrriStageRule {
+    int32_t TimeInfo;    // as rep_IrriRule
+    int32_t DepthInfo;
+};
+
+struct rep_IrriStrategy {
+    GenerateTimeMode TimeMode = GenerateTimeMode::AllRAW;
+    GenerateDepthMode DepthMode = GenerateDepthMode::ToFC;
+    std::vector<rep_IrriStageRule> Stages;   // the first 1..NrIrriStages stages; the last rule holds to harvest
+    dp SeasonCap = undef_double;             // mm of irrigation in the run
+    dp ECw = 0.0;                            // dS/m
+};
+
+// Day of the cycle on which each of the first NrStages stages of the loaded
+// crop starts: day 1, the day after germination, after full canopy and after
+// the start of senescence
+std::vector<int32_t> IrriStageStartDays(int32_t NrStages);
+
+// Strategy of the runs of the calling thread (nullptr: as in the project).
+// StopStage >= 1 stops the daily loop at the start of that stage (SetRunStop).
+// ApplyIrrigationStrategy is called by RunSimulation once the run is loaded.
+void SetIrrigationStrategy(const rep_IrriStrategy* Strategy, int32_t StopStage = 0);
+void ApplyIrrigationStrategy();
+
+enum class IrriGoal : intEnum {
+    Output = 0,              // best seasonal output
+    WaterProductivity = 1    // highest output per mm of irrigation
+};
+
+struct rep_IrriSearchSettings {
+    GenerateTimeMode TimeMode = GenerateTimeMode::AllRAW;
+    GenerateDepthMode DepthMode = GenerateDepthMode::ToFC;
+    std::vector<int32_t> TimeLevels = {40, 70, 100};   // candidate TimeInfo values
+    std::vector<int32_t> DepthLevels = {0};            // candidate DepthInfo values
+    bool PerStage = false;            // a choice per growth stage instead of one for the cycle
+    dp SeasonCap = undef_double;      // mm
+    SensOutput Output = SensOutput::Yield;
+    rep_CalibObjective Objective;     // SensOutput::FitObjective (lower is better)
+    IrriGoal Goal = IrriGoal::Output;
+    bool ReuseSegments = true;        // simulate the common prefix of the candidates once
+    int32_t NrThreads = 0;            // 0: one per hardware thread
+    int32_t MaxCandidates = 100000;
+};
+
+struct rep_IrriCandidate {
+    std::vector<rep_IrriStageRule> Stages;
+    dp Irrigation;          // mm, mean over the runs
+    dp Output;              // ProjectOutputValue; NaN when not available
+    dp WaterProductivity;   // Output / Irrigation; NaN without irrigation
+};
+
+struct rep_IrriSearchResult {
+    std::vector<rep_IrriCandidate> Candidates;
+    std::vector<int32_t> Front;   // Pareto front (index in Candidates) by increasing irrigation
+    int32_t Best;                 // index in Candidates of the best under the cap, -1 if none
+    int64_t NrSimulatedDays;      // days simulated in the search
+    int64_t NrCandidateDays;      // days of all candidates simulated from their start
+};
+
+// Candidates that no other candidate beats on both irrigation (less) and
+// output (more, or less when not HigherIsBetter), by increasing irrigation
+std::vector<int32_t> IrrigationParetoFront(const std::vector<rep_IrriCandidate>& Candidates, bool HigherIsBetter);
+
+// Simulates every run of the project for every combination of the levels
+// (per stage: every sequence of stage choices) under the seasonal cap. The
+// candidates form a tree on their stage choices: each node is simulated in
+// parallel on a thread pool from the state its parent reached at the start of
+// the stage, so the days before a stage are simulated once for all
+// candidates that agree on them.
+bool OptimizeIrrigation(const std::string& TheProjectFile, const rep_IrriSearchSettings& Settings,
+                        rep_IrriSearchResult& Result);
+
+} // namespace AquaCrop
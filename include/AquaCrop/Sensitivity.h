@@ -0,0 +1,86 @@
+#pragma once
+
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Optimize.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Global sensitivity analysis over the unit cube [0,1]^n. The designs are
+// generated and evaluated batch by batch (BatchObjective, as the optimizers
+// use) and folded into streaming estimators, so the model outputs of the
+// whole design are never held at once.
+
+enum class SensMethod : intEnum {
+    Morris = 0,   // elementary effects of one-at-a-time trajectories
+    Sobol = 1     // first order (Saltelli) and total (Jansen) indices
+};
+
+struct rep_SensSettings {
+    SensMethod Method = SensMethod::Morris;
+    int32_t NrSamples = 100;    // Morris: trajectories; Sobol: rows of the A and B matrices
+    int32_t MorrisLevels = 4;   // grid levels of the Morris design (even)
+    int32_t BatchRows = 64;     // trajectories or rows per batch
+    uint64_t Seed = 1;
+};
+
+// Elementary effects of a parameter, in output units per unit-cube range
+struct rep_MorrisIndex {
+    int32_t N;
+    dp Mu;       // mean effect
+    dp MuStar;   // mean absolute effect
+    dp Sigma;    // standard deviation of the effects
+};
+
+struct rep_SobolIndex {
+    dp S1;       // first order index
+    dp ST;       // total index
+};
+
+struct rep_SensResult {
+    int32_t NrEvaluations;
+    dp Mean, Variance;                     // of the output over the base points
+    std::vector<rep_MorrisIndex> Morris;   // SensMethod::Morris
+    std::vector<rep_SobolIndex> Sobol;     // SensMethod::Sobol
+};
+
+// Morris needs NrSamples * (NrDim + 1) evaluations, Sobol NrSamples * (NrDim + 2)
+void AnalyzeSensitivity(int32_t NrDim, const BatchObjective& Model, const rep_SensSettings& Settings,
+                        rep_SensResult& Result);
+
+const char* SensMethodName(SensMethod Method);
+// Accepts "morris" and "sobol"
+bool ParseSensMethod(const std::string& Name, SensMethod& Method);
+
+// Scalar output of a project simulation; for a PRM the mean over its runs
+enum class SensOutput : intEnum {
+    Biomass = 0,        // ton/ha
+    Yield = 1,          // ton/ha
+    Transpiration = 2,  // mm
+    FitObjective = 3    // ObjectiveValue against the observations
+};
+
+const char* SensOutputName(SensOutput Output);
+// Accepts "biomass", "yield", "transpiration" and "fit"
+bool ParseSensOutput(const std::string& Name, SensOutput& Output);
+// NaN when the output is not available (no runs, no observations)
+dp ProjectOutputValue(const std::vector<rep_RunResult>& Results, SensOutput Output, const rep_CalibObjective& Objective);
+
+struct rep_ProjectSensSettings {
+    rep_SensSettings Sens;
+    SensOutput Output = SensOutput::Biomass;
+    rep_CalibObjective Objective;   // SensOutput::FitObjective
+    int32_t NrThreads = 0;          // 0: one per hardware thread
+};
+
+// Sensitivity of the output of the project to the parameters, varied over
+// [Lower, Upper]. The simulations of a batch run in parallel on a thread pool;
+// the project file and the CO2 record are parsed once for all of them.
+bool AnalyzeProjectSensitivity(const std::string& TheProjectFile, const std::vector<rep_CalibParameter>& Parameters,
+                               const rep_ProjectSensSettings& Settings, rep_SensResult& Result);
+
+} // namespace AquaCrop
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+
+namespace AquaCrop {
+
+// Instruction set levels for the batch kernels
+enum class SimdLevel : intEnum {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+// Highest level supported by this build and CPU
+SimdLevel DetectSimdLevel();
+// Level used by the dispatching kernels: the detected level, lowered by the
+// environment variable AQUACROP_SIMD (scalar, sse2, avx2, avx512) if set
+SimdLevel ActiveSimdLevel();
+bool SimdLevelAvailable(SimdLevel Level);
+const char* SimdLevelName(SimdLevel Level);
+
+// DegreesDay for NrDays days at a fixed level; bit-identical to calling
+// DegreesDay day by day. Falls back to the scalar loop if Level is not available.
+void DegreesDaySeriesAt(SimdLevel Level, dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                        int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD);
+
+// Salt cell kernels at a fixed level; bit-identical to SaltSolutionDeposit cell
+// by cell and to Mixing pair by pair (Salt and Depo hold NrPairs+1 cells, Dif
+// and mm2 one value per pair). Mixing is a chain over the pairs and runs on
+// the two cells of a pair, so every level above Scalar uses the SSE2 kernel.
+void SaltSolutionDepositCellsAt(SimdLevel Level, dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells);
+void MixSaltCellsAt(SimdLevel Level, int32_t NrPairs, const dp* Dif, dp mm1, const dp* mm2, dp* Salt, dp* Depo);
+
+} // namespace AquaCrop
@@ -4,6 +4,68 @@
 
 namespace AquaCrop {
 
+// Daily soil water and salt balance kernels called by Budget_module
+void calculate_drainage();
+void calculate_runoff(dp MaxDepth);
+// Generated irrigation of the day: the AllDepl and AllRAW rules turn
+// TargetTimeVal into 1 (irrigate) or 0 on the root zone water expected at the
+// end of the day, and Irrigation follows the depth rule and the season cap
+void Calculate_irrigation(dp& SubDrain, int32_t& TargetTimeVal, int32_t TargetDepthVal);
+void calculate_infiltration(dp& InfiltratedRain, dp& InfiltratedIrrigation, dp& InfiltratedStorage, dp& SubDrain);
+void calculate_CapillaryRise(dp& CRwater, dp& CRsalt);
+void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp InfiltratedStorage, dp SubDrain, dp ECInfilt, int32_t dayi);
+void calculate_transpiration(dp Tpot, dp Coeffb0Salt, dp Coeffb1Salt, dp Coeffb2Salt);
+void calculate_weighting_factors(dp Depth, std::vector<CompartmentIndividual>& Compartment_local);
+// Drainage function of layer NrLayer and its inverse (fractions)
+dp calculate_delta_theta(dp theta_in, dp thetaAdjFC, int32_t NrLayer);
+dp calculate_theta_from_delta(dp delta_theta, dp thetaAdjFC, int32_t NrLayer);
+
+// Facts of a run that Budget_module would otherwise test every day. Each
+// combination is a separate instantiation of the daily step, selected once
+// per run, in which the stages the configuration rules out are not compiled.
+enum class BudgetBunds : intEnum {
+    None = 0,      // BundHeight < 0.001 m: surface runoff
+    Low = 1,       // no runoff, no ponding
+    Ponding = 2    // BundHeight >= 0.01 m: surface storage
+};
+
+enum class BudgetIrri : intEnum {
+    Fixed = 0,     // no irrigation, or the events of the irrigation file
+    Generate = 1,  // IrriMode::Generate
+    Net = 2        // IrriMode::Inet
+};
+
+struct rep_BudgetConfig {
+    bool GDDays;          // crop.ModeCycle
+    bool EffectiveRain;   // decadal or monthly rainfall records
+    BudgetBunds Bunds;
+    BudgetIrri Irri;
+    bool Groundwater;     // a water table below the surface during the run
+    bool Salinity;        // salt in the profile or in the irrigation, storage or groundwater
+};
+
+constexpr int32_t NrBudgetConfigs = 2 * 2 * 3 * 3 * 2 * 2;
+
+// TargetTimeVal and TargetDepthVal of a day without an irrigation rule
+// (GetIrriParam); Budget_module then generates no irrigation
+constexpr int32_t NoIrriTarget = -999;
+
+using BudgetModuleFn = void (*)(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
+    int32_t VirtualTimeCC, int32_t SumInterval, int32_t DayLastCut,
+    int32_t NrDayGrow, int32_t Tadj, int32_t GDDTadj, dp GDDayi,
+    dp CGCref, dp GDDCGCref, dp CO2i, dp CCxTotal, dp CCoTotal, dp CDCTotal,
+    dp GDDCDCTotal, dp SumGDDadjCC, dp Coeffb0Salt, dp Coeffb1Salt, dp Coeffb2Salt,
+    dp StressTotSaltPrev, dp DayFraction, dp GDDayFraction, dp FracAssim,
+    int32_t StressSFadjNEW, bool StorageON, bool MobilizationON,
+    dp& StressLeaf, dp& StressSenescence, dp& TimeSenescence,
+    bool& NoMoreCrop, dp& TESTVAL);
+
+// Configuration of the loaded run, from its current state and its events
+// (call once the run is initialized)
+rep_BudgetConfig CurrentBudgetConfig();
+BudgetModuleFn SelectBudgetModule(const rep_BudgetConfig& Config);
+
+// One day of the balance, selecting the variant for the current state
 void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     int32_t VirtualTimeCC, int32_t SumInterval, int32_t DayLastCut,
     int32_t NrDayGrow, int32_t Tadj, int32_t GDDTadj, dp GDDayi,
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "AquaCrop/Global.h"
+#include <vector>
+
+namespace AquaCrop {
+
+// Soil quantities derived from the groundwater depth and the compartments:
+// the water table flag, the adjusted field capacity (FCadj of Compartment),
+// the maximum capillary rise per compartment, the weighting factors of the
+// topsoil wetness and the extent of the root zone. Every part keeps the inputs it was derived from and
+// is only recomputed when one of them changes.
+struct rep_DerivedSoilState {
+    // compartments the state was derived for
+    std::vector<dp> Thickness;
+    std::vector<int32_t> Layer;
+
+    // groundwater depth (m) of WaterTableInProfile, FCadj and CRmax
+    bool GroundwaterValid;
+    dp DepthGWTmeter;
+    bool WaterTableInProfile;
+    std::vector<dp> CRmax;   // MaxCRatDepth at the middle of each compartment
+
+    // MaxCRatDepth per compartment for whole-centimetre depths: compartment
+    // compi holds the depths CRTableFrom..CRTableFrom+CRTableSize-1 (cm) from
+    // CRTableStart on. Built when the depth first moves for the compartments,
+    // so runs with a constant table do not pay for it.
+    bool CRTablesValid;
+    std::vector<int32_t> CRTableFrom;
+    std::vector<int32_t> CRTableSize;
+    std::vector<int32_t> CRTableStart;
+    std::vector<dp> CRTable;
+
+    // root zone of depth RootZoneDepth (m): compartments 1..RootZoneNrComp,
+    // each counted over RootZoneDZ (m, the last one possibly in part) with
+    // the gravel-free fraction RootZoneGravel, and its water at FC, WP and SAT (mm)
+    bool RootZoneValid;
+    dp RootZoneDepth;
+    int32_t RootZoneNrComp;
+    std::vector<dp> RootZoneDZ;
+    std::vector<dp> RootZoneGravel;
+    dp RootZoneFC, RootZoneWP, RootZoneSAT;
+
+    // depth (m) of the weighting factors
+    bool WeightsValid;
+    dp WeightDepth;
+    std::vector<dp> WFactor;
+};
+
+extern thread_local rep_DerivedSoilState DerivedSoil;
+
+// Forgets all derived quantities (the soil profile was loaded or reset)
+void InvalidateDerivedSoilState();
+// Brings WaterTableInProfile, FCadj of Compartment and CRmax up to date for
+// the groundwater depth DepthGWTmeter (m)
+void UpdateGroundwaterState(dp DepthGWTmeter);
+// Brings the root zone up to date for RootingDepth (m)
+void UpdateRootZoneState(dp RootingDepth);
+// Weighting factors of the compartments for the top Depth (m) of the soil
+const std::vector<dp>& WeightingFactors(dp Depth);
+
+} // namespace AquaCrop
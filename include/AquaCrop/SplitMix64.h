@@ -0,0 +1,37 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+
+#include <cstdint>
+
+namespace AquaCrop {
+
+// Deterministic pseudo-random stream (splitmix64). The sequence only depends
+// on the seed, so sampled inputs are identical on every platform and run.
+struct rep_SplitMix64 {
+    uint64_t State;
+
+    uint64_t Next();
+    dp Uniform();                     // [0, 1)
+    dp Uniform(dp Lower, dp Upper);   // [Lower, Upper)
+};
+
+inline uint64_t rep_SplitMix64::Next()
+{
+    uint64_t z = (State += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline dp rep_SplitMix64::Uniform()
+{
+    return static_cast<dp>(Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline dp rep_SplitMix64::Uniform(dp Lower, dp Upper)
+{
+    return Lower + (Upper - Lower) * Uniform();
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+#include <cstdint>
+#include <string>
+
+namespace AquaCrop {
+
+// The stages of Budget_module, in execution order
+enum class BudgetStage : intEnum {
+    BalanceBegin = 0,
+    Groundwater,
+    Drainage,
+    Runoff,
+    Infiltration,
+    CapillaryRise,
+    SaltBalance,
+    Germination,
+    FertilitySalinity,
+    CanopyCover,
+    ETpot,
+    Evaporation,
+    Transpiration,
+    GroundwaterInflow,
+    SaltConcentration,
+    BalanceEnd,
+    NrStages
+};
+
+constexpr int32_t NrBudgetStages = static_cast<int32_t>(BudgetStage::NrStages);
+
+const char* BudgetStageName(BudgetStage Stage);
+
+#ifdef AQUACROP_STAGE_HOOKS
+
+// Observer of the Budget_module state, called after every stage with the
+// day and the stage that just finished (golden-state regression harness).
+// nullptr, the default, disables the callback. Only in builds with
+// AQUACROP_STAGE_HOOKS.
+using BudgetStageObserver = void (*)(int32_t DayNr, BudgetStage Stage);
+extern BudgetStageObserver StageObserver;
+
+#endif
+
+#ifdef AQUACROP_STAGE_PROFILING
+
+// Per-stage time counters, collected per thread for the current run and
+// merged into the per-run table by EndStageProfileRun.
+uint64_t StageTicks();
+void AddStageTicks(BudgetStage Stage, uint64_t Ticks);
+void BeginStageProfileRun(const std::string& ProjectFile, int32_t NrRun);
+void EndStageProfileRun();
+// Text report on std::cerr and <PathName>StageProfile.txt/.json
+void WriteStageProfile(const std::string& PathName);
+
+// Hardware counters per stage (see PerfCounters.h)
+extern bool PerfCountersRequested;
+void PerfStageMark(BudgetStage Stage);
+
+#endif
+
+#if defined(AQUACROP_STAGE_PROFILING) || defined(AQUACROP_STAGE_HOOKS)
+
+// Consecutive stages of one day: Next() closes the running stage and starts
+// the next one, the destructor closes the last one. Closing a stage records
+// its time (AQUACROP_STAGE_PROFILING) and notifies the observer
+// (AQUACROP_STAGE_HOOKS).
+class StageSequence {
+public:
+    explicit StageSequence(int32_t DayNr) : DayNr_(DayNr), Stage_(BudgetStage::NrStages) {}
+    ~StageSequence() {
+#ifdef AQUACROP_STAGE_PROFILING
+        if (Stage_ != BudgetStage::NrStages) AddStageTicks(Stage_, StageTicks() - Start_);
+        if (PerfCountersRequested) PerfStageMark(Stage_);
+#endif
+#ifdef AQUACROP_STAGE_HOOKS
+        if (StageObserver != nullptr && Stage_ != BudgetStage::NrStages) StageObserver(DayNr_, Stage_);
+#endif
+    }
+    void Next(BudgetStage Stage) {
+#ifdef AQUACROP_STAGE_PROFILING
+        if (PerfCountersRequested) PerfStageMark(Stage_);
+        uint64_t Now = StageTicks();
+        if (Stage_ != BudgetStage::NrStages) AddStageTicks(Stage_, Now - Start_);
+        Start_ = Now;
+#endif
+#ifdef AQUACROP_STAGE_HOOKS
+        if (StageObserver != nullptr && Stage_ != BudgetStage::NrStages) StageObserver(DayNr_, Stage_);
+#endif
+        Stage_ = Stage;
+    }
+    StageSequence(const StageSequence&) = delete;
+    StageSequence& operator=(const StageSequence&) = delete;
+private:
+    int32_t DayNr_;
+    BudgetStage Stage_;
+#ifdef AQUACROP_STAGE_PROFILING
+    uint64_t Start_ = 0;
+#endif
+};
+
+#define AQUACROP_STAGE_SEQUENCE(DayNr) ::AquaCrop::StageSequence AquaCropStages_(DayNr)
+#define AQUACROP_STAGE(Stage) AquaCropStages_.Next(::AquaCrop::BudgetStage::Stage)
+
+#else
+
+// Neither profiling nor hooks: the stages compile to nothing
+#define AQUACROP_STAGE_SEQUENCE(DayNr) ((void)0)
+#define AQUACROP_STAGE(Stage) ((void)0)
+
+#endif
+
+#ifdef AQUACROP_STAGE_PROFILING
+
+#define AQUACROP_STAGE_RUN_BEGIN(ProjectFile, NrRun) ::AquaCrop::BeginStageProfileRun((ProjectFile), (NrRun))
+#define AQUACROP_STAGE_RUN_END() ::AquaCrop::EndStageProfileRun()
+#define AQUACROP_STAGE_REPORT(PathName) ::AquaCrop::WriteStageProfile(PathName)
+
+#else
+
+// Profiling disabled: the run hooks compile to nothing
+#define AQUACROP_STAGE_RUN_BEGIN(ProjectFile, NrRun) ((void)0)
+#define AQUACROP_STAGE_RUN_END() ((void)0)
+#define AQUACROP_STAGE_REPORT(PathName) ((void)0)
+
+#endif
+
+} // namespace AquaCrop
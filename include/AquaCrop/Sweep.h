@@ -0,0 +1,55 @@
+#pragma once
+
+#include "AquaCrop/Evaluation.h"
+#include "AquaCrop/Global.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Sowing dates from FromDay/FromMonth to ToDay/ToMonth every StepDays. A
+// window ending before it starts runs into the next year.
+struct rep_SowingWindow {
+    int32_t FromDay = 1, FromMonth = 1;
+    int32_t ToDay = 31, ToMonth = 12;
+    int32_t StepDays = 7;
+};
+
+// Sowing dates (DayNr) of the window starting in Year
+std::vector<int32_t> SowingDayNrs(const rep_SowingWindow& Window, int32_t Year);
+
+// Sowing date of the runs of the calling thread (undef_int: as in the project).
+// ApplySowingDate is called by RunSimulation once the run is loaded: it moves
+// the crop cycle and the simulation period to the new date, keeping their
+// lengths, and adjusts the crop lengths to it (ResetCropDay1,
+// AdjustCropFileParameters).
+void SetSowingDate(int32_t CropDay1);
+void ApplySowingDate();
+
+struct rep_SweepSettings {
+    rep_SowingWindow Window;
+    int32_t NrThreads = 0;  // 0: one per hardware thread
+};
+
+// Year x sowing date matrix; the years are the runs of the project
+struct rep_SweepResult {
+    std::vector<int32_t> Years;          // year of the sowing window of each run
+    std::vector<int32_t> SowingOffsets;  // days after the window start
+    std::vector<rep_RunResult> Cells;    // Years.size() x SowingOffsets.size(), by year
+
+    const rep_RunResult& Cell(int32_t Yeari, int32_t Datei) const   // 1-based
+    {
+        return Cells[(Yeari - 1) * SowingOffsets.size() + (Datei - 1)];
+    }
+};
+
+// Simulates every run of the project (one run of an .ACp, all runs of a PRM)
+// for every sowing date of the window in the year the run is sown. The dates
+// are simulated in parallel on a thread pool; the year-level inputs (the
+// parsed project, the CO2 record) are prepared once and shared by all dates
+// of the year.
+bool SweepSowingDates(const std::string& TheProjectFile, const rep_SweepSettings& Settings, rep_SweepResult& Result);
+
+} // namespace AquaCrop
@@ -6,6 +6,7 @@ namespace AquaCrop {
 void GetDecadeTemperatureDataSet(int32_t DayNr, std::vector<rep_DayEventDbl>& MinDataSet, std::vector<rep_DayEventDbl>& MaxDataSet);
 void GetMonthlyTemperatureDataSet(int32_t DayNr, std::vector<rep_DayEventDbl>& MinDataSet, std::vector<rep_DayEventDbl>& MaxDataSet);
 void TemperatureFileCoveringCropPeriod(int32_t Day1, int32_t DayN);
+void PrepareGDDIndex(int32_t FromDayNr, int32_t ToDayNr);
 int32_t GrowingDegreeDays(int32_t ValPeriod, int32_t FirstDayPeriod, dp Tbase, dp Tupper, dp TDayMin, dp TDayMax);
 int32_t SumCalendarDays(int32_t ValGDDays, int32_t FirstDayCrop, dp Tbase, dp Tupper, dp TDayMin, dp TDayMax);
 dp MaxAvailableGDD(int32_t DayNr, dp Tbase, dp Tupper, dp Tmin, dp Tmax);
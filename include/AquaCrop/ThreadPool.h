@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AquaCrop {
+
+// Fixed set of worker threads. Every worker owns its simulation state (the
+// thread_local globals of Global.h), so each task can run a whole project
+// independently of the others.
+class ThreadPool {
+public:
+    // NrThreads <= 0: one worker per hardware thread
+    explicit ThreadPool(int32_t NrThreads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int32_t Size() const { return static_cast<int32_t>(Workers_.size()); }
+
+    // True on the workers of every pool: work that would be split over a
+    // pool again is done on the worker instead
+    static bool OnWorker();
+
+    // Calls Task(Item) for Item = 0..NrItems-1 on the workers and returns when
+    // all items are done. Items are handed out one at a time, in order.
+    void ParallelFor(int32_t NrItems, const std::function<void(int32_t Item)>& Task);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> Workers_;
+    std::mutex Mutex_;
+    std::condition_variable WorkReady_;
+    std::condition_variable WorkDone_;
+    const std::function<void(int32_t)>* Task_ = nullptr;
+    int32_t NrItems_ = 0;
+    int32_t NextItem_ = 0;
+    int32_t NrBusy_ = 0;
+    bool Stop_ = false;
+};
+
+} // namespace AquaCrop
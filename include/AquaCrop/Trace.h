@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AquaCrop/Kinds.h"
+#include <cstdint>
+#include <string>
+
+namespace AquaCrop {
+
+// Chrome/Perfetto trace-event output (--trace out.json). Every thread
+// appends complete events to its own buffer without locking; the buffers
+// are written out by WriteTrace at the end of the program.
+
+extern bool TraceRequested;
+
+void StartTrace(const std::string& FileName);
+inline bool TraceEnabled() { return TraceRequested; }
+// Project and run number attached to the following spans of this thread
+void SetTraceTags(const std::string& ProjectFile, int32_t NrRun);
+uint64_t TraceNow();
+// Tags of this thread, taken when a span starts
+void CurrentTraceTags(int32_t& Tag, int32_t& NrRun);
+void AddTraceSpan(const char* Name, uint64_t Begin, uint64_t End, int32_t Tag, int32_t NrRun);
+void WriteTrace();
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* Name) : Name_(Name), Begin_(0), Tag_(-1), NrRun_(0) {
+        if (TraceEnabled()) {
+            CurrentTraceTags(Tag_, NrRun_);
+            Begin_ = TraceNow();
+        }
+    }
+    ~TraceSpan() {
+        if (TraceEnabled()) AddTraceSpan(Name_, Begin_, TraceNow(), Tag_, NrRun_);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+private:
+    const char* Name_;
+    uint64_t Begin_;
+    int32_t Tag_;
+    int32_t NrRun_;
+};
+
+#define AQUACROP_TRACE_CONCAT_(a, b) a##b
+#define AQUACROP_TRACE_CONCAT(a, b) AQUACROP_TRACE_CONCAT_(a, b)
+#define AQUACROP_TRACE_SPAN(Name) ::AquaCrop::TraceSpan AQUACROP_TRACE_CONCAT(AquaCropTraceSpan_, __LINE__)(Name)
+
+} // namespace AquaCrop
@@ -10,6 +10,12 @@
 
 namespace py = pybind11;
 
+// Python calls in from any of its threads; the simulation state of such a
+// thread is constructed before the call enters the library (Global.h)
+struct ThreadStateGuard {
+    ThreadStateGuard() { AquaCrop::InitializeThreadState(); }
+};
+
 // Helper class for results
 class SimulationResults {
 public:
@@ -125,57 +131,70 @@ PYBIND11_MODULE(_core, m) {
     
     // Model class
     py::class_<Model>(m, "Model")
-        .def(py::init<>())
+        .def(py::init<>(), py::call_guard<ThreadStateGuard>())
         .def(py::init<const std::string&>(),
+             py::call_guard<ThreadStateGuard>(),
              py::arg("config") = "")
         
         // Soil methods
         .def("set_soil", &Model::set_soil,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("soil_file"),
              "Set soil parameters from file")
         .def("set_soil_parameters", &Model::set_soil_parameters,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("params"),
              "Set soil parameters from dictionary")
         
         // Climate methods
         .def("set_climate", &Model::set_climate,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("climate_file"),
              "Set climate data from file")
         .def("set_climate_parameters", &Model::set_climate_parameters,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("params"),
              "Set climate parameters from dictionary")
         
         // Crop methods
         .def("set_crop", &Model::set_crop,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("crop_file"),
              "Set crop parameters from file")
         .def("set_crop_parameters", &Model::set_crop_parameters,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("params"),
              "Set crop parameters from dictionary")
         
         // Irrigation methods
         .def("set_irrigation", &Model::set_irrigation,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("irrigation"),
              "Set irrigation parameters")
         
         // Simulation control
         .def("set_start_date", &Model::set_start_date,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("date"),
              "Set simulation start date (YYYY-MM-DD)")
         .def("set_end_date", &Model::set_end_date,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("date"),
              "Set simulation end date (YYYY-MM-DD)")
         .def("set_initial_conditions", &Model::set_initial_conditions,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("conditions"),
              "Set initial soil water conditions")
         
         // Run simulation
         .def("run", &Model::run,
+             py::call_guard<ThreadStateGuard>(),
              py::arg("project_file") = "",
              "Run the simulation")
         
         // Results
         .def("get_results", &Model::get_results,
+             py::call_guard<ThreadStateGuard>(),
              "Get simulation results");
     
     // Free functions
@@ -0,0 +1,90 @@
+#include "AquaCrop/CO2Series.h"
+#include "AquaCrop/Utils.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace AquaCrop {
+
+namespace {
+
+struct rep_CO2CacheEntry {
+    std::filesystem::file_time_type WriteTime;
+    std::shared_ptr<const rep_CO2Series> Series;
+};
+
+std::mutex CO2CacheMutex;
+std::map<std::string, rep_CO2CacheEntry> CO2Cache;
+
+std::shared_ptr<const rep_CO2Series> ReadCO2Series(const std::string& CO2FileFull) {
+    std::ifstream fhandle(CO2FileFull);
+    if (!fhandle.is_open()) return nullptr;
+
+    std::string line;
+    for (int k = 0; k < 3; ++k) std::getline(fhandle, line); // Skip 3 lines
+
+    // records (year, CO2); lines without two numbers are skipped
+    std::vector<int32_t> Years;
+    std::vector<dp> Values;
+    while (std::getline(fhandle, line)) {
+        std::istringstream ss(line);
+        dp Year, CO2;
+        if (!(ss >> Year >> CO2)) continue;
+        Years.push_back(static_cast<int32_t>(roundc(Year, 1)));
+        Values.push_back(CO2);
+    }
+    if (Years.empty()) return nullptr;
+
+    auto Series = std::make_shared<rep_CO2Series>();
+    int32_t NrRecords = static_cast<int32_t>(Years.size());
+    Series->FirstYear = Years[0];
+    Series->LastYear = Years[0];
+    for (int32_t k = 1; k < NrRecords; ++k) {
+        if (Years[k] > Series->LastYear) Series->LastYear = Years[k];
+    }
+    Series->FirstCO2 = Values[0];
+    Series->LastCO2 = Values[NrRecords - 1];
+
+    // A year is interpolated between the first record at or after it and
+    // the record before that one (as the sequential file scan did)
+    int32_t NrYears = Series->LastYear - Series->FirstYear + 1;
+    Series->YearCO2.resize(NrYears);
+    Series->YearCO2[0] = Values[0];
+    int32_t b = 0;
+    for (int32_t y = 1; y < NrYears; ++y) {
+        int32_t Year = Series->FirstYear + y;
+        while (Years[b] < Year) ++b;
+        int32_t a = b - 1;
+        Series->YearCO2[y] = Values[a] + (Values[b] - Values[a]) * static_cast<dp>(Year - Years[a]) / static_cast<dp>(Years[b] - Years[a]);
+    }
+    return Series;
+}
+
+} // namespace
+
+dp rep_CO2Series::CO2ForYear(int32_t Year) const {
+    if (Year <= FirstYear) return FirstCO2;
+    if (Year > LastYear) return LastCO2;
+    return YearCO2[Year - FirstYear];
+}
+
+std::shared_ptr<const rep_CO2Series> GetCO2Series(const std::string& CO2FileFull) {
+    std::error_code ec;
+    std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(CO2FileFull, ec);
+    if (ec) return nullptr;
+
+    std::lock_guard<std::mutex> lock(CO2CacheMutex);
+    auto it = CO2Cache.find(CO2FileFull);
+    if (it != CO2Cache.end() && it->second.WriteTime == WriteTime) {
+        return it->second.Series;
+    }
+    std::shared_ptr<const rep_CO2Series> Series = ReadCO2Series(CO2FileFull);
+    if (Series) {
+        CO2Cache[CO2FileFull] = {WriteTime, Series};
+    }
+    return Series;
+}
+
+} // namespace AquaCrop
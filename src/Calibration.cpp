@@ -0,0 +1,260 @@
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/Run.h"
+#include "AquaCrop/StartUnit.h"
+#include "AquaCrop/ThreadPool.h"
+#include "AquaCrop/Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+namespace AquaCrop {
+
+namespace {
+
+#define AQUACROP_CROP_PARAM(Field, Description) \
+    {"crop." #Field, Description, [](dp V) { crop.Field = V; }, []() -> dp { return crop.Field; }}
+#define AQUACROP_CROP_INT_PARAM(Field, Description) \
+    {"crop." #Field, Description, [](dp V) { crop.Field = static_cast<decltype(crop.Field)>(roundc(V, 1)); }, \
+     []() -> dp { return static_cast<dp>(crop.Field); }}
+#define AQUACROP_SOIL_PARAM(Field, Description) \
+    {"soil." #Field, Description, [](dp V) { Soil.Field = static_cast<decltype(Soil.Field)>(V); }, \
+     []() -> dp { return static_cast<dp>(Soil.Field); }}
+#define AQUACROP_SOIL_INT_PARAM(Field, Description) \
+    {"soil." #Field, Description, [](dp V) { Soil.Field = static_cast<decltype(Soil.Field)>(roundc(V, 1)); }, \
+     []() -> dp { return static_cast<dp>(Soil.Field); }}
+
+// Soil.REW is not offered: InitializeSimulationRunPart1 does not use the
+// value of the soil file yet.
+const std::vector<rep_ParamBinding> Bindings = {
+    AQUACROP_CROP_PARAM(CCo, "initial canopy cover (fraction)"),
+    AQUACROP_CROP_PARAM(CCx, "maximum canopy cover (fraction)"),
+    AQUACROP_CROP_PARAM(CGC, "canopy growth coefficient (fraction/day)"),
+    AQUACROP_CROP_PARAM(CDC, "canopy decline coefficient (fraction/day)"),
+    AQUACROP_CROP_PARAM(GDDCGC, "canopy growth coefficient (fraction/growing degree day)"),
+    AQUACROP_CROP_PARAM(GDDCDC, "canopy decline coefficient (fraction/growing degree day)"),
+    AQUACROP_CROP_PARAM(KcTop, "crop coefficient at full canopy"),
+    AQUACROP_CROP_PARAM(KcDecline, "decline of the crop coefficient (%/day)"),
+    AQUACROP_CROP_PARAM(WP, "normalized water productivity (g/m2)"),
+    AQUACROP_CROP_INT_PARAM(HI, "reference harvest index (%)"),
+    AQUACROP_CROP_PARAM(dHIdt, "build-up of the harvest index (%/day)"),
+    AQUACROP_CROP_PARAM(pdef, "soil water depletion threshold for stomatal closure"),
+    AQUACROP_CROP_PARAM(pLeafDefUL, "upper threshold for canopy expansion"),
+    AQUACROP_CROP_PARAM(pLeafDefLL, "lower threshold for canopy expansion"),
+    AQUACROP_CROP_PARAM(pSenescence, "soil water depletion threshold for early senescence"),
+    AQUACROP_CROP_PARAM(pPollination, "soil water depletion threshold for pollination failure"),
+    AQUACROP_CROP_PARAM(KsShapeFactorLeaf, "shape factor of the stress curve for canopy expansion"),
+    AQUACROP_CROP_PARAM(KsShapeFactorStomata, "shape factor of the stress curve for stomatal closure"),
+    AQUACROP_CROP_PARAM(KsShapeFactorSenescence, "shape factor of the stress curve for senescence"),
+    AQUACROP_CROP_PARAM(RootMin, "minimum effective rooting depth (m)"),
+    AQUACROP_CROP_PARAM(RootMax, "maximum effective rooting depth (m)"),
+    AQUACROP_CROP_PARAM(Tbase, "base temperature (degC)"),
+    AQUACROP_CROP_PARAM(Tupper, "upper temperature (degC)"),
+    AQUACROP_SOIL_INT_PARAM(CNvalue, "curve number"),
+    AQUACROP_SOIL_PARAM(RootMax, "maximum rooting depth allowed by the soil profile (m)"),
+};
+
+#undef AQUACROP_CROP_PARAM
+#undef AQUACROP_CROP_INT_PARAM
+#undef AQUACROP_SOIL_PARAM
+#undef AQUACROP_SOIL_INT_PARAM
+
+// Overrides of the runs of this thread
+thread_local std::vector<const rep_ParamBinding*> OverrideBindings;
+thread_local std::vector<dp> OverrideValues;
+thread_local std::vector<dp> LoadedValues;
+// Settings read once per worker by InitializeTheProgram
+thread_local bool WorkerReady = false;
+
+dp MetricValue(const rep_FitStats& Fit, FitMetric Metric)
+{
+    dp Value = undef_double;
+    switch (Metric) {
+        case FitMetric::RMSE: Value = Fit.RMSE; break;
+        case FitMetric::NRMSE: Value = Fit.NRMSE; break;
+        case FitMetric::OneMinusD: Value = (Fit.d == undef_double) ? undef_double : 1.0 - Fit.d; break;
+        case FitMetric::OneMinusEF: Value = (Fit.EF == undef_double) ? undef_double : 1.0 - Fit.EF; break;
+    }
+    return Value;
+}
+
+} // namespace
+
+void PrepareSimulationThread()
+{
+    if (WorkerReady) return;
+    InitializeGlobalStrings();
+    InitializeTheProgram();
+    ConsoleOutput = false;
+    WorkerReady = true;
+}
+
+std::vector<rep_RunResult> SimulateProject(const std::string& TheProjectFile, typeproject TheProjectType,
+                                           const std::vector<rep_CalibParameter>& Parameters,
+                                           const std::vector<dp>& Values, int32_t OnlyRun)
+{
+    PrepareSimulationThread();
+    SetRunOverrides(Parameters, Values);
+    InitializeProject(1, TheProjectFile, TheProjectType);
+    if (OnlyRun >= 1 && OnlyRun <= static_cast<int32_t>(ProjectInput.size())) {
+        ProjectInput = {ProjectInput[OnlyRun-1]};
+        Simulation.NrRuns = 1;
+    }
+    std::vector<rep_RunResult> Results = RunSimulation(TheProjectFile, TheProjectType);
+    ClearRunOverrides();
+    return Results;
+}
+
+const std::vector<rep_ParamBinding>& ParameterBindings()
+{
+    return Bindings;
+}
+
+const rep_ParamBinding* FindParameterBinding(const std::string& Name)
+{
+    for (const rep_ParamBinding& Binding : Bindings) {
+        if (Name == Binding.Name) return &Binding;
+    }
+    return nullptr;
+}
+
+bool ParseCalibParameter(const std::string& Spec, rep_CalibParameter& Parameter)
+{
+    size_t First = Spec.find(':');
+    size_t Second = (First == std::string::npos) ? First : Spec.find(':', First + 1);
+    if (Second == std::string::npos) return false;
+    Parameter.Binding = FindParameterBinding(Spec.substr(0, First));
+    if (Parameter.Binding == nullptr) return false;
+    Parameter.Lower = std::atof(Spec.substr(First + 1, Second - First - 1).c_str());
+    Parameter.Upper = std::atof(Spec.substr(Second + 1).c_str());
+    return Parameter.Upper > Parameter.Lower;
+}
+
+std::vector<dp> ParameterValues(const std::vector<rep_CalibParameter>& Parameters, const std::vector<dp>& X)
+{
+    std::vector<dp> Values(Parameters.size());
+    for (size_t i = 0; i < Parameters.size(); ++i) {
+        Values[i] = Parameters[i].Lower + X[i] * (Parameters[i].Upper - Parameters[i].Lower);
+    }
+    return Values;
+}
+
+void SetRunOverrides(const std::vector<rep_CalibParameter>& Parameters, const std::vector<dp>& Values)
+{
+    OverrideBindings.resize(Parameters.size());
+    for (size_t i = 0; i < Parameters.size(); ++i) OverrideBindings[i] = Parameters[i].Binding;
+    OverrideValues = Values;
+}
+
+void ClearRunOverrides()
+{
+    OverrideBindings.clear();
+    OverrideValues.clear();
+}
+
+void ApplyRunOverrides()
+{
+    LoadedValues.resize(OverrideBindings.size());
+    for (size_t i = 0; i < OverrideBindings.size(); ++i) {
+        LoadedValues[i] = OverrideBindings[i]->Get();
+        if (!std::isnan(OverrideValues[i])) OverrideBindings[i]->Set(OverrideValues[i]);
+    }
+}
+
+const std::vector<dp>& LoadedParameterValues()
+{
+    return LoadedValues;
+}
+
+const char* FitMetricName(FitMetric Metric)
+{
+    switch (Metric) {
+        case FitMetric::RMSE: return "rmse";
+        case FitMetric::NRMSE: return "nrmse";
+        case FitMetric::OneMinusD: return "1-d";
+        case FitMetric::OneMinusEF: return "1-ef";
+    }
+    return "?";
+}
+
+bool ParseFitMetric(const std::string& Name, FitMetric& Metric)
+{
+    for (FitMetric M : {FitMetric::RMSE, FitMetric::NRMSE, FitMetric::OneMinusD, FitMetric::OneMinusEF}) {
+        if (Name == FitMetricName(M)) {
+            Metric = M;
+            return true;
+        }
+    }
+    return false;
+}
+
+dp ObjectiveValue(const std::vector<rep_RunResult>& Results, const rep_CalibObjective& Objective)
+{
+    dp Sum = 0.0, SumWeight = 0.0;
+    for (const rep_RunResult& Run : Results) {
+        for (int32_t k = 1; k <= NrObsSim; ++k) {
+            const rep_FitStats& Fit = Run.Fit[k-1];
+            dp Value = MetricValue(Fit, Objective.Metric);
+            if (Fit.N == 0 || Objective.Weight[k-1] <= 0.0 || Value == undef_double) continue;
+            Sum += Objective.Weight[k-1] * Value;
+            SumWeight += Objective.Weight[k-1];
+        }
+    }
+    return (SumWeight > 0.0) ? Sum / SumWeight : HUGE_VAL;
+}
+
+bool CalibrateProject(const std::string& TheProjectFile, const std::vector<rep_CalibParameter>& Parameters,
+                      const rep_CalibSettings& Settings, rep_CalibResult& Result)
+{
+    const int32_t NrParams = static_cast<int32_t>(Parameters.size());
+    typeproject TheProjectType;
+    GetProjectType(TheProjectFile, TheProjectType);
+    if (TheProjectType == typeproject::typenone) {
+        std::cerr << "Not a project file (.ACp or .PRM): " << TheProjectFile << std::endl;
+        return false;
+    }
+    ThreadPool Pool(Settings.NrThreads);
+
+    // reference run with the file values
+    const std::vector<dp> FileValues(NrParams, std::numeric_limits<dp>::quiet_NaN());
+    Pool.ParallelFor(1, [&](int32_t) {
+        Result.StartObjective = ObjectiveValue(SimulateProject(TheProjectFile, TheProjectType, Parameters, FileValues),
+                                               Settings.Objective);
+        Result.StartValues = LoadedParameterValues();
+    });
+    if (Result.StartObjective == HUGE_VAL) {
+        std::cerr << "No observations to calibrate against in " << TheProjectFile << std::endl;
+        return false;
+    }
+
+    rep_OptimSettings Optim = Settings.Optim;
+    Optim.Start.resize(NrParams);
+    for (int32_t i = 1; i <= NrParams; ++i) {
+        const rep_CalibParameter& P = Parameters[i-1];
+        Optim.Start[i-1] = (Result.StartValues[i-1] - P.Lower) / (P.Upper - P.Lower);
+    }
+    BatchObjective Objective = [&](const std::vector<std::vector<dp>>& Points, std::vector<dp>& Values) {
+        Pool.ParallelFor(static_cast<int32_t>(Points.size()), [&](int32_t Item) {
+            Values[Item] = ObjectiveValue(SimulateProject(TheProjectFile, TheProjectType, Parameters,
+                                                          ParameterValues(Parameters, Points[Item])),
+                                          Settings.Objective);
+        });
+    };
+    rep_OptimResult Optimum = MinimizeInUnitCube(NrParams, Objective, Optim);
+
+    Result.NrEvaluations = Optimum.NrEvaluations + 1;
+    Result.NrIterations = Optimum.NrIterations;
+    if (!Optimum.Best.empty() && Optimum.BestValue < Result.StartObjective) {
+        Result.BestValues = ParameterValues(Parameters, Optimum.Best);
+        Result.BestObjective = Optimum.BestValue;
+    } else {
+        Result.BestValues = Result.StartValues;
+        Result.BestObjective = Result.StartObjective;
+    }
+    return true;
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,68 @@
+#include "AquaCrop/CropCalendar.h"
+
+namespace AquaCrop {
+
+namespace {
+
+bool SameCurve(const rep_CCCurve& Curve, int32_t L0, int32_t L123, int32_t LMaturity, dp CCo, dp CCx, dp CGC, dp CDC,
+               int8_t SFRedCGC, int8_t SFRedCCx)
+{
+    return Curve.L0 == L0 && Curve.L123 == L123 && Curve.LMaturity == LMaturity && Curve.CCo == CCo
+        && Curve.CCx == CCx && Curve.CGC == CGC && Curve.CDC == CDC && Curve.SFRedCGC == SFRedCGC
+        && Curve.SFRedCCx == SFRedCCx;
+}
+
+// The curve with these parameters, filled in a free slot the first time;
+// nullptr when all slots hold other curves
+const rep_CCCurve* CalendarCurve(int32_t L0, int32_t L123, int32_t LMaturity, dp CCo, dp CCx, dp CGC, dp CDC,
+                                 int8_t SFRedCGC, int8_t SFRedCCx)
+{
+    for (rep_CCCurve& Curve : CropCalendar.Curves) {
+        if (Curve.Filled) {
+            if (SameCurve(Curve, L0, L123, LMaturity, CCo, CCx, CGC, CDC, SFRedCGC, SFRedCCx)) return &Curve;
+            continue;
+        }
+        if (LMaturity < 0) return nullptr;
+        Curve.L0 = L0;
+        Curve.L123 = L123;
+        Curve.LMaturity = LMaturity;
+        Curve.CCo = CCo;
+        Curve.CCx = CCx;
+        Curve.CGC = CGC;
+        Curve.CDC = CDC;
+        Curve.SFRedCGC = SFRedCGC;
+        Curve.SFRedCCx = SFRedCCx;
+        // day t of the curve is DAP t + DelayedDays, whatever the delay
+        Curve.CC.resize(LMaturity + 1);
+        for (int32_t t = 0; t <= LMaturity; ++t) {
+            Curve.CC[t] = CanopyCoverNoStressSF(t + Simulation.DelayedDays, L0, L123, LMaturity, 0, 0, 0, CCo, CCx, CGC, CDC, 0.0, 0.0, 0.0, modeCycle::CalendarDays, SFRedCGC, SFRedCCx);
+        }
+        Curve.Filled = true;
+        return &Curve;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void DetermineCropCalendar()
+{
+    for (rep_CCCurve& Curve : CropCalendar.Curves) {
+        Curve.Filled = false;
+        Curve.CC.clear();
+    }
+}
+
+dp CanopyCoverNoStressSFRun(int32_t DAP, int32_t L0, int32_t L123, int32_t LMaturity, int32_t GDDL0, int32_t GDDL123, int32_t GDDLMaturity, dp CCo, dp CCx, dp CGC, dp CDC, dp GDDCGC, dp GDDCDC, dp SumGDD, modeCycle TypeDays, int8_t SFRedCGC, int8_t SFRedCCx)
+{
+    if (TypeDays != modeCycle::GDDays) {
+        const rep_CCCurve* Curve = CalendarCurve(L0, L123, LMaturity, CCo, CCx, CGC, CDC, SFRedCGC, SFRedCCx);
+        if (Curve != nullptr) {
+            int32_t t = DAP - Simulation.DelayedDays;
+            return (t >= 1 && t <= LMaturity) ? Curve->CC[t] : 0.0;
+        }
+    }
+    return CanopyCoverNoStressSF(DAP, L0, L123, LMaturity, GDDL0, GDDL123, GDDLMaturity, CCo, CCx, CGC, CDC, GDDCGC, GDDCDC, SumGDD, TypeDays, SFRedCGC, SFRedCCx);
+}
+
+} // namespace AquaCrop
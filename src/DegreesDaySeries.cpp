@@ -0,0 +1,197 @@
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AQUACROP_X86_SIMD 1
+#endif
+
+namespace AquaCrop {
+
+namespace {
+
+// Per-day GDD, written as selects in the order of the comparisons in
+// DegreesDay so that every variant returns the same bits (also for NaN
+// temperatures and Tbase > Tupper). The vector variants rely on
+// min(a, b) = (a < b) ? a : b and max(a, b) = (a > b) ? a : b.
+inline dp DegreesDayMethod1(dp Tbase, dp Tupper, dp TDayMin, dp TDayMax) {
+    dp Tavg = (TDayMax + TDayMin) / 2.0;
+    Tavg = (Tavg > Tupper) ? Tupper : Tavg;
+    Tavg = (Tavg < Tbase) ? Tbase : Tavg;
+    return Tavg - Tbase;
+}
+
+inline dp DegreesDayMethod2(dp Tbase, dp Tupper, dp TDayMin, dp TDayMax) {
+    dp TstarMax = (TDayMax < Tbase) ? Tbase : TDayMax;
+    TstarMax = (TDayMax > Tupper) ? Tupper : TstarMax;
+    dp TstarMin = (TDayMin < Tbase) ? Tbase : TDayMin;
+    TstarMin = (TDayMin > Tupper) ? Tupper : TstarMin;
+    return (TstarMax + TstarMin) / 2.0 - Tbase;
+}
+
+inline dp DegreesDayMethod3(dp Tbase, dp Tupper, dp TDayMin, dp TDayMax) {
+    dp TstarMax = (TDayMax < Tbase) ? Tbase : TDayMax;
+    TstarMax = (TDayMax > Tupper) ? Tupper : TstarMax;
+    dp TstarMin = (TDayMin > Tupper) ? Tupper : TDayMin;
+    dp Tavg = (TstarMax + TstarMin) / 2.0;
+    Tavg = (Tavg < Tbase) ? Tbase : Tavg;
+    return Tavg - Tbase;
+}
+
+void DegreesDaySeriesScalar(dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                            int32_t From, int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD) {
+    switch (GDDSelectedMethod) {
+    case 1:
+        for (int32_t i = From; i < NrDays; ++i) GDD[i] = DegreesDayMethod1(Tbase, Tupper, TDayMin[i], TDayMax[i]);
+        break;
+    case 2:
+        for (int32_t i = From; i < NrDays; ++i) GDD[i] = DegreesDayMethod2(Tbase, Tupper, TDayMin[i], TDayMax[i]);
+        break;
+    default: // Method 3
+        for (int32_t i = From; i < NrDays; ++i) GDD[i] = DegreesDayMethod3(Tbase, Tupper, TDayMin[i], TDayMax[i]);
+        break;
+    }
+}
+
+#ifdef AQUACROP_X86_SIMD
+
+// Each variant handles the full vectors and returns the first day left for
+// the scalar loop.
+
+__attribute__((target("sse2")))
+int32_t DegreesDaySeriesSSE2(dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                             int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD) {
+    const __m128d Base = _mm_set1_pd(Tbase);
+    const __m128d Upper = _mm_set1_pd(Tupper);
+    const __m128d Two = _mm_set1_pd(2.0);
+    int32_t i = 0;
+    for (; i + 2 <= NrDays; i += 2) {
+        __m128d Tmin = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(TDayMin + i))));
+        __m128d Tmax = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(TDayMax + i))));
+        __m128d Tavg;
+        if (GDDSelectedMethod == 1) {
+            Tavg = _mm_div_pd(_mm_add_pd(Tmax, Tmin), Two);
+            Tavg = _mm_max_pd(Base, _mm_min_pd(Upper, Tavg));
+        } else {
+            __m128d Above = _mm_cmpgt_pd(Tmax, Upper);
+            __m128d TstarMax = _mm_or_pd(_mm_and_pd(Above, Upper), _mm_andnot_pd(Above, _mm_max_pd(Base, Tmax)));
+            __m128d TstarMin;
+            if (GDDSelectedMethod == 2) {
+                Above = _mm_cmpgt_pd(Tmin, Upper);
+                TstarMin = _mm_or_pd(_mm_and_pd(Above, Upper), _mm_andnot_pd(Above, _mm_max_pd(Base, Tmin)));
+            } else {
+                TstarMin = _mm_min_pd(Upper, Tmin);
+            }
+            Tavg = _mm_div_pd(_mm_add_pd(TstarMax, TstarMin), Two);
+            if (GDDSelectedMethod != 2) Tavg = _mm_max_pd(Base, Tavg);
+        }
+        _mm_storeu_pd(GDD + i, _mm_sub_pd(Tavg, Base));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+int32_t DegreesDaySeriesAVX2(dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                             int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD) {
+    const __m256d Base = _mm256_set1_pd(Tbase);
+    const __m256d Upper = _mm256_set1_pd(Tupper);
+    const __m256d Two = _mm256_set1_pd(2.0);
+    int32_t i = 0;
+    for (; i + 4 <= NrDays; i += 4) {
+        __m256d Tmin = _mm256_cvtps_pd(_mm_loadu_ps(TDayMin + i));
+        __m256d Tmax = _mm256_cvtps_pd(_mm_loadu_ps(TDayMax + i));
+        __m256d Tavg;
+        if (GDDSelectedMethod == 1) {
+            Tavg = _mm256_div_pd(_mm256_add_pd(Tmax, Tmin), Two);
+            Tavg = _mm256_max_pd(Base, _mm256_min_pd(Upper, Tavg));
+        } else {
+            __m256d TstarMax = _mm256_blendv_pd(_mm256_max_pd(Base, Tmax), Upper, _mm256_cmp_pd(Tmax, Upper, _CMP_GT_OQ));
+            __m256d TstarMin;
+            if (GDDSelectedMethod == 2) {
+                TstarMin = _mm256_blendv_pd(_mm256_max_pd(Base, Tmin), Upper, _mm256_cmp_pd(Tmin, Upper, _CMP_GT_OQ));
+            } else {
+                TstarMin = _mm256_min_pd(Upper, Tmin);
+            }
+            Tavg = _mm256_div_pd(_mm256_add_pd(TstarMax, TstarMin), Two);
+            if (GDDSelectedMethod != 2) Tavg = _mm256_max_pd(Base, Tavg);
+        }
+        _mm256_storeu_pd(GDD + i, _mm256_sub_pd(Tavg, Base));
+    }
+    return i;
+}
+
+// GCC 12 warns about the _mm512_undefined_pd() pass-through operand of the
+// unmasked _mm512_cvtps_pd/min/max intrinsics in its own header (a false
+// positive: the mask is all ones, so that operand is never read)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+__attribute__((target("avx512f")))
+int32_t DegreesDaySeriesAVX512(dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                               int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD) {
+    const __m512d Base = _mm512_set1_pd(Tbase);
+    const __m512d Upper = _mm512_set1_pd(Tupper);
+    const __m512d Two = _mm512_set1_pd(2.0);
+    int32_t i = 0;
+    for (; i + 8 <= NrDays; i += 8) {
+        __m512d Tmin = _mm512_cvtps_pd(_mm256_loadu_ps(TDayMin + i));
+        __m512d Tmax = _mm512_cvtps_pd(_mm256_loadu_ps(TDayMax + i));
+        __m512d Tavg;
+        if (GDDSelectedMethod == 1) {
+            Tavg = _mm512_div_pd(_mm512_add_pd(Tmax, Tmin), Two);
+            Tavg = _mm512_max_pd(Base, _mm512_min_pd(Upper, Tavg));
+        } else {
+            __m512d TstarMax = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(Tmax, Upper, _CMP_GT_OQ), _mm512_max_pd(Base, Tmax), Upper);
+            __m512d TstarMin;
+            if (GDDSelectedMethod == 2) {
+                TstarMin = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(Tmin, Upper, _CMP_GT_OQ), _mm512_max_pd(Base, Tmin), Upper);
+            } else {
+                TstarMin = _mm512_min_pd(Upper, Tmin);
+            }
+            Tavg = _mm512_div_pd(_mm512_add_pd(TstarMax, TstarMin), Two);
+            if (GDDSelectedMethod != 2) Tavg = _mm512_max_pd(Base, Tavg);
+        }
+        _mm512_storeu_pd(GDD + i, _mm512_sub_pd(Tavg, Base));
+    }
+    return i;
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // AQUACROP_X86_SIMD
+
+} // namespace
+
+void DegreesDaySeriesAt(SimdLevel Level, dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                        int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD) {
+    if (NrDays <= 0) return;
+    int32_t Done = 0;
+#ifdef AQUACROP_X86_SIMD
+    if (!SimdLevelAvailable(Level)) Level = SimdLevel::Scalar;
+    switch (Level) {
+    case SimdLevel::AVX512:
+        Done = DegreesDaySeriesAVX512(Tbase, Tupper, TDayMin, TDayMax, NrDays, GDDSelectedMethod, GDD);
+        break;
+    case SimdLevel::AVX2:
+        Done = DegreesDaySeriesAVX2(Tbase, Tupper, TDayMin, TDayMax, NrDays, GDDSelectedMethod, GDD);
+        break;
+    case SimdLevel::SSE2:
+        Done = DegreesDaySeriesSSE2(Tbase, Tupper, TDayMin, TDayMax, NrDays, GDDSelectedMethod, GDD);
+        break;
+    default:
+        break;
+    }
+#else
+    (void)Level;
+#endif
+    DegreesDaySeriesScalar(Tbase, Tupper, TDayMin, TDayMax, Done, NrDays, GDDSelectedMethod, GDD);
+}
+
+void DegreesDaySeries(dp Tbase, dp Tupper, const sp* TDayMin, const sp* TDayMax,
+                      int32_t NrDays, int8_t GDDSelectedMethod, dp* GDD) {
+    DegreesDaySeriesAt(ActiveSimdLevel(), Tbase, Tupper, TDayMin, TDayMax, NrDays, GDDSelectedMethod, GDD);
+}
+
+} // namespace AquaCrop
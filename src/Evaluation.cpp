@@ -0,0 +1,140 @@
+#include "AquaCrop/Evaluation.h"
+#include "AquaCrop/EventTimeline.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Utils.h"
+
+#include <cmath>
+
+namespace AquaCrop {
+
+namespace {
+
+// Missing observations are negative (-9 in the file)
+bool Observed(dp Value) {
+    return Value >= 0.0;
+}
+
+dp ObservedValue(const rep_ObsEvent& Obs, int32_t Kind) {
+    switch (static_cast<typeObsSim>(Kind)) {
+    case typeObsSim::ObsSimCC: return Obs.CCmean;
+    case typeObsSim::ObsSimB: return Obs.Bmean;
+    default: return Obs.SWCmean;
+    }
+}
+
+} // namespace
+
+void rep_FitAccumulator::Reset(dp ObsMeanIN) {
+    ObsMean = ObsMeanIN;
+    N = 0;
+    SumDiff = 0.0;
+    SumDiff2 = 0.0;
+    SumObsDev2 = 0.0;
+    SumPotErr2 = 0.0;
+}
+
+void rep_FitAccumulator::Add(dp Obs, dp Sim) {
+    dp Diff = Sim - Obs;
+    dp PotErr = std::abs(Sim - ObsMean) + std::abs(Obs - ObsMean);
+
+    ++N;
+    SumDiff += Diff;
+    SumDiff2 += Diff * Diff;
+    SumObsDev2 += (Obs - ObsMean) * (Obs - ObsMean);
+    SumPotErr2 += PotErr * PotErr;
+}
+
+rep_FitStats rep_FitAccumulator::Stats() const {
+    rep_FitStats S = {N, undef_double, undef_double, undef_double, undef_double, undef_double};
+
+    if (N == 0) return S;
+    S.RMSE = std::sqrt(SumDiff2 / N);
+    S.Bias = SumDiff / N;
+    if (ObsMean > 0.0) S.NRMSE = 100.0 * S.RMSE / ObsMean;
+    if (SumPotErr2 > 0.0) S.d = 1.0 - SumDiff2 / SumPotErr2;
+    if (SumObsDev2 > 0.0) S.EF = 1.0 - SumDiff2 / SumObsDev2;
+    return S;
+}
+
+void BeginRunEvaluation(int32_t FromDayNr, int32_t ToDayNr) {
+    const std::vector<rep_ObsEvent>& Observations = EventTimeline.Observations;
+    std::array<dp, NrObsSim> Sum = {0.0, 0.0, 0.0};
+    std::array<int32_t, NrObsSim> Count = {0, 0, 0};
+
+    RunEvaluation.FromDayNr = FromDayNr;
+    RunEvaluation.ObsOfDay.assign(Observations.empty() ? 0 : ToDayNr - FromDayNr + 1, -1);
+    for (size_t i = 0; i < Observations.size(); ++i) {
+        int32_t Day = Observations[i].DayNr - FromDayNr;
+        if (Day < 0 || Day > ToDayNr - FromDayNr) continue;
+        RunEvaluation.ObsOfDay[Day] = static_cast<int32_t>(i);
+    }
+    for (int32_t Index : RunEvaluation.ObsOfDay) {
+        if (Index < 0) continue;
+        for (int32_t Kind = 0; Kind < NrObsSim; ++Kind) {
+            dp Value = ObservedValue(Observations[Index], Kind);
+            if (!Observed(Value)) continue;
+            Sum[Kind] += Value;
+            ++Count[Kind];
+        }
+    }
+    for (int32_t Kind = 0; Kind < NrObsSim; ++Kind) {
+        RunEvaluation.Fit[Kind].Reset((Count[Kind] > 0) ? Sum[Kind] / Count[Kind] : 0.0);
+    }
+}
+
+void EvaluateDay(int32_t DayNr) {
+    int32_t Day = DayNr - RunEvaluation.FromDayNr;
+
+    if (Day < 0 || Day >= static_cast<int32_t>(RunEvaluation.ObsOfDay.size())) return;
+    int32_t Index = RunEvaluation.ObsOfDay[Day];
+    if (Index < 0) return;
+
+    const rep_ObsEvent& Obs = EventTimeline.Observations[Index];
+    if (Observed(Obs.CCmean)) {
+        RunEvaluation.Fit[static_cast<int32_t>(typeObsSim::ObsSimCC)].Add(Obs.CCmean, 100.0 * CCiActual);
+    }
+    if (Observed(Obs.Bmean)) {
+        RunEvaluation.Fit[static_cast<int32_t>(typeObsSim::ObsSimB)].Add(Obs.Bmean, SumWaBal.Biomass);
+    }
+    if (Observed(Obs.SWCmean)) {
+        RunEvaluation.Fit[static_cast<int32_t>(typeObsSim::ObsSimSWC)].Add(Obs.SWCmean, SWCZsoil(Obs.Zeval));
+    }
+}
+
+void EndRunEvaluation(rep_RunResult& Result) {
+    for (int32_t Kind = 0; Kind < NrObsSim; ++Kind) {
+        Result.Fit[Kind] = RunEvaluation.Fit[Kind].Stats();
+    }
+}
+
+dp SWCZsoil(dp Zsoil) {
+    dp CumDepth = 0.0, SWCact = 0.0, Factor;
+    int32_t compi = 0;
+
+    if (NrCompartments == 0) return 0.0;
+    do {
+        ++compi;
+        const CompartmentIndividual& Comp = Compartment[compi-1];
+        CumDepth += Comp.Thickness;
+        if (CumDepth <= Zsoil) {
+            Factor = 1.0;
+        } else {
+            dp Frac_value = Zsoil - (CumDepth - Comp.Thickness);
+            Factor = (Frac_value > 0.0) ? Frac_value / Comp.Thickness : 0.0;
+        }
+        SWCact += Factor * 10.0 * (Comp.theta * 100.0) * Comp.Thickness
+                  * (1.0 - soillayer[Comp.Layer-1].GravelVol / 100.0);
+    } while (roundc(100.0 * CumDepth, 1) < roundc(100.0 * Zsoil, 1) && compi < NrCompartments);
+    return SWCact;
+}
+
+const char* ObsSimName(typeObsSim Kind) {
+    switch (Kind) {
+    case typeObsSim::ObsSimCC: return "CC";
+    case typeObsSim::ObsSimB: return "biomass";
+    case typeObsSim::ObsSimSWC: return "SWC";
+    default: return "unknown";
+    }
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,241 @@
+#include "AquaCrop/EventTimeline.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Utils.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace AquaCrop {
+
+namespace {
+
+// Numeric rows of the table that follows the "====" line of an input file
+std::vector<std::vector<dp>> ReadTableRows(std::ifstream& fhandle, size_t NrColumns) {
+    std::vector<std::vector<dp>> Rows;
+    std::string line;
+    bool InTable = false;
+    while (std::getline(fhandle, line)) {
+        if (!InTable) {
+            size_t first = line.find_first_not_of(" \t");
+            InTable = (first != std::string::npos) && (line[first] == '=');
+            continue;
+        }
+        std::istringstream ss(line);
+        std::vector<dp> Row;
+        dp Value;
+        while (ss >> Value) Row.push_back(Value);
+        if (Row.size() >= NrColumns) Rows.push_back(std::move(Row));
+    }
+    return Rows;
+}
+
+// First number on the next line (settings written as "value : description")
+dp ReadLineValue(std::ifstream& fhandle) {
+    std::string line;
+    std::getline(fhandle, line);
+    std::istringstream ss(line);
+    dp Value = 0.0;
+    ss >> Value;
+    return Value;
+}
+
+// Day number of the first table day; tables not linked to a specific year
+// (1901) are moved to the year in which the run starts
+int32_t TableDayNr1(int32_t Dayi, int32_t Monthi, int32_t Yeari, int32_t FromDayNr) {
+    int32_t DayNr1;
+    if (Yeari == 1901) {
+        int32_t D, M, Y;
+        DetermineDate(FromDayNr, D, M, Y);
+        Yeari = Y;
+    }
+    DetermineDayNr(Dayi, Monthi, Yeari, DayNr1);
+    return DayNr1;
+}
+
+void AddEvent(int32_t DayNr, EventKind Kind, int32_t Index, int32_t FromDayNr, int32_t ToDayNr) {
+    if (DayNr < FromDayNr || DayNr > ToDayNr) return;
+    EventTimeline.Events.push_back({DayNr, Kind, Index});
+}
+
+void AddIrrigation(int32_t DayNr, EventKind Kind, dp Depth, dp ECw, int32_t FromDayNr, int32_t ToDayNr) {
+    if (Depth <= 0.0 || DayNr < FromDayNr || DayNr > ToDayNr) return;
+    EventTimeline.Irrigations.push_back({Depth, ECw});
+    AddEvent(DayNr, Kind, static_cast<int32_t>(EventTimeline.Irrigations.size()) - 1, FromDayNr, ToDayNr);
+}
+
+void ReadManualIrrigation(int32_t FromDayNr, int32_t ToDayNr) {
+    if (IrriFile == "(None)" || IrriMode_Val != IrriMode::Manual) return;
+    std::ifstream fhandle(IrriFileFull);
+    if (!fhandle.is_open()) return;
+
+    // Day numbers count from IrriFirstDayNr, or from the first day of the crop
+    int32_t DayNr1 = (IrriFirstDayNr != undef_int) ? IrriFirstDayNr : crop.Day1;
+    for (const std::vector<dp>& Row : ReadTableRows(fhandle, 2)) {
+        int32_t DayNr = DayNr1 + static_cast<int32_t>(roundc(Row[0], 1)) - 1;
+        dp ECw = (Row.size() > 2) ? Row[2] : Simulation.IrriECw;
+        AddIrrigation(DayNr, EventKind::Irrigation, Row[1], ECw, FromDayNr, ToDayNr);
+    }
+}
+
+void AddOffSeasonIrrigation(int32_t FromDayNr, int32_t ToDayNr) {
+    for (const rep_DayEventInt& Event : IrriBeforeSeason) {
+        int32_t DayNr = FromDayNr + Event.DayNr - 1;
+        if (Event.DayNr > 0 && DayNr < crop.Day1) {
+            AddIrrigation(DayNr, EventKind::IrrigationOutSeason, static_cast<dp>(Event.param), IrriECw.PreSeason, FromDayNr, ToDayNr);
+        }
+    }
+    for (const rep_DayEventInt& Event : IrriAfterSeason) {
+        if (Event.DayNr > 0) {
+            AddIrrigation(crop.DayN + Event.DayNr, EventKind::IrrigationOutSeason, static_cast<dp>(Event.param), IrriECw.PostSeason, FromDayNr, ToDayNr);
+        }
+    }
+}
+
+// A row takes effect on day FromDay of the cycle; rows that start before the
+// run are moved to its first day, where only the last of them applies
+void AddGenerationRules(int32_t FromDayNr, int32_t ToDayNr) {
+    if (IrriMode_Val != IrriMode::Generate) return;
+    const int32_t NrRules = static_cast<int32_t>(IrriGenerateRules.size());
+    for (int32_t Rulei = 1; Rulei <= NrRules; ++Rulei) {
+        int32_t DayNr = std::max(crop.Day1 + IrriGenerateRules[Rulei-1].FromDay - 1, FromDayNr);
+        if (Rulei < NrRules && crop.Day1 + IrriGenerateRules[Rulei].FromDay - 1 <= DayNr) continue;
+        AddEvent(DayNr, EventKind::IrrigationRule, Rulei - 1, FromDayNr, ToDayNr);
+    }
+}
+
+void ReadCuttings(int32_t FromDayNr, int32_t ToDayNr) {
+    if (!Cuttings.Considered || Cuttings.Generate || ManFile == "(None)") return;
+    std::ifstream fhandle(ManFilefull);
+    if (!fhandle.is_open()) return;
+
+    // Day numbers count from the first day of the cutting period
+    int32_t DayNr1 = (Cuttings.FirstDayNr != undef_int) ? Cuttings.FirstDayNr : crop.Day1 + Cuttings.Day1 - 1;
+    int32_t NrCut = 0;
+    for (const std::vector<dp>& Row : ReadTableRows(fhandle, 1)) {
+        int32_t DayNr = DayNr1 + static_cast<int32_t>(roundc(Row[0], 1)) - 1;
+        AddEvent(DayNr, EventKind::Cutting, NrCut++, FromDayNr, ToDayNr);
+    }
+}
+
+void ReadGroundwater(int32_t FromDayNr, int32_t ToDayNr) {
+    if (GroundWaterFile == "(None)" || simulparam.ConstGwt) return;
+    std::ifstream fhandle(GroundWaterFilefull);
+    if (!fhandle.is_open()) return;
+
+    std::string line;
+    std::getline(fhandle, line); // Description
+    std::getline(fhandle, line); // Version
+    int32_t Mode = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    if (Mode != 2) return;       // variable groundwater table only
+    int32_t Dayi = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    int32_t Monthi = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    int32_t Yeari = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    int32_t DayNr1 = TableDayNr1(Dayi, Monthi, Yeari, FromDayNr);
+
+    for (const std::vector<dp>& Row : ReadTableRows(fhandle, 3)) {
+        int32_t DayNr = DayNr1 + static_cast<int32_t>(roundc(Row[0], 1)) - 1;
+        EventTimeline.GwtPoints.push_back({DayNr, static_cast<int32_t>(roundc(100.0 * Row[1], 1)), Row[2]});
+    }
+    std::stable_sort(EventTimeline.GwtPoints.begin(), EventTimeline.GwtPoints.end(),
+                     [](const rep_GwtPoint& a, const rep_GwtPoint& b) { return a.DayNr < b.DayNr; });
+    for (size_t i = 0; i < EventTimeline.GwtPoints.size(); ++i) {
+        AddEvent(EventTimeline.GwtPoints[i].DayNr, EventKind::Groundwater, static_cast<int32_t>(i), FromDayNr, ToDayNr);
+    }
+}
+
+void ReadObservations(int32_t FromDayNr, int32_t ToDayNr) {
+    if (ObservationsFile == "(None)") return;
+    std::ifstream fhandle(ObservationsFilefull);
+    if (!fhandle.is_open()) return;
+
+    std::string line;
+    std::getline(fhandle, line); // Description
+    ReadLineValue(fhandle);      // Version
+    dp Zeval = ReadLineValue(fhandle);
+    int32_t Dayi = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    int32_t Monthi = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    int32_t Yeari = static_cast<int32_t>(roundc(ReadLineValue(fhandle), 1));
+    int32_t DayNr1 = TableDayNr1(Dayi, Monthi, Yeari, FromDayNr);
+
+    for (const std::vector<dp>& Row : ReadTableRows(fhandle, 7)) {
+        int32_t DayNr = DayNr1 + static_cast<int32_t>(roundc(Row[0], 1)) - 1;
+        EventTimeline.Observations.push_back({DayNr, Row[1], Row[2], Row[3], Row[4], Row[5], Row[6], Zeval});
+        AddEvent(DayNr, EventKind::Observation, static_cast<int32_t>(EventTimeline.Observations.size()) - 1, FromDayNr, ToDayNr);
+    }
+}
+
+} // namespace
+
+void rep_EventTimeline::Clear() {
+    Events.clear();
+    Irrigations.clear();
+    GwtPoints.clear();
+    Observations.clear();
+    Cursor = 0;
+    DayEnd = 0;
+}
+
+void rep_EventTimeline::AdvanceTo(int32_t DayNr) {
+    Cursor = DayEnd;
+    if (Cursor >= Events.size() || Events[Cursor].DayNr > DayNr) return;
+    while (Cursor < Events.size() && Events[Cursor].DayNr < DayNr) ++Cursor;
+    DayEnd = Cursor;
+    while (DayEnd < Events.size() && Events[DayEnd].DayNr == DayNr) ++DayEnd;
+}
+
+const rep_DayEvent* rep_EventTimeline::Today(EventKind Kind) const {
+    for (size_t i = Cursor; i < DayEnd; ++i) {
+        if (Events[i].Kind == Kind) return &Events[i];
+    }
+    return nullptr;
+}
+
+void BuildEventTimeline(int32_t FromDayNr, int32_t ToDayNr) {
+    EventTimeline.Clear();
+    ReadManualIrrigation(FromDayNr, ToDayNr);
+    AddOffSeasonIrrigation(FromDayNr, ToDayNr);
+    AddGenerationRules(FromDayNr, ToDayNr);
+    ReadCuttings(FromDayNr, ToDayNr);
+    ReadGroundwater(FromDayNr, ToDayNr);
+    ReadObservations(FromDayNr, ToDayNr);
+
+    std::stable_sort(EventTimeline.Events.begin(), EventTimeline.Events.end(),
+                     [](const rep_DayEvent& a, const rep_DayEvent& b) {
+                         if (a.DayNr != b.DayNr) return a.DayNr < b.DayNr;
+                         return a.Kind < b.Kind;
+                     });
+}
+
+bool GetGwtSegment(int32_t DayNr, int32_t& DNr1, int32_t& DNr2, int32_t& Z1, int32_t& Z2, dp& EC1, dp& EC2) {
+    const std::vector<rep_GwtPoint>& Points = EventTimeline.GwtPoints;
+    if (Points.empty()) return false;
+
+    // first point after DayNr
+    auto it = std::upper_bound(Points.begin(), Points.end(), DayNr,
+                               [](int32_t Day, const rep_GwtPoint& P) { return Day < P.DayNr; });
+    if (it == Points.begin()) {
+        // before the table: constant at the first point
+        DNr1 = DayNr;
+        DNr2 = it->DayNr;
+        Z1 = Z2 = it->Zcm;
+        EC1 = EC2 = it->ECdSm;
+    } else if (it == Points.end()) {
+        // after the table: constant at the last point
+        const rep_GwtPoint& Last = Points.back();
+        DNr1 = DNr2 = Last.DayNr;
+        Z1 = Z2 = Last.Zcm;
+        EC1 = EC2 = Last.ECdSm;
+    } else {
+        const rep_GwtPoint& P1 = *(it - 1);
+        DNr1 = P1.DayNr;
+        DNr2 = it->DayNr;
+        Z1 = P1.Zcm;
+        Z2 = it->Zcm;
+        EC1 = P1.ECdSm;
+        EC2 = it->ECdSm;
+    }
+    return true;
+}
+
+} // namespace AquaCrop
@@ -1,5 +1,11 @@
 #include "AquaCrop/Global.h"
 #include "AquaCrop/Utils.h"
+#include "AquaCrop/CO2Series.h"
+#include "AquaCrop/CropCalendar.h"
+#include "AquaCrop/Evaluation.h"
+#include "AquaCrop/EventTimeline.h"
+#include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/SoilState.h"
 #include <iostream>
 #include <string>
 #include <algorithm>
@@ -17,96 +23,96 @@ bool FileExists(const std::string& full_name)
 }
 
 // Global variables (Definitions)
-std::string RainFile;
-std::string RainFileFull;
-std::string RainDescription;
-std::string EToFile;
-std::string EToFileFull;
-std::string EToDescription;
-std::string CalendarFile;
-std::string CalendarFileFull;
-std::string CalendarDescription;
-std::string CO2File;
-std::string CO2FileFull;
-std::string CO2Description;
-std::string IrriFile;
-std::string IrriFileFull;
-std::string CropFile;
-std::string CropFileFull;
-std::string CropDescription;
-std::string PathNameProg;
-std::string PathNameOutp;
-std::string PathNameSimul;
-std::string ProfFile;
-std::string ProfFilefull;
-std::string ProfDescription;
-std::string ManFile;
-std::string ManFilefull;
-std::string ObservationsFile;
-std::string ObservationsFilefull;
-std::string ObservationsDescription;
-std::string OffSeasonFile;
-std::string OffSeasonFilefull;
-std::string OutputName;
-std::string GroundWaterFile;
-std::string GroundWaterFilefull;
-std::string ClimateFile;
-std::string ClimateFileFull;
-std::string ClimateDescription;
-std::string IrriDescription;
-std::string ClimFile;
-std::string SWCiniFile;
-std::string SWCiniFileFull;
-std::string SWCiniDescription;
-std::string ProjectDescription;
-std::string ProjectFile;
-std::string ProjectFileFull;
-std::string MultipleProjectDescription;
-std::string MultipleProjectFile;
-std::string TemperatureFile;
-std::string TemperatureFileFull;
-std::string TemperatureDescription;
-std::string MultipleProjectFileFull;
-std::string FullFileNameProgramParameters;
-std::string ManDescription;
-std::string ClimDescription;
-std::string OffSeasonDescription;
-std::string GroundwaterDescription;
-std::string TnxReferenceFile;
-std::string TnxReferenceFileFull;
-std::string TnxReference365DaysFile;
-std::string TnxReference365DaysFileFull;
-
-rep_IrriECw IrriECw;
-rep_Manag Management;
-rep_PerennialPeriod perennialperiod;
-rep_param simulparam;
-rep_Cuttings Cuttings;
-rep_Onset onset;
-rep_EndSeason endseason;
-rep_Crop crop;
-rep_Content TotalSaltContent;
-rep_Content TotalWaterContent;
-rep_EffectiveRain effectiverain;
-rep_soil Soil;
-rep_RootZoneWC RootZoneWC;
-rep_CropFileSet CropFileSet;
-rep_sum SumWaBal;
-rep_RootZoneSalt RootZoneSalt;
-rep_clim TemperatureRecord, ClimRecord, RainRecord, EToRecord;
-rep_sim Simulation;
-
-GenerateTimeMode GenerateTimeMode_Val;
-GenerateDepthMode GenerateDepthMode_Val;
-IrriMode IrriMode_Val;
-IrriMethod IrriMethod_Val;
-
-int32_t TnxReferenceYear;
-int32_t DaySubmerged;
-int32_t MaxPlotNew;
-int32_t NrCompartments;
-int32_t IrriFirstDayNr;
-dp ZiAqua = 0.0;
+thread_local std::string RainFile;
+thread_local std::string RainFileFull;
+thread_local std::string RainDescription;
+thread_local std::string EToFile;
+thread_local std::string EToFileFull;
+thread_local std::string EToDescription;
+thread_local std::string CalendarFile;
+thread_local std::string CalendarFileFull;
+thread_local std::string CalendarDescription;
+thread_local std::string CO2File;
+thread_local std::string CO2FileFull;
+thread_local std::string CO2Description;
+thread_local std::string IrriFile;
+thread_local std::string IrriFileFull;
+thread_local std::string CropFile;
+thread_local std::string CropFileFull;
+thread_local std::string CropDescription;
+thread_local std::string PathNameProg;
+thread_local std::string PathNameOutp;
+thread_local std::string PathNameSimul;
+thread_local std::string ProfFile;
+thread_local std::string ProfFilefull;
+thread_local std::string ProfDescription;
+thread_local std::string ManFile;
+thread_local std::string ManFilefull;
+thread_local std::string ObservationsFile;
+thread_local std::string ObservationsFilefull;
+thread_local std::string ObservationsDescription;
+thread_local std::string OffSeasonFile;
+thread_local std::string OffSeasonFilefull;
+thread_local std::string OutputName;
+thread_local std::string GroundWaterFile;
+thread_local std::string GroundWaterFilefull;
+thread_local std::string ClimateFile;
+thread_local std::string ClimateFileFull;
+thread_local std::string ClimateDescription;
+thread_local std::string IrriDescription;
+thread_local std::string ClimFile;
+thread_local std::string SWCiniFile;
+thread_local std::string SWCiniFileFull;
+thread_local std::string SWCiniDescription;
+thread_local std::string ProjectDescription;
+thread_local std::string ProjectFile;
+thread_local std::string ProjectFileFull;
+thread_local std::string MultipleProjectDescription;
+thread_local std::string MultipleProjectFile;
+thread_local std::string TemperatureFile;
+thread_local std::string TemperatureFileFull;
+thread_local std::string TemperatureDescription;
+thread_local std::string MultipleProjectFileFull;
+thread_local std::string FullFileNameProgramParameters;
+thread_local std::string ManDescription;
+thread_local std::string ClimDescription;
+thread_local std::string OffSeasonDescription;
+thread_local std::string GroundwaterDescription;
+thread_local std::string TnxReferenceFile;
+thread_local std::string TnxReferenceFileFull;
+thread_local std::string TnxReference365DaysFile;
+thread_local std::string TnxReference365DaysFileFull;
+
+thread_local rep_IrriECw IrriECw;
+thread_local rep_Manag Management;
+thread_local rep_PerennialPeriod perennialperiod;
+thread_local rep_param simulparam;
+thread_local rep_Cuttings Cuttings;
+thread_local rep_Onset onset;
+thread_local rep_EndSeason endseason;
+thread_local rep_Crop crop;
+thread_local rep_Content TotalSaltContent;
+thread_local rep_Content TotalWaterContent;
+thread_local rep_EffectiveRain effectiverain;
+thread_local rep_soil Soil;
+thread_local rep_RootZoneWC RootZoneWC;
+thread_local rep_CropFileSet CropFileSet;
+thread_local rep_sum SumWaBal;
+thread_local rep_RootZoneSalt RootZoneSalt;
+thread_local rep_clim TemperatureRecord, ClimRecord, RainRecord, EToRecord;
+thread_local rep_sim Simulation;
+
+thread_local GenerateTimeMode GenerateTimeMode_Val;
+thread_local GenerateDepthMode GenerateDepthMode_Val;
+thread_local IrriMode IrriMode_Val;
+thread_local IrriMethod IrriMethod_Val;
+
+thread_local int32_t TnxReferenceYear;
+thread_local int32_t DaySubmerged;
+thread_local int32_t MaxPlotNew;
+thread_local int32_t NrCompartments;
+thread_local int32_t IrriFirstDayNr;
+thread_local dp ZiAqua = 0.0;
 
 // Placeholder implementations for missing declarations in Global.h
 dp GetManagement_BundHeight() { return Management.BundHeight; }
@@ -120,72 +126,101 @@ void SetDaySubmerged(int32_t val) { DaySubmerged = val; }
 dp GetSimulParam_DelayLowOxygen() { return (dp)simulparam.DelayLowOxygen; }
 dp GetRootingDepth() { return RootingDepth; }
 
-int8_t IniPercTAW;
-int8_t MaxPlotTr;
-int8_t OutputAggregate;
-
-int fTnxReference;
-int fTnxReference_iostat;
-int fTnxReference365Days;
-int fTnxReference365Days_iostat;
-
-dp CCiActual;
-dp CCiprev;
-dp CCiTopEarlySen;
-dp CRsalt;
-dp CRwater;
-dp ECdrain = 0.0;
-dp ECiAqua;
-dp ECstorage;
-dp Eact;
-dp Epot;
-dp ETo;
-dp Drain;
-dp Infiltrated;
-dp Irrigation;
-dp Rain;
-dp RootingDepth;
-dp Runoff;
-dp SaltInfiltr;
-dp Surf0 = 0.0;
-dp SurfaceStorage;
-dp Tact;
-dp Tpot;
-dp TactWeedInfested;
-dp Tmax;
-dp Tmin;
-dp TmaxCropReference;
-dp TminCropReference;
-dp TmaxTnxReference365Days;
-dp TminTnxReference365Days;
-
-std::vector<sp> TmaxRun(366);
-std::vector<sp> TminRun(366);
-std::vector<sp> TmaxTnxReference12MonthsRun(12);
-std::vector<sp> TminTnxReference12MonthsRun(12);
-std::vector<sp> TmaxCropReferenceRun(365);
-std::vector<sp> TminCropReferenceRun(365);
-std::vector<sp> TmaxTnxReference365DaysRun(365);
-std::vector<sp> TminTnxReference365DaysRun(365);
-
-bool EvapoEntireSoilSurface;
-bool PreDay, OutDaily, Out8Irri;
-bool Out1Wabal;
-bool Out2Crop;
-bool Out3Prof;
-bool Out4Salt;
-bool Out5CompWC;
-bool Out6CompEC;
-bool Out7Clim;
-bool Part1Mult, Part2Eval;
-
-std::string PathNameList, PathNameParam;
-
-std::vector<CompartmentIndividual> Compartment(max_No_compartments);
-std::vector<SoilLayerIndividual> soillayer(max_SoilLayers);
-
-std::vector<rep_DayEventInt> IrriBeforeSeason(5);
-std::vector<rep_DayEventInt> IrriAfterSeason(5);
+thread_local int8_t IniPercTAW;
+thread_local int8_t MaxPlotTr;
+thread_local int8_t OutputAggregate;
+
+thread_local int fTnxReference;
+thread_local int fTnxReference_iostat;
+thread_local int fTnxReference365Days;
+thread_local int fTnxReference365Days_iostat;
+
+thread_local dp CCiActual;
+thread_local dp CCiprev;
+thread_local dp CCiTopEarlySen;
+thread_local dp CRsalt;
+thread_local dp CRwater;
+thread_local dp ECdrain = 0.0;
+thread_local dp ECiAqua;
+thread_local dp ECstorage;
+thread_local dp Eact;
+thread_local dp Epot;
+thread_local dp ETo;
+thread_local dp Drain;
+thread_local dp Infiltrated;
+thread_local dp Irrigation;
+thread_local dp Rain;
+thread_local dp RootingDepth;
+thread_local dp Runoff;
+thread_local dp SaltInfiltr;
+thread_local dp Surf0 = 0.0;
+thread_local dp SurfaceStorage;
+thread_local dp Tact;
+thread_local dp Tpot;
+thread_local dp TactWeedInfested;
+thread_local dp Tmax;
+thread_local dp Tmin;
+thread_local dp TmaxCropReference;
+thread_local dp TminCropReference;
+thread_local dp TmaxTnxReference365Days;
+thread_local dp TminTnxReference365Days;
+
+thread_local std::vector<sp> TmaxRun(366);
+thread_local std::vector<sp> TminRun(366);
+thread_local std::vector<sp> TmaxTnxReference12MonthsRun(12);
+thread_local std::vector<sp> TminTnxReference12MonthsRun(12);
+thread_local std::vector<sp> TmaxCropReferenceRun(365);
+thread_local std::vector<sp> TminCropReferenceRun(365);
+thread_local std::vector<sp> TmaxTnxReference365DaysRun(365);
+thread_local std::vector<sp> TminTnxReference365DaysRun(365);
+
+thread_local bool EvapoEntireSoilSurface;
+thread_local bool PreDay, OutDaily, Out8Irri;
+thread_local bool ConsoleOutput = true;
+thread_local bool Out1Wabal;
+thread_local bool Out2Crop;
+thread_local bool Out3Prof;
+thread_local bool Out4Salt;
+thread_local bool Out5CompWC;
+thread_local bool Out6CompEC;
+thread_local bool Out7Clim;
+thread_local bool Part1Mult, Part2Eval;
+
+thread_local std::string PathNameList, PathNameParam;
+
+thread_local std::vector<CompartmentIndividual> Compartment(max_No_compartments);
+thread_local std::vector<CompartmentSaltIndividual> CompartmentSalt(max_No_compartments);
+thread_local std::vector<SoilLayerIndividual> soillayer(max_SoilLayers);
+
+thread_local std::vector<rep_DayEventInt> IrriBeforeSeason(5);
+thread_local std::vector<rep_DayEventInt> IrriAfterSeason(5);
+thread_local std::vector<rep_IrriRule> IrriGenerateRules;
+thread_local dp IrriSeasonCap = undef_double;
+
+// Per-thread state of other modules that needs dynamic initialization,
+// defined here so that InitializeThreadState constructs all of it
+thread_local rep_EventTimeline EventTimeline;
+thread_local rep_RunEvaluation RunEvaluation = {};
+thread_local std::vector<ProjectInput_type> ProjectInput;
+thread_local rep_DerivedSoilState DerivedSoil = {};
+thread_local rep_CropCalendar CropCalendar = {};
+
+namespace {
+
+// The thread_local variables of this file are constructed together on the
+// first access from this file. With -fno-extern-tls-init the other files
+// access them directly, so every thread constructs them before it touches
+// the simulation state: the main thread here, before main().
+struct rep_MainThreadState {
+    rep_MainThreadState() { InitializeThreadState(); }
+} MainThreadState;
+
+} // namespace
+
+void InitializeThreadState()
+{
+    (void)Compartment.size();
+}
 
 // Function implementations
 dp DeduceAquaCropVersion(const std::string& FullNameXXFile)
@@ -297,8 +332,8 @@ void DeclareInitialCondAtFCandNoSalt()
         }
         for (celli = 1; celli <= soillayer[ind-1].SCP1; ++celli)
         {
-            Compartment[compi-1].Salt[celli-1] = 0.0;
-            Compartment[compi-1].Depo[celli-1] = 0.0;
+            CompartmentSalt[compi-1].Salt[celli-1] = 0.0;
+            CompartmentSalt[compi-1].Depo[celli-1] = 0.0;
         }
     }
 }
@@ -318,7 +353,7 @@ void set_layer_undef(SoilLayerIndividual& LayerData)
     LayerData.Macro = undef_int;
     LayerData.UL = undef_double;
     LayerData.Dx = undef_double;
-    for (int i = 0; i < 11; ++i)
+    for (int i = 0; i < max_SaltCells; ++i)
     {
         LayerData.SaltMobility[i] = undef_double;
     }
@@ -326,6 +361,7 @@ void set_layer_undef(SoilLayerIndividual& LayerData)
     LayerData.CRa = 0.0;
     LayerData.CRb = 0.0;
     LayerData.WaterContent = undef_double;
+    DetermineDrainageCoefficients(LayerData);
 }
 
 void CropStressParametersSoilFertility(const rep_Shapes& CropSResp, int32_t StressLevel, rep_EffectStress& StressOUT)
@@ -1084,6 +1120,11 @@ void TimeToMaxCanopySF(dp CCo, dp CGC, dp CCx, int32_t L0, int32_t L12, int32_t
 }
 
 dp SoilEvaporationReductionCoefficient(dp Wrel, dp Edecline)
+{
+    return SoilEvaporationReductionCoefficient(Wrel, Edecline, std::exp(Edecline) - 1.0);
+}
+
+dp SoilEvaporationReductionCoefficient(dp Wrel, dp Edecline, dp ExpEdeclineMin1)
 {
     if (Wrel <= 0.00001)
     {
@@ -1095,7 +1136,7 @@ dp SoilEvaporationReductionCoefficient(dp Wrel, dp Edecline)
     }
     else
     {
-        return (std::exp(Edecline * Wrel) - 1.0) / (std::exp(Edecline) - 1.0);
+        return (std::exp(Edecline * Wrel) - 1.0) / ExpEdeclineMin1;
     }
 }
 
@@ -1385,7 +1426,7 @@ void DetermineCN_default(dp Infiltr, int8_t& CN2)
     }
 }
 
-dp ECeComp(const CompartmentIndividual& Comp)
+dp ECeComp(const CompartmentIndividual& Comp, const CompartmentSaltIndividual& CompSalt)
 {
     dp volSAT, TotSalt, denominator;
     int32_t i;
@@ -1394,7 +1435,7 @@ dp ECeComp(const CompartmentIndividual& Comp)
     TotSalt = 0.0;
     for (i = 0; i < static_cast<int32_t>(soillayer[Comp.Layer - 1].SCP1); ++i)
     {
-        TotSalt += Comp.Salt[i] + Comp.Depo[i];
+        TotSalt += CompSalt.Salt[i] + CompSalt.Depo[i];
     }
 
     denominator = volSAT * 10.0 * Comp.Thickness * (1.0 - soillayer[Comp.Layer - 1].GravelVol / 100.0);
@@ -1408,7 +1449,7 @@ dp ECeComp(const CompartmentIndividual& Comp)
     return TotSalt / equiv;
 }
 
-dp ECswComp(const CompartmentIndividual& Comp, bool atFC)
+dp ECswComp(const CompartmentIndividual& Comp, const CompartmentSaltIndividual& CompSalt, bool atFC)
 {
     dp TotSalt;
     int32_t i;
@@ -1416,7 +1457,7 @@ dp ECswComp(const CompartmentIndividual& Comp, bool atFC)
     TotSalt = 0.0;
     for (i = 0; i < static_cast<int32_t>(soillayer[Comp.Layer - 1].SCP1); ++i)
     {
-        TotSalt += Comp.Salt[i] + Comp.Depo[i];
+        TotSalt += CompSalt.Salt[i] + CompSalt.Depo[i];
     }
 
     if (atFC)
@@ -1705,6 +1746,8 @@ void NoIrrigation()
     }
     IrriECw.PreSeason = 0.0;
     IrriECw.PostSeason = 0.0;
+    IrriGenerateRules.clear();
+    IrriSeasonCap = undef_double;
 }
 
 void LoadIrriScheduleInfo(const std::string& FullName)
@@ -1717,6 +1760,8 @@ void LoadIrriScheduleInfo(const std::string& FullName)
 
     std::getline(file, IrriDescription);
     file >> VersionNr;
+    IrriGenerateRules.clear();
+    IrriSeasonCap = undef_double;
 
     file >> i;
     switch (i)
@@ -1767,6 +1812,24 @@ void LoadIrriScheduleInfo(const std::string& FullName)
         default: GenerateDepthMode_Val = GenerateDepthMode::FixDepth; break;
         }
         IrriFirstDayNr = undef_int;
+
+        // Schedule rows after the "====" line: FromDay TimeInfo DepthInfo [ECw]
+        std::string line;
+        bool InTable = false;
+        while (std::getline(file, line)) {
+            if (!InTable) {
+                size_t first = line.find_first_not_of(" \t");
+                InTable = (first != std::string::npos) && (line[first] == '=');
+                continue;
+            }
+            std::istringstream ss(line);
+            rep_IrriRule Rule;
+            Rule.ECw = Simulation.IrriECw;
+            if (ss >> Rule.FromDay >> Rule.TimeInfo >> Rule.DepthInfo) {
+                ss >> Rule.ECw;
+                IrriGenerateRules.push_back(Rule);
+            }
+        }
     }
 
     if (IrriMode_Val == IrriMode::Inet)
@@ -1855,9 +1918,6 @@ void SplitStringInThreeParams(const std::string& StringIN, dp& Par1, dp& Par2, d
 dp CO2ForSimulationPeriod(int32_t FromDayNr, int32_t ToDayNr)
 {
     int32_t Dayi, Monthi, FromYi, ToYi;
-    dp CO2From, CO2To, CO2a, CO2b, YearA, YearB;
-    std::string TempString;
-    std::ifstream fhandle;
 
     DetermineDate(FromDayNr, Dayi, Monthi, FromYi);
     DetermineDate(ToDayNr, Dayi, Monthi, ToYi);
@@ -1866,76 +1926,16 @@ dp CO2ForSimulationPeriod(int32_t FromDayNr, int32_t ToDayNr)
     {
         return CO2Ref;
     }
-    else
-    {
-        fhandle.open(CO2FileFull);
-        if (fhandle.is_open())
-        {
-            std::string line;
-            for(int k=0; k<3; ++k) std::getline(fhandle, line); // Skip 3 lines
 
-            std::getline(fhandle, TempString);
-            SplitStringInTwoParams(TempString, YearB, CO2b);
-
-            if (roundc(YearB, 1) >= FromYi)
-            {
-                CO2From = CO2b;
-                YearA = YearB;
-                CO2a = CO2b;
-            }
-            else
-            {
-                do
-                {
-                    YearA = YearB;
-                    CO2a = CO2b;
-                    if (!std::getline(fhandle, TempString)) break;
-                    SplitStringInTwoParams(TempString, YearB, CO2b);
-                } while (!(roundc(YearB, 1) >= FromYi));
-
-                if (FromYi > roundc(YearB, 1))
-                {
-                    CO2From = CO2b;
-                }
-                else
-                {
-                    CO2From = CO2a + (CO2b - CO2a) * static_cast<dp>(FromYi - static_cast<int32_t>(roundc(YearA, 1))) / static_cast<dp>(static_cast<int32_t>(roundc(YearB, 1)) - static_cast<int32_t>(roundc(YearA, 1)));
-                }
-            }
-
-            CO2To = CO2From;
-            if (ToYi > FromYi && static_cast<dp>(ToYi) > roundc(YearA, 1))
-            {
-                if (roundc(YearB, 1) >= ToYi)
-                {
-                    CO2To = CO2a + (CO2b - CO2a) * static_cast<dp>(ToYi - static_cast<int32_t>(roundc(YearA, 1))) / static_cast<dp>(static_cast<int32_t>(roundc(YearB, 1)) - static_cast<int32_t>(roundc(YearA, 1)));
-                }
-                else if (fhandle.good())
-                {
-                    do
-                    {
-                        YearA = YearB;
-                        CO2a = CO2b;
-                        if (!std::getline(fhandle, TempString)) break;
-                        SplitStringInTwoParams(TempString, YearB, CO2b);
-                        if (roundc(YearB, 1) >= ToYi) break;
-                    } while (fhandle.good());
-
-                    if (ToYi > roundc(YearB, 1))
-                    {
-                        CO2To = CO2b;
-                    }
-                    else
-                    {
-                        CO2To = CO2a + (CO2b - CO2a) * static_cast<dp>(ToYi - static_cast<int32_t>(roundc(YearA, 1))) / static_cast<dp>(static_cast<int32_t>(roundc(YearB, 1)) - static_cast<int32_t>(roundc(YearA, 1)));
-                    }
-                }
-            }
-            fhandle.close();
-            return (CO2From + CO2To) / 2.0;
-        }
+    // Parsed once per file and shared by all runs
+    std::shared_ptr<const rep_CO2Series> Series = GetCO2Series(CO2FileFull);
+    if (!Series)
+    {
         return CO2Ref; // Fallback
     }
+    dp CO2From = Series->CO2ForYear(FromYi);
+    dp CO2To = (ToYi > FromYi) ? Series->CO2ForYear(ToYi) : CO2From;
+    return (CO2From + CO2To) / 2.0;
 }
 
 void ReadRainfallSettings()
@@ -2127,7 +2127,7 @@ int32_t ActiveCells(const CompartmentIndividual& Comp)
     return 1;
 }
 
-void DetermineSaltContent(dp ECe, CompartmentIndividual& Comp)
+void DetermineSaltContent(dp ECe, const CompartmentIndividual& Comp, CompartmentSaltIndividual& CompSalt)
 {
     // ... (incomplete placeholder logic)
 }
@@ -2578,12 +2578,17 @@ void LoadProfile(const std::string& FullName)
 
     std::getline(fhandle, ProfDescriptionLocal);
     ProfDescription = ProfDescriptionLocal;
+    // one value per line, followed by its description
     fhandle >> VersionNr;
+    fhandle.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     fhandle >> TempShortInt; Soil.CNvalue = (int8_t)TempShortInt;
+    fhandle.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     fhandle >> TempShortInt; Soil.REW = (int8_t)TempShortInt;
+    fhandle.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     fhandle >> TempShortInt; Soil.NrSoilLayers = (int8_t)TempShortInt;
-    
-    // Skip 3 lines
+    fhandle.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    // Skip 3 lines (obsolete restrictive layer depth and the table header)
     for(int k=0; k<3; ++k) fhandle.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
     for (i = 1; i <= Soil.NrSoilLayers; ++i)
@@ -2647,6 +2652,7 @@ void LoadProfileProcessing(dp VersionNr)
     for (i = 1; i <= Soil.NrSoilLayers; ++i)
     {
         soillayer[i-1].tau = TauFromKsat(soillayer[i-1].InfRate);
+        DetermineDrainageCoefficients(soillayer[i-1]);
 
         if (soillayer[i-1].InfRate <= 112.0)
         {
@@ -2697,11 +2703,97 @@ int32_t SumCalendarDaysReferenceTnx(int32_t ValGDDays, int32_t RefCropDay1, int3
     return 0;
 }
 
-void DesignateSoilLayerToCompartments(int32_t NrCompartments, int32_t NrSoilLayers, std::vector<CompartmentIndividual>& Compartment) {}
+void DesignateSoilLayerToCompartments(int32_t NrCompartments, int32_t NrSoilLayers, std::vector<CompartmentIndividual>& Compartment)
+{
+    int32_t i, layeri, compi;
+    dp depth, depthi;
+    bool finished, NextLayer;
+
+    depth = 0.0;
+    depthi = 0.0;
+    layeri = 1;
+    compi = 1;
+    finished = (NrCompartments < 1 || NrSoilLayers < 1);
+    while (!finished)
+    {
+        depth += soillayer[layeri-1].Thickness;
+        do
+        {
+            depthi += Compartment[compi-1].Thickness / 2.0;
+            if (depthi <= depth)
+            {
+                Compartment[compi-1].Layer = layeri;
+                NextLayer = false;
+                depthi += Compartment[compi-1].Thickness / 2.0;
+                compi++;
+                finished = (compi > NrCompartments);
+            }
+            else
+            {
+                depthi -= Compartment[compi-1].Thickness / 2.0;
+                NextLayer = true;
+                layeri++;
+                finished = (layeri > NrSoilLayers);
+            }
+        } while (!finished && !NextLayer);
+    }
 
-void specify_soil_layer(int32_t NrCompartments, int32_t NrSoilLayers, std::vector<SoilLayerIndividual>& SoilLayer, std::vector<CompartmentIndividual>& Compartment, rep_Content& TotalWaterContent) {}
+    for (i = compi; i <= NrCompartments; ++i)
+    {
+        Compartment[i-1].Layer = NrSoilLayers;
+    }
+    for (i = NrCompartments + 1; i <= max_No_compartments; ++i)
+    {
+        Compartment[i-1].Thickness = undef_double;
+    }
+}
 
-void Calculate_Saltmobility(int32_t layer, int8_t SaltDiffusion, int8_t Macro, std::vector<dp>& Mobil)
+void specify_soil_layer(int32_t NrCompartments, int32_t NrSoilLayers, std::vector<SoilLayerIndividual>& SoilLayer, std::vector<CompartmentIndividual>& Compartment, rep_Content& TotalWaterContent)
+{
+    int32_t layeri, compi, celli;
+
+    DesignateSoilLayerToCompartments(NrCompartments, NrSoilLayers, Compartment);
+    InvalidateDerivedSoilState();
+
+    // Soil layers and compartments at field capacity, without salts and
+    // without groundwater table (FCadj = FC)
+    TotalWaterContent.BeginDay = 0.0;
+    for (layeri = 1; layeri <= NrSoilLayers; ++layeri)
+    {
+        SoilLayer[layeri-1].WaterContent = 0.0;
+    }
+    for (compi = 1; compi <= NrCompartments; ++compi)
+    {
+        SoilLayerIndividual& Layer = SoilLayer[Compartment[compi-1].Layer-1];
+        Compartment[compi-1].theta = Layer.FC / 100.0;
+        Compartment[compi-1].FCadj = Layer.FC;
+        Compartment[compi-1].DayAnaero = 0;
+        for (celli = 1; celli <= Layer.SCP1; ++celli)
+        {
+            CompartmentSalt[compi-1].Salt[celli-1] = 0.0;
+            CompartmentSalt[compi-1].Depo[celli-1] = 0.0;
+        }
+        Simulation.ThetaIni[compi-1] = Compartment[compi-1].theta;
+        Simulation.ECeIni[compi-1] = 0.0;
+        Layer.WaterContent += Simulation.ThetaIni[compi-1] * 100.0 * 10.0 * Compartment[compi-1].Thickness;
+    }
+    for (layeri = 1; layeri <= NrSoilLayers; ++layeri)
+    {
+        TotalWaterContent.BeginDay += SoilLayer[layeri-1].WaterContent;
+    }
+
+    DeclareInitialCondAtFCandNoSalt();
+}
+
+void DetermineDrainageCoefficients(SoilLayerIndividual& Layer)
+{
+    Layer.ThetaSat = Layer.SAT / 100.0;
+    Layer.ThetaFC = Layer.FC / 100.0;
+    Layer.TauRange = Layer.tau * (Layer.ThetaSat - Layer.ThetaFC);
+    Layer.ExpRangeMin1 = std::exp(Layer.ThetaSat - Layer.ThetaFC) - 1.0;
+}
+
+void Calculate_Saltmobility(int32_t layer, int8_t SaltDiffusion, int8_t Macro, std::array<dp, SaltCellStride>& Mobil)
 {
     int32_t i, CelMax;
     dp Mix, a, b, xi, yi, UL;
@@ -2771,7 +2863,15 @@ void Calculate_Saltmobility(int32_t layer, int8_t SaltDiffusion, int8_t Macro, s
     }
 }
 
-void CompleteProfileDescription() {}
+void CompleteProfileDescription()
+{
+    for (int32_t i = Soil.NrSoilLayers + 1; i <= max_SoilLayers; ++i)
+    {
+        set_layer_undef(soillayer[i-1]);
+    }
+    Simulation.ResetIniSWC = true; // soil water content and soil salinity
+    specify_soil_layer(NrCompartments, Soil.NrSoilLayers, soillayer, Compartment, TotalWaterContent);
+}
 
 void GlobalZero(rep_sum& SumWaBal)
 {
@@ -2,6 +2,7 @@
 #include "AquaCrop/Global.h"
 #include "AquaCrop/Utils.h"
 #include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/Instrument.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -35,6 +36,7 @@ void ResetDefaultSoil(bool use_default_soil_file)
         soillayer[i].Description = "Loamy Sand";
         soillayer[i].SoilClass = 2;
         DetermineParametersCR(2, 500.0, soillayer[i].CRa, soillayer[i].CRb);
+        DetermineDrainageCoefficients(soillayer[i]);
     }
     if (use_default_soil_file)
     {
@@ -173,6 +175,7 @@ void LoadSimulationRunProject(int32_t NrRun)
     TemperatureFile = input.Temperature_Filename;
     if (TemperatureFile != "(None)" && TemperatureFile != "(External)") {
         TemperatureFileFull = input.Temperature_Directory + TemperatureFile;
+        AQUACROP_REGION("load_climate");
         LoadClim(TemperatureFileFull, TemperatureDescription, TemperatureRecord);
         CompleteClimateDescription(TemperatureRecord);
     }
@@ -181,6 +184,7 @@ void LoadSimulationRunProject(int32_t NrRun)
     EToFile = input.ETo_Filename;
     if (EToFile != "(None)" && EToFile != "(External)") {
         EToFileFull = input.ETo_Directory + EToFile;
+        AQUACROP_REGION("load_climate");
         LoadClim(EToFileFull, EToDescription, EToRecord);
         CompleteClimateDescription(EToRecord);
     }
@@ -189,6 +193,7 @@ void LoadSimulationRunProject(int32_t NrRun)
     RainFile = input.Rain_Filename;
     if (RainFile != "(None)" && RainFile != "(External)") {
         RainFileFull = input.Rain_Directory + RainFile;
+        AQUACROP_REGION("load_climate");
         LoadClim(RainFileFull, RainDescription, RainRecord);
         CompleteClimateDescription(RainRecord);
     }
@@ -213,6 +218,7 @@ void LoadSimulationRunProject(int32_t NrRun)
     CropFile = input.Crop_Filename;
     if (CropFile != "(None)") {
         CropFileFull = input.Crop_Directory + CropFile;
+        AQUACROP_REGION("load_crop");
         LoadCrop(CropFileFull);
     }
 
@@ -221,6 +227,8 @@ void LoadSimulationRunProject(int32_t NrRun)
     if (IrriFile != "(None)") {
         IrriFileFull = input.Irrigation_Directory + IrriFile;
         LoadIrriScheduleInfo(IrriFileFull);
+    } else {
+        NoIrrigation();
     }
 
     // 5. Management
@@ -234,7 +242,9 @@ void LoadSimulationRunProject(int32_t NrRun)
     ProfFile = input.Soil_Filename;
     if (ProfFile != "(None)") {
         ProfFilefull = input.Soil_Directory + ProfFile;
+        AQUACROP_REGION("load_profile");
         LoadProfile(ProfFilefull);
+        CompleteProfileDescription();
     }
 
     // 7. GroundWater
@@ -243,6 +253,7 @@ void LoadSimulationRunProject(int32_t NrRun)
         GroundWaterFilefull = input.GroundWater_Directory + GroundWaterFile;
         int32_t Zcm;
         dp ECdSm;
+        AQUACROP_REGION("load_groundwater");
         LoadGroundWater(GroundWaterFilefull, Simulation.FromDayNr, Zcm, ECdSm);
         ZiAqua = static_cast<dp>(Zcm);
         ECiAqua = ECdSm;
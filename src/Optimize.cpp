@@ -0,0 +1,385 @@
+#include "AquaCrop/Optimize.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/SplitMix64.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace AquaCrop {
+
+namespace {
+
+using Point = std::vector<dp>;
+
+// Bookkeeping shared by the methods: evaluates batches within the budget and
+// remembers the best point seen
+struct rep_Search {
+    const BatchObjective& Objective;
+    int32_t MaxEvaluations;
+    rep_OptimResult Result;
+
+    rep_Search(const BatchObjective& ObjectiveIN, int32_t MaxEvaluationsIN)
+        : Objective(ObjectiveIN), MaxEvaluations(MaxEvaluationsIN)
+    {
+        Result.BestValue = HUGE_VAL;
+        Result.NrEvaluations = 0;
+        Result.NrIterations = 0;
+    }
+
+    int32_t Remaining() const { return MaxEvaluations - Result.NrEvaluations; }
+
+    void Evaluate(const std::vector<Point>& Points, std::vector<dp>& Values)
+    {
+        Values.assign(Points.size(), HUGE_VAL);
+        Objective(Points, Values);
+        Result.NrEvaluations += static_cast<int32_t>(Points.size());
+        for (size_t i = 0; i < Points.size(); ++i) {
+            if (std::isnan(Values[i])) Values[i] = HUGE_VAL;
+            if (Values[i] < Result.BestValue) {
+                Result.BestValue = Values[i];
+                Result.Best = Points[i];
+            }
+        }
+    }
+};
+
+void Clip(Point& X)
+{
+    for (dp& Xi : X) Xi = std::min(1.0, std::max(0.0, Xi));
+}
+
+bool Converged(dp Best, dp Worst, dp Tolerance)
+{
+    return (Worst - Best) <= Tolerance * (std::abs(Best) + Tolerance);
+}
+
+dp Gaussian(rep_SplitMix64& Rng)
+{
+    // Box-Muller; 1 - U keeps the logarithm finite
+    dp U1 = 1.0 - Rng.Uniform();
+    dp U2 = Rng.Uniform();
+    return std::sqrt(-2.0 * std::log(U1)) * std::cos(2.0 * PI * U2);
+}
+
+Point StartPoint(int32_t NrDim, const rep_OptimSettings& Settings)
+{
+    Point X(NrDim, 0.5);
+    if (static_cast<int32_t>(Settings.Start.size()) == NrDim) X = Settings.Start;
+    Clip(X);
+    return X;
+}
+
+// Nelder-Mead. After every sort the reflection, expansion and both
+// contractions are evaluated together, so a step costs one batch of four
+// (a shrink one batch of NrDim) instead of one to three sequential calls.
+void NelderMead(int32_t NrDim, const rep_OptimSettings& Settings, rep_Search& Search)
+{
+    const int32_t N = NrDim;
+    std::vector<Point> Simplex(N + 1, StartPoint(N, Settings));
+    for (int32_t i = 1; i <= N; ++i) {
+        dp& Xi = Simplex[i][i-1];
+        Xi = (Xi + 0.2 <= 1.0) ? Xi + 0.2 : Xi - 0.2;
+    }
+    std::vector<dp> F;
+    Search.Evaluate(Simplex, F);
+
+    std::vector<int32_t> Order(N + 1);
+    std::vector<Point> Trial(4, Point(N));
+    std::vector<dp> FTrial;
+    while (Search.Remaining() >= 4) {
+        std::iota(Order.begin(), Order.end(), 0);
+        std::sort(Order.begin(), Order.end(), [&F](int32_t a, int32_t b) { return F[a] < F[b]; });
+        const int32_t Best = Order[0], Worst = Order[N], Second = Order[N-1];
+        if (Converged(F[Best], F[Worst], Settings.Tolerance)) break;
+        ++Search.Result.NrIterations;
+
+        Point Centroid(N, 0.0);
+        for (int32_t k = 0; k < N; ++k) {
+            for (int32_t j = 0; j < N; ++j) Centroid[j] += Simplex[Order[k]][j];
+        }
+        for (dp& Cj : Centroid) Cj /= N;
+
+        // reflection, expansion, outside and inside contraction
+        const dp Coef[4] = {1.0, 2.0, 0.5, -0.5};
+        for (int32_t t = 0; t < 4; ++t) {
+            for (int32_t j = 0; j < N; ++j) {
+                Trial[t][j] = Centroid[j] + Coef[t] * (Centroid[j] - Simplex[Worst][j]);
+            }
+            Clip(Trial[t]);
+        }
+        Search.Evaluate(Trial, FTrial);
+
+        int32_t Accept = -1;
+        if (FTrial[0] < F[Best]) {
+            Accept = (FTrial[1] < FTrial[0]) ? 1 : 0;
+        } else if (FTrial[0] < F[Second]) {
+            Accept = 0;
+        } else if (FTrial[0] < F[Worst]) {
+            if (FTrial[2] <= FTrial[0]) Accept = 2;
+        } else if (FTrial[3] < F[Worst]) {
+            Accept = 3;
+        }
+
+        if (Accept >= 0) {
+            Simplex[Worst] = Trial[Accept];
+            F[Worst] = FTrial[Accept];
+        } else {
+            // shrink towards the best vertex
+            if (Search.Remaining() < N) break;
+            std::vector<Point> Shrunk;
+            for (int32_t k = 1; k <= N; ++k) {
+                Point X = Simplex[Order[k]];
+                for (int32_t j = 0; j < N; ++j) X[j] = Simplex[Best][j] + 0.5 * (X[j] - Simplex[Best][j]);
+                Shrunk.push_back(X);
+            }
+            std::vector<dp> FShrunk;
+            Search.Evaluate(Shrunk, FShrunk);
+            for (int32_t k = 1; k <= N; ++k) {
+                Simplex[Order[k]] = Shrunk[k-1];
+                F[Order[k]] = FShrunk[k-1];
+            }
+        }
+    }
+}
+
+// Differential evolution, DE/rand/1/bin. A generation is one batch.
+void DifferentialEvolution(int32_t NrDim, const rep_OptimSettings& Settings, rep_Search& Search)
+{
+    const int32_t N = NrDim;
+    const int32_t NP = (Settings.PopulationSize >= 4) ? Settings.PopulationSize : std::max(8, 10 * N);
+    const dp Fw = 0.6, CR = 0.9;
+    rep_SplitMix64 Rng{Settings.Seed};
+
+    std::vector<Point> Pop(NP, Point(N));
+    Pop[0] = StartPoint(N, Settings);
+    for (int32_t i = 1; i < NP; ++i) {
+        for (dp& Xj : Pop[i]) Xj = Rng.Uniform();
+    }
+    std::vector<dp> F;
+    Search.Evaluate(Pop, F);
+
+    std::vector<Point> Trial(NP, Point(N));
+    std::vector<dp> FTrial;
+    auto Pick = [&Rng, NP]() { return static_cast<int32_t>(Rng.Uniform() * NP) % NP; };
+    while (Search.Remaining() >= NP) {
+        auto Range = std::minmax_element(F.begin(), F.end());
+        if (Converged(*Range.first, *Range.second, Settings.Tolerance)) break;
+        ++Search.Result.NrIterations;
+
+        for (int32_t i = 0; i < NP; ++i) {
+            int32_t a, b, c;
+            do { a = Pick(); } while (a == i);
+            do { b = Pick(); } while (b == i || b == a);
+            do { c = Pick(); } while (c == i || c == a || c == b);
+            int32_t JRand = static_cast<int32_t>(Rng.Uniform() * N) % N;
+            for (int32_t j = 0; j < N; ++j) {
+                if (j == JRand || Rng.Uniform() < CR) {
+                    Trial[i][j] = Pop[a][j] + Fw * (Pop[b][j] - Pop[c][j]);
+                    // bounce back inside instead of piling up on the bounds
+                    if (Trial[i][j] < 0.0) Trial[i][j] = Rng.Uniform() * Pop[i][j];
+                    if (Trial[i][j] > 1.0) Trial[i][j] = Pop[i][j] + Rng.Uniform() * (1.0 - Pop[i][j]);
+                } else {
+                    Trial[i][j] = Pop[i][j];
+                }
+            }
+        }
+        Search.Evaluate(Trial, FTrial);
+        for (int32_t i = 0; i < NP; ++i) {
+            if (FTrial[i] <= F[i]) {
+                Pop[i] = Trial[i];
+                F[i] = FTrial[i];
+            }
+        }
+    }
+}
+
+// Eigen decomposition of the symmetric matrix A (cyclic Jacobi). On return
+// the columns of V are the eigenvectors and D the eigenvalues.
+void SymmetricEigen(std::vector<Point> A, std::vector<Point>& V, Point& D)
+{
+    const int32_t N = static_cast<int32_t>(A.size());
+    V.assign(N, Point(N, 0.0));
+    for (int32_t i = 0; i < N; ++i) V[i][i] = 1.0;
+    for (int32_t Sweep = 1; Sweep <= 50; ++Sweep) {
+        dp OffDiag = 0.0;
+        for (int32_t p = 0; p < N; ++p) {
+            for (int32_t q = p + 1; q < N; ++q) OffDiag += A[p][q] * A[p][q];
+        }
+        if (OffDiag < 1.0e-30) break;
+        for (int32_t p = 0; p < N; ++p) {
+            for (int32_t q = p + 1; q < N; ++q) {
+                if (std::abs(A[p][q]) < 1.0e-300) continue;
+                dp Theta = (A[q][q] - A[p][p]) / (2.0 * A[p][q]);
+                dp T = ((Theta >= 0.0) ? 1.0 : -1.0) / (std::abs(Theta) + std::sqrt(Theta * Theta + 1.0));
+                dp C = 1.0 / std::sqrt(T * T + 1.0), S = T * C;
+                for (int32_t k = 0; k < N; ++k) {
+                    dp Akp = A[k][p], Akq = A[k][q];
+                    A[k][p] = C * Akp - S * Akq;
+                    A[k][q] = S * Akp + C * Akq;
+                }
+                for (int32_t k = 0; k < N; ++k) {
+                    dp Apk = A[p][k], Aqk = A[q][k];
+                    A[p][k] = C * Apk - S * Aqk;
+                    A[q][k] = S * Apk + C * Aqk;
+                }
+                for (int32_t k = 0; k < N; ++k) {
+                    dp Vkp = V[k][p], Vkq = V[k][q];
+                    V[k][p] = C * Vkp - S * Vkq;
+                    V[k][q] = S * Vkp + C * Vkq;
+                }
+            }
+        }
+    }
+    D.resize(N);
+    for (int32_t i = 0; i < N; ++i) D[i] = A[i][i];
+}
+
+// CMA-ES with rank-one and rank-mu updates (Hansen's tutorial defaults).
+// Samples outside the cube are evaluated at their projection on the cube plus
+// a penalty on the distance, so the mean is pulled back inside.
+void CMAES(int32_t NrDim, const rep_OptimSettings& Settings, rep_Search& Search)
+{
+    const int32_t N = NrDim;
+    const dp n = static_cast<dp>(N);
+    const int32_t Lambda = (Settings.PopulationSize >= 4) ? Settings.PopulationSize
+                                                         : 4 + static_cast<int32_t>(3.0 * std::log(n));
+    const int32_t Mu = Lambda / 2;
+    Point W(Mu);
+    for (int32_t i = 0; i < Mu; ++i) W[i] = std::log(Lambda / 2.0 + 0.5) - std::log(i + 1.0);
+    dp SumW = std::accumulate(W.begin(), W.end(), 0.0), SumW2 = 0.0;
+    for (dp& Wi : W) {
+        Wi /= SumW;
+        SumW2 += Wi * Wi;
+    }
+    const dp MuEff = 1.0 / SumW2;
+    const dp Cc = (4.0 + MuEff / n) / (n + 4.0 + 2.0 * MuEff / n);
+    const dp Cs = (MuEff + 2.0) / (n + MuEff + 5.0);
+    const dp C1 = 2.0 / ((n + 1.3) * (n + 1.3) + MuEff);
+    const dp CMu = std::min(1.0 - C1, 2.0 * (MuEff - 2.0 + 1.0 / MuEff) / ((n + 2.0) * (n + 2.0) + MuEff));
+    const dp Damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((MuEff - 1.0) / (n + 1.0)) - 1.0) + Cs;
+    const dp ChiN = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+    rep_SplitMix64 Rng{Settings.Seed};
+
+    Point Mean = StartPoint(N, Settings);
+    dp Sigma = 0.3;
+    Point Pc(N, 0.0), Ps(N, 0.0), D(N, 1.0);
+    std::vector<Point> C(N, Point(N, 0.0)), B(N, Point(N, 0.0));
+    for (int32_t i = 0; i < N; ++i) C[i][i] = B[i][i] = 1.0;
+    int32_t EigenEval = 0;
+
+    std::vector<Point> Z(Lambda, Point(N)), Y(Lambda, Point(N)), X(Lambda, Point(N)), Repaired(Lambda);
+    std::vector<dp> F, Fitness(Lambda);
+    std::vector<int32_t> Order(Lambda);
+    while (Search.Remaining() >= Lambda) {
+        ++Search.Result.NrIterations;
+        for (int32_t k = 0; k < Lambda; ++k) {
+            for (dp& Zj : Z[k]) Zj = Gaussian(Rng);
+            for (int32_t i = 0; i < N; ++i) {
+                dp Yi = 0.0;
+                for (int32_t j = 0; j < N; ++j) Yi += B[i][j] * D[j] * Z[k][j];
+                Y[k][i] = Yi;
+                X[k][i] = Mean[i] + Sigma * Yi;
+            }
+            Repaired[k] = X[k];
+            Clip(Repaired[k]);
+        }
+        Search.Evaluate(Repaired, F);
+        for (int32_t k = 0; k < Lambda; ++k) {
+            dp Dist2 = 0.0;
+            for (int32_t j = 0; j < N; ++j) Dist2 += (X[k][j] - Repaired[k][j]) * (X[k][j] - Repaired[k][j]);
+            Fitness[k] = F[k] + (1.0 + std::abs(F[k])) * Dist2;
+        }
+        std::iota(Order.begin(), Order.end(), 0);
+        std::sort(Order.begin(), Order.end(), [&Fitness](int32_t a, int32_t b) { return Fitness[a] < Fitness[b]; });
+        if (Converged(F[Order[0]], F[Order[Lambda-1]], Settings.Tolerance)) break;
+
+        // recombination: weighted mean of the mu best steps
+        Point YW(N, 0.0), ZW(N, 0.0);
+        for (int32_t k = 0; k < Mu; ++k) {
+            for (int32_t j = 0; j < N; ++j) {
+                YW[j] += W[k] * Y[Order[k]][j];
+                ZW[j] += W[k] * Z[Order[k]][j];
+            }
+        }
+        for (int32_t j = 0; j < N; ++j) Mean[j] += Sigma * YW[j];
+
+        // evolution paths; B * ZW is C^(-1/2) * YW
+        dp PsNorm2 = 0.0;
+        for (int32_t i = 0; i < N; ++i) {
+            dp BZ = 0.0;
+            for (int32_t j = 0; j < N; ++j) BZ += B[i][j] * ZW[j];
+            Ps[i] = (1.0 - Cs) * Ps[i] + std::sqrt(Cs * (2.0 - Cs) * MuEff) * BZ;
+            PsNorm2 += Ps[i] * Ps[i];
+        }
+        dp Gen = static_cast<dp>(Search.Result.NrIterations);
+        bool HSig = std::sqrt(PsNorm2) / std::sqrt(1.0 - std::pow(1.0 - Cs, 2.0 * Gen)) / ChiN < 1.4 + 2.0 / (n + 1.0);
+        for (int32_t i = 0; i < N; ++i) {
+            Pc[i] = (1.0 - Cc) * Pc[i] + (HSig ? std::sqrt(Cc * (2.0 - Cc) * MuEff) : 0.0) * YW[i];
+        }
+
+        // covariance update
+        dp DeltaHSig = HSig ? 0.0 : Cc * (2.0 - Cc);
+        for (int32_t i = 0; i < N; ++i) {
+            for (int32_t j = 0; j <= i; ++j) {
+                dp RankMu = 0.0;
+                for (int32_t k = 0; k < Mu; ++k) RankMu += W[k] * Y[Order[k]][i] * Y[Order[k]][j];
+                C[i][j] = (1.0 - C1 - CMu) * C[i][j] + C1 * (Pc[i] * Pc[j] + DeltaHSig * C[i][j]) + CMu * RankMu;
+                C[j][i] = C[i][j];
+            }
+        }
+        Sigma *= std::exp((Cs / Damps) * (std::sqrt(PsNorm2) / ChiN - 1.0));
+
+        // decompose C again once the update has drifted enough
+        if (Search.Result.NrEvaluations - EigenEval > Lambda / (C1 + CMu) / n / 10.0) {
+            EigenEval = Search.Result.NrEvaluations;
+            Point Eigen;
+            SymmetricEigen(C, B, Eigen);
+            for (int32_t i = 0; i < N; ++i) D[i] = std::sqrt(std::max(Eigen[i], 1.0e-20));
+        }
+        if (Sigma * *std::max_element(D.begin(), D.end()) < 1.0e-12) break;
+    }
+}
+
+} // namespace
+
+rep_OptimResult MinimizeInUnitCube(int32_t NrDim, const BatchObjective& Objective, const rep_OptimSettings& Settings)
+{
+    rep_Search Search(Objective, Settings.MaxEvaluations);
+    if (NrDim <= 0) return Search.Result;
+    switch (Settings.Method) {
+        case OptimMethod::NelderMead:
+            NelderMead(NrDim, Settings, Search);
+            break;
+        case OptimMethod::DifferentialEvolution:
+            DifferentialEvolution(NrDim, Settings, Search);
+            break;
+        case OptimMethod::CMAES:
+            CMAES(NrDim, Settings, Search);
+            break;
+    }
+    return Search.Result;
+}
+
+const char* OptimMethodName(OptimMethod Method)
+{
+    switch (Method) {
+        case OptimMethod::NelderMead: return "nelder-mead";
+        case OptimMethod::DifferentialEvolution: return "de";
+        case OptimMethod::CMAES: return "cmaes";
+    }
+    return "?";
+}
+
+bool ParseOptimMethod(const std::string& Name, OptimMethod& Method)
+{
+    for (OptimMethod M : {OptimMethod::NelderMead, OptimMethod::DifferentialEvolution, OptimMethod::CMAES}) {
+        if (Name == OptimMethodName(M)) {
+            Method = M;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace AquaCrop
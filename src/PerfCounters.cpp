@@ -0,0 +1,263 @@
+#include "AquaCrop/PerfCounters.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace AquaCrop {
+
+bool PerfCountersRequested = false;
+
+namespace {
+
+const char* PerfCounterName(int32_t i) {
+    switch (static_cast<PerfCounter>(i)) {
+    case PerfCounter::Cycles: return "cycles";
+    case PerfCounter::Instructions: return "instructions";
+    case PerfCounter::CacheMisses: return "cache_misses";
+    case PerfCounter::BranchMisses: return "branch_misses";
+    default: return "unknown";
+    }
+}
+
+struct rep_PerfTotals {
+    uint64_t Calls = 0;
+    double Value[NrPerfCounters] = {};
+};
+
+// Counter totals, per thread while running and merged for the report
+struct rep_PerfData {
+    std::map<std::string, rep_PerfTotals> Regions;
+    std::array<rep_PerfTotals, NrBudgetStages> Stages;
+};
+
+std::mutex PerfMutex;
+rep_PerfData PerfTotal;
+bool CountersOpened[NrPerfCounters] = {};
+
+void MergePerfData(rep_PerfData& Data) {
+    std::lock_guard<std::mutex> lock(PerfMutex);
+    for (const auto& Region : Data.Regions) {
+        rep_PerfTotals& T = PerfTotal.Regions[Region.first];
+        T.Calls += Region.second.Calls;
+        for (int32_t c = 0; c < NrPerfCounters; ++c) T.Value[c] += Region.second.Value[c];
+    }
+    for (int32_t s = 0; s < NrBudgetStages; ++s) {
+        PerfTotal.Stages[s].Calls += Data.Stages[s].Calls;
+        for (int32_t c = 0; c < NrPerfCounters; ++c) PerfTotal.Stages[s].Value[c] += Data.Stages[s].Value[c];
+    }
+    Data = rep_PerfData();
+}
+
+struct rep_PerfThread {
+    bool Tried = false;
+    int GroupFd = -1;
+    int Fds[NrPerfCounters] = {-1, -1, -1, -1};
+    int Slot[NrPerfCounters] = {-1, -1, -1, -1}; // position in the group read
+    int NrOpen = 0;
+    rep_PerfData Data;
+    rep_PerfSample LastMark{};
+    bool HasMark = false;
+
+    ~rep_PerfThread() {
+        if (NrOpen > 0) MergePerfData(Data);
+#ifdef __linux__
+        for (int fd : Fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+};
+
+thread_local rep_PerfThread PerfThread;
+
+#ifdef __linux__
+int OpenCounter(uint64_t Config, int GroupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = Config;
+    attr.disabled = (GroupFd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, GroupFd, 0));
+}
+#endif
+
+// Opens the group of the calling thread once; the cycle counter leads
+bool OpenThreadCounters(int* Error) {
+    rep_PerfThread& T = PerfThread;
+    if (T.Tried) return T.NrOpen > 0;
+    T.Tried = true;
+#ifdef __linux__
+    const uint64_t Configs[NrPerfCounters] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                              PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    T.GroupFd = OpenCounter(Configs[0], -1);
+    if (T.GroupFd < 0) {
+        if (Error != nullptr) *Error = errno;
+        return false;
+    }
+    T.Fds[0] = T.GroupFd;
+    T.Slot[0] = T.NrOpen++;
+    // members that the CPU or hypervisor does not provide are left out
+    for (int32_t c = 1; c < NrPerfCounters; ++c) {
+        T.Fds[c] = OpenCounter(Configs[c], T.GroupFd);
+        if (T.Fds[c] >= 0) T.Slot[c] = T.NrOpen++;
+    }
+    ioctl(T.GroupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(T.GroupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    std::lock_guard<std::mutex> lock(PerfMutex);
+    for (int32_t c = 0; c < NrPerfCounters; ++c) {
+        if (T.Slot[c] >= 0) CountersOpened[c] = true;
+    }
+    return true;
+#else
+    if (Error != nullptr) *Error = 0;
+    return false;
+#endif
+}
+
+// Counter deltas, scaled up when the kernel multiplexed the group
+void AddDelta(rep_PerfTotals& Totals, const rep_PerfSample& Begin, const rep_PerfSample& End) {
+    uint64_t dEnabled = End.TimeEnabled - Begin.TimeEnabled;
+    uint64_t dRunning = End.TimeRunning - Begin.TimeRunning;
+    double Scale = (dRunning > 0 && dRunning < dEnabled) ? static_cast<double>(dEnabled) / static_cast<double>(dRunning) : 1.0;
+    Totals.Calls++;
+    for (int32_t c = 0; c < NrPerfCounters; ++c) {
+        Totals.Value[c] += static_cast<double>(End.Value[c] - Begin.Value[c]) * Scale;
+    }
+}
+
+void WriteTotalsText(std::ostream& out, const std::string& Name, const rep_PerfTotals& T) {
+    out << std::left << std::setw(24) << Name << std::right << std::setw(10) << T.Calls;
+    for (int32_t c = 0; c < NrPerfCounters; ++c) {
+        if (CountersOpened[c]) {
+            out << std::setw(16) << std::fixed << std::setprecision(0) << T.Value[c];
+        } else {
+            out << std::setw(16) << "n/a";
+        }
+    }
+    bool HaveIPC = CountersOpened[0] && CountersOpened[1] && T.Value[0] > 0.0;
+    if (HaveIPC) {
+        out << std::setw(8) << std::setprecision(2) << T.Value[1] / T.Value[0];
+    } else {
+        out << std::setw(8) << "n/a";
+    }
+    out << std::defaultfloat << std::endl;
+}
+
+void WriteTotalsJson(std::ostream& out, const std::string& Name, const rep_PerfTotals& T) {
+    out << "{\"name\": \"" << Name << "\", \"calls\": " << T.Calls;
+    for (int32_t c = 0; c < NrPerfCounters; ++c) {
+        out << ", \"" << PerfCounterName(c) << "\": ";
+        if (CountersOpened[c]) {
+            out << std::fixed << std::setprecision(0) << T.Value[c] << std::defaultfloat;
+        } else {
+            out << "null";
+        }
+    }
+    out << "}";
+}
+
+} // namespace
+
+bool EnablePerfCounters() {
+    int Error = 0;
+    PerfCountersRequested = OpenThreadCounters(&Error);
+    if (!PerfCountersRequested) {
+        std::cerr << "perf: hardware counters unavailable";
+        if (Error != 0) std::cerr << " (" << std::strerror(Error) << ")";
+        std::cerr << "; check /proc/sys/kernel/perf_event_paranoid. Continuing without counters." << std::endl;
+    }
+    return PerfCountersRequested;
+}
+
+bool ReadPerfCounters(rep_PerfSample& Sample) {
+    if (!OpenThreadCounters(nullptr)) return false;
+#ifdef __linux__
+    const rep_PerfThread& T = PerfThread;
+    uint64_t Buffer[3 + NrPerfCounters];
+    ssize_t Size = read(T.GroupFd, Buffer, sizeof(Buffer));
+    if (Size < static_cast<ssize_t>(3 * sizeof(uint64_t))) return false;
+    Sample.TimeEnabled = Buffer[1];
+    Sample.TimeRunning = Buffer[2];
+    for (int32_t c = 0; c < NrPerfCounters; ++c) {
+        Sample.Value[c] = (T.Slot[c] >= 0 && static_cast<uint64_t>(T.Slot[c]) < Buffer[0]) ? Buffer[3 + T.Slot[c]] : 0;
+    }
+    return true;
+#else
+    (void)Sample;
+    return false;
+#endif
+}
+
+void AddPerfRegion(const char* Name, const rep_PerfSample& Begin, const rep_PerfSample& End) {
+    AddDelta(PerfThread.Data.Regions[Name], Begin, End);
+}
+
+void PerfStageMark(BudgetStage Stage) {
+    rep_PerfThread& T = PerfThread;
+    rep_PerfSample Now;
+    if (!ReadPerfCounters(Now)) return;
+    if (Stage != BudgetStage::NrStages && T.HasMark) {
+        AddDelta(T.Data.Stages[static_cast<int32_t>(Stage)], T.LastMark, Now);
+    }
+    T.LastMark = Now;
+    T.HasMark = true;
+}
+
+void WritePerfReport(const std::string& PathName) {
+    if (!PerfCountersEnabled()) return;
+    MergePerfData(PerfThread.Data);
+
+    std::lock_guard<std::mutex> lock(PerfMutex);
+    bool HaveStages = false;
+    for (const rep_PerfTotals& T : PerfTotal.Stages) HaveStages = HaveStages || (T.Calls > 0);
+
+    std::ostream& out = std::cerr;
+    out << "Hardware counters (user space, summed over threads)" << std::endl;
+    out << std::left << std::setw(24) << "region" << std::right << std::setw(10) << "calls";
+    for (int32_t c = 0; c < NrPerfCounters; ++c) out << std::setw(16) << PerfCounterName(c);
+    out << std::setw(8) << "IPC" << std::endl;
+    for (const auto& Region : PerfTotal.Regions) WriteTotalsText(out, Region.first, Region.second);
+    if (HaveStages) {
+        for (int32_t s = 0; s < NrBudgetStages; ++s) {
+            WriteTotalsText(out, std::string("stage/") + BudgetStageName(static_cast<BudgetStage>(s)), PerfTotal.Stages[s]);
+        }
+    } else {
+        out << "(per-stage counters need a build with -DAQUACROP_STAGE_PROFILING=ON)" << std::endl;
+    }
+
+    std::ofstream fjson(PathName + "PerfCounters.json");
+    if (!fjson.is_open()) return;
+    fjson << "{\n  \"regions\": [";
+    bool First = true;
+    for (const auto& Region : PerfTotal.Regions) {
+        fjson << (First ? "\n    " : ",\n    ");
+        WriteTotalsJson(fjson, Region.first, Region.second);
+        First = false;
+    }
+    fjson << "\n  ],\n  \"stages\": [";
+    if (HaveStages) {
+        for (int32_t s = 0; s < NrBudgetStages; ++s) {
+            fjson << ((s == 0) ? "\n    " : ",\n    ");
+            WriteTotalsJson(fjson, BudgetStageName(static_cast<BudgetStage>(s)), PerfTotal.Stages[s]);
+        }
+    }
+    fjson << "\n  ]\n}\n";
+}
+
+} // namespace AquaCrop
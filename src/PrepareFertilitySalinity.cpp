@@ -1,7 +1,382 @@
 #include "AquaCrop/PrepareFertilitySalinity.h"
+#include "AquaCrop/ThreadPool.h"
+#include "AquaCrop/Utils.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace AquaCrop {
 
+namespace {
+
+// Reference climate of the relationships: constant ETo, the temperatures of
+// the simulation parameters and the reference CO2 (no WP adjustment)
+constexpr dp EToStandard = 5.0;
+constexpr int32_t NrFertilityLevels = 8;   // soil fertility stress 0, 10 .. 70 %
+constexpr int32_t NrSaltLevels = 10;       // CCx reduction by salinity 0, 10 .. 90 %
+// Bump when the reference simulation changes, so that on-disk entries of an
+// older version are not used
+constexpr int32_t ReferenceVersion = 1;
+
+// The crop and climate inputs the reference simulation reads
+struct rep_ReferenceCrop {
+    modeCycle ModeCycle;
+    subkind CropSubkind;
+    bool DeterminancyLinked;
+    int32_t L0, L12, L123, L1234, LToFlor, LFlor;
+    int32_t GDDL0, GDDL12, GDDL123, GDDL1234;
+    dp CCo, CCx, CGC, GDDCGC, CDC, GDDCDC;
+    dp KcTop, KcDecline;
+    dp GDDayi, KsTr;
+    dp WP;
+    int32_t WPy;
+};
+
+// Canopy development of one stress level
+struct rep_ReferenceStress {
+    int8_t RedCGC, RedCCX, RedWP;
+    dp CDecline;
+};
+
+struct rep_ReferenceFit {
+    dp b0, b1, b2;
+    std::array<dp, NrSaltLevels - 1> X;   // relative biomass (%) at the stress levels above 0
+};
+
+rep_ReferenceCrop MakeReferenceCrop(
+    modeCycle ModeCycle, subkind CropSubkind, bool DeterminancyLinked,
+    int32_t DaysToGermination, int32_t DaysToFullCanopy, int32_t DaysToSenescence, int32_t DaysToHarvest,
+    int32_t DaysToFlowering, int32_t LengthFlowering,
+    int32_t GDDaysToGermination, int32_t GDDaysToFullCanopy, int32_t GDDaysToSenescence, int32_t GDDaysToHarvest,
+    dp CCo, dp CCx, dp CGC, dp GDDCGC, dp CDC, dp GDDCDC, dp KcTop, dp KcDecline,
+    dp Tbase, dp Tupper, dp Tmin, dp Tmax, dp GDtranspLow, dp WP, int32_t WPy)
+{
+    rep_ReferenceCrop Ref;
+    Ref.ModeCycle = ModeCycle;
+    Ref.CropSubkind = CropSubkind;
+    Ref.DeterminancyLinked = DeterminancyLinked;
+    Ref.L0 = DaysToGermination;
+    Ref.L12 = DaysToFullCanopy;
+    Ref.L123 = DaysToSenescence;
+    Ref.L1234 = DaysToHarvest;
+    Ref.LToFlor = DaysToFlowering;
+    Ref.LFlor = LengthFlowering;
+    Ref.GDDL0 = GDDaysToGermination;
+    Ref.GDDL12 = GDDaysToFullCanopy;
+    Ref.GDDL123 = GDDaysToSenescence;
+    Ref.GDDL1234 = GDDaysToHarvest;
+    Ref.CCo = CCo;
+    Ref.CCx = CCx;
+    Ref.CGC = CGC;
+    Ref.GDDCGC = GDDCGC;
+    Ref.CDC = CDC;
+    Ref.GDDCDC = GDDCDC;
+    Ref.KcTop = KcTop;
+    Ref.KcDecline = KcDecline;
+    // the reference day is the same every day of the cycle; read here, on the
+    // calling thread, since simulparam is per thread
+    Ref.GDDayi = DegreesDay(Tbase, Tupper, Tmin, Tmax, simulparam.GDDMethod);
+    Ref.KsTr = (GDtranspLow > 0.0) ? KsTemperature(0.0, GDtranspLow, Ref.GDDayi) : 1.0;
+    Ref.WP = WP;
+    Ref.WPy = WPy;
+    return Ref;
+}
+
+// Biomass (ton/ha) of the reference season without water stress, for the
+// canopy development of one stress level
+dp ReferenceBiomass(const rep_ReferenceCrop& Ref, rep_ReferenceStress Stress)
+{
+    int32_t L12SF = Ref.L12;
+    int32_t GDDL12SF = Ref.GDDL12;
+    int32_t ClassSF = 1;
+    dp RatDGDD = 1.0;
+    dp SumGDD = 0.0;
+    dp Biomass = 0.0;
+
+    // adjusted length of the period to maximum canopy cover
+    TimeToMaxCanopySF(Ref.CCo, Ref.CGC, Ref.CCx, Ref.L0, Ref.L12, Ref.L123, Ref.LToFlor, Ref.LFlor,
+                      Ref.DeterminancyLinked, L12SF, Stress.RedCGC, Stress.RedCCX, ClassSF);
+    if (Ref.ModeCycle == modeCycle::GDDays && L12SF != Ref.L12) {
+        GDDL12SF = static_cast<int32_t>(roundc(static_cast<dp>(L12SF) * Ref.GDDayi, 1));
+        if (Ref.GDDL123 > GDDL12SF && Ref.L123 > L12SF) {
+            RatDGDD = static_cast<dp>(Ref.L123 - L12SF) / static_cast<dp>(Ref.GDDL123 - GDDL12SF);
+        }
+    }
+
+    const dp WPStress = Ref.WP * (1.0 - static_cast<dp>(Stress.RedWP) / 100.0);
+    const bool YieldFormation = (Ref.CropSubkind == subkind::Grain || Ref.CropSubkind == subkind::Tuber)
+                             && Ref.WPy != 100;
+    for (int32_t Dayi = 1; Dayi <= Ref.L1234; ++Dayi) {
+        SumGDD += Ref.GDDayi;
+        dp CCi = CCiNoWaterStressSF(Dayi, Ref.L0, L12SF, Ref.L123, Ref.L1234, Ref.GDDL0, GDDL12SF, Ref.GDDL123,
+                                    Ref.GDDL1234, Ref.CCo, Ref.CCx, Ref.CGC, Ref.GDDCGC, Ref.CDC, Ref.GDDCDC,
+                                    SumGDD, RatDGDD, Stress.RedCGC, Stress.RedCCX, Stress.CDecline, Ref.ModeCycle);
+        if (CCi <= 0.0) continue;
+        // canopy cover with micro-advection, and the ageing of the canopy
+        // once maximum canopy cover is reached
+        dp CCstar = std::min(1.0, 1.72 * CCi - CCi * CCi + 0.30 * CCi * CCi * CCi);
+        dp Kc = Ref.KcTop;
+        if (Dayi > L12SF + 5) Kc -= static_cast<dp>(Dayi - L12SF - 5) * Ref.KcDecline / 100.0;
+        if (Kc <= 0.0) continue;
+        dp Tpot = Kc * CCstar * EToStandard * Ref.KsTr;
+
+        dp WPi = WPStress;
+        if (YieldFormation && Dayi > Ref.LToFlor) WPi *= static_cast<dp>(Ref.WPy) / 100.0;
+        Biomass += 0.01 * WPi * (Tpot / EToStandard);
+    }
+    return Biomass;
+}
+
+// y = b0 + b1 x + b2 x^2 by least squares; false when the points do not
+// determine a quadratic (e.g. a stress without any effect on the biomass)
+bool QuadraticRegression(int32_t NrPoints, const dp* x, const dp* y, dp& b0, dp& b1, dp& b2)
+{
+    dp Sx = 0.0, Sx2 = 0.0, Sx3 = 0.0, Sx4 = 0.0, Sy = 0.0, Sxy = 0.0, Sx2y = 0.0;
+    for (int32_t i = 0; i < NrPoints; ++i) {
+        dp x2 = x[i] * x[i];
+        Sx += x[i];
+        Sx2 += x2;
+        Sx3 += x2 * x[i];
+        Sx4 += x2 * x2;
+        Sy += y[i];
+        Sxy += x[i] * y[i];
+        Sx2y += x2 * y[i];
+    }
+    const dp n = static_cast<dp>(NrPoints);
+    // Cramer's rule on the normal equations
+    auto Det3 = [](dp a, dp b, dp c, dp d, dp e, dp f, dp g, dp h, dp i) {
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    };
+    dp D = Det3(n, Sx, Sx2, Sx, Sx2, Sx3, Sx2, Sx3, Sx4);
+    if (std::abs(D) <= 1e-9 * std::max(1.0, Sx4 * Sx4)) return false;
+    b0 = Det3(Sy, Sx, Sx2, Sxy, Sx2, Sx3, Sx2y, Sx3, Sx4) / D;
+    b1 = Det3(n, Sy, Sx2, Sx, Sxy, Sx3, Sx2, Sx2y, Sx4) / D;
+    b2 = Det3(n, Sx, Sy, Sx, Sx2, Sxy, Sx2, Sx3, Sx2y) / D;
+    return true;
+}
+
+// Reference biomass for all stress levels, in parallel. The simulations only
+// read Ref, so the workers need none of the thread_local simulation state.
+// A caller that already is a pool worker (one run of a calibration batch)
+// simulates the levels itself.
+std::vector<dp> ReferenceBiomassLevels(const rep_ReferenceCrop& Ref, const std::vector<rep_ReferenceStress>& Levels)
+{
+    const int32_t NrLevels = static_cast<int32_t>(Levels.size());
+    std::vector<dp> Biomass(Levels.size(), 0.0);
+    auto Simulate = [&](int32_t Item) { Biomass[Item] = ReferenceBiomass(Ref, Levels[Item]); };
+    if (ThreadPool::OnWorker()) {
+        for (int32_t Item = 0; Item < NrLevels; ++Item) Simulate(Item);
+    } else {
+        ThreadPool Pool(static_cast<int32_t>(std::min<unsigned>(std::max(1u, std::thread::hardware_concurrency()),
+                                                                static_cast<unsigned>(NrLevels))));
+        Pool.ParallelFor(NrLevels, Simulate);
+    }
+    return Biomass;
+}
+
+rep_ReferenceFit FitFertilityRelationship(const rep_ReferenceCrop& Ref, const rep_Shapes& StressResponse)
+{
+    std::vector<rep_ReferenceStress> Levels(NrFertilityLevels);
+    for (int32_t Si = 1; Si <= NrFertilityLevels; ++Si) {
+        rep_EffectStress Effect;
+        CropStressParametersSoilFertility(StressResponse, 10 * (Si - 1), Effect);
+        Levels[Si-1] = {Effect.RedCGC, Effect.RedCCX, Effect.RedWP, Effect.CDecline};
+    }
+    std::vector<dp> Biomass = ReferenceBiomassLevels(Ref, Levels);
+
+    // soil fertility stress (%) as a function of the relative biomass (%)
+    std::array<dp, NrFertilityLevels> BioMProc, StressProc;
+    for (int32_t Si = 1; Si <= NrFertilityLevels; ++Si) {
+        BioMProc[Si-1] = (Biomass[0] > 0.0) ? 100.0 * Biomass[Si-1] / Biomass[0] : 100.0;
+        StressProc[Si-1] = 10.0 * static_cast<dp>(Si - 1);
+    }
+    rep_ReferenceFit Fit;
+    if (!QuadraticRegression(NrFertilityLevels, BioMProc.data(), StressProc.data(), Fit.b0, Fit.b1, Fit.b2)) {
+        Fit.b0 = undef_double;
+        Fit.b1 = undef_double;
+        Fit.b2 = undef_double;
+    }
+    Fit.X.fill(undef_double);
+    for (int32_t Si = 2; Si <= NrFertilityLevels; ++Si) Fit.X[Si-2] = BioMProc[Si-1];
+    return Fit;
+}
+
+rep_ReferenceFit FitSaltRelationship(const rep_ReferenceCrop& Ref, int8_t CCsaltDistortion)
+{
+    // salinity reduces CCx; the distortion of the canopy slows its growth too
+    std::vector<rep_ReferenceStress> Levels(NrSaltLevels);
+    for (int32_t Si = 1; Si <= NrSaltLevels; ++Si) {
+        int32_t CCxRed = 10 * (Si - 1);
+        int32_t CGCRed = static_cast<int32_t>(roundc(static_cast<dp>(CCxRed) * static_cast<dp>(CCsaltDistortion) / 100.0, 1));
+        Levels[Si-1] = {static_cast<int8_t>(std::min(CGCRed, 100)), static_cast<int8_t>(CCxRed), 0, 0.0};
+    }
+    std::vector<dp> Biomass = ReferenceBiomassLevels(Ref, Levels);
+
+    // CCx reduction (%) as a function of the salt stress (%), the reduction
+    // of the biomass
+    std::array<dp, NrSaltLevels> SaltProc, CCxRedProc;
+    rep_ReferenceFit Fit;
+    for (int32_t Si = 1; Si <= NrSaltLevels; ++Si) {
+        dp BioMProc = (Biomass[0] > 0.0) ? 100.0 * Biomass[Si-1] / Biomass[0] : 100.0;
+        SaltProc[Si-1] = 100.0 - BioMProc;
+        CCxRedProc[Si-1] = 10.0 * static_cast<dp>(Si - 1);
+        if (Si > 1) Fit.X[Si-2] = BioMProc;
+    }
+    if (!QuadraticRegression(NrSaltLevels, SaltProc.data(), CCxRedProc.data(), Fit.b0, Fit.b1, Fit.b2)) {
+        Fit.b0 = undef_double;
+        Fit.b1 = undef_double;
+        Fit.b2 = undef_double;
+    }
+    return Fit;
+}
+
+// ---------------------------------------------------------------------------
+// Cache of the fitted relationships. The key holds every input the reference
+// simulation reads, so runs that differ only in other crop parameters share
+// an entry. Entries live for the process; with AQUACROP_REFERENCE_CACHE set to
+// a directory they are also kept there, one file per key, for later runs.
+
+template <typename T>
+void PutKey(std::string& Key, T Value)
+{
+    char Bytes[sizeof(T)];
+    std::memcpy(Bytes, &Value, sizeof(T));
+    Key.append(Bytes, sizeof(T));
+}
+
+std::string ReferenceKey(char Kind, const rep_ReferenceCrop& Ref)
+{
+    std::string Key;
+    Key.reserve(160);
+    PutKey(Key, Kind);
+    PutKey(Key, ReferenceVersion);
+    PutKey(Key, static_cast<int32_t>(Ref.ModeCycle));
+    PutKey(Key, static_cast<int32_t>(Ref.CropSubkind));
+    PutKey(Key, Ref.DeterminancyLinked);
+    for (int32_t L : {Ref.L0, Ref.L12, Ref.L123, Ref.L1234, Ref.LToFlor, Ref.LFlor,
+                      Ref.GDDL0, Ref.GDDL12, Ref.GDDL123, Ref.GDDL1234, Ref.WPy}) {
+        PutKey(Key, L);
+    }
+    for (dp x : {Ref.CCo, Ref.CCx, Ref.CGC, Ref.GDDCGC, Ref.CDC, Ref.GDDCDC, Ref.KcTop, Ref.KcDecline,
+                 Ref.GDDayi, Ref.KsTr, Ref.WP}) {
+        PutKey(Key, x);
+    }
+    return Key;
+}
+
+// FNV-1a, 64 bit
+uint64_t HashKey(const std::string& Key)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : Key) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+struct KeyHash {
+    size_t operator()(const std::string& Key) const { return static_cast<size_t>(HashKey(Key)); }
+};
+
+std::mutex CacheMutex;
+std::unordered_map<std::string, rep_ReferenceFit, KeyHash> FitCache;
+std::atomic<int64_t> NrFits{0};
+
+std::string HexString(const std::string& Bytes)
+{
+    static const char Digits[] = "0123456789abcdef";
+    std::string Hex;
+    Hex.reserve(2 * Bytes.size());
+    for (unsigned char c : Bytes) {
+        Hex += Digits[c >> 4];
+        Hex += Digits[c & 0x0f];
+    }
+    return Hex;
+}
+
+std::string DiskCacheFile(const std::string& Key)
+{
+    const char* Dir = std::getenv("AQUACROP_REFERENCE_CACHE");
+    if (Dir == nullptr || *Dir == '\0') return "";
+    char Name[32];
+    std::snprintf(Name, sizeof(Name), "%016llx.ref", static_cast<unsigned long long>(HashKey(Key)));
+    std::string Path = Dir;
+    if (Path.back() != '/') Path += '/';
+    return Path + Name;
+}
+
+// The file holds the key (a hash collision is read as a miss), then the
+// coefficients and X10.. with all digits
+bool ReadDiskCache(const std::string& File, const std::string& Key, rep_ReferenceFit& Fit)
+{
+    std::ifstream In(File);
+    if (!In.is_open()) return false;
+    std::string StoredKey;
+    In >> StoredKey;
+    if (StoredKey != HexString(Key)) return false;
+    In >> Fit.b0 >> Fit.b1 >> Fit.b2;
+    for (dp& x : Fit.X) In >> x;
+    return !In.fail();
+}
+
+void WriteDiskCache(const std::string& File, const std::string& Key, const rep_ReferenceFit& Fit)
+{
+    // written aside and renamed, so that concurrent processes read whole files
+    std::ostringstream Temp;
+    Temp << File << ".tmp" << std::this_thread::get_id();
+    {
+        std::ofstream Out(Temp.str());
+        if (!Out.is_open()) {
+            std::cerr << "Reference relationship cache not written: " << File << std::endl;
+            return;
+        }
+        Out << HexString(Key) << '\n' << std::setprecision(17) << Fit.b0 << ' ' << Fit.b1 << ' ' << Fit.b2 << '\n';
+        for (dp x : Fit.X) Out << x << ' ';
+        Out << '\n';
+    }
+    if (std::rename(Temp.str().c_str(), File.c_str()) != 0) {
+        std::cerr << "Reference relationship cache not written: " << File << std::endl;
+        std::remove(Temp.str().c_str());
+    }
+}
+
+template <typename FitFn>
+rep_ReferenceFit CachedFit(const std::string& Key, FitFn Fitter)
+{
+    {
+        std::lock_guard<std::mutex> Lock(CacheMutex);
+        auto It = FitCache.find(Key);
+        if (It != FitCache.end()) return It->second;
+    }
+    rep_ReferenceFit Fit;
+    std::string File = DiskCacheFile(Key);
+    if (File.empty() || !ReadDiskCache(File, Key, Fit)) {
+        Fit = Fitter();
+        ++NrFits;
+        if (!File.empty()) WriteDiskCache(File, Key, Fit);
+    }
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    FitCache.emplace(Key, Fit);
+    return Fit;
+}
+
+} // namespace
+
 void ReferenceStressBiomassRelationship(
     int32_t DaysToCCini, int32_t GDDaysToCCini, int32_t DaysToGermination,
     int32_t DaysToFullCanopy, int32_t DaysToSenescence, int32_t DaysToHarvest,
@@ -18,10 +393,26 @@ void ReferenceStressBiomassRelationship(
     int32_t GDDaysToFlowering, int32_t GDDLengthFlowering,
     int32_t GDDaysToHIo, plant Planting, int32_t DaysToHIo)
 {
-    // Placeholder
-    Coeffb0 = 0.0;
-    Coeffb1 = 0.0;
-    Coeffb2 = 0.0;
+    rep_ReferenceCrop Ref = MakeReferenceCrop(ModeCycle, CropSubkind, DeterminancyLinked,
+        DaysToGermination, DaysToFullCanopy, DaysToSenescence, DaysToHarvest, DaysToFlowering, LengthFlowering,
+        GDDaysToGermination, GDDaysToFullCanopy, GDDaysToSenescence, GDDaysToHarvest,
+        CCo, CCx, CGC, GDDCGC, CDC, GDDCDC, KcTop, KcDecline, Tbase, Tupper, Tmin, Tmax, GDtranspLow, WP, WPy);
+    std::string Key = ReferenceKey('F', Ref);
+    for (dp Shape : {StressResponse.ShapeCGC, StressResponse.ShapeCCX, StressResponse.ShapeWP, StressResponse.ShapeCDecline}) {
+        PutKey(Key, Shape);
+    }
+
+    rep_ReferenceFit Fit = CachedFit(Key, [&] { return FitFertilityRelationship(Ref, StressResponse); });
+    Coeffb0 = Fit.b0;
+    Coeffb1 = Fit.b1;
+    Coeffb2 = Fit.b2;
+    X10 = Fit.X[0];
+    X20 = Fit.X[1];
+    X30 = Fit.X[2];
+    X40 = Fit.X[3];
+    X50 = Fit.X[4];
+    X60 = Fit.X[5];
+    X70 = Fit.X[6];
 }
 
 void ReferenceCCxSaltStressRelationship(
@@ -40,10 +431,37 @@ void ReferenceCCxSaltStressRelationship(
     dp& X10, dp& X20, dp& X30, dp& X40, dp& X50, dp& X60, dp& X70, dp& X80, dp& X90,
     int32_t GDDaysToHIo, plant Planting, int32_t DaysToHIo)
 {
-    // Placeholder
-    Coeffb0Salt = 0.0;
-    Coeffb1Salt = 0.0;
-    Coeffb2Salt = 0.0;
+    rep_ReferenceCrop Ref = MakeReferenceCrop(ModeCycle, CropSubkind, DeterminancyLinked,
+        DaysToGermination, DaysToFullCanopy, DaysToSenescence, DaysToHarvest, DaysToFlowering, LengthFlowering,
+        GDDaysToGermination, GDDaysToFullCanopy, GDDaysToSenescence, GDDaysToHarvest,
+        CCo, CCx, CGC, GDDCGC, CDC, GDDCDC, KcTop, KcDecline, Tbase, Tupper, Tmin, Tmax, GDtranspLow, WP, WPy);
+    std::string Key = ReferenceKey('S', Ref);
+    PutKey(Key, CCsaltDistortion);
+
+    rep_ReferenceFit Fit = CachedFit(Key, [&] { return FitSaltRelationship(Ref, CCsaltDistortion); });
+    Coeffb0Salt = Fit.b0;
+    Coeffb1Salt = Fit.b1;
+    Coeffb2Salt = Fit.b2;
+    X10 = Fit.X[0];
+    X20 = Fit.X[1];
+    X30 = Fit.X[2];
+    X40 = Fit.X[3];
+    X50 = Fit.X[4];
+    X60 = Fit.X[5];
+    X70 = Fit.X[6];
+    X80 = Fit.X[7];
+    X90 = Fit.X[8];
+}
+
+void ClearReferenceRelationshipCache()
+{
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    FitCache.clear();
+}
+
+int64_t NrReferenceRelationshipFits()
+{
+    return NrFits.load();
 }
 
 }
@@ -1,19 +1,49 @@
 #include "AquaCrop/ProjectInput.h"
 #include "AquaCrop/Utils.h"
 #include "AquaCrop/Global.h" // For split/parsing helpers if needed, or I'll reimplement/use existing helpers
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace AquaCrop {
 
-std::vector<ProjectInput_type> ProjectInput;
+namespace {
+
+struct rep_ProjectCacheEntry {
+    std::filesystem::file_time_type WriteTime;
+    std::shared_ptr<const std::vector<ProjectInput_type>> Runs;
+};
+
+// Parsed project files shared by all threads, keyed by file name and the
+// requested number of runs
+std::mutex ProjectCacheMutex;
+std::map<std::pair<std::string, int32_t>, rep_ProjectCacheEntry> ProjectCache;
+
+} // namespace
 
 void allocate_project_input(int32_t NrRuns) {
     ProjectInput.resize(NrRuns);
 }
 
 void initialize_project_input(const std::string& filename, int32_t NrRuns) {
+    // every run re-reads the file from the top, so a PRM costs O(NrRuns^2)
+    // lines; repeated simulations of a project (calibration, sensitivity)
+    // copy the parsed runs instead
+    std::error_code ec;
+    std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(filename, ec);
+    if (!ec) {
+        std::lock_guard<std::mutex> lock(ProjectCacheMutex);
+        auto it = ProjectCache.find({filename, NrRuns});
+        if (it != ProjectCache.end() && it->second.WriteTime == WriteTime) {
+            ProjectInput = *it->second.Runs;
+            return;
+        }
+    }
+
     int32_t NrRuns_local;
 
     if (NrRuns != -1) {
@@ -26,6 +56,16 @@ void initialize_project_input(const std::string& filename, int32_t NrRuns) {
     for (int32_t i = 1; i <= NrRuns_local; ++i) {
         ProjectInput[i - 1].read_project_file(filename, i);
     }
+
+    if (!ec) {
+        std::lock_guard<std::mutex> lock(ProjectCacheMutex);
+        ProjectCache[{filename, NrRuns}] = {WriteTime, std::make_shared<const std::vector<ProjectInput_type>>(ProjectInput)};
+    }
+}
+
+void ClearProjectInputCache() {
+    std::lock_guard<std::mutex> lock(ProjectCacheMutex);
+    ProjectCache.clear();
 }
 
 void ReadNumberSimulationRuns(const std::string& TempFileNameFull, int32_t& NrRuns) {
@@ -109,10 +149,6 @@ void ProjectInput_type::read_project_file(const std::string& filename, int32_t N
     fhandle >> Crop_DayN;
     std::getline(fhandle, line); // consume rest of line
 
-    std::cout << "    DEBUG: read run " << NrRun << ": YearSeason=" << (int)Simulation_YearSeason 
-              << " SimDay1=" << Simulation_DayNr1 << " SimDayN=" << Simulation_DayNrN 
-              << " CropDay1=" << Crop_Day1 << " CropDayN=" << Crop_DayN << std::endl;
-
     auto read_section = [&](std::string& info, std::string& fname, std::string& dir) {
         if (!std::getline(fhandle, info)) return;
         if (!std::getline(fhandle, fname)) return;
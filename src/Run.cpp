@@ -1,4 +1,5 @@
 #include "AquaCrop/Run.h"
+#include "AquaCrop/Calibration.h"
 #include "AquaCrop/Global.h"
 #include "AquaCrop/Utils.h"
 #include "AquaCrop/Simul.h"
@@ -9,35 +10,45 @@
 #include "AquaCrop/InfoResults.h"
 #include "AquaCrop/InitialSettings.h"
 #include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/CropCalendar.h"
+#include "AquaCrop/RunConstants.h"
+#include "AquaCrop/SoilState.h"
+#include "AquaCrop/EventTimeline.h"
+#include "AquaCrop/StageProfile.h"
+#include "AquaCrop/Scheduling.h"
+#include "AquaCrop/Sweep.h"
+#include "AquaCrop/Instrument.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <cmath>
+#include <type_traits>
+#include <memory>
+#include <array>
+#include <algorithm>
 
 namespace AquaCrop {
 
 namespace {
 
 // Module variables from ac_run
-std::string TheProjectFile;
-
-std::ofstream fDaily;
-std::ofstream fRun;
-std::ofstream fIrri;
-std::ofstream fEToSIM;
-std::ofstream fEval;
-std::ofstream fRainSIM;
-std::ofstream fTempSIM;
-std::ifstream fCuts;
-std::ifstream fObs;
-std::ofstream fHarvest;
-std::ofstream fIrrInfo;
-
-std::string fHarvest_filename;
-std::string fIrrInfo_filename;
-std::string fEval_filename;
+thread_local std::string TheProjectFile;
+
+thread_local std::ofstream fDaily;
+thread_local std::ofstream fRun;
+thread_local std::ofstream fIrri;
+thread_local std::ofstream fEToSIM;
+thread_local std::ofstream fEval;
+thread_local std::ofstream fRainSIM;
+thread_local std::ofstream fTempSIM;
+thread_local std::ofstream fHarvest;
+thread_local std::ofstream fIrrInfo;
+
+thread_local std::string fHarvest_filename;
+thread_local std::string fIrrInfo_filename;
+thread_local std::string fEval_filename;
 
 struct rep_GwTable {
     int32_t DNr1, DNr2;
@@ -82,70 +93,76 @@ struct rep_Transfer {
     dp Bmobilized;
 };
 
-rep_GwTable GwTable;
-std::vector<rep_DayEventDbl> EToDataSet(31);
-std::vector<rep_DayEventDbl> RainDataSet(31);
-rep_plotPar PlotVarCrop;
-repIrriInfoRecord IrriInfoRecord1, IrriInfoRecord2;
-rep_StressTot StressTot;
-repCutInfoRecord CutInfoRecord1, CutInfoRecord2;
-rep_Transfer Transfer;
-std::vector<rep_DayEventDbl> TminDataSet(31);
-std::vector<rep_DayEventDbl> TmaxDataSet(31);
-rep_sum PreviousSum;
-
-int32_t DayNri;
-int32_t IrriInterval;
-int32_t Tadj, GDDTadj;
-int32_t DayLastCut, NrCut, SumInterval;
-int32_t PreviousStressLevel, StressSFadjNEW;
-int32_t RepeatToDay;
-
-dp Bin;
-dp Bout;
-dp GDDayi;
-dp CO2i;
-dp FracBiomassPotSF;
-dp SumETo, SumGDD, Ziprev, SumGDDPrev;
-dp CCxWitheredTpotNoS;
-dp Coeffb0, Coeffb1, Coeffb2;
-dp Coeffb0Salt, Coeffb1Salt, Coeffb2Salt;
-dp StressLeaf, StressSenescence;
-dp DayFraction, GDDayFraction;
-dp CGCref, GDDCGCref;
-dp TimeSenescence;
-dp SumKcTop, SumKcTopStress, SumKci;
-dp CCoTotal, CCxTotal, CDCTotal, GDDCDCTotal, CCxCropWeedsNoSFstress;
-dp WeedRCi, CCiActualWeedInfested, fWeedNoS, Zeval;
-dp BprevSum, YprevSum, SumGDDcuts, HItimesBEF;
-dp ScorAT1, ScorAT2, HItimesAT1, HItimesAT2, HItimesAT;
-dp alfaHI, alfaHIAdj;
-dp SumGDDadjCC, FracAssim;
-
-int32_t NextSimFromDayNr;
-int32_t DayNr1Eval, DayNrEval;
-int8_t LineNrEval;
-
-dp PreviousSumETo, PreviousSumGDD, PreviousBmob, PreviousBsto;
-int8_t StageCode;
-int32_t PreviousDayNr;
-bool NoYear;
-
-bool WaterTableInProfile, StartMode, NoMoreCrop;
-bool GlobalIrriECw;
-int32_t LastIrriDAP;
+thread_local rep_GwTable GwTable;
+thread_local std::vector<rep_DayEventDbl> EToDataSet(31);
+thread_local std::vector<rep_DayEventDbl> RainDataSet(31);
+thread_local rep_plotPar PlotVarCrop;
+thread_local repIrriInfoRecord IrriInfoRecord1, IrriInfoRecord2;
+thread_local rep_StressTot StressTot;
+thread_local repCutInfoRecord CutInfoRecord1, CutInfoRecord2;
+thread_local rep_Transfer Transfer;
+thread_local std::vector<rep_DayEventDbl> TminDataSet(31);
+thread_local std::vector<rep_DayEventDbl> TmaxDataSet(31);
+thread_local rep_sum PreviousSum;
+
+thread_local int32_t DayNri;
+thread_local int32_t IrriInterval;
+thread_local int32_t Tadj, GDDTadj;
+thread_local int32_t DayLastCut, NrCut, SumInterval;
+thread_local int32_t PreviousStressLevel, StressSFadjNEW;
+thread_local int32_t RepeatToDay;
+
+thread_local dp Bin;
+thread_local dp Bout;
+thread_local dp GDDayi;
+thread_local dp CO2i;
+thread_local dp FracBiomassPotSF;
+thread_local dp SumETo, SumGDD, Ziprev, SumGDDPrev;
+thread_local dp CCxWitheredTpotNoS;
+thread_local dp Coeffb0, Coeffb1, Coeffb2;
+thread_local dp Coeffb0Salt, Coeffb1Salt, Coeffb2Salt;
+thread_local dp StressLeaf, StressSenescence;
+thread_local dp DayFraction, GDDayFraction;
+thread_local dp CGCref, GDDCGCref;
+thread_local dp TimeSenescence;
+thread_local dp SumKcTop, SumKcTopStress, SumKci;
+thread_local dp CCoTotal, CCxTotal, CDCTotal, GDDCDCTotal, CCxCropWeedsNoSFstress;
+thread_local dp WeedRCi, CCiActualWeedInfested, fWeedNoS, Zeval;
+thread_local dp BprevSum, YprevSum, SumGDDcuts, HItimesBEF;
+thread_local dp ScorAT1, ScorAT2, HItimesAT1, HItimesAT2, HItimesAT;
+thread_local dp alfaHI, alfaHIAdj;
+thread_local dp SumGDDadjCC, FracAssim;
+
+thread_local int32_t NextSimFromDayNr;
+thread_local int32_t DayNr1Eval, DayNrEval;
+thread_local int8_t LineNrEval;
+
+thread_local dp PreviousSumETo, PreviousSumGDD, PreviousBmob, PreviousBsto;
+thread_local int8_t StageCode;
+thread_local int32_t PreviousDayNr;
+thread_local bool NoYear;
+
+thread_local bool WaterTableInProfile, StartMode, NoMoreCrop;
+thread_local bool GlobalIrriECw;
+thread_local int32_t LastIrriDAP;
+
+// Day at which the daily loop of the next run stops (SetRunStop), the state
+// it continues from (SetRunResume) and the state of the last stopped run
+thread_local int32_t RunStopDayNr = undef_int;
+thread_local std::shared_ptr<const rep_RunState> RunResumeState;
+thread_local std::shared_ptr<const rep_RunState> RunStoppedState;
 
 // Forward declarations of local functions
 void InitializeSimulationRunPart1();
 void InitializeClimate();
 void InitializeSimulationRunPart2();
 void InitializeRunPart2();
-void FileManagement();
+bool FileManagement(const rep_RunState* Resume);
 void FinalizeRun1(int8_t NrRun, const std::string& TheProjectFile, typeproject TheProjectType);
 void FinalizeRun2(int8_t NrRun, typeproject TheProjectType);
 void CreateDailyClimFiles(int32_t FromSimDay, int32_t ToSimDay);
 void OpenClimFilesAndGetDataFirstDay(int32_t FirstDayNr);
-void AdvanceOneTimeStep(dp& WPi, bool& HarvestNow);
+void AdvanceOneTimeStep(BudgetModuleFn BudgetStep, dp& WPi, bool& HarvestNow);
 void ReadClimateNextDay();
 void SetGDDVariablesNextDay();
 void WriteTitleDailyResults(typeproject TheProjectType, int8_t TheNrRun);
@@ -163,7 +180,7 @@ void CloseIrrigationFile();
 void CloseManagementFile();
 void ResetCropAndSimulationPeriod(int32_t NewCropDay1);
 void GetGwtSet(int32_t DayNrIN, rep_GwTable& GwT);
-void GetZandECgwt(int32_t& ZiAqua, dp& ECiAqua);
+void GetZandECgwt(dp& ZiAqua, dp& ECiAqua);
 void CheckForPrint(const std::string& TheProjectFile);
 void WriteTheResults(int8_t ANumber, int32_t Day1, int32_t Month1, int32_t Year1, int32_t DayN, int32_t MonthN, int32_t YearN, dp RPer, dp EToPer, dp GDDPer, dp IrriPer, dp InfiltPer, dp ROPer, dp DrainPer, dp CRwPer, dp EPer, dp ExPer, dp TrPer, dp TrWPer, dp TrxPer, dp SalInPer, dp SalOutPer, dp SalCRPer, dp BiomassPer, dp BUnlimPer, dp BmobPer, dp BstoPer, const std::string& TheProjectFile);
 void DetermineGrowthStage(int32_t Dayi, dp CCiPrev);
@@ -179,21 +196,106 @@ void AdjustSWCRootZone(dp& PreIrri);
 void GetIrriParam(int32_t& TargetTimeVal, int32_t& TargetDepthVal);
 int32_t IrriManual();
 int32_t IrriOutSeason();
-void OpenIrrigationFile();
 void RecordHarvest(int32_t NrCut, int32_t DayInSeason);
 void WriteDailyResults(int32_t DAP, dp WPi);
 void WriteIrrInfo();
 void WriteEvaluationData(int32_t DAP);
+void WriteRunEvaluation(const rep_RunResult& Result);
 void AdjustCompartments();
 
 } // namespace
 
-void RunSimulation(const std::string& TheProjectFile_, typeproject TheProjectType)
+// Everything the daily loop reads and changes: the simulation state of
+// Global.h and of this file, the position in the event timeline and the
+// fit accumulators
+#define AQUACROP_RUN_STATE(X) \
+    X(Management) X(crop) X(Soil) X(Simulation) X(SumWaBal) X(RootZoneWC) X(RootZoneSalt) \
+    X(TotalSaltContent) X(TotalWaterContent) X(Compartment) X(CompartmentSalt) X(soillayer) X(NrCompartments) \
+    X(ZiAqua) X(ECiAqua) X(DaySubmerged) X(CCiActual) X(CCiprev) X(CCiTopEarlySen) X(CRsalt) \
+    X(CRwater) X(ECdrain) X(ECstorage) X(Eact) X(Epot) X(ETo) X(Drain) X(Infiltrated) X(Irrigation) \
+    X(Rain) X(RootingDepth) X(Runoff) X(SaltInfiltr) X(Surf0) X(SurfaceStorage) X(Tact) X(Tpot) \
+    X(TactWeedInfested) X(Tmax) X(Tmin) X(PreDay) X(EvapoEntireSoilSurface) \
+    X(GwTable) X(PlotVarCrop) X(IrriInfoRecord1) X(IrriInfoRecord2) X(StressTot) X(CutInfoRecord1) \
+    X(CutInfoRecord2) X(Transfer) X(PreviousSum) X(DayNri) X(IrriInterval) X(Tadj) X(GDDTadj) \
+    X(DayLastCut) X(NrCut) X(SumInterval) X(PreviousStressLevel) X(StressSFadjNEW) X(Bin) X(Bout) \
+    X(GDDayi) X(CO2i) X(FracBiomassPotSF) X(SumETo) X(SumGDD) X(Ziprev) X(SumGDDPrev) \
+    X(CCxWitheredTpotNoS) X(Coeffb0) X(Coeffb1) X(Coeffb2) X(Coeffb0Salt) X(Coeffb1Salt) \
+    X(Coeffb2Salt) X(StressLeaf) X(StressSenescence) X(DayFraction) X(GDDayFraction) X(CGCref) \
+    X(GDDCGCref) X(TimeSenescence) X(SumKcTop) X(SumKcTopStress) X(SumKci) X(CCoTotal) X(CCxTotal) \
+    X(CDCTotal) X(GDDCDCTotal) X(CCxCropWeedsNoSFstress) X(WeedRCi) X(CCiActualWeedInfested) \
+    X(Zeval) X(BprevSum) X(YprevSum) X(SumGDDcuts) X(HItimesBEF) X(ScorAT1) X(ScorAT2) \
+    X(HItimesAT1) X(HItimesAT2) X(HItimesAT) X(alfaHI) X(alfaHIAdj) X(SumGDDadjCC) X(FracAssim) \
+    X(DayNr1Eval) X(DayNrEval) X(LineNrEval) X(PreviousSumETo) X(PreviousSumGDD) X(PreviousBmob) \
+    X(PreviousBsto) X(StageCode) X(PreviousDayNr) X(NoYear) X(WaterTableInProfile) X(StartMode) \
+    X(NoMoreCrop) X(GlobalIrriECw) X(LastIrriDAP)
+
+struct rep_RunState {
+#define AQUACROP_RUN_STATE_MEMBER(Name) std::remove_cv_t<decltype(AquaCrop::Name)> Name;
+    AQUACROP_RUN_STATE(AQUACROP_RUN_STATE_MEMBER)
+#undef AQUACROP_RUN_STATE_MEMBER
+    size_t EventCursor, EventDayEnd;
+    std::array<rep_FitAccumulator, NrObsSim> Fit;
+    bool HarvestNow;
+};
+
+namespace {
+
+std::shared_ptr<const rep_RunState> SaveRunState(bool HarvestNow)
+{
+    auto State = std::make_shared<rep_RunState>();
+#define AQUACROP_RUN_STATE_SAVE(Name) State->Name = Name;
+    AQUACROP_RUN_STATE(AQUACROP_RUN_STATE_SAVE)
+#undef AQUACROP_RUN_STATE_SAVE
+    State->EventCursor = EventTimeline.Cursor;
+    State->EventDayEnd = EventTimeline.DayEnd;
+    State->Fit = RunEvaluation.Fit;
+    State->HarvestNow = HarvestNow;
+    return State;
+}
+
+// The run is initialized as usual (its event timeline included) before the
+// state of the earlier segment replaces the daily state
+void RestoreRunState(const rep_RunState& State)
+{
+#define AQUACROP_RUN_STATE_RESTORE(Name) Name = State.Name;
+    AQUACROP_RUN_STATE(AQUACROP_RUN_STATE_RESTORE)
+#undef AQUACROP_RUN_STATE_RESTORE
+    EventTimeline.Cursor = State.EventCursor;
+    EventTimeline.DayEnd = State.EventDayEnd;
+    RunEvaluation.Fit = State.Fit;
+}
+
+} // namespace
+
+void SetRunStop(int32_t StopDayNr)
+{
+    RunStopDayNr = StopDayNr;
+}
+
+void SetRunResume(std::shared_ptr<const rep_RunState> State)
+{
+    RunResumeState = std::move(State);
+}
+
+std::shared_ptr<const rep_RunState> TakeRunState()
+{
+    return std::move(RunStoppedState);
+}
+
+int32_t RunStateDayNr(const rep_RunState& State)
+{
+    return State.DayNri;
+}
+
+std::vector<rep_RunResult> RunSimulation(const std::string& TheProjectFile_, typeproject TheProjectType)
 {
     int32_t NrRuns = 1;
+    std::vector<rep_RunResult> Results;
     
     NextSimFromDayNr = undef_int;
     TheProjectFile = TheProjectFile_;
+    // a worker may still hold the stopped state of an earlier project
+    RunStoppedState.reset();
     
     // InitializeSimulation
     OpenOutputRun(TheProjectType);
@@ -208,11 +310,17 @@ void RunSimulation(const std::string& TheProjectFile_, typeproject TheProjectTyp
 
     for (int8_t NrRun = 1; NrRun <= NrRuns; ++NrRun)
     {
-        std::cout << "  Running simulation " << (int)NrRun << " of " << NrRuns << "..." << std::endl;
+        if (ConsoleOutput) std::cout << "  Running simulation " << (int)NrRun << " of " << NrRuns << "..." << std::endl;
+        SetTraceTags(TheProjectFile, NrRun);
+        AQUACROP_TRACE_SPAN("run");
         // InitializeRunPart1
         if (TheProjectType != typeproject::typenone) // TypeNone
         {
+            AQUACROP_REGION("initialize_run_part1");
             LoadSimulationRunProject(NrRun);
+            ApplyRunOverrides();
+            ApplySowingDate();
+            ApplyIrrigationStrategy();
             AdjustCompartments();
             rep_sum SumWaBal_temp = SumWaBal;
             GlobalZero(SumWaBal_temp);
@@ -221,14 +329,38 @@ void RunSimulation(const std::string& TheProjectFile_, typeproject TheProjectTyp
             InitializeSimulationRunPart1();
         }
 
-        std::cout << "    From: " << Simulation.FromDayNr << " To: " << Simulation.ToDayNr << std::endl;
+        if (ConsoleOutput) std::cout << "    From: " << Simulation.FromDayNr << " To: " << Simulation.ToDayNr << std::endl;
 
-        InitializeClimate();
-        InitializeRunPart2();
+        {
+            AQUACROP_REGION("initialize_climate");
+            InitializeClimate();
+        }
+        {
+            AQUACROP_REGION("initialize_run_part2");
+            InitializeRunPart2();
+            DetermineRunConstants(CO2i);
+            DetermineCropCalendar();
+        }
         WriteTitleDailyResults(TheProjectType, NrRun);
-        FileManagement();
-        FinalizeRun1(NrRun, TheProjectFile, TheProjectType);
-        FinalizeRun2(NrRun, TheProjectType);
+        std::shared_ptr<const rep_RunState> Resume = std::move(RunResumeState);
+        if (Resume) RestoreRunState(*Resume);
+        bool Stopped;
+        AQUACROP_STAGE_RUN_BEGIN(TheProjectFile, NrRun);
+        {
+            AQUACROP_REGION("daily_loop");
+            Stopped = FileManagement(Resume.get());
+        }
+        AQUACROP_STAGE_RUN_END();
+        RunStopDayNr = undef_int;
+        if (Stopped) continue;
+        {
+            AQUACROP_REGION("finalize_run");
+            FinalizeRun1(NrRun, TheProjectFile, TheProjectType);
+            FinalizeRun2(NrRun, TheProjectType);
+        }
+        Results.push_back({NrRun, Simulation.FromDayNr, Simulation.ToDayNr, {}, SumWaBal});
+        EndRunEvaluation(Results.back());
+        WriteRunEvaluation(Results.back());
     }
 
     // FinalizeSimulation
@@ -236,6 +368,7 @@ void RunSimulation(const std::string& TheProjectFile_, typeproject TheProjectTyp
     if (OutDaily) fDaily.close();
     if (Out8Irri) fIrrInfo.close();
     if (Part1Mult) fHarvest.close();
+    return Results;
 }
 
 namespace { // Implementation of local functions
@@ -367,9 +500,8 @@ void InitializeSimulationRunPart1() {
     // Initialise Soil details
     Soil.REW = 0; // Simplified
     
-    bool WaterTableInProfile_temp = WaterTableInProfile;
-    CheckForWaterTableInProfile((ZiAqua / 100.0), Compartment, WaterTableInProfile_temp);
-    WaterTableInProfile = WaterTableInProfile_temp;
+    UpdateGroundwaterState(ZiAqua / 100.0);
+    WaterTableInProfile = DerivedSoil.WaterTableInProfile;
     if (WaterTableInProfile) AdjustForWatertable();
     
     StartMode = true;
@@ -389,6 +521,8 @@ void InitializeClimate() {
 
 void InitializeRunPart2() {
     // ...
+    PrepareGDDIndex(Simulation.FromDayNr, Simulation.ToDayNr);
+
     // Calculate initial GDD
     GDDayi = DegreesDay(crop.Tbase, crop.Tupper, simulparam.Tmin, simulparam.Tmax, simulparam.GDDMethod);
     if (DayNri >= crop.Day1) {
@@ -401,13 +535,15 @@ void InitializeRunPart2() {
     
     IrriInterval = 1;
     GlobalIrriECw = true;
-    OpenIrrigationFile();
+    IrriInfoRecord1.NoMoreInfo = true;
+    // Dated irrigation, cuttings, groundwater and observations of the run
+    BuildEventTimeline(Simulation.FromDayNr, Simulation.ToDayNr);
+    BeginRunEvaluation(Simulation.FromDayNr, Simulation.ToDayNr);
+    GetGwtSet(DayNri, GwTable);
     LastIrriDAP = 0;
     
     // Set parameters for Budget_module
-    Coeffb0Salt = 0.0; // Placeholder
-    Coeffb1Salt = 0.0; // Placeholder
-    Coeffb2Salt = 0.0; // Placeholder
+    RelationshipsForFertilityAndSaltStress();
     
     CGCref = crop.CGC;
     GDDCGCref = crop.GDDCGC;
@@ -420,19 +556,29 @@ void InitializeRunPart2() {
     // ... more logic ...
 }
 
-void FileManagement() {
+// False when the run is complete; true when it stopped at RunStopDayNr, its
+// state kept in RunStoppedState
+bool FileManagement(const rep_RunState* Resume) {
     dp WPi = 0.0;
-    bool HarvestNow = false;
+    bool HarvestNow = (Resume != nullptr) ? Resume->HarvestNow : false;
     RepeatToDay = Simulation.ToDayNr;
+    // Variant of Budget_module for the configuration of the run; the one
+    // of a run without salt does not touch the salt cells
+    const BudgetModuleFn BudgetStep = SelectBudgetModule(CurrentBudgetConfig());
     
     do {
-        AdvanceOneTimeStep(WPi, HarvestNow);
+        if (RunStopDayNr != undef_int && DayNri >= RunStopDayNr) {
+            RunStoppedState = SaveRunState(HarvestNow);
+            return true;
+        }
+        AdvanceOneTimeStep(BudgetStep, WPi, HarvestNow);
         ReadClimateNextDay();
         SetGDDVariablesNextDay();
     } while ((DayNri - 1) != RepeatToDay);
+    return false;
 }
 
-void AdvanceOneTimeStep(dp& WPi, bool& HarvestNow) {
+void AdvanceOneTimeStep(BudgetModuleFn BudgetStep, dp& WPi, bool& HarvestNow) {
     int32_t TargetTimeVal, TargetDepthVal;
     int32_t VirtualTimeCC;
     dp TESTVAL;
@@ -440,9 +586,23 @@ void AdvanceOneTimeStep(dp& WPi, bool& HarvestNow) {
     if (EToFile == "(None)") ETo = 5.0; // Placeholder
     if (RainFile == "(None)") Rain = 0.0; // Placeholder
     if (StartMode) StartMode = false;
-    
-    // ... Groundwater ...
-    
+
+    // Events of the day (one comparison on days without events)
+    EventTimeline.AdvanceTo(DayNri);
+
+    // Variable groundwater table
+    if (!simulparam.ConstGwt && !EventTimeline.GwtPoints.empty()) {
+        if (EventTimeline.Today(EventKind::Groundwater) != nullptr) GetGwtSet(DayNri, GwTable);
+        GetZandECgwt(ZiAqua, ECiAqua);
+        WaterTableInProfile = DerivedSoil.WaterTableInProfile;
+        if (WaterTableInProfile) AdjustForWatertable();
+    }
+
+    // Cuttings on fixed days
+    if (Cuttings.Considered && !Cuttings.Generate) {
+        HarvestNow = (EventTimeline.Today(EventKind::Cutting) != nullptr);
+    }
+
     Irrigation = 0.0;
     GetIrriParam(TargetTimeVal, TargetDepthVal);
     
@@ -454,12 +614,18 @@ void AdvanceOneTimeStep(dp& WPi, bool& HarvestNow) {
     }
     
     // Budget Module Call
-    Budget_module(DayNri, TargetTimeVal, TargetDepthVal, VirtualTimeCC, SumInterval, DayLastCut,
+    BudgetStep(DayNri, TargetTimeVal, TargetDepthVal, VirtualTimeCC, SumInterval, DayLastCut,
         StressTot.NrD, Tadj, GDDTadj, GDDayi, CGCref, GDDCGCref, CO2i, CCxTotal, CCoTotal, CDCTotal,
         GDDCDCTotal, Simulation.SumGDDfromDay1, Coeffb0Salt, Coeffb1Salt, Coeffb2Salt, StressTot.Salt, DayFraction, GDDayFraction,
         FracAssim, StressSFadjNEW, Transfer.Store, Transfer.Mobilize, StressLeaf, StressSenescence, TimeSenescence,
         NoMoreCrop, TESTVAL);
-        
+
+    // Days since the last irrigation (FixInt generation)
+    IrriInterval = (Irrigation > 0.0) ? 1 : IrriInterval + 1;
+
+    // Goodness of fit on days with observations
+    EvaluateDay(DayNri);
+
     WriteDailyResults(DayNri, WPi);
     
     DayNri++;
@@ -499,12 +665,14 @@ void OpenOutputDaily(typeproject TheProjectType) {}
 void OpenOutputIrrInfo(typeproject TheProjectType) {}
 void OpenPart1MultResults(typeproject TheProjectType) {}
 void WriteTitleDailyResults(typeproject TheProjectType, int8_t TheNrRun) {
+    if (!ConsoleOutput) return;
     std::cout << "SIMULATED AquaCrop run (placeholder)" << std::endl;
     std::cout << "Days: " << (Simulation.ToDayNr - Simulation.FromDayNr + 1) << std::endl << std::endl;
     std::cout << "Day biomass(kg/ha) canopy(%) transpiration(mm) soil_moisture(%)" << std::endl;
 }
 
 void WriteDailyResults(int32_t DAP, dp WPi) {
+    if (!ConsoleOutput) return;
     int32_t day = DAP - Simulation.DelayedDays;
     dp growth_factor = 1.0;
     
@@ -534,25 +702,145 @@ void CloseManagementFile() {}
 void CheckForPrint(const std::string& TheProjectFile) {}
 void WriteIrrInfo() {}
 void WriteEvaluationData(int32_t DAP) {}
+
+void WriteRunEvaluation(const rep_RunResult& Result) {
+    if (!ConsoleOutput) return;
+    for (int32_t Kind = 0; Kind < NrObsSim; ++Kind) {
+        const rep_FitStats& Fit = Result.Fit[Kind];
+        if (Fit.N == 0) continue;
+        std::cout << "    Evaluation " << ObsSimName(static_cast<typeObsSim>(Kind)) << ": n=" << Fit.N
+                  << std::setprecision(3) << " RMSE=" << Fit.RMSE << " NRMSE=" << Fit.NRMSE << "%"
+                  << " d=" << Fit.d << " EF=" << Fit.EF << " bias=" << Fit.Bias << std::endl;
+    }
+}
 void RecordHarvest(int32_t NrCut, int32_t DayInSeason) {}
 void AdjustForWatertable() {}
 void ResetPreviousSum(rep_sum& PreviousSum) {}
-void GetGwtSet(int32_t DayNrIN, rep_GwTable& GwT) {}
-void GetZandECgwt(int32_t& ZiAqua, dp& ECiAqua) {}
-void OpenIrrigationFile() {}
-void GetIrriParam(int32_t& TargetTimeVal, int32_t& TargetDepthVal) { TargetTimeVal=-999; TargetDepthVal=-999;}
+void GetGwtSet(int32_t DayNrIN, rep_GwTable& GwT) {
+    GetGwtSegment(DayNrIN, GwT.DNr1, GwT.DNr2, GwT.Z1, GwT.Z2, GwT.EC1, GwT.EC2);
+}
+
+void GetZandECgwt(dp& ZiAqua, dp& ECiAqua) {
+    if (GwTable.DNr1 == GwTable.DNr2) {
+        ZiAqua = GwTable.Z1;
+        ECiAqua = GwTable.EC1;
+    } else {
+        ZiAqua = GwTable.Z1 + roundc(static_cast<dp>(DayNri - GwTable.DNr1) * static_cast<dp>(GwTable.Z2 - GwTable.Z1) / static_cast<dp>(GwTable.DNr2 - GwTable.DNr1), 1);
+        ECiAqua = GwTable.EC1 + static_cast<dp>(DayNri - GwTable.DNr1) * (GwTable.EC2 - GwTable.EC1) / static_cast<dp>(GwTable.DNr2 - GwTable.DNr1);
+    }
+    // FCadj and the water table flag follow only a changed depth
+    UpdateGroundwaterState(ZiAqua / 100.0);
+}
+
+void GetIrriParam(int32_t& TargetTimeVal, int32_t& TargetDepthVal) {
+    TargetTimeVal = NoIrriTarget;
+    TargetDepthVal = NoIrriTarget;
+    if (DayNri < crop.Day1 || DayNri > crop.DayN) {
+        Irrigation = IrriOutSeason();
+    } else if (IrriMode_Val == IrriMode::Manual) {
+        Irrigation = IrriManual();
+    } else if (IrriMode_Val == IrriMode::Generate) {
+        // Row of the generated schedule that starts today
+        const rep_DayEvent* Event = EventTimeline.Today(EventKind::IrrigationRule);
+        if (Event != nullptr) {
+            const rep_IrriRule& Rule = IrriGenerateRules[Event->Index];
+            IrriInfoRecord1 = {false, Rule.FromDay, undef_int, Rule.TimeInfo, Rule.DepthInfo};
+            Simulation.IrriECw = Rule.ECw;
+            IrriInterval = 1;
+        }
+        if (IrriInfoRecord1.NoMoreInfo) return;
+        TargetTimeVal = IrriInfoRecord1.TimeInfo;
+        TargetDepthVal = IrriInfoRecord1.DepthInfo;
+        if (GenerateTimeMode_Val == GenerateTimeMode::FixInt) {
+            TargetTimeVal = (IrriInterval >= TargetTimeVal) ? 1 : 0;
+        } else if (GenerateTimeMode_Val == GenerateTimeMode::WaterBetweenBunds) {
+            TargetTimeVal = (Management.BundHeight >= 0.01 && SurfaceStorage < TargetTimeVal) ? 1 : 0;
+        }
+    }
+}
 void DetermineGrowthStage(int32_t Dayi, dp CCiPrev) {}
-void RelationshipsForFertilityAndSaltStress() {}
+void RelationshipsForFertilityAndSaltStress() {
+    dp X10, X20, X30, X40, X50, X60, X70, X80, X90;
+    dp BioTop, BioLow, StrTop, StrLow;
+
+    // 1. Soil fertility: stress (%) as a function of the relative biomass (%)
+    FracBiomassPotSF = 1.0;
+    if (crop.StressResponse.Calibrated) {
+        ReferenceStressBiomassRelationship(crop.DaysToCCini, crop.GDDaysToCCini, crop.DaysToGermination,
+            crop.DaysToFullCanopy, crop.DaysToSenescence, crop.DaysToHarvest, crop.DaysToFlowering,
+            crop.LengthFlowering, crop.GDDaysToGermination, crop.GDDaysToFullCanopy, crop.GDDaysToSenescence,
+            crop.GDDaysToHarvest, crop.WPy, crop.HI, crop.CCo, crop.CCx, crop.CGC, crop.GDDCGC, crop.CDC,
+            crop.GDDCDC, crop.KcTop, crop.KcDecline, static_cast<dp>(crop.CCEffectEvapLate), crop.Tbase,
+            crop.Tupper, simulparam.Tmin, simulparam.Tmax, crop.GDtranspLow, crop.WP, crop.dHIdt, crop.Day1,
+            crop.DeterminancyLinked, crop.StressResponse, crop.CropSubkind, crop.ModeCycle,
+            Coeffb0, Coeffb1, Coeffb2, X10, X20, X30, X40, X50, X60, X70,
+            crop.GDDaysToFlowering, crop.GDDLengthFlowering, crop.GDDaysToHIo, crop.Planting, crop.DaysToHIo);
+    } else {
+        Coeffb0 = undef_double;
+        Coeffb1 = undef_double;
+        Coeffb2 = undef_double;
+    }
+    // fraction of the potential biomass under the fertility stress of the run
+    if (Management.FertilityStress != 0 && crop.StressResponse.Calibrated && Coeffb0 != undef_double) {
+        BioLow = 100.0;
+        StrLow = 0.0;
+        BioTop = BioLow;
+        StrTop = StrLow;
+        while (StrLow < static_cast<dp>(Management.FertilityStress) && BioLow > 0.0) {
+            BioTop = BioLow;
+            StrTop = StrLow;
+            BioLow = BioLow - 1.0;
+            StrLow = Coeffb0 + Coeffb1 * BioLow + Coeffb2 * BioLow * BioLow;
+        }
+        if (StrLow > StrTop) {
+            FracBiomassPotSF = (BioTop - (static_cast<dp>(Management.FertilityStress) - StrTop) / (StrLow - StrTop)) / 100.0;
+        } else {
+            FracBiomassPotSF = BioTop / 100.0;
+        }
+        FracBiomassPotSF = std::max(0.0, std::min(1.0, FracBiomassPotSF));
+    }
+
+    // 2. Soil salinity: CCx reduction (%) as a function of the salt stress (%),
+    // only for runs with salt
+    if (CurrentBudgetConfig().Salinity) {
+        ReferenceCCxSaltStressRelationship(crop.DaysToCCini, crop.GDDaysToCCini, crop.DaysToGermination,
+            crop.DaysToFullCanopy, crop.DaysToSenescence, crop.DaysToHarvest, crop.DaysToFlowering,
+            crop.LengthFlowering, crop.GDDaysToFlowering, crop.GDDLengthFlowering, crop.GDDaysToGermination,
+            crop.GDDaysToFullCanopy, crop.GDDaysToSenescence, crop.GDDaysToHarvest, crop.WPy, crop.HI, crop.CCo,
+            crop.CCx, crop.CGC, crop.GDDCGC, crop.CDC, crop.GDDCDC, crop.KcTop, crop.KcDecline,
+            static_cast<dp>(crop.CCEffectEvapLate), crop.Tbase, crop.Tupper, simulparam.Tmin, simulparam.Tmax,
+            crop.GDtranspLow, crop.WP, crop.dHIdt, crop.Day1, crop.DeterminancyLinked, crop.CropSubkind,
+            crop.ModeCycle, crop.CCsaltDistortion, Coeffb0Salt, Coeffb1Salt, Coeffb2Salt,
+            X10, X20, X30, X40, X50, X60, X70, X80, X90, crop.GDDaysToHIo, crop.Planting, crop.DaysToHIo);
+    } else {
+        Coeffb0Salt = undef_double;
+        Coeffb1Salt = undef_double;
+        Coeffb2Salt = undef_double;
+    }
+}
 void GetSumGDDBeforeSimulation(dp& SumGDDtillDay, dp& SumGDDtillDayM1) {}
 void GetPotValSF(int32_t DAP, dp SumGDDAdjCC, dp& PotValSF) {}
 void InitializeTransferAssimilates(dp& Bin, dp& Bout, dp& AssimToMobilize, dp& AssimMobilized, dp& FracAssim, bool& StorageON, bool& MobilizationON, bool HarvestNow) {}
 void AdjustSWCRootZone(dp& PreIrri) {}
-int32_t IrriManual() { return 0; }
-int32_t IrriOutSeason() { return 0; }
+int32_t IrriManual() {
+    const rep_DayEvent* Event = EventTimeline.Today(EventKind::Irrigation);
+    if (Event == nullptr) return 0;
+    const rep_IrriEvent& Irri = EventTimeline.Irrigations[Event->Index];
+    Simulation.IrriECw = Irri.ECw;
+    return static_cast<int32_t>(roundc(Irri.Depth, 1));
+}
+
+int32_t IrriOutSeason() {
+    const rep_DayEvent* Event = EventTimeline.Today(EventKind::IrrigationOutSeason);
+    if (Event == nullptr) return 0;
+    const rep_IrriEvent& Irri = EventTimeline.Irrigations[Event->Index];
+    Simulation.IrriECw = Irri.ECw;
+    return static_cast<int32_t>(roundc(Irri.Depth, 1));
+}
 void ResetCropAndSimulationPeriod(int32_t NewCropDay1) {}
 void OpenHarvestInfo() {}
 void GetNextHarvest() {}
 
 } // namespace anonymous
 
-} // namespace AquaCrop
\ No newline at end of file
+} // namespace AquaCrop
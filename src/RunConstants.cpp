@@ -0,0 +1,45 @@
+#include "AquaCrop/RunConstants.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Utils.h"
+#include <cmath>
+
+namespace AquaCrop {
+
+thread_local rep_RunConstants RunConst = {};
+
+void DetermineRunConstants(dp CO2i)
+{
+    // CO2 correction for the crop water productivity
+    RunConst.CO2i = CO2i;
+    RunConst.WP = crop.WP;
+    RunConst.AdaptedToCO2 = crop.AdaptedToCO2;
+    RunConst.fCO2 = fAdjustedForCO2(CO2i, crop.WP, crop.AdaptedToCO2);
+
+    // Curve numbers for runoff
+    RunConst.CN2 = static_cast<int8_t>(roundc(static_cast<dp>(Soil.CNvalue) * (100.0 + static_cast<dp>(Management.CNcorrection)) / 100.0, 1));
+    DetermineCNIandIII(RunConst.CN2, RunConst.CN1, RunConst.CN3);
+
+    // Soil evaporation
+    RunConst.EvapDecline = static_cast<dp>(simulparam.EvapDeclineFactor);
+    RunConst.ExpEvapDeclineMin1 = std::exp(RunConst.EvapDecline) - 1.0;
+    RunConst.fMulch = 1.0;
+    if (Management.Mulch > 0) {
+        RunConst.fMulch = 1.0 - (static_cast<dp>(Management.Mulch) / 100.0) * (static_cast<dp>(Management.EffectMulchInS) / 100.0);
+    }
+    RunConst.fEvapRootNr = 1.0;
+    if (simulparam.EffectiveRain.RootNrEvap > 0) {
+        RunConst.fEvapRootNr = std::exp((1.0/static_cast<dp>(simulparam.EffectiveRain.RootNrEvap)) * std::log((Soil.REW+1.0)/20.0));
+    }
+
+    RunConst.Filled = true;
+}
+
+dp fAdjustedForCO2Run(dp CO2i, dp WPi, int8_t PercentA)
+{
+    if (RunConst.Filled && CO2i == RunConst.CO2i && WPi == RunConst.WP && PercentA == RunConst.AdaptedToCO2) {
+        return RunConst.fCO2;
+    }
+    return fAdjustedForCO2(CO2i, WPi, PercentA);
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,165 @@
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AQUACROP_X86_SIMD 1
+#endif
+
+namespace AquaCrop {
+
+namespace {
+
+// Mixing of two neighbouring cells (salt diffusion within a compartment)
+void Mixing(dp Dif, dp mm1, dp mm2, dp& Salt1, dp& Salt2, dp& Depo1, dp& Depo2) {
+    dp EC1, EC2, ECmix;
+
+    SaltSolutionDeposit(mm1, Salt1, Depo1);
+    EC1 = Salt1 / (mm1 * equiv);
+    SaltSolutionDeposit(mm2, Salt2, Depo2);
+    EC2 = Salt2 / (mm2 * equiv);
+    ECmix = (EC1 * mm1 + EC2 * mm2) / (mm1 + mm2);
+    EC1 = EC1 + (ECmix - EC1) * Dif;
+    EC2 = EC2 + (ECmix - EC2) * Dif;
+    Salt1 = EC1 * mm1 * equiv;
+    SaltSolutionDeposit(mm1, Salt1, Depo1);
+    Salt2 = EC2 * mm2 * equiv;
+    SaltSolutionDeposit(mm2, Salt2, Depo2);
+}
+
+void SaltSolutionDepositCellsScalar(dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t From, int32_t NrCells) {
+    for (int32_t i = From; i < NrCells; ++i) SaltSolutionDeposit(mm, SaltSolution[i], SaltDeposit[i]);
+}
+
+void MixSaltCellsScalar(int32_t NrPairs, const dp* Dif, dp mm1, const dp* mm2, dp* Salt, dp* Depo) {
+    for (int32_t i = 0; i < NrPairs; ++i) Mixing(Dif[i], mm1, mm2[i], Salt[i], Salt[i+1], Depo[i], Depo[i+1]);
+}
+
+#ifdef AQUACROP_X86_SIMD
+
+// SaltSolutionDeposit as selects: the deposit is +0.0 and the solution kept
+// when it does not exceed the solubility (also for NaN), as in the scalar code.
+// Each variant handles the full vectors and returns the first cell left for
+// the scalar loop.
+
+__attribute__((target("sse2")))
+inline void DepositSSE2(__m128d Cap, __m128d& Salt, __m128d& Depo) {
+    Salt = _mm_add_pd(Salt, Depo);
+    __m128d Above = _mm_cmpgt_pd(Salt, Cap);
+    Depo = _mm_and_pd(Above, _mm_sub_pd(Salt, Cap));
+    Salt = _mm_or_pd(_mm_and_pd(Above, Cap), _mm_andnot_pd(Above, Salt));
+}
+
+__attribute__((target("sse2")))
+int32_t SaltSolutionDepositCellsSSE2(dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells) {
+    const __m128d Cap = _mm_set1_pd(static_cast<dp>(simulparam.SaltSolub) * mm);
+    int32_t i = 0;
+    for (; i + 2 <= NrCells; i += 2) {
+        __m128d Salt = _mm_loadu_pd(SaltSolution + i);
+        __m128d Depo = _mm_loadu_pd(SaltDeposit + i);
+        DepositSSE2(Cap, Salt, Depo);
+        _mm_storeu_pd(SaltSolution + i, Salt);
+        _mm_storeu_pd(SaltDeposit + i, Depo);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+int32_t SaltSolutionDepositCellsAVX2(dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells) {
+    const __m256d Cap = _mm256_set1_pd(static_cast<dp>(simulparam.SaltSolub) * mm);
+    int32_t i = 0;
+    for (; i + 4 <= NrCells; i += 4) {
+        __m256d Salt = _mm256_add_pd(_mm256_loadu_pd(SaltSolution + i), _mm256_loadu_pd(SaltDeposit + i));
+        __m256d Above = _mm256_cmp_pd(Salt, Cap, _CMP_GT_OQ);
+        _mm256_storeu_pd(SaltDeposit + i, _mm256_and_pd(Above, _mm256_sub_pd(Salt, Cap)));
+        _mm256_storeu_pd(SaltSolution + i, _mm256_blendv_pd(Salt, Cap, Above));
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+int32_t SaltSolutionDepositCellsAVX512(dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells) {
+    const __m512d Cap = _mm512_set1_pd(static_cast<dp>(simulparam.SaltSolub) * mm);
+    int32_t i = 0;
+    for (; i + 8 <= NrCells; i += 8) {
+        __m512d Salt = _mm512_add_pd(_mm512_loadu_pd(SaltSolution + i), _mm512_loadu_pd(SaltDeposit + i));
+        __mmask8 Above = _mm512_cmp_pd_mask(Salt, Cap, _CMP_GT_OQ);
+        _mm512_storeu_pd(SaltDeposit + i, _mm512_maskz_sub_pd(Above, Salt, Cap));
+        _mm512_storeu_pd(SaltSolution + i, _mm512_mask_blend_pd(Above, Salt, Cap));
+    }
+    return i;
+}
+
+// The pairs follow each other (pair i mixes the cell that pair i-1 left), so
+// the vector runs over the two cells of a pair: lane 0 the upper cell with
+// mm1, lane 1 the lower cell with mm2[i]
+__attribute__((target("sse2")))
+void MixSaltCellsSSE2(int32_t NrPairs, const dp* Dif, dp mm1, const dp* mm2, dp* Salt, dp* Depo) {
+    const __m128d Equiv = _mm_set1_pd(equiv);
+    const dp Solub = static_cast<dp>(simulparam.SaltSolub);
+    for (int32_t i = 0; i < NrPairs; ++i) {
+        const __m128d mm = _mm_set_pd(mm2[i], mm1);
+        const __m128d Cap = _mm_mul_pd(_mm_set1_pd(Solub), mm);
+        __m128d S = _mm_loadu_pd(Salt + i);
+        __m128d D = _mm_loadu_pd(Depo + i);
+        DepositSSE2(Cap, S, D);
+        __m128d EC = _mm_div_pd(S, _mm_mul_pd(mm, Equiv));
+        __m128d Weighted = _mm_mul_pd(EC, mm);
+        dp ECmix = (_mm_cvtsd_f64(Weighted) + _mm_cvtsd_f64(_mm_unpackhi_pd(Weighted, Weighted))) / (mm1 + mm2[i]);
+        EC = _mm_add_pd(EC, _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(ECmix), EC), _mm_set1_pd(Dif[i])));
+        S = _mm_mul_pd(_mm_mul_pd(EC, mm), Equiv);
+        DepositSSE2(Cap, S, D);
+        _mm_storeu_pd(Salt + i, S);
+        _mm_storeu_pd(Depo + i, D);
+    }
+}
+
+#endif // AQUACROP_X86_SIMD
+
+} // namespace
+
+void SaltSolutionDepositCellsAt(SimdLevel Level, dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells) {
+    if (NrCells <= 0) return;
+    int32_t Done = 0;
+#ifdef AQUACROP_X86_SIMD
+    if (!SimdLevelAvailable(Level)) Level = SimdLevel::Scalar;
+    switch (Level) {
+    case SimdLevel::AVX512:
+        Done = SaltSolutionDepositCellsAVX512(mm, SaltSolution, SaltDeposit, NrCells);
+        break;
+    case SimdLevel::AVX2:
+        Done = SaltSolutionDepositCellsAVX2(mm, SaltSolution, SaltDeposit, NrCells);
+        break;
+    case SimdLevel::SSE2:
+        Done = SaltSolutionDepositCellsSSE2(mm, SaltSolution, SaltDeposit, NrCells);
+        break;
+    default:
+        break;
+    }
+#else
+    (void)Level;
+#endif
+    SaltSolutionDepositCellsScalar(mm, SaltSolution, SaltDeposit, Done, NrCells);
+}
+
+void MixSaltCellsAt(SimdLevel Level, int32_t NrPairs, const dp* Dif, dp mm1, const dp* mm2, dp* Salt, dp* Depo) {
+#ifdef AQUACROP_X86_SIMD
+    if (Level != SimdLevel::Scalar && SimdLevelAvailable(SimdLevel::SSE2)) {
+        MixSaltCellsSSE2(NrPairs, Dif, mm1, mm2, Salt, Depo);
+        return;
+    }
+#else
+    (void)Level;
+#endif
+    MixSaltCellsScalar(NrPairs, Dif, mm1, mm2, Salt, Depo);
+}
+
+void SaltSolutionDepositCells(dp mm, dp* SaltSolution, dp* SaltDeposit, int32_t NrCells) {
+    SaltSolutionDepositCellsAt(ActiveSimdLevel(), mm, SaltSolution, SaltDeposit, NrCells);
+}
+
+void MixSaltCells(int32_t NrPairs, const dp* Dif, dp mm1, const dp* mm2, dp* Salt, dp* Depo) {
+    MixSaltCellsAt(ActiveSimdLevel(), NrPairs, Dif, mm1, mm2, Salt, Depo);
+}
+
+} // namespace AquaCrop
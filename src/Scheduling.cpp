@@ -0,0 +1,230 @@
+#include "AquaCrop/Scheduling.h"
+#include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/Run.h"
+#include "AquaCrop/StartUnit.h"
+#include "AquaCrop/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+namespace AquaCrop {
+
+namespace {
+
+thread_local const rep_IrriStrategy* ActiveStrategy = nullptr;
+thread_local int32_t ActiveStopStage = 0;
+
+// Part of a candidate simulated from the state of its parent node to the
+// start of the next stage (State), or to the end of the run (Result)
+struct rep_Segment {
+    std::shared_ptr<const rep_RunState> State;
+    bool Final = false;
+    rep_RunResult Result{};
+    int32_t NrDays = 0;
+};
+
+} // namespace
+
+std::vector<int32_t> IrriStageStartDays(int32_t NrStages)
+{
+    std::vector<int32_t> Starts = {1};
+    for (int32_t Day : {crop.DaysToGermination + 1, crop.DaysToFullCanopy + 1, crop.DaysToSenescence + 1}) {
+        Starts.push_back(std::max(Day, Starts.back() + 1));
+    }
+    Starts.resize(std::clamp(NrStages, 1, NrIrriStages));
+    return Starts;
+}
+
+void SetIrrigationStrategy(const rep_IrriStrategy* Strategy, int32_t StopStage)
+{
+    ActiveStrategy = Strategy;
+    ActiveStopStage = StopStage;
+}
+
+void ApplyIrrigationStrategy()
+{
+    if (ActiveStrategy == nullptr || ActiveStrategy->Stages.empty()) return;
+    const rep_IrriStrategy& Strategy = *ActiveStrategy;
+    const int32_t NrStages = std::min(static_cast<int32_t>(Strategy.Stages.size()), NrIrriStages);
+    const std::vector<int32_t> Starts = IrriStageStartDays(NrStages);
+
+    IrriMode_Val = IrriMode::Generate;
+    GenerateTimeMode_Val = Strategy.TimeMode;
+    GenerateDepthMode_Val = Strategy.DepthMode;
+    IrriFirstDayNr = undef_int;
+    IrriSeasonCap = Strategy.SeasonCap;
+    IrriGenerateRules.clear();
+    for (int32_t Stagei = 1; Stagei <= NrStages; ++Stagei) {
+        const rep_IrriStageRule& Rule = Strategy.Stages[Stagei-1];
+        IrriGenerateRules.push_back({Starts[Stagei-1], Rule.TimeInfo, Rule.DepthInfo, Strategy.ECw});
+    }
+    if (ActiveStopStage >= 1 && ActiveStopStage <= NrStages) {
+        SetRunStop(crop.Day1 + Starts[ActiveStopStage-1] - 1);
+    }
+}
+
+std::vector<int32_t> IrrigationParetoFront(const std::vector<rep_IrriCandidate>& Candidates, bool HigherIsBetter)
+{
+    const dp Sign = HigherIsBetter ? 1.0 : -1.0;
+    std::vector<int32_t> Order;
+    for (int32_t i = 0; i < static_cast<int32_t>(Candidates.size()); ++i) {
+        if (!std::isnan(Candidates[i].Output) && !std::isnan(Candidates[i].Irrigation)) Order.push_back(i);
+    }
+    // by irrigation, the best output first among equal irrigation
+    std::stable_sort(Order.begin(), Order.end(), [&](int32_t a, int32_t b) {
+        if (Candidates[a].Irrigation != Candidates[b].Irrigation) return Candidates[a].Irrigation < Candidates[b].Irrigation;
+        return Sign * Candidates[a].Output > Sign * Candidates[b].Output;
+    });
+    std::vector<int32_t> Front;
+    dp BestSoFar = -std::numeric_limits<dp>::infinity();
+    for (int32_t i : Order) {
+        if (Sign * Candidates[i].Output > BestSoFar) {
+            Front.push_back(i);
+            BestSoFar = Sign * Candidates[i].Output;
+        }
+    }
+    return Front;
+}
+
+bool OptimizeIrrigation(const std::string& TheProjectFile, const rep_IrriSearchSettings& Settings,
+                        rep_IrriSearchResult& Result)
+{
+    typeproject TheProjectType;
+    GetProjectType(TheProjectFile, TheProjectType);
+    if (TheProjectType == typeproject::typenone) {
+        std::cerr << "Not a project file (.ACp or .PRM): " << TheProjectFile << std::endl;
+        return false;
+    }
+    const int32_t NrDepths = static_cast<int32_t>(Settings.DepthLevels.size());
+    const int32_t NrOptions = static_cast<int32_t>(Settings.TimeLevels.size()) * NrDepths;
+    const int32_t NrStages = Settings.PerStage ? NrIrriStages : 1;
+    int64_t NrCandidates = 1;
+    for (int32_t Stagei = 1; Stagei <= NrStages && NrCandidates <= Settings.MaxCandidates; ++Stagei) {
+        NrCandidates *= NrOptions;
+    }
+    if (NrOptions == 0 || NrCandidates > Settings.MaxCandidates) {
+        std::cerr << "Need 1 to " << Settings.MaxCandidates << " candidate schedules" << std::endl;
+        return false;
+    }
+    ThreadPool Pool(Settings.NrThreads);
+
+    // Runs of the project, parsed once for all simulations (project input cache)
+    std::vector<int32_t> RunDays;
+    Pool.ParallelFor(1, [&](int32_t) {
+        PrepareSimulationThread();
+        InitializeProject(1, TheProjectFile, TheProjectType);
+        for (const ProjectInput_type& Run : ProjectInput) {
+            RunDays.push_back(Run.Simulation_DayNrN - Run.Simulation_DayNr1 + 1);
+        }
+    });
+    const int32_t NrRuns = static_cast<int32_t>(RunDays.size());
+    if (NrRuns == 0) {
+        std::cerr << "No runs in " << TheProjectFile << std::endl;
+        return false;
+    }
+
+    // Strategy of node Node of the tree at depth Level: the choices of the
+    // first Level stages, the stages after them are not reached
+    auto NodeStrategy = [&](int64_t Node, int32_t Level) {
+        rep_IrriStrategy Strategy;
+        Strategy.TimeMode = Settings.TimeMode;
+        Strategy.DepthMode = Settings.DepthMode;
+        Strategy.SeasonCap = Settings.SeasonCap;
+        Strategy.Stages.assign(NrStages, {Settings.TimeLevels[0], Settings.DepthLevels[0]});
+        for (int32_t Stagei = Level; Stagei >= 1; --Stagei) {
+            const int32_t Option = static_cast<int32_t>(Node % NrOptions);
+            Strategy.Stages[Stagei-1] = {Settings.TimeLevels[Option / NrDepths], Settings.DepthLevels[Option % NrDepths]};
+            Node /= NrOptions;
+        }
+        return Strategy;
+    };
+
+    // Level 0 simulates the days before the first stage; level l the days of
+    // stage l, from the state of the parent node (Node / NrOptions). Without
+    // reuse only the leaves are simulated, each from the start of the run.
+    std::vector<rep_Segment> Parents, Segments;
+    int64_t NrSimulatedDays = 0;
+    int64_t NrNodes = 1;
+    for (int32_t Level = Settings.ReuseSegments ? 0 : NrStages; Level <= NrStages; ++Level) {
+        if (Level > 0) NrNodes = Settings.ReuseSegments ? NrNodes * NrOptions : NrCandidates;
+        const bool FromStart = (Level == 0 || !Settings.ReuseSegments);
+        Segments.assign(static_cast<size_t>(NrNodes * NrRuns), rep_Segment{});
+        Pool.ParallelFor(static_cast<int32_t>(NrNodes * NrRuns), [&](int32_t Item) {
+            const int64_t Node = Item / NrRuns;
+            const int32_t Runi = Item % NrRuns + 1;
+            rep_Segment& Segment = Segments[Item];
+            const rep_Segment* Parent = FromStart ? nullptr : &Parents[(Node / NrOptions) * NrRuns + Runi - 1];
+            if (Parent != nullptr && Parent->Final) {
+                Segment.Final = true;
+                Segment.Result = Parent->Result;
+                return;
+            }
+            PrepareSimulationThread();
+            const rep_IrriStrategy Strategy = NodeStrategy(Node, Level);
+            SetIrrigationStrategy(&Strategy, Level < NrStages ? Level + 1 : 0);
+            if (Parent != nullptr) SetRunResume(Parent->State);
+            std::vector<rep_RunResult> Runs = SimulateProject(TheProjectFile, TheProjectType, {}, {}, Runi);
+            SetIrrigationStrategy(nullptr);
+            SetRunResume(nullptr);
+            Segment.State = TakeRunState();
+
+            const int32_t FirstDayNr = (Parent != nullptr) ? RunStateDayNr(*Parent->State) : undef_int;
+            if (Segment.State != nullptr) {
+                if (FirstDayNr != undef_int) Segment.NrDays = RunStateDayNr(*Segment.State) - FirstDayNr;
+                else Segment.NrDays = RunStateDayNr(*Segment.State) - ProjectInput.front().Simulation_DayNr1;
+            } else {
+                Segment.Final = true;
+                if (!Runs.empty()) Segment.Result = Runs.front();
+                Segment.Result.NrRun = static_cast<int8_t>(Runi);
+                Segment.NrDays = Segment.Result.ToDayNr + 1 - ((FirstDayNr != undef_int) ? FirstDayNr : Segment.Result.FromDayNr);
+            }
+        });
+        for (const rep_Segment& Segment : Segments) NrSimulatedDays += Segment.NrDays;
+        std::swap(Parents, Segments);
+    }
+
+    // The leaves, in the order of the candidates
+    Result.Candidates.assign(static_cast<size_t>(NrCandidates), rep_IrriCandidate{});
+    Result.NrCandidateDays = 0;
+    for (int32_t Runi = 1; Runi <= NrRuns; ++Runi) Result.NrCandidateDays += NrCandidates * RunDays[Runi-1];
+    Result.NrSimulatedDays = NrSimulatedDays;
+    for (int64_t Candidatei = 0; Candidatei < NrCandidates; ++Candidatei) {
+        rep_IrriCandidate& Candidate = Result.Candidates[Candidatei];
+        Candidate.Stages = NodeStrategy(Candidatei, NrStages).Stages;
+        std::vector<rep_RunResult> Runs;
+        dp SumIrrigation = 0.0;
+        for (int32_t Runi = 1; Runi <= NrRuns; ++Runi) {
+            Runs.push_back(Parents[Candidatei * NrRuns + Runi - 1].Result);
+            SumIrrigation += Runs.back().Sums.Irrigation;
+        }
+        Candidate.Irrigation = SumIrrigation / NrRuns;
+        Candidate.Output = ProjectOutputValue(Runs, Settings.Output, Settings.Objective);
+        Candidate.WaterProductivity = (Candidate.Irrigation > 0.0) ? Candidate.Output / Candidate.Irrigation
+                                                                   : std::numeric_limits<dp>::quiet_NaN();
+    }
+
+    const bool HigherIsBetter = (Settings.Output != SensOutput::FitObjective);
+    Result.Front = IrrigationParetoFront(Result.Candidates, HigherIsBetter);
+    Result.Best = -1;
+    for (int32_t i = 0; i < static_cast<int32_t>(Result.Candidates.size()); ++i) {
+        const rep_IrriCandidate& Candidate = Result.Candidates[i];
+        dp Value = (Settings.Goal == IrriGoal::WaterProductivity) ? Candidate.WaterProductivity : Candidate.Output;
+        if (std::isnan(Value)) continue;
+        if (!HigherIsBetter) Value = -Value;
+        if (Result.Best < 0) {
+            Result.Best = i;
+            continue;
+        }
+        const rep_IrriCandidate& Best = Result.Candidates[Result.Best];
+        dp BestValue = (Settings.Goal == IrriGoal::WaterProductivity) ? Best.WaterProductivity : Best.Output;
+        if (!HigherIsBetter) BestValue = -BestValue;
+        // ties go to the candidate with less irrigation
+        if (Value > BestValue || (Value == BestValue && Candidate.Irrigation < Best.Irrigation)) Result.Best = i;
+    }
+    return true;
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,283 @@
+#include "AquaCrop/Sensitivity.h"
+#include "AquaCrop/SplitMix64.h"
+#include "AquaCrop/StartUnit.h"
+#include "AquaCrop/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace AquaCrop {
+
+namespace {
+
+using Point = std::vector<dp>;
+
+// Running mean and sum of squared deviations (Welford)
+struct rep_Moments {
+    int64_t N = 0;
+    dp Mean = 0.0;
+    dp M2 = 0.0;
+
+    void Add(dp X)
+    {
+        ++N;
+        dp Delta = X - Mean;
+        Mean += Delta / static_cast<dp>(N);
+        M2 += Delta * (X - Mean);
+    }
+    dp Variance() const { return (N > 1) ? M2 / static_cast<dp>(N - 1) : 0.0; }
+};
+
+bool AllFinite(const std::vector<dp>& Values, size_t First, size_t Count)
+{
+    for (size_t k = First; k < First + Count; ++k) {
+        if (!std::isfinite(Values[k])) return false;
+    }
+    return true;
+}
+
+// Trajectories on a grid of Levels values per dimension: a random base point
+// and a random order in which every coordinate moves once by +-Delta
+void Morris(int32_t NrDim, const BatchObjective& Model, const rep_SensSettings& Settings, rep_SensResult& Result)
+{
+    const int32_t N = NrDim;
+    const int32_t Levels = std::max(2, Settings.MorrisLevels);
+    const dp Delta = Levels / (2.0 * (Levels - 1));
+    rep_SplitMix64 Rng{Settings.Seed};
+
+    std::vector<rep_Moments> Effects(N);
+    std::vector<dp> SumAbs(N, 0.0);
+    rep_Moments Base;
+    std::vector<Point> Points;
+    std::vector<dp> Values;
+    std::vector<int32_t> Order(N);
+    std::vector<std::vector<int32_t>> Orders;
+    std::vector<Point> Steps;
+    for (int32_t Done = 0; Done < Settings.NrSamples;) {
+        const int32_t Rows = std::min(std::max(1, Settings.BatchRows), Settings.NrSamples - Done);
+        Points.clear();
+        Orders.assign(Rows, std::vector<int32_t>(N));
+        Steps.assign(Rows, Point(N));
+        for (int32_t r = 0; r < Rows; ++r) {
+            Point X(N);
+            for (int32_t j = 0; j < N; ++j) {
+                int32_t Level = std::min(Levels - 1, static_cast<int32_t>(Rng.Uniform() * Levels));
+                X[j] = static_cast<dp>(Level) / (Levels - 1);
+                Steps[r][j] = (X[j] + Delta <= 1.0 + 1.0e-12) ? Delta : -Delta;
+                Order[j] = j;
+            }
+            for (int32_t j = N - 1; j > 0; --j) {
+                std::swap(Order[j], Order[std::min(j, static_cast<int32_t>(Rng.Uniform() * (j + 1)))]);
+            }
+            Orders[r] = Order;
+            Points.push_back(X);
+            for (int32_t k = 0; k < N; ++k) {
+                X[Order[k]] += Steps[r][Order[k]];
+                Points.push_back(X);
+            }
+        }
+        Values.assign(Points.size(), 0.0);
+        Model(Points, Values);
+        Result.NrEvaluations += static_cast<int32_t>(Points.size());
+
+        for (int32_t r = 0; r < Rows; ++r) {
+            const size_t First = static_cast<size_t>(r) * (N + 1);
+            if (!AllFinite(Values, First, N + 1)) continue;
+            Base.Add(Values[First]);
+            for (int32_t k = 0; k < N; ++k) {
+                const int32_t j = Orders[r][k];
+                dp Effect = (Values[First + k + 1] - Values[First + k]) / Steps[r][j];
+                Effects[j].Add(Effect);
+                SumAbs[j] += std::abs(Effect);
+            }
+        }
+        Done += Rows;
+    }
+
+    Result.Mean = Base.Mean;
+    Result.Variance = Base.Variance();
+    Result.Morris.resize(N);
+    for (int32_t j = 0; j < N; ++j) {
+        rep_MorrisIndex& Index = Result.Morris[j];
+        Index.N = static_cast<int32_t>(Effects[j].N);
+        Index.Mu = Effects[j].Mean;
+        Index.MuStar = (Effects[j].N > 0) ? SumAbs[j] / static_cast<dp>(Effects[j].N) : 0.0;
+        Index.Sigma = std::sqrt(Effects[j].Variance());
+    }
+}
+
+// Rows of two independent samples A and B, and the N matrices AB_i (A with
+// column i of B). Per row:
+//   first order  Vi  += f(B) (f(AB_i) - f(A))      (Saltelli 2010)
+//   total        VTi += (f(A) - f(AB_i))^2 / 2     (Jansen 1999)
+// f(B) is taken relative to the first f(A). That shifts the sum of a finite
+// sample by Centre * sum (f(AB_i) - f(A)), whose expectation is zero: the
+// estimator stays unbiased, with less round-off and a lower variance when
+// the output mean is large next to its spread.
+void Sobol(int32_t NrDim, const BatchObjective& Model, const rep_SensSettings& Settings, rep_SensResult& Result)
+{
+    const int32_t N = NrDim;
+    rep_SplitMix64 Rng{Settings.Seed};
+
+    std::vector<dp> SumFirst(N, 0.0), SumTotal(N, 0.0);
+    rep_Moments Output;
+    int64_t NrRows = 0;
+    bool Centred = false;
+    dp Centre = 0.0;
+    std::vector<Point> Points;
+    std::vector<dp> Values;
+    for (int32_t Done = 0; Done < Settings.NrSamples;) {
+        const int32_t Rows = std::min(std::max(1, Settings.BatchRows), Settings.NrSamples - Done);
+        Points.clear();
+        for (int32_t r = 0; r < Rows; ++r) {
+            Point A(N), B(N);
+            for (dp& Aj : A) Aj = Rng.Uniform();
+            for (dp& Bj : B) Bj = Rng.Uniform();
+            Points.push_back(A);
+            Points.push_back(B);
+            for (int32_t i = 0; i < N; ++i) {
+                Point AB = A;
+                AB[i] = B[i];
+                Points.push_back(AB);
+            }
+        }
+        Values.assign(Points.size(), 0.0);
+        Model(Points, Values);
+        Result.NrEvaluations += static_cast<int32_t>(Points.size());
+
+        for (int32_t r = 0; r < Rows; ++r) {
+            const size_t First = static_cast<size_t>(r) * (N + 2);
+            if (!AllFinite(Values, First, N + 2)) continue;
+            const dp FA = Values[First], FB = Values[First + 1];
+            if (!Centred) {
+                Centre = FA;
+                Centred = true;
+            }
+            Output.Add(FA);
+            Output.Add(FB);
+            for (int32_t i = 0; i < N; ++i) {
+                const dp FABi = Values[First + 2 + i];
+                SumFirst[i] += (FB - Centre) * (FABi - FA);
+                SumTotal[i] += 0.5 * (FA - FABi) * (FA - FABi);
+            }
+            ++NrRows;
+        }
+        Done += Rows;
+    }
+
+    Result.Mean = Output.Mean;
+    Result.Variance = Output.Variance();
+    Result.Sobol.assign(N, {0.0, 0.0});
+    if (NrRows == 0 || Result.Variance <= 0.0) return;
+    for (int32_t i = 0; i < N; ++i) {
+        Result.Sobol[i].S1 = SumFirst[i] / NrRows / Result.Variance;
+        Result.Sobol[i].ST = SumTotal[i] / NrRows / Result.Variance;
+    }
+}
+
+} // namespace
+
+void AnalyzeSensitivity(int32_t NrDim, const BatchObjective& Model, const rep_SensSettings& Settings,
+                        rep_SensResult& Result)
+{
+    Result.NrEvaluations = 0;
+    Result.Mean = 0.0;
+    Result.Variance = 0.0;
+    Result.Morris.clear();
+    Result.Sobol.clear();
+    if (NrDim <= 0) return;
+    switch (Settings.Method) {
+        case SensMethod::Morris:
+            Morris(NrDim, Model, Settings, Result);
+            break;
+        case SensMethod::Sobol:
+            Sobol(NrDim, Model, Settings, Result);
+            break;
+    }
+}
+
+const char* SensMethodName(SensMethod Method)
+{
+    switch (Method) {
+        case SensMethod::Morris: return "morris";
+        case SensMethod::Sobol: return "sobol";
+    }
+    return "?";
+}
+
+bool ParseSensMethod(const std::string& Name, SensMethod& Method)
+{
+    for (SensMethod M : {SensMethod::Morris, SensMethod::Sobol}) {
+        if (Name == SensMethodName(M)) {
+            Method = M;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* SensOutputName(SensOutput Output)
+{
+    switch (Output) {
+        case SensOutput::Biomass: return "biomass";
+        case SensOutput::Yield: return "yield";
+        case SensOutput::Transpiration: return "transpiration";
+        case SensOutput::FitObjective: return "fit";
+    }
+    return "?";
+}
+
+bool ParseSensOutput(const std::string& Name, SensOutput& Output)
+{
+    for (SensOutput O : {SensOutput::Biomass, SensOutput::Yield, SensOutput::Transpiration, SensOutput::FitObjective}) {
+        if (Name == SensOutputName(O)) {
+            Output = O;
+            return true;
+        }
+    }
+    return false;
+}
+
+dp ProjectOutputValue(const std::vector<rep_RunResult>& Results, SensOutput Output, const rep_CalibObjective& Objective)
+{
+    if (Output == SensOutput::FitObjective) {
+        dp Value = ObjectiveValue(Results, Objective);
+        return (Value == HUGE_VAL) ? std::numeric_limits<dp>::quiet_NaN() : Value;
+    }
+    if (Results.empty()) return std::numeric_limits<dp>::quiet_NaN();
+    dp Sum = 0.0;
+    for (const rep_RunResult& Run : Results) {
+        switch (Output) {
+            case SensOutput::Biomass: Sum += Run.Sums.Biomass; break;
+            case SensOutput::Yield: Sum += Run.Sums.YieldPart; break;
+            case SensOutput::Transpiration: Sum += Run.Sums.Tact; break;
+            case SensOutput::FitObjective: break;
+        }
+    }
+    return Sum / static_cast<dp>(Results.size());
+}
+
+bool AnalyzeProjectSensitivity(const std::string& TheProjectFile, const std::vector<rep_CalibParameter>& Parameters,
+                               const rep_ProjectSensSettings& Settings, rep_SensResult& Result)
+{
+    typeproject TheProjectType;
+    GetProjectType(TheProjectFile, TheProjectType);
+    if (TheProjectType == typeproject::typenone) {
+        std::cerr << "Not a project file (.ACp or .PRM): " << TheProjectFile << std::endl;
+        return false;
+    }
+    ThreadPool Pool(Settings.NrThreads);
+    BatchObjective Model = [&](const std::vector<std::vector<dp>>& Points, std::vector<dp>& Values) {
+        Pool.ParallelFor(static_cast<int32_t>(Points.size()), [&](int32_t Item) {
+            Values[Item] = ProjectOutputValue(SimulateProject(TheProjectFile, TheProjectType, Parameters,
+                                                              ParameterValues(Parameters, Points[Item])),
+                                              Settings.Output, Settings.Objective);
+        });
+    };
+    AnalyzeSensitivity(static_cast<int32_t>(Parameters.size()), Model, Settings.Sens, Result);
+    return true;
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,52 @@
+#include "AquaCrop/Simd.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace AquaCrop {
+
+namespace {
+
+SimdLevel ParseSimdLevel(const char* Name, SimdLevel Default) {
+    if (Name == nullptr) return Default;
+    if (std::strcmp(Name, "scalar") == 0) return SimdLevel::Scalar;
+    if (std::strcmp(Name, "sse2") == 0) return SimdLevel::SSE2;
+    if (std::strcmp(Name, "avx2") == 0) return SimdLevel::AVX2;
+    if (std::strcmp(Name, "avx512") == 0) return SimdLevel::AVX512;
+    return Default;
+}
+
+} // namespace
+
+SimdLevel DetectSimdLevel() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel ActiveSimdLevel() {
+    static const SimdLevel Level = [] {
+        SimdLevel Detected = DetectSimdLevel();
+        SimdLevel Requested = ParseSimdLevel(std::getenv("AQUACROP_SIMD"), Detected);
+        return (Requested < Detected) ? Requested : Detected;
+    }();
+    return Level;
+}
+
+bool SimdLevelAvailable(SimdLevel Level) {
+    return Level <= DetectSimdLevel();
+}
+
+const char* SimdLevelName(SimdLevel Level) {
+    switch (Level) {
+    case SimdLevel::SSE2: return "sse2";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+} // namespace AquaCrop
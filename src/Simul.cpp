@@ -2,18 +2,26 @@
 #include "AquaCrop/Global.h"
 #include "AquaCrop/Utils.h"
 #include "AquaCrop/ClimProcessing.h"
+#include "AquaCrop/EventTimeline.h"
 #include "AquaCrop/TempProcessing.h"
 #include "AquaCrop/PrepareFertilitySalinity.h"
 #include "AquaCrop/RootUnit.h"
 #include "AquaCrop/InfoResults.h"
 #include "AquaCrop/InitialSettings.h"
 #include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/CropCalendar.h"
+#include "AquaCrop/RunConstants.h"
+#include "AquaCrop/SoilState.h"
+#include "AquaCrop/StageProfile.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <array>
+#include <utility>
 
 namespace AquaCrop {
 
@@ -24,12 +32,14 @@ enum control_type : intEnum {
 };
 
 // --- Forward Declarations of local functions ---
+template <bool Salinity>
 void CheckWaterSaltBalance(int32_t dayi, dp InfiltratedRain, control_type control, dp InfiltratedIrrigation, dp InfiltratedStorage, dp& Surf0, dp& ECInfilt, dp& ECdrain, dp& HorizontalWaterFlow, dp& HorizontalSaltFlow, dp& SubDrain);
 void calculate_drainage();
 void calculate_runoff(dp MaxDepth);
-void Calculate_irrigation(dp& SubDrain, int32_t& TargetTimeVal, int32_t TargetDepthVal);
 void CalculateEffectiveRainfall(dp& SubDrain);
 void calculate_CapillaryRise(dp& CRwater, dp& CRsalt);
+template <bool Salinity>
+void CapillaryRise(dp& CRwater, dp& CRsalt);
 void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp InfiltratedStorage, dp SubDrain, dp ECInfilt, int32_t dayi);
 void CheckGermination();
 void EffectSoilFertilitySalinityStress(int32_t& StressSFadjNEW, dp Coeffb0Salt, dp Coeffb1Salt, dp Coeffb2Salt, int32_t NrDayGrow, dp StressTotSaltPrev, int32_t VirtualTimeCC);
@@ -51,8 +61,33 @@ void HorizontalInflowGWTable(dp DepthGWTmeter, dp& HorizontalSaltFlow, dp& Horiz
 void ConcentrateSalts();
 void AdjustpStomatalToETo(dp MeanETo, dp& pStomatULAct);
 
+namespace {
+
+// Position of a configuration in the table of BudgetStep instantiations
+constexpr int32_t BudgetConfigIndex(const rep_BudgetConfig& Config)
+{
+    return (Config.GDDays ? 1 : 0) + (Config.EffectiveRain ? 2 : 0) + (Config.Groundwater ? 4 : 0)
+        + (Config.Salinity ? 8 : 0) + 16 * (static_cast<int32_t>(Config.Bunds) + 3 * static_cast<int32_t>(Config.Irri));
+}
+
+constexpr rep_BudgetConfig BudgetConfigOf(int32_t Index)
+{
+    rep_BudgetConfig Config{};
+    Config.GDDays = (Index & 1) != 0;
+    Config.EffectiveRain = (Index & 2) != 0;
+    Config.Groundwater = (Index & 4) != 0;
+    Config.Salinity = (Index & 8) != 0;
+    Config.Bunds = static_cast<BudgetBunds>((Index / 16) % 3);
+    Config.Irri = static_cast<BudgetIrri>((Index / 16) / 3);
+    return Config;
+}
+
 // --- Core BUDGET_module ---
-void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
+// One day of the balance for the run configuration Config (rep_BudgetConfig
+// packed by BudgetConfigIndex): every fact fixed for the run is a constant
+// here, so the stages that cannot act in the configuration are not compiled.
+template <int32_t Config>
+void BudgetStep(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     int32_t VirtualTimeCC, int32_t SumInterval, int32_t DayLastCut,
     int32_t NrDayGrow, int32_t Tadj, int32_t GDDTadj, dp GDDayi,
     dp CGCref, dp GDDCGCref, dp CO2i, dp CCxTotal, dp CCoTotal, dp CDCTotal,
@@ -62,21 +97,23 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     dp& StressLeaf, dp& StressSenescence, dp& TimeSenescence,
     bool& NoMoreCrop, dp& TESTVAL)
 {
+    constexpr rep_BudgetConfig Run = BudgetConfigOf(Config);
     control_type control;
     dp InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, EpotTot, SubDrain;
     int32_t DAP;
     dp ECInfilt;
-    bool WaterTableInProfile;
+    bool WaterTableInProfile = false;
     dp HorizontalWaterFlow, HorizontalSaltFlow;
     bool SWCtopSoilConsidered_temp;
     dp EvapWCsurf_temp, CRwater_temp, Tpot_temp, Epot_temp;
-    std::vector<CompartmentIndividual> Comp_temp = Compartment;
     dp Crop_pActStom_temp;
     dp CRsalt_temp, ECdrain_temp, Surf0_temp;
     int32_t TargetTimeVal_loc = TargetTimeVal;
     int32_t StressSFadjNEW_loc = StressSFadjNEW;
+    AQUACROP_STAGE_SEQUENCE(DayNr);
 
     // 1. Soil water balance
+    AQUACROP_STAGE(BalanceBegin);
     control = control_begin_day;
     ECdrain_temp = ECdrain;
     Surf0_temp = Surf0;
@@ -88,8 +125,9 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     HorizontalSaltFlow = 0.0;
     ECInfilt = 0.0;
     SubDrain = 0.0;
+    EpotTot = 0.0;
 
-    CheckWaterSaltBalance(DayNr, InfiltratedRain, control,
+    CheckWaterSaltBalance<Run.Salinity>(DayNr, InfiltratedRain, control,
                           InfiltratedIrrigation, InfiltratedStorage,
                           Surf0_temp, ECInfilt, ECdrain_temp,
                           HorizontalWaterFlow, HorizontalSaltFlow,
@@ -98,16 +136,20 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     Surf0 = Surf0_temp;
 
     // 2. Adjustments in presence of Groundwater table
-    CheckForWaterTableInProfile(ZiAqua / 100.0, Compartment, WaterTableInProfile);
-    Comp_temp = Compartment;
-    CalculateAdjustedFC(ZiAqua / 100.0, Comp_temp);
-    Compartment = Comp_temp;
+    AQUACROP_STAGE(Groundwater);
+    if constexpr (Run.Groundwater) {
+        // recomputed only when the depth or the compartments changed
+        UpdateGroundwaterState(ZiAqua / 100.0);
+        WaterTableInProfile = DerivedSoil.WaterTableInProfile;
+    }
 
     // 3. Drainage
+    AQUACROP_STAGE(Drainage);
     calculate_drainage();
 
     // 4. Runoff
-    if (Management.BundHeight < 0.001) {
+    AQUACROP_STAGE(Runoff);
+    if constexpr (Run.Bunds == BudgetBunds::None) {
         DaySubmerged = 0;
         if (Management.RunoffOn && Rain > 0.1) {
             calculate_runoff(simulparam.RunoffDepth);
@@ -115,14 +157,17 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     }
 
     // 5. Infiltration (Rain and Irrigation)
-    if (RainRecord.DataType == datatype::decadely || RainRecord.DataType == datatype::monthly) {
+    AQUACROP_STAGE(Infiltration);
+    if constexpr (Run.EffectiveRain) {
         CalculateEffectiveRainfall(SubDrain);
     }
 
-    if (IrriMode_Val == IrriMode::Generate && Irrigation < ac_zero_threshold && TargetTimeVal_loc != undef_int) {
-        Calculate_irrigation(SubDrain, TargetTimeVal_loc, TargetDepthVal);
+    if constexpr (Run.Irri == BudgetIrri::Generate) {
+        if (Irrigation < ac_zero_threshold && TargetTimeVal_loc != NoIrriTarget) {
+            Calculate_irrigation(SubDrain, TargetTimeVal_loc, TargetDepthVal);
+        }
     }
-    if (Management.BundHeight >= 0.01) {
+    if constexpr (Run.Bunds == BudgetBunds::Ponding) {
         calculate_surfacestorage(InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, ECInfilt, SubDrain, DayNr);
     } else {
         calculate_Extra_runoff(InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, SubDrain);
@@ -130,50 +175,59 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     calculate_infiltration(InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, SubDrain);
 
     // 6. Capillary Rise
-    CRwater_temp = CRwater;
-    CRsalt_temp = CRsalt;
-    calculate_CapillaryRise(CRwater_temp, CRsalt_temp);
-    CRwater = CRwater_temp;
-    CRsalt = CRsalt_temp;
+    AQUACROP_STAGE(CapillaryRise);
+    if constexpr (Run.Groundwater) {
+        CRwater_temp = CRwater;
+        CRsalt_temp = CRsalt;
+        CapillaryRise<Run.Salinity>(CRwater_temp, CRsalt_temp);
+        CRwater = CRwater_temp;
+        CRsalt = CRsalt_temp;
+    }
 
     // 7. Salt balance
-    calculate_saltcontent(InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, SubDrain, ECInfilt, DayNr);
+    AQUACROP_STAGE(SaltBalance);
+    if constexpr (Run.Salinity) {
+        calculate_saltcontent(InfiltratedRain, InfiltratedIrrigation, InfiltratedStorage, SubDrain, ECInfilt, DayNr);
+    } else {
+        SaltInfiltr = 0.0;
+    }
 
     // 8. Check Germination
+    AQUACROP_STAGE(Germination);
     if (!Simulation.Germinate && DayNr >= crop.Day1) {
         CheckGermination();
     }
 
     // 9. Determine effect of soil fertiltiy and soil salinity stress
+    AQUACROP_STAGE(FertilitySalinity);
     if (!NoMoreCrop) {
         EffectSoilFertilitySalinityStress(StressSFadjNEW_loc, Coeffb0Salt, Coeffb1Salt, Coeffb2Salt, NrDayGrow, StressTotSaltPrev, VirtualTimeCC);
     }
 
     // 10. Canopy Cover (CC)
+    AQUACROP_STAGE(CanopyCover);
     if (!NoMoreCrop) {
         SWCtopSoilConsidered_temp = Simulation.SWCtopSoilConsidered;
         DetermineRootZoneWC(RootingDepth, SWCtopSoilConsidered_temp);
         Simulation.SWCtopSoilConsidered = SWCtopSoilConsidered_temp;
         
-        switch (crop.ModeCycle) {
-            case modeCycle::GDDays:
-                DetermineCCiGDD(CCxTotal, CCoTotal, StressLeaf, FracAssim,
-                                MobilizationON, StorageON, SumGDDadjCC,
-                                VirtualTimeCC, StressSenescence,
-                                TimeSenescence, NoMoreCrop, CDCTotal,
-                                GDDayFraction, GDDayi, GDDCDCTotal, GDDTadj);
-                break;
-            default:
-                DetermineCCi(CCxTotal, CCoTotal, StressLeaf, FracAssim,
-                             MobilizationON, StorageON, Tadj, VirtualTimeCC,
-                             StressSenescence, TimeSenescence, NoMoreCrop,
-                             CDCTotal, DayFraction, GDDCDCTotal, TESTVAL);
-                break;
+        if constexpr (Run.GDDays) {
+            DetermineCCiGDD(CCxTotal, CCoTotal, StressLeaf, FracAssim,
+                            MobilizationON, StorageON, SumGDDadjCC,
+                            VirtualTimeCC, StressSenescence,
+                            TimeSenescence, NoMoreCrop, CDCTotal,
+                            GDDayFraction, GDDayi, GDDCDCTotal, GDDTadj);
+        } else {
+            DetermineCCi(CCxTotal, CCoTotal, StressLeaf, FracAssim,
+                         MobilizationON, StorageON, Tadj, VirtualTimeCC,
+                         StressSenescence, TimeSenescence, NoMoreCrop,
+                         CDCTotal, DayFraction, GDDCDCTotal, TESTVAL);
         }
     }
 
     // 11. Determine Tpot and Epot
-    if (crop.ModeCycle == modeCycle::CalendarDays) {
+    AQUACROP_STAGE(ETpot);
+    if constexpr (!Run.GDDays) {
         DAP = VirtualTimeCC;
     } else {
         DAP = SumCalendarDays(roundc(SumGDDadjCC, 1), crop.Day1,
@@ -198,11 +252,18 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     crop.pActStom = Crop_pActStom_temp;
 
     // 12. Evaporation
+    AQUACROP_STAGE(Evaporation);
     if (!PreDay) {
         PrepareStage2();
     }
-    if (Rain > 0.0 || (Irrigation > 0.0 && IrriMode_Val != IrriMode::Inet)) {
-        PrepareStage1();
+    if constexpr (Run.Irri == BudgetIrri::Net) {
+        if (Rain > 0.0) {
+            PrepareStage1();
+        }
+    } else {
+        if (Rain > 0.0 || Irrigation > 0.0) {
+            PrepareStage1();
+        }
     }
     EvapWCsurf_temp = Simulation.EvapWCsurf;
     Epot_temp = Epot;
@@ -210,8 +271,10 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     Epot = Epot_temp;
     Simulation.EvapWCsurf = EvapWCsurf_temp;
     
-    if ((RainRecord.DataType == datatype::decadely || RainRecord.DataType == datatype::monthly) && simulparam.EffectiveRain.RootNrEvap > 0) {
-        Epot = Epot * (std::exp((1.0/static_cast<dp>(simulparam.EffectiveRain.RootNrEvap)) * std::log((Soil.REW+1.0)/20.0)));
+    if constexpr (Run.EffectiveRain) {
+        if (simulparam.EffectiveRain.RootNrEvap > 0) {
+            Epot = Epot * RunConst.fEvapRootNr;
+        }
     }
 
     Eact = 0.0;
@@ -227,11 +290,14 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
         }
     }
     
-    if ((RainRecord.DataType == datatype::decadely || RainRecord.DataType == datatype::monthly) && simulparam.EffectiveRain.RootNrEvap > 0.0) {
-        Epot = Epot / (std::exp((1.0/static_cast<dp>(simulparam.EffectiveRain.RootNrEvap)) * std::log((Soil.REW+1.0)/20.0)));
+    if constexpr (Run.EffectiveRain) {
+        if (simulparam.EffectiveRain.RootNrEvap > 0.0) {
+            Epot = Epot / RunConst.fEvapRootNr;
+        }
     }
 
     // 13. Transpiration
+    AQUACROP_STAGE(Transpiration);
     if (!NoMoreCrop && RootingDepth > 0.0001) {
         if (SurfaceStorage > 0.0 && (crop.AnaeroPoint == 0 || DaySubmerged < simulparam.DelayLowOxygen)) {
             surface_transpiration(Coeffb0Salt, Coeffb1Salt, Coeffb2Salt);
@@ -245,18 +311,25 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     FeedbackCC();
 
     // 14. Adjustment to groundwater table
-    if (WaterTableInProfile) {
-        HorizontalInflowGWTable(ZiAqua / 100.0, HorizontalSaltFlow, HorizontalWaterFlow);
+    AQUACROP_STAGE(GroundwaterInflow);
+    if constexpr (Run.Groundwater) {
+        if (WaterTableInProfile) {
+            HorizontalInflowGWTable(ZiAqua / 100.0, HorizontalSaltFlow, HorizontalWaterFlow);
+        }
     }
 
     // 15. Salt concentration
-    ConcentrateSalts();
+    AQUACROP_STAGE(SaltConcentration);
+    if constexpr (Run.Salinity) {
+        ConcentrateSalts();
+    }
 
     // 16. Soil water balance
+    AQUACROP_STAGE(BalanceEnd);
     control = control_end_day;
     ECdrain_temp = ECdrain;
     Surf0_temp = Surf0;
-    CheckWaterSaltBalance(DayNr, InfiltratedRain, control,
+    CheckWaterSaltBalance<Run.Salinity>(DayNr, InfiltratedRain, control,
                                InfiltratedIrrigation, InfiltratedStorage,
                                Surf0_temp, ECInfilt, ECdrain_temp,
                                HorizontalWaterFlow, HorizontalSaltFlow,
@@ -265,6 +338,95 @@ void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
     Surf0 = Surf0_temp;
 }
 
+template <int32_t... Config>
+constexpr std::array<BudgetModuleFn, sizeof...(Config)> BudgetStepTable(std::integer_sequence<int32_t, Config...>)
+{
+    return {&BudgetStep<Config>...};
+}
+
+constexpr std::array<BudgetModuleFn, NrBudgetConfigs> BudgetSteps =
+    BudgetStepTable(std::make_integer_sequence<int32_t, NrBudgetConfigs>{});
+
+// Salt that can enter or already is in the profile during the run: in the
+// compartments, on the surface, in the irrigation water, or in the
+// groundwater when it can reach the profile
+bool SaltInRun(bool Groundwater)
+{
+    if (ECstorage != 0.0 || Simulation.IrriECw != 0.0 || IrriECw.PreSeason != 0.0 || IrriECw.PostSeason != 0.0) {
+        return true;
+    }
+    for (const rep_IrriEvent& Irri : EventTimeline.Irrigations) {
+        if (Irri.ECw != 0.0) return true;
+    }
+    for (const rep_IrriRule& Rule : IrriGenerateRules) {
+        if (Rule.ECw != 0.0) return true;
+    }
+    if (Groundwater) {
+        if (ECiAqua != 0.0) return true;
+        for (const rep_GwtPoint& Point : EventTimeline.GwtPoints) {
+            if (Point.ECdSm != 0.0) return true;
+        }
+    }
+    for (const CompartmentSaltIndividual& CompSalt : CompartmentSalt) {
+        for (dp Salt : CompSalt.Salt) {
+            if (Salt != 0.0) return true;
+        }
+        for (dp Depo : CompSalt.Depo) {
+            if (Depo != 0.0) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+rep_BudgetConfig CurrentBudgetConfig()
+{
+    rep_BudgetConfig Config;
+    Config.GDDays = (crop.ModeCycle == modeCycle::GDDays);
+    Config.EffectiveRain = (RainRecord.DataType == datatype::decadely || RainRecord.DataType == datatype::monthly);
+    if (Management.BundHeight >= 0.01) {
+        Config.Bunds = BudgetBunds::Ponding;
+    } else if (Management.BundHeight >= 0.001) {
+        Config.Bunds = BudgetBunds::Low;
+    } else {
+        Config.Bunds = BudgetBunds::None;
+    }
+    if (IrriMode_Val == IrriMode::Generate) {
+        Config.Irri = BudgetIrri::Generate;
+    } else if (IrriMode_Val == IrriMode::Inet) {
+        Config.Irri = BudgetIrri::Net;
+    } else {
+        Config.Irri = BudgetIrri::Fixed;
+    }
+    // ZiAqua only changes with a variable table (AdvanceOneTimeStep)
+    Config.Groundwater = (ZiAqua > 0.0 || (!simulparam.ConstGwt && !EventTimeline.GwtPoints.empty()));
+    Config.Salinity = SaltInRun(Config.Groundwater);
+    return Config;
+}
+
+BudgetModuleFn SelectBudgetModule(const rep_BudgetConfig& Config)
+{
+    return BudgetSteps[BudgetConfigIndex(Config)];
+}
+
+void Budget_module(int32_t DayNr, int32_t TargetTimeVal, int32_t TargetDepthVal,
+    int32_t VirtualTimeCC, int32_t SumInterval, int32_t DayLastCut,
+    int32_t NrDayGrow, int32_t Tadj, int32_t GDDTadj, dp GDDayi,
+    dp CGCref, dp GDDCGCref, dp CO2i, dp CCxTotal, dp CCoTotal, dp CDCTotal,
+    dp GDDCDCTotal, dp SumGDDadjCC, dp Coeffb0Salt, dp Coeffb1Salt, dp Coeffb2Salt,
+    dp StressTotSaltPrev, dp DayFraction, dp GDDayFraction, dp FracAssim,
+    int32_t StressSFadjNEW, bool StorageON, bool MobilizationON,
+    dp& StressLeaf, dp& StressSenescence, dp& TimeSenescence,
+    bool& NoMoreCrop, dp& TESTVAL)
+{
+    SelectBudgetModule(CurrentBudgetConfig())(DayNr, TargetTimeVal, TargetDepthVal, VirtualTimeCC,
+        SumInterval, DayLastCut, NrDayGrow, Tadj, GDDTadj, GDDayi, CGCref, GDDCGCref, CO2i,
+        CCxTotal, CCoTotal, CDCTotal, GDDCDCTotal, SumGDDadjCC, Coeffb0Salt, Coeffb1Salt, Coeffb2Salt,
+        StressTotSaltPrev, DayFraction, GDDayFraction, FracAssim, StressSFadjNEW, StorageON,
+        MobilizationON, StressLeaf, StressSenescence, TimeSenescence, NoMoreCrop, TESTVAL);
+}
+
 void AdjustpStomatalToETo(dp MeanETo, dp& pStomatULAct) {
     if (crop.CropPMethod == pMethod::FAOCorrection) {
         pStomatULAct = crop.pdef + (5.0 - MeanETo) * simulparam.pAdjFAO;
@@ -276,38 +438,18 @@ void AdjustpStomatalToETo(dp MeanETo, dp& pStomatULAct) {
 }
 
 void DetermineRootZoneWC(dp RootingDepth, bool& ZtopSWCconsidered) {
-    dp Ztop, Zbot, depthi, theta, theta_fc, theta_wp, theta_sat;
-    int32_t compi, layeri;
+    int32_t compi;
 
-    RootZoneWC.Actual = 0.0;
-    RootZoneWC.FC = 0.0;
-    RootZoneWC.WP = 0.0;
-    RootZoneWC.SAT = 0.0;
+    // the extent of the root zone and its water at FC, WP and SAT only
+    // change with RootingDepth (SoilState.h)
+    UpdateRootZoneState(RootingDepth);
+    RootZoneWC.FC = DerivedSoil.RootZoneFC;
+    RootZoneWC.WP = DerivedSoil.RootZoneWP;
+    RootZoneWC.SAT = DerivedSoil.RootZoneSAT;
 
-    depthi = 0.0;
-    for (compi = 1; compi <= NrCompartments; ++compi) {
-        layeri = Compartment[compi - 1].Layer;
-        theta = Compartment[compi - 1].theta;
-        theta_fc = soillayer[layeri - 1].FC / 100.0;
-        theta_wp = soillayer[layeri - 1].WP / 100.0;
-        theta_sat = soillayer[layeri - 1].SAT / 100.0;
-
-        Ztop = depthi;
-        depthi += Compartment[compi - 1].Thickness;
-        Zbot = depthi;
-
-        if (Zbot <= RootingDepth) {
-            RootZoneWC.Actual += theta * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-            RootZoneWC.FC += theta_fc * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-            RootZoneWC.WP += theta_wp * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-            RootZoneWC.SAT += theta_sat * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-        } else if (Ztop < RootingDepth) {
-            RootZoneWC.Actual += theta * 1000.0 * (RootingDepth - Ztop) * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-            RootZoneWC.FC += theta_fc * 1000.0 * (RootingDepth - Ztop) * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-            RootZoneWC.WP += theta_wp * 1000.0 * (RootingDepth - Ztop) * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-            RootZoneWC.SAT += theta_sat * 1000.0 * (RootingDepth - Ztop) * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
-        }
-        if (depthi >= RootingDepth) break;
+    RootZoneWC.Actual = 0.0;
+    for (compi = 1; compi <= DerivedSoil.RootZoneNrComp; ++compi) {
+        RootZoneWC.Actual += Compartment[compi - 1].theta * 1000.0 * DerivedSoil.RootZoneDZ[compi - 1] * DerivedSoil.RootZoneGravel[compi - 1];
     }
 }
 
@@ -322,14 +464,10 @@ void FeedbackCC() {
 }
 
 void ConcentrateSalts() {
-    int32_t compi, celli;
-    dp SaltSolub;
+    int32_t compi;
 
-    SaltSolub = static_cast<dp>(simulparam.SaltSolub);
     for (compi = 1; compi <= NrCompartments; ++compi) {
-        for (celli = 1; celli <= soillayer[Compartment[compi - 1].Layer - 1].SCP1; ++celli) {
-            SaltSolutionDeposit(Compartment[compi - 1].Thickness * 1000.0, Compartment[compi - 1].Salt[celli - 1], Compartment[compi - 1].Depo[celli - 1]);
-        }
+        SaltSolutionDepositCells(Compartment[compi - 1].Thickness * 1000.0, CompartmentSalt[compi - 1].Salt.data(), CompartmentSalt[compi - 1].Depo.data(), soillayer[Compartment[compi - 1].Layer - 1].SCP1);
     }
 }
 
@@ -348,11 +486,7 @@ void PrepareStage2() {
 }
 
 void AdjustEpotMulchWettedSurface(int32_t dayi, dp EpotTot, dp& Epot, dp& EvapWCsurface) {
-    dp fMulch = 1.0;
-    if (Management.Mulch > 0) {
-        fMulch = 1.0 - (static_cast<dp>(Management.Mulch) / 100.0) * (static_cast<dp>(Management.EffectMulchInS) / 100.0);
-    }
-    Epot = EpotTot * fMulch;
+    Epot = EpotTot * RunConst.fMulch;
     EvapWCsurface = Simulation.EvapWCsurf;
 }
 
@@ -464,7 +598,7 @@ void CalculateSoilEvaporationStage2() {
 
 
 
-    Kr = SoilEvaporationReductionCoefficient(Wrel, static_cast<dp>(simulparam.EvapDeclineFactor));
+    Kr = SoilEvaporationReductionCoefficient(Wrel, RunConst.EvapDecline, RunConst.ExpEvapDeclineMin1);
 
 
 
@@ -1394,6 +1528,7 @@ void calculate_transpiration(dp Tpot, dp Coeffb0Salt, dp Coeffb1Salt, dp Coeffb2
 
 // --- Placeholder implementations ---// Note: Actual implementation should be moved here as they are ported.
 
+template <bool Salinity>
 void CheckWaterSaltBalance(int32_t dayi, dp InfiltratedRain, control_type control, dp InfiltratedIrrigation, dp InfiltratedStorage, dp& Surf0, dp& ECInfilt, dp& ECdrain, dp& HorizontalWaterFlow, dp& HorizontalSaltFlow, dp& SubDrain) {
     dp Surf1, ECw;
 
@@ -1407,9 +1542,11 @@ void CheckWaterSaltBalance(int32_t dayi, dp InfiltratedRain, control_type contro
                  Compartment[compi-1].Thickness * (1.0 -
                   soillayer[Compartment[compi-1].Layer - 1].GravelVol / 100.0);
             Compartment[compi-1].fluxout = 0.0;
-            for (int32_t celli = 1; celli <= soillayer[Compartment[compi-1].Layer - 1].SCP1; ++celli) {
-                TotalSaltContent.BeginDay += (Compartment[compi-1].Salt[celli-1] +
-                          Compartment[compi-1].Depo[celli-1]) / 100.0; // Mg/ha
+            if constexpr (Salinity) {
+                for (int32_t celli = 1; celli <= soillayer[Compartment[compi-1].Layer - 1].SCP1; ++celli) {
+                    TotalSaltContent.BeginDay += (CompartmentSalt[compi-1].Salt[celli-1] +
+                              CompartmentSalt[compi-1].Depo[celli-1]) / 100.0; // Mg/ha
+                }
             }
         }
         Drain = 0.0;
@@ -1452,9 +1589,11 @@ void CheckWaterSaltBalance(int32_t dayi, dp InfiltratedRain, control_type contro
                     Compartment[compi-1].theta * 1000.0 *
                           Compartment[compi-1].theta * (1.0 -
                        soillayer[Compartment[compi-1].Layer - 1].GravelVol / 100.0);
-            for (int32_t celli = 1; celli <= soillayer[Compartment[compi-1].Layer - 1].SCP1; ++celli) {
-                TotalSaltContent.EndDay += (Compartment[compi-1].Salt[celli-1] +
-                      Compartment[compi-1].Depo[celli-1]) / 100.0; // Mg/ha
+            if constexpr (Salinity) {
+                for (int32_t celli = 1; celli <= soillayer[Compartment[compi-1].Layer - 1].SCP1; ++celli) {
+                    TotalSaltContent.EndDay += (CompartmentSalt[compi-1].Salt[celli-1] +
+                          CompartmentSalt[compi-1].Depo[celli-1]) / 100.0; // Mg/ha
+                }
             }
         }
         TotalWaterContent.ErrorDay = TotalWaterContent.BeginDay + Surf0 - (TotalWaterContent.EndDay + Drain + Runoff + Eact + Tact + Surf1 - Rain - Irrigation - CRwater - HorizontalWaterFlow);
@@ -1487,19 +1626,20 @@ void CheckWaterSaltBalance(int32_t dayi, dp InfiltratedRain, control_type contro
         break;
     }
 }
+// Both use the coefficients cached in the layer (DetermineDrainageCoefficients),
+// in the same operations as with SAT, FC and tau
 dp calculate_delta_theta(dp theta_in, dp thetaAdjFC, int32_t NrLayer) {
-    dp DeltaX, theta, theta_sat, theta_fc;
+    dp DeltaX, theta;
+    const SoilLayerIndividual& Layer = soillayer[NrLayer - 1];
 
     theta = theta_in;
-    theta_sat = soillayer[NrLayer - 1].SAT / 100.0;
-    theta_fc = soillayer[NrLayer - 1].FC / 100.0;
-    if (theta > theta_sat) {
-        theta = theta_sat;
+    if (theta > Layer.ThetaSat) {
+        theta = Layer.ThetaSat;
     }
     if (theta <= thetaAdjFC) {
         DeltaX = 0.0;
     } else {
-        DeltaX = soillayer[NrLayer - 1].tau * (theta_sat - theta_fc) * (std::exp(theta - theta_fc) - 1.0) / (std::exp(theta_sat - theta_fc) - 1.0);
+        DeltaX = Layer.TauRange * (std::exp(theta - Layer.ThetaFC) - 1.0) / Layer.ExpRangeMin1;
         if ((theta - DeltaX) < thetaAdjFC) {
             DeltaX = theta - thetaAdjFC;
         }
@@ -1508,20 +1648,18 @@ dp calculate_delta_theta(dp theta_in, dp thetaAdjFC, int32_t NrLayer) {
 }
 
 dp calculate_theta_from_delta(dp delta_theta, dp thetaAdjFC, int32_t NrLayer) {
-    dp ThetaX, theta_sat, theta_fc, tau;
+    dp ThetaX;
+    const SoilLayerIndividual& Layer = soillayer[NrLayer - 1];
 
-    theta_sat = soillayer[NrLayer - 1].SAT / 100.0;
-    theta_fc = soillayer[NrLayer - 1].FC / 100.0;
-    tau = soillayer[NrLayer - 1].tau;
     if (delta_theta <= 1e-12) {
         ThetaX = thetaAdjFC;
-    } else if (tau > 0.0) {
-        ThetaX = theta_fc + std::log(1.0 + delta_theta * (std::exp(theta_sat - theta_fc) - 1.0) / (tau * (theta_sat - theta_fc)));
+    } else if (Layer.tau > 0.0) {
+        ThetaX = Layer.ThetaFC + std::log(1.0 + delta_theta * Layer.ExpRangeMin1 / Layer.TauRange);
         if (ThetaX < thetaAdjFC) {
             ThetaX = thetaAdjFC;
         }
     } else {
-        ThetaX = theta_sat + 0.1;
+        ThetaX = Layer.ThetaSat + 0.1;
     }
     return ThetaX;
 }
@@ -1664,21 +1802,20 @@ void calculate_weighting_factors(dp Depth, std::vector<CompartmentIndividual>& C
 void calculate_relative_wetness_topsoil(dp& SUM, dp MaxDepth) {
     dp CumDepth, theta;
     int32_t compi, layeri;
-    std::vector<CompartmentIndividual> Compartment_temp = Compartment;
+    const std::vector<dp>& WFactor = WeightingFactors(MaxDepth);
 
-    calculate_weighting_factors(MaxDepth, Compartment_temp);
     SUM = 0.0;
     CumDepth = 0.0;
 
     for (compi = 1; compi <= NrCompartments; ++compi) {
-        layeri = Compartment_temp[compi - 1].Layer;
-        CumDepth += Compartment_temp[compi - 1].Thickness;
-        if (Compartment_temp[compi - 1].theta < soillayer[layeri - 1].WP / 100.0) {
+        layeri = Compartment[compi - 1].Layer;
+        CumDepth += Compartment[compi - 1].Thickness;
+        if (Compartment[compi - 1].theta < soillayer[layeri - 1].WP / 100.0) {
             theta = soillayer[layeri - 1].WP / 100.0;
         } else {
-            theta = Compartment_temp[compi - 1].theta;
+            theta = Compartment[compi - 1].theta;
         }
-        SUM += Compartment_temp[compi - 1].WFactor * (theta - soillayer[layeri - 1].WP / 100.0) / (soillayer[layeri - 1].FC / 100.0 - soillayer[layeri - 1].WP / 100.0);
+        SUM += WFactor[compi - 1] * (theta - soillayer[layeri - 1].WP / 100.0) / (soillayer[layeri - 1].FC / 100.0 - soillayer[layeri - 1].WP / 100.0);
         if (CumDepth >= MaxDepth) break;
     }
 
@@ -1694,11 +1831,12 @@ void calculate_runoff(dp MaxDepth) {
     dp SUM, CNA, Shower, term, S;
     int8_t CN2, CN1, CN3;
 
-    CN2 = static_cast<int8_t>(roundc(static_cast<dp>(Soil.CNvalue) * (100.0 + static_cast<dp>(Management.CNcorrection)) / 100.0, 1));
+    CN2 = RunConst.CN2;
     if (RainRecord.DataType == datatype::daily) {
         if (simulparam.CNcorrection) {
             calculate_relative_wetness_topsoil(SUM, MaxDepth);
-            DetermineCNIandIII(CN2, CN1, CN3);
+            CN1 = RunConst.CN1;
+            CN3 = RunConst.CN3;
             CNA = static_cast<dp>(roundc(static_cast<dp>(CN1) + (static_cast<dp>(CN3) - static_cast<dp>(CN1)) * SUM, 1));
         } else {
             CNA = static_cast<dp>(CN2);
@@ -1727,24 +1865,39 @@ void calculate_runoff(dp MaxDepth) {
     }
 }
 void Calculate_irrigation(dp& SubDrain, int32_t& TargetTimeVal, int32_t TargetDepthVal) {
-    dp depletion, RAW, TAW;
+    dp ZrWC, RAWi;
+    bool SWCtopSoilConsidered_temp;
 
-    depletion = RootZoneWC.FC - RootZoneWC.Actual;
-    TAW = RootZoneWC.FC - RootZoneWC.WP;
-    RAW = (static_cast<dp>(simulparam.PercRAW) / 100.0) * TAW;
+    // root zone water content expected at the end of the day without irrigation
+    SWCtopSoilConsidered_temp = Simulation.SWCtopSoilConsidered;
+    DetermineRootZoneWC(RootingDepth, SWCtopSoilConsidered_temp);
+    Simulation.SWCtopSoilConsidered = SWCtopSoilConsidered_temp;
+    ZrWC = RootZoneWC.Actual - Epot - Tpot + Rain - Runoff - SubDrain;
 
     switch (GenerateTimeMode_Val) {
-    case GenerateTimeMode::AllRAW:
-        if (depletion >= RAW) {
-            Irrigation = depletion;
-        }
+    case GenerateTimeMode::AllDepl:
+        TargetTimeVal = ((RootZoneWC.FC - ZrWC) >= TargetTimeVal) ? 1 : 0;
         break;
-    case GenerateTimeMode::FixInt:
-        // simplified
+    case GenerateTimeMode::AllRAW:
+        RAWi = (static_cast<dp>(TargetTimeVal) / 100.0) * crop.pActStom * (RootZoneWC.FC - RootZoneWC.WP);
+        TargetTimeVal = ((RootZoneWC.FC - ZrWC) >= RAWi) ? 1 : 0;
         break;
-    default:
+    default: // FixInt and WaterBetweenBunds are decided in GetIrriParam
         break;
     }
+
+    if (TargetTimeVal == 1) {
+        if (GenerateDepthMode_Val == GenerateDepthMode::FixDepth) {
+            Irrigation = static_cast<dp>(TargetDepthVal);
+        } else {
+            Irrigation = std::max(0.0, (RootZoneWC.FC - ZrWC) + TargetDepthVal);
+        }
+    } else {
+        Irrigation = 0.0;
+    }
+    if (IrriSeasonCap != undef_double) {
+        Irrigation = std::min(Irrigation, std::max(0.0, IrriSeasonCap - SumWaBal.Irrigation));
+    }
 }
 
 // --- Placeholder implementations ---
@@ -1813,7 +1966,8 @@ void CalculateEffectiveRainfall(dp& SubDrain) {
         }
     }
 }
-void calculate_CapillaryRise(dp& CRwater, dp& CRsalt) {
+template <bool Salinity>
+void CapillaryRise(dp& CRwater, dp& CRsalt) {
     dp DepthGWTmeter, Ztop, Zbot, Zi, CRmax, CRactual, CRcomp, SaltCRcomp, delta_theta;
     int32_t compi, layeri;
 
@@ -1822,6 +1976,7 @@ void calculate_CapillaryRise(dp& CRwater, dp& CRsalt) {
     CRsalt = 0.0;
 
     if (DepthGWTmeter > 0.0) {
+        UpdateGroundwaterState(DepthGWTmeter);
         Zbot = 0.0;
         for (compi = 1; compi <= NrCompartments; ++compi) {
             Ztop = Zbot;
@@ -1829,7 +1984,7 @@ void calculate_CapillaryRise(dp& CRwater, dp& CRsalt) {
             Zi = (Ztop + Zbot) / 2.0;
             layeri = Compartment[compi - 1].Layer;
             if (Zi < DepthGWTmeter) {
-                CRmax = MaxCRatDepth(soillayer[layeri - 1].CRa, soillayer[layeri - 1].CRb, (soillayer[layeri - 1].tau * 1000.0), Zi, DepthGWTmeter);
+                CRmax = DerivedSoil.CRmax[compi - 1];
                 CRactual = CRmax; // simplified: actual CR is max CR for now
                 delta_theta = soillayer[layeri - 1].SAT / 100.0 - Compartment[compi - 1].theta;
                 CRcomp = delta_theta * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[layeri - 1].GravelVol / 100.0);
@@ -1838,62 +1993,53 @@ void calculate_CapillaryRise(dp& CRwater, dp& CRsalt) {
                 }
                 Compartment[compi - 1].theta += CRactual / (1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[layeri - 1].GravelVol / 100.0));
                 CRwater += CRactual;
-                SaltCRcomp = CRactual * ECiAqua * equiv / 100.0;
-                SaltSolutionDeposit(Compartment[compi - 1].Thickness * 1000.0, Compartment[compi - 1].Salt[0], Compartment[compi - 1].Depo[0]);
-                Compartment[compi - 1].Salt[0] += SaltCRcomp;
-                CRsalt += SaltCRcomp;
+                if constexpr (Salinity) {
+                    SaltCRcomp = CRactual * ECiAqua * equiv / 100.0;
+                    SaltSolutionDeposit(Compartment[compi - 1].Thickness * 1000.0, CompartmentSalt[compi - 1].Salt[0], CompartmentSalt[compi - 1].Depo[0]);
+                    CompartmentSalt[compi - 1].Salt[0] += SaltCRcomp;
+                    CRsalt += SaltCRcomp;
+                }
             }
         }
     }
 }
-void Mixing(dp Dif, dp mm1, dp mm2, dp& Salt1, dp& Salt2, dp& Depo1, dp& Depo2) {
-    dp EC1, EC2, ECmix;
-
-    SaltSolutionDeposit(mm1, Salt1, Depo1);
-    EC1 = Salt1 / (mm1 * equiv);
-    SaltSolutionDeposit(mm2, Salt2, Depo2);
-    EC2 = Salt2 / (mm2 * equiv);
-    ECmix = (EC1 * mm1 + EC2 * mm2) / (mm1 + mm2);
-    EC1 = EC1 + (ECmix - EC1) * Dif;
-    EC2 = EC2 + (ECmix - EC2) * Dif;
-    Salt1 = EC1 * mm1 * equiv;
-    SaltSolutionDeposit(mm1, Salt1, Depo1);
-    Salt2 = EC2 * mm2 * equiv;
-    SaltSolutionDeposit(mm2, Salt2, Depo2);
-}
 
-void MoveSaltTo(CompartmentIndividual& Compx, int32_t celx, dp DS) {
+void calculate_CapillaryRise(dp& CRwater, dp& CRsalt) {
+    CapillaryRise<true>(CRwater, CRsalt);
+}
+void MoveSaltTo(const CompartmentIndividual& Compx, CompartmentSaltIndividual& SaltX, int32_t celx, dp DS) {
     dp mmx;
     int32_t celx_local = celx;
 
     if (DS >= 0.0) {
-        Compx.Salt[celx_local-1] += DS;
+        SaltX.Salt[celx_local-1] += DS;
         mmx = soillayer[Compx.Layer - 1].Dx * 1000.0 * Compx.Thickness * (1.0 - soillayer[Compx.Layer - 1].GravelVol / 100.0);
         if (celx_local == (int32_t)soillayer[Compx.Layer - 1].SCP1) {
             mmx = 2.0 * mmx;
         }
-        SaltSolutionDeposit(mmx, Compx.Salt[celx_local - 1], Compx.Depo[celx_local - 1]);
+        SaltSolutionDeposit(mmx, SaltX.Salt[celx_local - 1], SaltX.Depo[celx_local - 1]);
     } else {
         celx_local = (int32_t)soillayer[Compx.Layer - 1].SCP1;
-        Compx.Salt[celx_local-1] += DS;
+        SaltX.Salt[celx_local-1] += DS;
         mmx = 2.0 * soillayer[Compx.Layer - 1].Dx * 1000.0 * Compx.Thickness * (1.0 - soillayer[Compx.Layer - 1].GravelVol / 100.0);
-        SaltSolutionDeposit(mmx, Compx.Salt[celx_local - 1], Compx.Depo[celx_local - 1]);
+        SaltSolutionDeposit(mmx, SaltX.Salt[celx_local - 1], SaltX.Depo[celx_local - 1]);
         mmx = mmx / 2.0;
-        while (Compx.Salt[celx_local - 1] < 0.0) {
+        while (SaltX.Salt[celx_local - 1] < 0.0) {
             if (celx_local == 1) {
                 // Should not happen based on Fortran logic but handle it
                 break;
             }
-            Compx.Salt[celx_local - 2] += Compx.Salt[celx_local - 1];
-            Compx.Salt[celx_local - 1] = 0.0;
+            SaltX.Salt[celx_local - 2] += SaltX.Salt[celx_local - 1];
+            SaltX.Salt[celx_local - 1] = 0.0;
             celx_local--;
-            SaltSolutionDeposit(mmx, Compx.Salt[celx_local - 1], Compx.Depo[celx_local - 1]);
+            SaltSolutionDeposit(mmx, SaltX.Salt[celx_local - 1], SaltX.Depo[celx_local - 1]);
         }
     }
 }
 
 void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp InfiltratedStorage, dp SubDrain, dp ECInfilt, int32_t dayi) {
-    dp SaltIN, SaltOUT, mmIN, DeltaTheta, Theta, SAT, mm1, mm2, Dx, limit, Dif, UL;
+    dp SaltIN, SaltOUT, mmIN, DeltaTheta, Theta, SAT, mm1, mm2, Dx, limit, UL;
+    std::array<dp, SaltCellStride> mm2Cells;
     dp Zr, depthi, ECsubdrain, ECcel, DeltaZ, ECsw1, ECsw2, ECsw, SM1, SM2, DS1, DS2, DS;
     int32_t compi, celi, celiM1, Ni;
     dp ECw;
@@ -1933,12 +2079,13 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
         if (celi == 0) celi = 1;
 
         if (DeltaTheta > 0.0) {
-            Compartment[compi - 1].Salt[celi - 1] += SaltIN;
+            CompartmentSalt[compi - 1].Salt[celi - 1] += SaltIN;
         }
 
         if (celi > 1) {
+            // mixing of the cells 1..celi pair by pair (vectorized, see Simd.h)
+            mm1 = Dx * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
             for (Ni = 1; Ni <= (celi - 1); ++Ni) {
-                mm1 = Dx * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
                 if (Ni < (int32_t)soillayer[Compartment[compi - 1].Layer - 1].SC) {
                     mm2 = mm1;
                 } else if (Theta > SAT) {
@@ -1946,9 +2093,10 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
                 } else {
                     mm2 = (SAT - UL) * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
                 }
-                Dif = soillayer[Compartment[compi - 1].Layer - 1].SaltMobility[Ni - 1];
-                Mixing(Dif, mm1, mm2, Compartment[compi - 1].Salt[Ni - 1], Compartment[compi - 1].Salt[Ni], Compartment[compi - 1].Depo[Ni - 1], Compartment[compi - 1].Depo[Ni]);
+                mm2Cells[Ni - 1] = mm2;
             }
+            MixSaltCells(celi - 1, soillayer[Compartment[compi - 1].Layer - 1].SaltMobility.data(), mm1, mm2Cells.data(),
+                         CompartmentSalt[compi - 1].Salt.data(), CompartmentSalt[compi - 1].Depo.data());
         }
 
         SaltOUT = 0.0;
@@ -1961,25 +2109,25 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
                     limit = UL;
                 }
                 if ((Theta - DeltaTheta) < limit) {
-                    SaltOUT += Compartment[compi - 1].Salt[celi - 1] + Compartment[compi - 1].Depo[celi - 1];
-                    Compartment[compi - 1].Salt[celi - 1] = 0.0;
+                    SaltOUT += CompartmentSalt[compi - 1].Salt[celi - 1] + CompartmentSalt[compi - 1].Depo[celi - 1];
+                    CompartmentSalt[compi - 1].Salt[celi - 1] = 0.0;
                     mm1 = (Theta - limit) * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
                     if (SaltOUT > (static_cast<dp>(simulparam.SaltSolub) * mm1)) {
-                        Compartment[compi - 1].Depo[celi - 1] = SaltOUT - (static_cast<dp>(simulparam.SaltSolub) * mm1);
+                        CompartmentSalt[compi - 1].Depo[celi - 1] = SaltOUT - (static_cast<dp>(simulparam.SaltSolub) * mm1);
                         SaltOUT = static_cast<dp>(simulparam.SaltSolub) * mm1;
                     } else {
-                        Compartment[compi - 1].Depo[celi - 1] = 0.0;
+                        CompartmentSalt[compi - 1].Depo[celi - 1] = 0.0;
                     }
                     DeltaTheta -= (Theta - limit);
                     Theta = limit;
                     celi--;
                 } else {
-                    SaltOUT += (Compartment[compi - 1].Salt[celi - 1] + Compartment[compi - 1].Depo[celi - 1]) * (DeltaTheta / (Theta - limit));
-                    Compartment[compi - 1].Salt[celi - 1] *= (1.0 - DeltaTheta / (Theta - limit));
-                    Compartment[compi - 1].Depo[celi - 1] *= (1.0 - DeltaTheta / (Theta - limit));
+                    SaltOUT += (CompartmentSalt[compi - 1].Salt[celi - 1] + CompartmentSalt[compi - 1].Depo[celi - 1]) * (DeltaTheta / (Theta - limit));
+                    CompartmentSalt[compi - 1].Salt[celi - 1] *= (1.0 - DeltaTheta / (Theta - limit));
+                    CompartmentSalt[compi - 1].Depo[celi - 1] *= (1.0 - DeltaTheta / (Theta - limit));
                     mm1 = DeltaTheta * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
                     if (SaltOUT > (static_cast<dp>(simulparam.SaltSolub) * mm1)) {
-                        Compartment[compi - 1].Depo[celi - 1] += (SaltOUT - static_cast<dp>(simulparam.SaltSolub) * mm1);
+                        CompartmentSalt[compi - 1].Depo[celi - 1] += (SaltOUT - static_cast<dp>(simulparam.SaltSolub) * mm1);
                         SaltOUT = static_cast<dp>(simulparam.SaltSolub) * mm1;
                     }
                     DeltaTheta = 0.0;
@@ -1987,7 +2135,7 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
                     if (celi == (int32_t)soillayer[Compartment[compi - 1].Layer - 1].SCP1) {
                         mm1 = 2.0 * mm1;
                     }
-                    SaltSolutionDeposit(mm1, Compartment[compi - 1].Salt[celi - 1], Compartment[compi - 1].Depo[celi - 1]);
+                    SaltSolutionDeposit(mm1, CompartmentSalt[compi - 1].Salt[celi - 1], CompartmentSalt[compi - 1].Depo[celi - 1]);
                 }
             }
         }
@@ -2002,7 +2150,7 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
     if (NrCompartments > 0) {
         celi = ActiveCells(Compartment[0]);
         SM2 = soillayer[Compartment[0].Layer - 1].SaltMobility[celi - 1] / 4.0;
-        ECsw2 = ECswComp(Compartment[0], false);
+        ECsw2 = ECswComp(Compartment[0], CompartmentSalt[0], false);
         mm2 = Compartment[0].theta * 1000.0 * Compartment[0].Thickness * (1.0 - soillayer[Compartment[0].Layer - 1].GravelVol / 100.0);
         for (compi = 2; compi <= NrCompartments; ++compi) {
             celiM1 = celi;
@@ -2011,7 +2159,7 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
             mm1 = mm2;
             celi = ActiveCells(Compartment[compi - 1]);
             SM2 = soillayer[Compartment[compi - 1].Layer - 1].SaltMobility[celi - 1] / 4.0;
-            ECsw2 = ECswComp(Compartment[compi - 1], false);
+            ECsw2 = ECswComp(Compartment[compi - 1], CompartmentSalt[compi - 1], false);
             mm2 = Compartment[compi - 1].theta * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
             ECsw = (ECsw1 * mm1 + ECsw2 * mm2) / (mm1 + mm2);
             DS1 = (ECsw1 - (ECsw1 + (ECsw - ECsw1) * SM1)) * mm1 * equiv;
@@ -2025,9 +2173,9 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
                 if (ECsw1 > ECsw) {
                     DS = DS * (-1.0);
                 }
-                MoveSaltTo(Compartment[compi - 2], celiM1, DS);
+                MoveSaltTo(Compartment[compi - 2], CompartmentSalt[compi - 2], celiM1, DS);
                 DS = DS * (-1.0);
-                MoveSaltTo(Compartment[compi - 1], celi, DS);
+                MoveSaltTo(Compartment[compi - 1], CompartmentSalt[compi - 1], celi, DS);
             }
         }
     }
@@ -2055,10 +2203,10 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
             } else {
                 mm1 = 2.0 * soillayer[Compartment[compi - 1].Layer - 1].Dx * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
             }
-            ECcel = Compartment[compi - 1].Salt[celi - 1] / (mm1 * equiv);
+            ECcel = CompartmentSalt[compi - 1].Salt[celi - 1] / (mm1 * equiv);
             ECsubdrain = (ECcel * mm1 * (DeltaZ / Compartment[compi - 1].Thickness) + ECsubdrain * SubDrain) / (mm1 * (DeltaZ / Compartment[compi - 1].Thickness) + SubDrain);
-            Compartment[compi - 1].Salt[celi - 1] = (1.0 - (DeltaZ / Compartment[compi - 1].Thickness)) * Compartment[compi - 1].Salt[celi - 1] + (DeltaZ / Compartment[compi - 1].Thickness) * ECsubdrain * mm1 * equiv;
-            SaltSolutionDeposit(mm1, Compartment[compi - 1].Salt[celi - 1], Compartment[compi - 1].Depo[celi - 1]);
+            CompartmentSalt[compi - 1].Salt[celi - 1] = (1.0 - (DeltaZ / Compartment[compi - 1].Thickness)) * CompartmentSalt[compi - 1].Salt[celi - 1] + (DeltaZ / Compartment[compi - 1].Thickness) * ECsubdrain * mm1 * equiv;
+            SaltSolutionDeposit(mm1, CompartmentSalt[compi - 1].Salt[celi - 1], CompartmentSalt[compi - 1].Depo[celi - 1]);
             if (depthi >= Zr || compi >= NrCompartments) break;
         }
 
@@ -2073,8 +2221,8 @@ void calculate_saltcontent(dp InfiltratedRain, dp InfiltratedIrrigation, dp Infi
             } else {
                 mm1 = 2.0 * soillayer[Compartment[compi - 1].Layer - 1].Dx * 1000.0 * Compartment[compi - 1].Thickness * (1.0 - soillayer[Compartment[compi - 1].Layer - 1].GravelVol / 100.0);
             }
-            Compartment[compi - 1].Salt[celi - 1] += ECsubdrain * SubDrain * equiv;
-            SaltSolutionDeposit(mm1, Compartment[compi - 1].Salt[celi - 1], Compartment[compi - 1].Depo[celi - 1]);
+            CompartmentSalt[compi - 1].Salt[celi - 1] += ECsubdrain * SubDrain * equiv;
+            SaltSolutionDeposit(mm1, CompartmentSalt[compi - 1].Salt[celi - 1], CompartmentSalt[compi - 1].Depo[celi - 1]);
         }
     }
 }
@@ -2109,7 +2257,7 @@ void DetermineCCi(dp CCxTotal, dp CCoTotal, dp& StressLeaf, dp FracAssim, bool M
     dp CCi;
     int32_t DAP = VirtualTimeCC;
 
-    CCi = CanopyCoverNoStressSF(DAP, crop.DaysToGermination, crop.DaysToSenescence, crop.DaysToHarvest, crop.GDDaysToGermination, crop.GDDaysToSenescence, crop.GDDaysToHarvest, CCoTotal, CCxTotal, crop.CGC, crop.CDC, crop.GDDCGC, crop.GDDCDC, Simulation.SumGDD, modeCycle::CalendarDays, Simulation.EffectStress.RedCGC, Simulation.EffectStress.RedCCX);
+    CCi = CanopyCoverNoStressSFRun(DAP, crop.DaysToGermination, crop.DaysToSenescence, crop.DaysToHarvest, crop.GDDaysToGermination, crop.GDDaysToSenescence, crop.GDDaysToHarvest, CCoTotal, CCxTotal, crop.CGC, crop.CDC, crop.GDDCGC, crop.GDDCDC, Simulation.SumGDD, modeCycle::CalendarDays, Simulation.EffectStress.RedCGC, Simulation.EffectStress.RedCCX);
     CCiActual = CCi;
 }
 
@@ -2386,7 +2534,7 @@ void DeterminePotentialBiomass(int32_t VirtualTimeCC, dp SumGDDadjCC,
         DAP = SumCalendarDays(roundc(SumGDDadjCC, 1), crop.Day1, crop.Tbase, crop.Tupper, simulparam.Tmin, simulparam.Tmax);
     }
 
-    CCi = CanopyCoverNoStressSF(DAP, crop.DaysToGermination, crop.DaysToSenescence, crop.DaysToHarvest, crop.GDDaysToGermination, crop.GDDaysToSenescence, crop.GDDaysToHarvest, crop.CCoAdjusted, crop.CCxAdjusted, crop.CGC, crop.CDC, crop.GDDCGC, crop.GDDCDC, SumGDDadjCC, crop.ModeCycle, 0, 0);
+    CCi = CanopyCoverNoStressSFRun(DAP, crop.DaysToGermination, crop.DaysToSenescence, crop.DaysToHarvest, crop.GDDaysToGermination, crop.GDDaysToSenescence, crop.GDDaysToHarvest, crop.CCoAdjusted, crop.CCxAdjusted, crop.CGC, crop.CDC, crop.GDDCGC, crop.GDDCDC, SumGDDadjCC, crop.ModeCycle, 0, 0);
 
     if (CCi > CCxWitheredTpotNoS) {
         CCxWitheredTpotNoS = CCi;
@@ -2394,7 +2542,7 @@ void DeterminePotentialBiomass(int32_t VirtualTimeCC, dp SumGDDadjCC,
 
     CalculateETpot(DAP, crop.DaysToGermination, crop.DaysToFullCanopy, crop.DaysToSenescence, crop.DaysToHarvest, 0, CCi, ETo, crop.KcTop, crop.KcDecline, crop.CCxAdjusted, CCxWitheredTpotNoS, crop.CCEffectEvapLate, CO2i, GDDayi, crop.GDtranspLow, TpotNoS, EpotNoS);
 
-    WPi = crop.WP * fAdjustedForCO2(CO2i, crop.WP, crop.AdaptedToCO2);
+    WPi = crop.WP * fAdjustedForCO2Run(CO2i, crop.WP, crop.AdaptedToCO2);
     BiomassUnlim = WPi * (TpotNoS / ETo);
 }
 
@@ -2416,7 +2564,7 @@ void DetermineBiomassAndYield(int32_t DayNr, dp ETo, dp Tmin, dp Tmax, dp CO2i,
     int32_t DAP, HIfinal_int;
     int8_t PercentLagPhase;
 
-    WPi_adj = WPi * fAdjustedForCO2(CO2i, WPi, crop.AdaptedToCO2);
+    WPi_adj = WPi * fAdjustedForCO2Run(CO2i, WPi, crop.AdaptedToCO2);
     Biomass = WPi_adj * (Tact / ETo);
     BiomassTot += Biomass;
 
@@ -0,0 +1,159 @@
+#include "AquaCrop/SoilState.h"
+#include "AquaCrop/Simul.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AquaCrop {
+
+namespace {
+
+// Compares the compartments with those of the derived state; a changed
+// profile invalidates everything derived from it
+void CheckProfile() {
+    bool Same = (static_cast<int32_t>(DerivedSoil.Thickness.size()) == NrCompartments);
+    for (int32_t compi = 1; Same && compi <= NrCompartments; ++compi) {
+        Same = (DerivedSoil.Thickness[compi - 1] == Compartment[compi - 1].Thickness
+                && DerivedSoil.Layer[compi - 1] == Compartment[compi - 1].Layer);
+    }
+    if (Same) return;
+    DerivedSoil.Thickness.resize(NrCompartments);
+    DerivedSoil.Layer.resize(NrCompartments);
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        DerivedSoil.Thickness[compi - 1] = Compartment[compi - 1].Thickness;
+        DerivedSoil.Layer[compi - 1] = Compartment[compi - 1].Layer;
+    }
+    DerivedSoil.GroundwaterValid = false;
+    DerivedSoil.CRTablesValid = false;
+    DerivedSoil.RootZoneValid = false;
+    DerivedSoil.WeightsValid = false;
+}
+
+// Tables of MaxCRatDepth for whole-centimetre depths from just above the
+// middle of each compartment down to 4 m below it. Shallower depths give 99
+// and deeper ones 0 without exp/log, so those stay with MaxCRatDepth.
+void BuildCRTables() {
+    DerivedSoil.CRTableFrom.resize(NrCompartments);
+    DerivedSoil.CRTableSize.resize(NrCompartments);
+    DerivedSoil.CRTableStart.resize(NrCompartments);
+    DerivedSoil.CRTable.clear();
+    dp Ztop, Zbot = 0.0;
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        Ztop = Zbot;
+        Zbot = Ztop + Compartment[compi - 1].Thickness;
+        dp Zi = (Ztop + Zbot) / 2.0;
+        const SoilLayerIndividual& Layer = soillayer[Compartment[compi - 1].Layer - 1];
+        int32_t From = std::max(1, static_cast<int32_t>(std::floor(Zi * 100.0)) - 1);
+        int32_t To = static_cast<int32_t>(std::ceil((Zi + 4.0) * 100.0)) + 1;
+        DerivedSoil.CRTableFrom[compi - 1] = From;
+        DerivedSoil.CRTableSize[compi - 1] = To - From + 1;
+        DerivedSoil.CRTableStart[compi - 1] = static_cast<int32_t>(DerivedSoil.CRTable.size());
+        for (int32_t Zcm = From; Zcm <= To; ++Zcm) {
+            DerivedSoil.CRTable.push_back(MaxCRatDepth(Layer.CRa, Layer.CRb, (Layer.tau * 1000.0), Zi, Zcm / 100.0));
+        }
+    }
+    DerivedSoil.CRTablesValid = true;
+}
+
+// MaxCRatDepth of compartment compi (middle at Zi) from the table when the
+// depth is a whole number of centimetres (as the groundwater table of a run)
+// and in it: the entry was computed from the same arguments
+dp CRmaxAt(int32_t compi, dp Zi, dp DepthGWTmeter) {
+    if (DerivedSoil.CRTablesValid) {
+        dp Zcm = std::round(DepthGWTmeter * 100.0);
+        int32_t i = static_cast<int32_t>(Zcm) - DerivedSoil.CRTableFrom[compi - 1];
+        if (Zcm / 100.0 == DepthGWTmeter && i >= 0 && i < DerivedSoil.CRTableSize[compi - 1]) {
+            return DerivedSoil.CRTable[DerivedSoil.CRTableStart[compi - 1] + i];
+        }
+    }
+    const SoilLayerIndividual& Layer = soillayer[Compartment[compi - 1].Layer - 1];
+    return MaxCRatDepth(Layer.CRa, Layer.CRb, (Layer.tau * 1000.0), Zi, DepthGWTmeter);
+}
+
+} // namespace
+
+void InvalidateDerivedSoilState() {
+    DerivedSoil.Thickness.clear();
+    DerivedSoil.Layer.clear();
+    DerivedSoil.GroundwaterValid = false;
+    DerivedSoil.CRTablesValid = false;
+    DerivedSoil.RootZoneValid = false;
+    DerivedSoil.WeightsValid = false;
+}
+
+void UpdateGroundwaterState(dp DepthGWTmeter) {
+    CheckProfile();
+    if (DerivedSoil.GroundwaterValid && DerivedSoil.DepthGWTmeter == DepthGWTmeter) return;
+    if (DerivedSoil.GroundwaterValid && !DerivedSoil.CRTablesValid) BuildCRTables();
+
+    CheckForWaterTableInProfile(DepthGWTmeter, Compartment, DerivedSoil.WaterTableInProfile);
+    CalculateAdjustedFC(DepthGWTmeter, Compartment);
+
+    // same midpoints as CapillaryRise
+    DerivedSoil.CRmax.resize(NrCompartments);
+    dp Ztop, Zbot = 0.0;
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        Ztop = Zbot;
+        Zbot = Ztop + Compartment[compi - 1].Thickness;
+        DerivedSoil.CRmax[compi - 1] = CRmaxAt(compi, (Ztop + Zbot) / 2.0, DepthGWTmeter);
+    }
+
+    DerivedSoil.DepthGWTmeter = DepthGWTmeter;
+    DerivedSoil.GroundwaterValid = true;
+}
+
+void UpdateRootZoneState(dp RootingDepth) {
+    CheckProfile();
+    if (DerivedSoil.RootZoneValid && DerivedSoil.RootZoneDepth == RootingDepth) return;
+
+    // compartments and sums as in DetermineRootZoneWC
+    DerivedSoil.RootZoneDZ.resize(NrCompartments);
+    DerivedSoil.RootZoneGravel.resize(NrCompartments);
+    DerivedSoil.RootZoneNrComp = 0;
+    DerivedSoil.RootZoneFC = 0.0;
+    DerivedSoil.RootZoneWP = 0.0;
+    DerivedSoil.RootZoneSAT = 0.0;
+    dp Ztop, Zbot, depthi = 0.0;
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        const SoilLayerIndividual& Layer = soillayer[Compartment[compi - 1].Layer - 1];
+        Ztop = depthi;
+        depthi += Compartment[compi - 1].Thickness;
+        Zbot = depthi;
+
+        dp DZ;
+        if (Zbot <= RootingDepth) {
+            DZ = Compartment[compi - 1].Thickness;
+        } else if (Ztop < RootingDepth) {
+            DZ = RootingDepth - Ztop;
+        } else {
+            break;
+        }
+        dp Gravel = (1.0 - Layer.GravelVol / 100.0);
+        DerivedSoil.RootZoneFC += Layer.FC / 100.0 * 1000.0 * DZ * Gravel;
+        DerivedSoil.RootZoneWP += Layer.WP / 100.0 * 1000.0 * DZ * Gravel;
+        DerivedSoil.RootZoneSAT += Layer.SAT / 100.0 * 1000.0 * DZ * Gravel;
+        DerivedSoil.RootZoneDZ[compi - 1] = DZ;
+        DerivedSoil.RootZoneGravel[compi - 1] = Gravel;
+        DerivedSoil.RootZoneNrComp = compi;
+        if (depthi >= RootingDepth) break;
+    }
+
+    DerivedSoil.RootZoneDepth = RootingDepth;
+    DerivedSoil.RootZoneValid = true;
+}
+
+const std::vector<dp>& WeightingFactors(dp Depth) {
+    CheckProfile();
+    if (!DerivedSoil.WeightsValid || DerivedSoil.WeightDepth != Depth) {
+        std::vector<CompartmentIndividual> Compartment_temp = Compartment;
+        calculate_weighting_factors(Depth, Compartment_temp);
+        DerivedSoil.WFactor.resize(NrCompartments);
+        for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+            DerivedSoil.WFactor[compi - 1] = Compartment_temp[compi - 1].WFactor;
+        }
+        DerivedSoil.WeightDepth = Depth;
+        DerivedSoil.WeightsValid = true;
+    }
+    return DerivedSoil.WFactor;
+}
+
+} // namespace AquaCrop
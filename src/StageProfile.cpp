@@ -0,0 +1,184 @@
+#include "AquaCrop/StageProfile.h"
+
+#ifdef AQUACROP_STAGE_PROFILING
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace AquaCrop {
+
+#ifdef AQUACROP_STAGE_HOOKS
+BudgetStageObserver StageObserver = nullptr;
+#endif
+
+const char* BudgetStageName(BudgetStage Stage) {
+    switch (Stage) {
+    case BudgetStage::BalanceBegin: return "balance_begin";
+    case BudgetStage::Groundwater: return "groundwater";
+    case BudgetStage::Drainage: return "drainage";
+    case BudgetStage::Runoff: return "runoff";
+    case BudgetStage::Infiltration: return "infiltration";
+    case BudgetStage::CapillaryRise: return "capillary_rise";
+    case BudgetStage::SaltBalance: return "salt_balance";
+    case BudgetStage::Germination: return "germination";
+    case BudgetStage::FertilitySalinity: return "fertility_salinity";
+    case BudgetStage::CanopyCover: return "canopy_cover";
+    case BudgetStage::ETpot: return "etpot";
+    case BudgetStage::Evaporation: return "evaporation";
+    case BudgetStage::Transpiration: return "transpiration";
+    case BudgetStage::GroundwaterInflow: return "groundwater_inflow";
+    case BudgetStage::SaltConcentration: return "salt_concentration";
+    case BudgetStage::BalanceEnd: return "balance_end";
+    default: return "unknown";
+    }
+}
+
+#ifdef AQUACROP_STAGE_PROFILING
+
+namespace {
+
+struct rep_StageRun {
+    std::string ProjectFile;
+    int32_t NrRun = 0;
+    std::array<uint64_t, NrBudgetStages> Calls{};
+    std::array<uint64_t, NrBudgetStages> Ticks{};
+};
+
+// Reference points to convert ticks to nanoseconds
+struct rep_TickOrigin {
+    uint64_t Ticks;
+    std::chrono::steady_clock::time_point Time;
+};
+
+const rep_TickOrigin& TickOrigin() {
+    static const rep_TickOrigin Origin{StageTicks(), std::chrono::steady_clock::now()};
+    return Origin;
+}
+
+thread_local rep_StageRun CurrentRun;
+std::mutex StageRunsMutex;
+std::vector<rep_StageRun> StageRuns;
+
+std::string JsonString(const std::string& Str) {
+    std::string Out = "\"";
+    for (char c : Str) {
+        if (c == '"' || c == '\\') Out += '\\';
+        Out += c;
+    }
+    return Out + "\"";
+}
+
+} // namespace
+
+uint64_t StageTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void AddStageTicks(BudgetStage Stage, uint64_t Ticks) {
+    int32_t i = static_cast<int32_t>(Stage);
+    CurrentRun.Calls[i]++;
+    CurrentRun.Ticks[i] += Ticks;
+}
+
+void BeginStageProfileRun(const std::string& ProjectFile, int32_t NrRun) {
+    TickOrigin();
+    CurrentRun = rep_StageRun();
+    CurrentRun.ProjectFile = ProjectFile;
+    CurrentRun.NrRun = NrRun;
+}
+
+void EndStageProfileRun() {
+    std::lock_guard<std::mutex> lock(StageRunsMutex);
+    StageRuns.push_back(CurrentRun);
+    CurrentRun = rep_StageRun();
+}
+
+void WriteStageProfile(const std::string& PathName) {
+    std::lock_guard<std::mutex> lock(StageRunsMutex);
+    if (StageRuns.empty()) return;
+
+    // nanoseconds per tick over the profiled period
+    const rep_TickOrigin& Origin = TickOrigin();
+    uint64_t dTicks = StageTicks() - Origin.Ticks;
+    double dNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Origin.Time).count();
+    double NsPerTick = (dTicks > 0) ? dNs / static_cast<double>(dTicks) : 1.0;
+
+    rep_StageRun Total;
+    for (const rep_StageRun& Run : StageRuns) {
+        for (int32_t i = 0; i < NrBudgetStages; ++i) {
+            Total.Calls[i] += Run.Calls[i];
+            Total.Ticks[i] += Run.Ticks[i];
+        }
+    }
+    uint64_t AllTicks = 0;
+    for (uint64_t t : Total.Ticks) AllTicks += t;
+    double NrRuns = static_cast<double>(StageRuns.size());
+
+    // Text report
+    std::ofstream ftext(PathName + "StageProfile.txt");
+    auto WriteText = [&](std::ostream& out) {
+        out << "Budget_module stage profile: " << StageRuns.size() << " run(s), "
+            << Total.Calls[0] << " day(s)" << std::endl;
+        out << std::left << std::setw(20) << "stage" << std::right
+            << std::setw(12) << "calls" << std::setw(14) << "total ms"
+            << std::setw(14) << "ns/call" << std::setw(14) << "ms/run" << std::setw(9) << "share" << std::endl;
+        for (int32_t i = 0; i < NrBudgetStages; ++i) {
+            double Ns = static_cast<double>(Total.Ticks[i]) * NsPerTick;
+            double Mean = (Total.Calls[i] > 0) ? Ns / static_cast<double>(Total.Calls[i]) : 0.0;
+            double Share = (AllTicks > 0) ? 100.0 * static_cast<double>(Total.Ticks[i]) / static_cast<double>(AllTicks) : 0.0;
+            out << std::left << std::setw(20) << BudgetStageName(static_cast<BudgetStage>(i)) << std::right
+                << std::setw(12) << Total.Calls[i] << std::fixed << std::setprecision(3)
+                << std::setw(14) << Ns / 1e6 << std::setprecision(1) << std::setw(14) << Mean
+                << std::setprecision(3) << std::setw(14) << Ns / 1e6 / NrRuns
+                << std::setprecision(1) << std::setw(8) << Share << "%" << std::endl;
+        }
+        out << std::defaultfloat;
+    };
+    WriteText(std::cerr);
+    if (ftext.is_open()) WriteText(ftext);
+
+    // JSON report
+    std::ofstream fjson(PathName + "StageProfile.json");
+    if (!fjson.is_open()) return;
+    fjson << std::setprecision(6);
+    fjson << "{\n  \"ns_per_tick\": " << NsPerTick << ",\n  \"stages\": [\n";
+    for (int32_t i = 0; i < NrBudgetStages; ++i) {
+        double Ns = static_cast<double>(Total.Ticks[i]) * NsPerTick;
+        fjson << "    {\"name\": " << JsonString(BudgetStageName(static_cast<BudgetStage>(i)))
+              << ", \"calls\": " << Total.Calls[i]
+              << ", \"total_ns\": " << Ns
+              << ", \"mean_ns\": " << ((Total.Calls[i] > 0) ? Ns / static_cast<double>(Total.Calls[i]) : 0.0)
+              << ", \"mean_ns_per_run\": " << Ns / NrRuns << "}"
+              << ((i + 1 < NrBudgetStages) ? "," : "") << "\n";
+    }
+    fjson << "  ],\n  \"runs\": [\n";
+    for (size_t r = 0; r < StageRuns.size(); ++r) {
+        const rep_StageRun& Run = StageRuns[r];
+        fjson << "    {\"project\": " << JsonString(Run.ProjectFile) << ", \"run\": " << Run.NrRun << ", \"stages\": {";
+        for (int32_t i = 0; i < NrBudgetStages; ++i) {
+            fjson << JsonString(BudgetStageName(static_cast<BudgetStage>(i)))
+                  << ": {\"calls\": " << Run.Calls[i] << ", \"ns\": " << static_cast<double>(Run.Ticks[i]) * NsPerTick << "}"
+                  << ((i + 1 < NrBudgetStages) ? ", " : "");
+        }
+        fjson << "}}" << ((r + 1 < StageRuns.size()) ? "," : "") << "\n";
+    }
+    fjson << "  ]\n}\n";
+}
+
+#endif // AQUACROP_STAGE_PROFILING
+
+} // namespace AquaCrop
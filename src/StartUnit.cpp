@@ -4,6 +4,8 @@
 #include "AquaCrop/InitialSettings.h"
 #include "AquaCrop/Run.h"
 #include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/StageProfile.h"
+#include "AquaCrop/Instrument.h"
 
 #include <iostream>
 #include <fstream>
@@ -29,7 +31,12 @@ void StartTheProgram() {
         std::string TheProjectFile = GetProjectFileName(iproject);
         typeproject TheProjectType;
         GetProjectType(TheProjectFile, TheProjectType);
-        InitializeProject(iproject, TheProjectFile, TheProjectType);
+        SetTraceTags(TheProjectFile, 0);
+        AQUACROP_TRACE_SPAN("project");
+        {
+            AQUACROP_REGION("initialize_project");
+            InitializeProject(iproject, TheProjectFile, TheProjectType);
+        }
         RunSimulation(TheProjectFile, TheProjectType);
     }
 
@@ -60,7 +67,9 @@ void InitializeTheProgram() {
 }
 
 void FinalizeTheProgram() {
-    // Placeholder
+    AQUACROP_STAGE_REPORT(PathNameOutp);
+    WritePerfReport(PathNameOutp);
+    WriteTrace();
 }
 
 void PrepareReport() {
@@ -115,7 +124,7 @@ void GetProjectType(const std::string& TheProjectFile, typeproject& TheProjectTy
 }
 
 void InitializeProject(int32_t iproject, const std::string& TheProjectFile, typeproject TheProjectType) {
-    std::cout << "  " << iproject << ". " << TheProjectFile << std::endl;
+    if (ConsoleOutput) std::cout << "  " << iproject << ". " << TheProjectFile << std::endl;
 
     if (TheProjectType == typeproject::typenone) return;
 
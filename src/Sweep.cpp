@@ -0,0 +1,103 @@
+#include "AquaCrop/Sweep.h"
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/ProjectInput.h"
+#include "AquaCrop/StartUnit.h"
+#include "AquaCrop/TempProcessing.h"
+#include "AquaCrop/ThreadPool.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace AquaCrop {
+
+namespace {
+
+thread_local int32_t SowingDay1 = undef_int;
+
+} // namespace
+
+std::vector<int32_t> SowingDayNrs(const rep_SowingWindow& Window, int32_t Year)
+{
+    int32_t FirstDayNr, LastDayNr;
+    DetermineDayNr(Window.FromDay, Window.FromMonth, Year, FirstDayNr);
+    DetermineDayNr(Window.ToDay, Window.ToMonth, Year, LastDayNr);
+    if (LastDayNr < FirstDayNr) DetermineDayNr(Window.ToDay, Window.ToMonth, Year + 1, LastDayNr);
+
+    std::vector<int32_t> DayNrs;
+    const int32_t Step = std::max(1, Window.StepDays);
+    for (int32_t DayNr = FirstDayNr; DayNr <= LastDayNr; DayNr += Step) DayNrs.push_back(DayNr);
+    return DayNrs;
+}
+
+void SetSowingDate(int32_t CropDay1)
+{
+    SowingDay1 = CropDay1;
+}
+
+void ApplySowingDate()
+{
+    if (SowingDay1 == undef_int) return;
+    const int32_t Shift = SowingDay1 - crop.Day1;
+    crop.Day1 += Shift;
+    crop.DayN += Shift;
+    Simulation.FromDayNr += Shift;
+    Simulation.ToDayNr += Shift;
+    AdjustCropFileParameters(CropFileSet, crop.DaysToHarvest, ResetCropDay1(crop.Day1, true), crop.ModeCycle,
+                             crop.Tbase, crop.Tupper, crop.DaysToSenescence, crop.DaysToHarvest,
+                             crop.GDDaysToSenescence, crop.GDDaysToHarvest);
+}
+
+bool SweepSowingDates(const std::string& TheProjectFile, const rep_SweepSettings& Settings, rep_SweepResult& Result)
+{
+    typeproject TheProjectType;
+    GetProjectType(TheProjectFile, TheProjectType);
+    if (TheProjectType == typeproject::typenone) {
+        std::cerr << "Not a project file (.ACp or .PRM): " << TheProjectFile << std::endl;
+        return false;
+    }
+    ThreadPool Pool(Settings.NrThreads);
+
+    // Year-level preparation, once: parses the project (kept in the project
+    // input cache for all simulations) and places the window in the year each
+    // run is sown
+    std::vector<int32_t> WindowStart;
+    Result.Years.clear();
+    Pool.ParallelFor(1, [&](int32_t) {
+        PrepareSimulationThread();
+        InitializeProject(1, TheProjectFile, TheProjectType);
+        for (const ProjectInput_type& Run : ProjectInput) {
+            int32_t Dayi, Monthi, Yeari;
+            DetermineDate(Run.Crop_Day1, Dayi, Monthi, Yeari);
+            Result.Years.push_back(Yeari);
+            WindowStart.push_back(SowingDayNrs(Settings.Window, Yeari).front());
+        }
+    });
+    if (Result.Years.empty()) {
+        std::cerr << "No runs in " << TheProjectFile << std::endl;
+        return false;
+    }
+    const std::vector<int32_t> FirstYearDates = SowingDayNrs(Settings.Window, Result.Years.front());
+    Result.SowingOffsets.clear();
+    for (int32_t DayNr : FirstYearDates) Result.SowingOffsets.push_back(DayNr - FirstYearDates.front());
+
+    // Dates by year, so the consecutive simulations of a worker share the
+    // inputs of their year
+    const int32_t NrYears = static_cast<int32_t>(Result.Years.size());
+    const int32_t NrDates = static_cast<int32_t>(Result.SowingOffsets.size());
+    Result.Cells.assign(static_cast<size_t>(NrYears) * NrDates, rep_RunResult{});
+    Pool.ParallelFor(NrYears * NrDates, [&](int32_t Item) {
+        const int32_t Yeari = Item / NrDates + 1;
+        const int32_t Datei = Item % NrDates + 1;
+        PrepareSimulationThread();
+        SetSowingDate(WindowStart[Yeari-1] + Result.SowingOffsets[Datei-1]);
+        std::vector<rep_RunResult> Runs = SimulateProject(TheProjectFile, TheProjectType, {}, {}, Yeari);
+        SetSowingDate(undef_int);
+        if (!Runs.empty()) {
+            Result.Cells[Item] = Runs.front();
+            Result.Cells[Item].NrRun = static_cast<int8_t>(Yeari);
+        }
+    });
+    return true;
+}
+
+} // namespace AquaCrop
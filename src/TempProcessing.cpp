@@ -1,5 +1,6 @@
 #include "AquaCrop/TempProcessing.h"
 #include "AquaCrop/Utils.h"
+#include <algorithm>
 #include <cmath>
 #include <fstream> // For std::ifstream
 #include <iostream> // For std::cout, std::cerr, std::endl
@@ -16,18 +17,94 @@ void GetMonthlyTemperatureDataSet(int32_t DayNr, std::vector<rep_DayEventDbl>& M
 void TemperatureFileCoveringCropPeriod(int32_t Day1, int32_t DayN) {
     // Placeholder
 }
+namespace {
+
+// Cumulative GDD over the run temperature series for one Tbase/Tupper/method
+struct rep_GDDIndex {
+    dp Tbase, Tupper, TDayMin, TDayMax;
+    int8_t GDDMethod;
+    dp DayGDD;               // GDD of a day at TDayMin/TDayMax (no series)
+    std::vector<dp> CumGDD;  // CumGDD[i]: GDD from GDDFirstDayNr up to day GDDFirstDayNr+i-1
+};
+
+thread_local int32_t GDDFirstDayNr = undef_int;
+thread_local int32_t GDDNrDays = 0;
+thread_local bool GDDSeries = false;
+thread_local std::vector<rep_GDDIndex> GDDIndices;
+
+const rep_GDDIndex& GetGDDIndex(dp Tbase, dp Tupper, dp TDayMin, dp TDayMax) {
+    for (const rep_GDDIndex& idx : GDDIndices) {
+        if (idx.Tbase == Tbase && idx.Tupper == Tupper && idx.TDayMin == TDayMin
+            && idx.TDayMax == TDayMax && idx.GDDMethod == simulparam.GDDMethod) {
+            return idx;
+        }
+    }
+    rep_GDDIndex idx;
+    idx.Tbase = Tbase;
+    idx.Tupper = Tupper;
+    idx.TDayMin = TDayMin;
+    idx.TDayMax = TDayMax;
+    idx.GDDMethod = simulparam.GDDMethod;
+    idx.DayGDD = DegreesDay(Tbase, Tupper, TDayMin, TDayMax, simulparam.GDDMethod);
+    if (GDDSeries) {
+        // daily GDD in CumGDD[1..], then summed in place
+        idx.CumGDD.resize(GDDNrDays + 1);
+        idx.CumGDD[0] = 0.0;
+        DegreesDaySeries(Tbase, Tupper, TminRun.data(), TmaxRun.data(), GDDNrDays, simulparam.GDDMethod, idx.CumGDD.data() + 1);
+        for (int32_t i = 0; i < GDDNrDays; ++i) {
+            idx.CumGDD[i + 1] += idx.CumGDD[i];
+        }
+    }
+    GDDIndices.push_back(std::move(idx));
+    return GDDIndices.back();
+}
+
+} // namespace
+
+void PrepareGDDIndex(int32_t FromDayNr, int32_t ToDayNr) {
+    // The run series TminRun/TmaxRun start at FromDayNr
+    GDDIndices.clear();
+    GDDFirstDayNr = FromDayNr;
+    GDDNrDays = ToDayNr - FromDayNr + 1;
+    if (GDDNrDays > static_cast<int32_t>(TminRun.size())) GDDNrDays = static_cast<int32_t>(TminRun.size());
+    if (GDDNrDays < 0) GDDNrDays = 0;
+    GDDSeries = (TemperatureFile != "(None)") && (TemperatureRecord.NrObs > 0) && (GDDNrDays > 0);
+}
+
 int32_t GrowingDegreeDays(int32_t ValPeriod, int32_t FirstDayPeriod, dp Tbase, dp Tupper, dp TDayMin, dp TDayMax) {
     if (ValPeriod <= 0) return 0;
-    // Simple placeholder logic: use average Tmin/Tmax if no file
-    dp DayGDD = DegreesDay(Tbase, Tupper, TDayMin, TDayMax, simulparam.GDDMethod);
-    return roundc(ValPeriod * DayGDD, 1);
+    const rep_GDDIndex& idx = GetGDDIndex(Tbase, Tupper, TDayMin, TDayMax);
+    if (!GDDSeries) return roundc(ValPeriod * idx.DayGDD, 1);
+
+    // days outside the run series count at TDayMin/TDayMax
+    int32_t i0 = FirstDayPeriod - GDDFirstDayNr;
+    int32_t i1 = i0 + ValPeriod;
+    int32_t j0 = std::min(std::max(i0, 0), GDDNrDays);
+    int32_t j1 = std::min(std::max(i1, 0), GDDNrDays);
+    dp GDDays = idx.CumGDD[j1] - idx.CumGDD[j0];
+    GDDays += static_cast<dp>(ValPeriod - (j1 - j0)) * idx.DayGDD;
+    return roundc(GDDays, 1);
 }
 
 int32_t SumCalendarDays(int32_t ValGDDays, int32_t FirstDayCrop, dp Tbase, dp Tupper, dp TDayMin, dp TDayMax) {
     if (ValGDDays <= 0) return 0;
-    dp DayGDD = DegreesDay(Tbase, Tupper, TDayMin, TDayMax, simulparam.GDDMethod);
-    if (std::abs(DayGDD) < 1e-6) return undef_int;
-    return roundc(ValGDDays / DayGDD, 1);
+    const rep_GDDIndex& idx = GetGDDIndex(Tbase, Tupper, TDayMin, TDayMax);
+    int32_t i0 = FirstDayCrop - GDDFirstDayNr;
+    if (!GDDSeries || i0 < 0 || i0 >= GDDNrDays) {
+        if (std::abs(idx.DayGDD) < 1e-6) return undef_int;
+        return roundc(ValGDDays / idx.DayGDD, 1);
+    }
+
+    // first day on which the GDD summed from FirstDayCrop reaches ValGDDays
+    dp Target = idx.CumGDD[i0] + static_cast<dp>(ValGDDays);
+    auto it = std::lower_bound(idx.CumGDD.begin() + i0 + 1, idx.CumGDD.end(), Target);
+    if (it != idx.CumGDD.end()) {
+        return static_cast<int32_t>(it - (idx.CumGDD.begin() + i0));
+    }
+    // beyond the series: continue at TDayMin/TDayMax
+    int32_t NrCDays = GDDNrDays - i0;
+    if (std::abs(idx.DayGDD) < 1e-6) return undef_int;
+    return NrCDays + roundc((Target - idx.CumGDD[GDDNrDays]) / idx.DayGDD, 1);
 }
 
 dp MaxAvailableGDD(int32_t DayNr, dp Tbase, dp Tupper, dp Tmin, dp Tmax) {
@@ -59,7 +136,7 @@ void LoadSimulationRunProject(const std::string& projectFileName) {
         file >> Simulation.FromDayNr; // Read actual FromDayNr
         file >> Simulation.ToDayNr;   // Read actual ToDayNr
         file.close();
-        std::cout << "  - Loaded project: " << fullName
+        if (ConsoleOutput) std::cout << "  - Loaded project: " << fullName
                   << " (Period: " << Simulation.FromDayNr << " to " << Simulation.ToDayNr << ")" << std::endl;
     } else {
         std::cerr << "WARNING: Could not open project file: " << fullName << std::endl;
@@ -0,0 +1,70 @@
+#include "AquaCrop/ThreadPool.h"
+#include "AquaCrop/Global.h"
+
+namespace AquaCrop {
+
+namespace {
+
+thread_local bool IsWorker = false;
+
+} // namespace
+
+ThreadPool::ThreadPool(int32_t NrThreads)
+{
+    if (NrThreads <= 0) NrThreads = static_cast<int32_t>(std::thread::hardware_concurrency());
+    if (NrThreads <= 0) NrThreads = 1;
+    Workers_.reserve(NrThreads);
+    for (int32_t i = 0; i < NrThreads; ++i) {
+        Workers_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        Stop_ = true;
+    }
+    WorkReady_.notify_all();
+    for (std::thread& Worker : Workers_) Worker.join();
+}
+
+void ThreadPool::ParallelFor(int32_t NrItems, const std::function<void(int32_t Item)>& Task)
+{
+    if (NrItems <= 0) return;
+    std::unique_lock<std::mutex> Lock(Mutex_);
+    Task_ = &Task;
+    NrItems_ = NrItems;
+    NextItem_ = 0;
+    WorkReady_.notify_all();
+    WorkDone_.wait(Lock, [this] { return NextItem_ >= NrItems_ && NrBusy_ == 0; });
+    Task_ = nullptr;
+}
+
+bool ThreadPool::OnWorker()
+{
+    return IsWorker;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    IsWorker = true;
+    InitializeThreadState();
+    std::unique_lock<std::mutex> Lock(Mutex_);
+    for (;;) {
+        WorkReady_.wait(Lock, [this] { return Stop_ || NextItem_ < NrItems_; });
+        if (Stop_) return;
+        while (NextItem_ < NrItems_) {
+            int32_t Item = NextItem_++;
+            const std::function<void(int32_t)>& Task = *Task_;
+            ++NrBusy_;
+            Lock.unlock();
+            Task(Item);
+            Lock.lock();
+            --NrBusy_;
+        }
+        if (NrBusy_ == 0) WorkDone_.notify_all();
+    }
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,133 @@
+#include "AquaCrop/Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace AquaCrop {
+
+bool TraceRequested = false;
+
+namespace {
+
+struct rep_TraceEvent {
+    const char* Name;
+    uint64_t Begin; // ns since the start of the trace
+    uint64_t End;
+    int32_t Tag;    // index in rep_TraceBuffer::Projects, -1 if none
+    int32_t NrRun;
+};
+
+// Owned by one thread while it runs; kept alive by the registry
+struct rep_TraceBuffer {
+    int32_t Tid;
+    std::vector<rep_TraceEvent> Events;
+    std::vector<std::string> Projects;
+    int32_t Tag = -1;
+    int32_t NrRun = 0;
+};
+
+std::string TraceFileName;
+std::chrono::steady_clock::time_point TraceOrigin;
+std::mutex TraceRegistryMutex;
+std::vector<std::shared_ptr<rep_TraceBuffer>> TraceBuffers;
+
+rep_TraceBuffer& ThreadBuffer() {
+    thread_local std::shared_ptr<rep_TraceBuffer> Buffer;
+    if (!Buffer) {
+        Buffer = std::make_shared<rep_TraceBuffer>();
+        Buffer->Events.reserve(4096);
+        std::lock_guard<std::mutex> lock(TraceRegistryMutex);
+        Buffer->Tid = static_cast<int32_t>(TraceBuffers.size()) + 1;
+        TraceBuffers.push_back(Buffer);
+    }
+    return *Buffer;
+}
+
+void WriteJsonString(std::ostream& out, const std::string& Str) {
+    out << '"';
+    for (char c : Str) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char Escaped[8];
+            std::snprintf(Escaped, sizeof(Escaped), "\\u%04x", static_cast<unsigned>(c));
+            out << Escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+void StartTrace(const std::string& FileName) {
+    TraceFileName = FileName;
+    TraceOrigin = std::chrono::steady_clock::now();
+    TraceRequested = true;
+}
+
+uint64_t TraceNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - TraceOrigin).count());
+}
+
+void SetTraceTags(const std::string& ProjectFile, int32_t NrRun) {
+    if (!TraceEnabled()) return;
+    rep_TraceBuffer& Buffer = ThreadBuffer();
+    if (Buffer.Tag < 0 || Buffer.Projects[Buffer.Tag] != ProjectFile) {
+        Buffer.Projects.push_back(ProjectFile);
+        Buffer.Tag = static_cast<int32_t>(Buffer.Projects.size()) - 1;
+    }
+    Buffer.NrRun = NrRun;
+}
+
+void CurrentTraceTags(int32_t& Tag, int32_t& NrRun) {
+    const rep_TraceBuffer& Buffer = ThreadBuffer();
+    Tag = Buffer.Tag;
+    NrRun = Buffer.NrRun;
+}
+
+void AddTraceSpan(const char* Name, uint64_t Begin, uint64_t End, int32_t Tag, int32_t NrRun) {
+    ThreadBuffer().Events.push_back({Name, Begin, End, Tag, NrRun});
+}
+
+void WriteTrace() {
+    if (!TraceEnabled()) return;
+    std::ofstream out(TraceFileName);
+    if (!out.is_open()) {
+        std::cerr << "trace: cannot write " << TraceFileName << std::endl;
+        return;
+    }
+
+    // Called after the worker threads have finished
+    std::lock_guard<std::mutex> lock(TraceRegistryMutex);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"aquacrop\"}}";
+    char Times[64];
+    for (const std::shared_ptr<rep_TraceBuffer>& Buffer : TraceBuffers) {
+        out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << Buffer->Tid
+            << ", \"args\": {\"name\": \"thread " << Buffer->Tid << "\"}}";
+        for (const rep_TraceEvent& Event : Buffer->Events) {
+            // microseconds with ns resolution
+            std::snprintf(Times, sizeof(Times), "\"ts\": %.3f, \"dur\": %.3f",
+                          static_cast<double>(Event.Begin) / 1000.0, static_cast<double>(Event.End - Event.Begin) / 1000.0);
+            out << ",\n{\"name\": ";
+            WriteJsonString(out, Event.Name);
+            out << ", \"ph\": \"X\", " << Times << ", \"pid\": 1, \"tid\": " << Buffer->Tid;
+            if (Event.Tag >= 0) {
+                out << ", \"args\": {\"project\": ";
+                WriteJsonString(out, Buffer->Projects[Event.Tag]);
+                out << ", \"run\": " << Event.NrRun << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+} // namespace AquaCrop
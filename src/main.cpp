@@ -1,6 +1,21 @@
 #include "AquaCrop/StartUnit.h"
+#include "AquaCrop/PerfCounters.h"
+#include "AquaCrop/Trace.h"
+#include <cstring>
+#include <iostream>
 
-int main() {
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--perf") == 0) {
+            AquaCrop::EnablePerfCounters();
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            AquaCrop::StartTrace(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            std::cerr << "Usage: aquacrop_main [--perf] [--trace out.json]" << std::endl;
+            return 1;
+        }
+    }
     AquaCrop::StartTheProgram();
     return 0;
 }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "AquaCrop/Global.h"
+#include "AquaCrop/StageProfile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AquaCrop {
+
+// Golden-state regression harness: the state after every Budget_module stage
+// of a corpus of synthetic seasons is recorded from a reference build and
+// compared, stage by stage, against a candidate build.
+// Both need a build with AQUACROP_STAGE_HOOKS and return false without.
+
+// One watched state variable. Two values match when they are equal or differ
+// by at most Abs or by at most Ulp units in the last place. The tolerances are
+// stored in the record and a comparison uses those.
+struct rep_GoldenVariable {
+    std::string Name;
+    dp Abs;
+    int64_t Ulp;
+};
+
+// A synthetic season of the corpus (see Synthetic.h)
+struct rep_GoldenCase {
+    std::string Name;
+    uint64_t Seed;
+    int32_t DayNr1;
+    int32_t NrDays;
+};
+
+// First mismatch between the record and the candidate state
+struct rep_GoldenDivergence {
+    bool Found;
+    std::string Case;
+    int32_t Day;          // 1 = first day of the season, 0 = initial state
+    int32_t DayNr;
+    BudgetStage Stage;    // stage after which the state diverges
+    std::string Variable;
+    dp Reference;
+    dp Candidate;
+};
+
+// Watched variables, in the order of CaptureGoldenState
+const std::vector<rep_GoldenVariable>& GoldenVariables();
+void CaptureGoldenState(std::vector<dp>& State);
+
+// Distance between two doubles in units in the last place
+int64_t UlpDistance(dp a, dp b);
+
+// Runs the cases and writes the state after every stage to FileName, as the
+// variables that changed since the previous stage; false on I/O errors
+bool RecordGoldenStates(const std::vector<rep_GoldenCase>& Cases, const std::string& FileName);
+
+// Runs the cases recorded in FileName and compares every stage against the
+// record. Returns false when the file cannot be used; a mismatch is reported
+// in Divergence. NrCompared is the number of stage states compared.
+bool CompareGoldenStates(const std::string& FileName, rep_GoldenDivergence& Divergence, int64_t& NrCompared);
+
+} // namespace AquaCrop
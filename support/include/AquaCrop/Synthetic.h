@@ -0,0 +1,51 @@
+#pragma once
+
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/SplitMix64.h"
+
+#include <cstdint>
+
+namespace AquaCrop {
+
+// Synthetic soils, seasons and weather of the tests, benchmarks and the
+// workload generator (aquacrop_support, not part of aquacrop_core)
+
+// Texture classes sampled by the synthetic profiles
+struct rep_SoilTexture {
+    const char* Name;
+    dp SAT, FC, WP;  // vol%
+    dp InfRate;      // saturated hydraulic conductivity, mm/day
+};
+
+constexpr int32_t NrSyntheticTextures = 8;
+extern const rep_SoilTexture SyntheticTextures[NrSyntheticTextures];
+
+// Weather of one synthetic day
+struct rep_SyntheticDay {
+    dp Rain;  // mm
+    dp ETo;   // mm
+    dp Tmin;  // degC
+    dp Tmax;  // degC
+};
+
+// Simulation parameters with the default values of the program
+void SetDefaultSimulParam();
+
+// Soil profile of 1 to 3 layers with random texture, discretised in
+// compartments with a random initial water and salt content
+void SetupSyntheticProfile(uint64_t Seed);
+
+// Profile, crop, management and run constants of a season that starts at
+// DayNr1 and lasts NrDays days; the crop is sown on DayNr1
+void SetupSyntheticSeason(uint64_t Seed, int32_t DayNr1, int32_t NrDays);
+
+// Seasonal weather for day DayOfYear (1..365) drawn from Rng
+rep_SyntheticDay SyntheticWeather(rep_SplitMix64& Rng, int32_t DayOfYear);
+
+// Runs Budget_module for NrDays consecutive days from DayNr1 on the state
+// left by SetupSyntheticSeason, in the variant BudgetStep (nullptr: the one
+// selected for the state); returns the number of simulated days
+int32_t RunSyntheticSeason(uint64_t Seed, int32_t DayNr1, int32_t NrDays, BudgetModuleFn BudgetStep = nullptr);
+
+} // namespace AquaCrop
@@ -0,0 +1,318 @@
+#include "AquaCrop/GoldenState.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Synthetic.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace AquaCrop {
+
+namespace {
+
+constexpr const char* GoldenHeader = "AquaCrop golden state 1";
+
+// Tolerances written to a new record (a comparison uses those of the
+// record): water contents in m3/m3, fluxes and storages in mm, salts in Mg/ha
+constexpr dp ThetaAbs = 1.0e-12;
+constexpr dp AmountAbs = 1.0e-9;
+constexpr int64_t StateUlp = 64;
+
+// Day and stage of a state as one increasing key; the initial state is -1
+int64_t StateKey(int32_t Day, int32_t Stage)
+{
+    return (Day == 0) ? -1 : static_cast<int64_t>(Day - 1) * NrBudgetStages + Stage;
+}
+
+struct rep_GoldenRecord {
+    int64_t Key;
+    int32_t Var;
+    dp Value;
+};
+
+struct rep_GoldenRun {
+    // recording
+    std::ostream* Out = nullptr;
+    std::vector<dp> Previous;
+    // comparing, with the tolerances of the record
+    const std::vector<rep_GoldenRecord>* Records = nullptr;
+    const std::vector<rep_GoldenVariable>* Tolerances = nullptr;
+    size_t NextRecord = 0;
+    std::vector<dp> Reference;
+    rep_GoldenDivergence* Divergence = nullptr;
+    int64_t NrCompared = 0;
+    // both
+    std::string Case;
+    int32_t DayNr1 = 0;
+    std::vector<dp> Current;
+};
+
+rep_GoldenRun GoldenRun;
+
+bool SameBits(dp a, dp b)
+{
+    return std::memcmp(&a, &b, sizeof(dp)) == 0;
+}
+
+bool Matches(const rep_GoldenVariable& Variable, dp Reference, dp Candidate)
+{
+    if (SameBits(Reference, Candidate) || Reference == Candidate) return true;
+    if (std::isnan(Reference) || std::isnan(Candidate)) return std::isnan(Reference) && std::isnan(Candidate);
+    return std::abs(Reference - Candidate) <= Variable.Abs || UlpDistance(Reference, Candidate) <= Variable.Ulp;
+}
+
+void WriteChanges(int32_t Day, int32_t Stage)
+{
+    std::vector<dp>& Now = GoldenRun.Current;
+    char Value[40];
+
+    CaptureGoldenState(Now);
+    for (size_t i = 0; i < Now.size(); ++i) {
+        if (Day != 0 && SameBits(Now[i], GoldenRun.Previous[i])) continue;
+        std::snprintf(Value, sizeof(Value), "%a", Now[i]);
+        *GoldenRun.Out << Day << ' ' << Stage << ' ' << i << ' ' << Value << '\n';
+    }
+    GoldenRun.Previous.swap(Now);
+}
+
+void CompareState(int32_t Day, int32_t Stage)
+{
+    rep_GoldenDivergence& Divergence = *GoldenRun.Divergence;
+    const std::vector<rep_GoldenRecord>& Records = *GoldenRun.Records;
+    const std::vector<rep_GoldenVariable>& Variables = *GoldenRun.Tolerances;
+    int64_t Key = StateKey(Day, Stage);
+
+    if (Divergence.Found) return;
+    while (GoldenRun.NextRecord < Records.size() && Records[GoldenRun.NextRecord].Key <= Key) {
+        const rep_GoldenRecord& Record = Records[GoldenRun.NextRecord++];
+        GoldenRun.Reference[Record.Var] = Record.Value;
+    }
+    CaptureGoldenState(GoldenRun.Current);
+    ++GoldenRun.NrCompared;
+    for (size_t i = 0; i < Variables.size(); ++i) {
+        if (Matches(Variables[i], GoldenRun.Reference[i], GoldenRun.Current[i])) continue;
+        Divergence.Found = true;
+        Divergence.Case = GoldenRun.Case;
+        Divergence.Day = Day;
+        Divergence.DayNr = GoldenRun.DayNr1 + Day - 1;
+        Divergence.Stage = static_cast<BudgetStage>(Stage);
+        Divergence.Variable = Variables[i].Name;
+        Divergence.Reference = GoldenRun.Reference[i];
+        Divergence.Candidate = GoldenRun.Current[i];
+        return;
+    }
+}
+
+#ifdef AQUACROP_STAGE_HOOKS
+
+void RecordObserver(int32_t DayNr, BudgetStage Stage)
+{
+    WriteChanges(DayNr - GoldenRun.DayNr1 + 1, static_cast<int32_t>(Stage));
+}
+
+void CompareObserver(int32_t DayNr, BudgetStage Stage)
+{
+    CompareState(DayNr - GoldenRun.DayNr1 + 1, static_cast<int32_t>(Stage));
+}
+
+#endif
+
+// The observer is compiled in with AQUACROP_STAGE_HOOKS only
+bool StageHooksAvailable()
+{
+#ifdef AQUACROP_STAGE_HOOKS
+    return true;
+#else
+    std::cerr << "golden: this build has no stage hooks, configure with -DAQUACROP_STAGE_HOOKS=ON" << std::endl;
+    return false;
+#endif
+}
+
+} // namespace
+
+const std::vector<rep_GoldenVariable>& GoldenVariables()
+{
+    static const std::vector<rep_GoldenVariable> Variables = [] {
+        std::vector<rep_GoldenVariable> V;
+        for (int32_t compi = 1; compi <= max_No_compartments; ++compi) {
+            std::string Comp = "[" + std::to_string(compi) + "]";
+            V.push_back({"theta" + Comp, ThetaAbs, StateUlp});
+            V.push_back({"fluxout" + Comp, AmountAbs, StateUlp});
+            for (int32_t celli = 1; celli <= 11; ++celli) {
+                V.push_back({"Salt" + Comp + "[" + std::to_string(celli) + "]", AmountAbs, StateUlp});
+            }
+            for (int32_t celli = 1; celli <= 11; ++celli) {
+                V.push_back({"Depo" + Comp + "[" + std::to_string(celli) + "]", AmountAbs, StateUlp});
+            }
+        }
+        for (const char* Name : {"CCiActual", "Tpot", "Tact", "Epot", "Eact", "Drain", "Runoff",
+                                 "Infiltrated", "CRwater", "CRsalt", "SurfaceStorage", "ECstorage",
+                                 "ECdrain", "SaltInfiltr", "RootingDepth", "EvapWCsurf"}) {
+            V.push_back({Name, AmountAbs, StateUlp});
+        }
+        return V;
+    }();
+    return Variables;
+}
+
+void CaptureGoldenState(std::vector<dp>& State)
+{
+    State.clear();
+    State.reserve(GoldenVariables().size());
+    for (int32_t compi = 1; compi <= max_No_compartments; ++compi) {
+        if (compi <= NrCompartments) {
+            const CompartmentIndividual& Comp = Compartment[compi-1];
+            State.push_back(Comp.theta);
+            State.push_back(Comp.fluxout);
+            const CompartmentSaltIndividual& CompSalt = CompartmentSalt[compi-1];
+            State.insert(State.end(), CompSalt.Salt.begin(), CompSalt.Salt.begin() + max_SaltCells);
+            State.insert(State.end(), CompSalt.Depo.begin(), CompSalt.Depo.begin() + max_SaltCells);
+        } else {
+            State.insert(State.end(), 24, 0.0);
+        }
+    }
+    for (dp Value : {CCiActual, Tpot, Tact, Epot, Eact, Drain, Runoff, Infiltrated, CRwater, CRsalt,
+                     SurfaceStorage, ECstorage, ECdrain, SaltInfiltr, RootingDepth, Simulation.EvapWCsurf}) {
+        State.push_back(Value);
+    }
+}
+
+int64_t UlpDistance(dp a, dp b)
+{
+    int64_t ia, ib;
+
+    if (std::isnan(a) || std::isnan(b)) return INT64_MAX;
+    std::memcpy(&ia, &a, sizeof(dp));
+    std::memcpy(&ib, &b, sizeof(dp));
+    // map the sign-magnitude encoding on a monotonic integer scale
+    if (ia < 0) ia = INT64_MIN - ia;
+    if (ib < 0) ib = INT64_MIN - ib;
+    if ((ia >= 0) != (ib >= 0)) {
+        uint64_t d = static_cast<uint64_t>(std::llabs(ia)) + static_cast<uint64_t>(std::llabs(ib));
+        return (d > static_cast<uint64_t>(INT64_MAX)) ? INT64_MAX : static_cast<int64_t>(d);
+    }
+    return std::llabs(ia - ib);
+}
+
+bool RecordGoldenStates(const std::vector<rep_GoldenCase>& Cases, const std::string& FileName)
+{
+    if (!StageHooksAvailable()) return false;
+    std::ofstream fout(FileName);
+    if (!fout) {
+        std::cerr << "golden: cannot write " << FileName << std::endl;
+        return false;
+    }
+    const std::vector<rep_GoldenVariable>& Variables = GoldenVariables();
+    fout << GoldenHeader << '\n' << "variables " << Variables.size() << '\n';
+    for (const rep_GoldenVariable& Variable : Variables) {
+        fout << Variable.Name << ' ' << Variable.Abs << ' ' << Variable.Ulp << '\n';
+    }
+
+    GoldenRun = rep_GoldenRun{};
+    GoldenRun.Out = &fout;
+    for (const rep_GoldenCase& Case : Cases) {
+        fout << "case " << Case.Name << ' ' << Case.Seed << ' ' << Case.DayNr1 << ' ' << Case.NrDays << '\n';
+        GoldenRun.Case = Case.Name;
+        GoldenRun.DayNr1 = Case.DayNr1;
+        SetupSyntheticSeason(Case.Seed, Case.DayNr1, Case.NrDays);
+        WriteChanges(0, 0);
+#ifdef AQUACROP_STAGE_HOOKS
+        StageObserver = RecordObserver;
+        RunSyntheticSeason(Case.Seed, Case.DayNr1, Case.NrDays);
+        StageObserver = nullptr;
+#endif
+        fout << "end\n";
+    }
+    GoldenRun = rep_GoldenRun{};
+    return static_cast<bool>(fout);
+}
+
+bool CompareGoldenStates(const std::string& FileName, rep_GoldenDivergence& Divergence, int64_t& NrCompared)
+{
+    std::ifstream fin(FileName);
+    std::string Line, Word;
+    size_t NrVariables = 0;
+    const std::vector<rep_GoldenVariable>& Variables = GoldenVariables();
+
+    Divergence = rep_GoldenDivergence{};
+    NrCompared = 0;
+    if (!StageHooksAvailable()) return false;
+    if (!fin) {
+        std::cerr << "golden: cannot read " << FileName << std::endl;
+        return false;
+    }
+    std::getline(fin, Line);
+    if (Line != GoldenHeader) {
+        std::cerr << "golden: " << FileName << " is not a golden-state record" << std::endl;
+        return false;
+    }
+    fin >> Word >> NrVariables;
+    bool SameLayout = (Word == "variables" && NrVariables == Variables.size());
+    std::vector<rep_GoldenVariable> Tolerances(NrVariables);
+    for (size_t i = 0; SameLayout && i < NrVariables; ++i) {
+        fin >> Tolerances[i].Name >> Tolerances[i].Abs >> Tolerances[i].Ulp;
+        SameLayout = fin && (Tolerances[i].Name == Variables[i].Name);
+    }
+    if (!SameLayout) {
+        std::cerr << "golden: the variables of " << FileName << " differ from this build, record it again" << std::endl;
+        return false;
+    }
+
+    std::vector<rep_GoldenRecord> Records;
+    rep_GoldenCase Case;
+    while (fin >> Word) {
+        if (Word != "case" || !(fin >> Case.Name >> Case.Seed >> Case.DayNr1 >> Case.NrDays)) {
+            std::cerr << "golden: unexpected '" << Word << "' in " << FileName << std::endl;
+            return false;
+        }
+        Records.clear();
+        while (fin >> Word && Word != "end") {
+            int32_t Day = std::atoi(Word.c_str()), Stage;
+            size_t Var;
+            std::string Value;
+            fin >> Stage >> Var >> Value;
+            if (!fin || Var >= Variables.size()) {
+                std::cerr << "golden: corrupt record in case " << Case.Name << " of " << FileName << std::endl;
+                return false;
+            }
+            Records.push_back({StateKey(Day, Stage), static_cast<int32_t>(Var), std::strtod(Value.c_str(), nullptr)});
+        }
+
+        GoldenRun = rep_GoldenRun{};
+        GoldenRun.Records = &Records;
+        GoldenRun.Tolerances = &Tolerances;
+        GoldenRun.Divergence = &Divergence;
+        GoldenRun.Case = Case.Name;
+        GoldenRun.DayNr1 = Case.DayNr1;
+        GoldenRun.Reference.assign(Variables.size(), 0.0);
+        SetupSyntheticSeason(Case.Seed, Case.DayNr1, Case.NrDays);
+        CompareState(0, 0);
+#ifdef AQUACROP_STAGE_HOOKS
+        StageObserver = CompareObserver;
+        RunSyntheticSeason(Case.Seed, Case.DayNr1, Case.NrDays);
+        StageObserver = nullptr;
+#endif
+        NrCompared += GoldenRun.NrCompared;
+        if (!Divergence.Found && GoldenRun.NextRecord < Records.size()) {
+            // the record has states beyond the last stage of the candidate
+            const rep_GoldenRecord& Record = Records[GoldenRun.NextRecord];
+            Divergence.Found = true;
+            Divergence.Case = Case.Name;
+            Divergence.Day = static_cast<int32_t>(Record.Key / NrBudgetStages) + 1;
+            Divergence.DayNr = Case.DayNr1 + Divergence.Day - 1;
+            Divergence.Stage = static_cast<BudgetStage>(Record.Key % NrBudgetStages);
+            Divergence.Variable = Variables[Record.Var].Name;
+            Divergence.Reference = Record.Value;
+            Divergence.Candidate = GoldenRun.Current.empty() ? 0.0 : GoldenRun.Current[Record.Var];
+        }
+        GoldenRun = rep_GoldenRun{};
+        if (Divergence.Found) break;
+    }
+    return true;
+}
+
+} // namespace AquaCrop
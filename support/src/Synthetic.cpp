@@ -0,0 +1,228 @@
+#include "AquaCrop/Synthetic.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/CropCalendar.h"
+#include "AquaCrop/InitialSettings.h"
+#include "AquaCrop/RunConstants.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/SoilState.h"
+#include "AquaCrop/Utils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AquaCrop {
+
+namespace {
+
+constexpr dp SyntheticCO2 = 400.0;
+
+} // namespace
+
+const rep_SoilTexture SyntheticTextures[NrSyntheticTextures] = {
+    {"sand",        36.0, 13.0,  6.0, 1500.0},
+    {"loamy_sand",  38.0, 16.0,  8.0,  800.0},
+    {"sandy_loam",  41.0, 22.0, 10.0,  500.0},
+    {"loam",        46.0, 31.0, 15.0,  250.0},
+    {"silt_loam",   46.0, 33.0, 13.0,  150.0},
+    {"clay_loam",   47.0, 39.0, 23.0,   50.0},
+    {"silty_clay",  50.0, 44.0, 32.0,   20.0},
+    {"clay",        55.0, 50.0, 39.0,   15.0},
+};
+
+void SetDefaultSimulParam()
+{
+    simulparam.EvapDeclineFactor = 4;
+    simulparam.KcWetBare = 1.10;
+    simulparam.PercCCxHIfinal = 5;
+    simulparam.RootPercentZmin = 70;
+    simulparam.MaxRootZoneExpansion = 5.00;
+    simulparam.KsShapeFactorRoot = -6;
+    simulparam.TAWGermination = 20;
+    simulparam.pAdjFAO = 1.0;
+    simulparam.DelayLowOxygen = 3;
+    simulparam.ExpFsen = 1.00;
+    simulparam.Beta = 12;
+    simulparam.ThicknessTopSWC = 10;
+    simulparam.EvapZmax = 30;
+    simulparam.RunoffDepth = 0.30;
+    simulparam.CNcorrection = true;
+    simulparam.Tmin = 12.0;
+    simulparam.Tmax = 28.0;
+    simulparam.GDDMethod = 3;
+    simulparam.PercRAW = 50;
+    simulparam.CompDefThick = 0.10;
+    simulparam.CropDay1 = 81;
+    simulparam.Tbase = 10.0;
+    simulparam.Tupper = 30.0;
+    simulparam.IrriFwInSeason = 100;
+    simulparam.IrriFwOffSeason = 100;
+    simulparam.EffectiveRain.EffMethod = EffectiveRainMethod::usda;
+    simulparam.EffectiveRain.PercentEffRain = 70;
+    simulparam.EffectiveRain.ShowersInDecade = 2;
+    simulparam.EffectiveRain.RootNrEvap = 5;
+    simulparam.SaltDiff = 20;
+    simulparam.SaltSolub = 100;
+    simulparam.ConstGwt = true;
+    simulparam.RootNrDF = 16;
+    simulparam.IniAbstract = 5;
+}
+
+void SetupSyntheticProfile(uint64_t Seed)
+{
+    rep_SplitMix64 Rng{Seed};
+    int32_t layeri, compi;
+    dp Ztop, Zbot, LayerBottom;
+
+    Soil.NrSoilLayers = static_cast<int8_t>(1 + Rng.Next() % 3);
+    Soil.CNvalue = static_cast<int8_t>(Rng.Uniform(55.0, 85.0));
+    Soil.REW = static_cast<int8_t>(Rng.Uniform(5.0, 12.0));
+    for (layeri = 1; layeri <= Soil.NrSoilLayers; ++layeri) {
+        const rep_SoilTexture& T = SyntheticTextures[Rng.Next() % NrSyntheticTextures];
+        soillayer[layeri-1].Description = "synthetic";
+        soillayer[layeri-1].Thickness = (layeri < Soil.NrSoilLayers) ? Rng.Uniform(0.2, 0.5) : 4.0;
+        soillayer[layeri-1].SAT = T.SAT;
+        soillayer[layeri-1].FC = T.FC;
+        soillayer[layeri-1].WP = T.WP;
+        soillayer[layeri-1].InfRate = T.InfRate * Rng.Uniform(0.8, 1.2);
+        soillayer[layeri-1].Penetrability = 100;
+        soillayer[layeri-1].GravelMass = static_cast<int8_t>(Rng.Uniform(0.0, 15.0));
+        soillayer[layeri-1].GravelVol = FromGravelMassToGravelVolume(soillayer[layeri-1].SAT, soillayer[layeri-1].GravelMass);
+    }
+    LoadProfileProcessing(7.1);
+    for (layeri = 1; layeri <= Soil.NrSoilLayers; ++layeri) {
+        DetermineParametersCR(soillayer[layeri-1].SoilClass, soillayer[layeri-1].InfRate,
+                              soillayer[layeri-1].CRa, soillayer[layeri-1].CRb);
+    }
+
+    // compartments: layer, initial water content between WP and SAT, dissolved salts
+    layeri = 1;
+    Zbot = 0.0;
+    LayerBottom = soillayer[0].Thickness;
+    InvalidateDerivedSoilState();
+    for (compi = 1; compi <= NrCompartments; ++compi) {
+        Ztop = Zbot;
+        Zbot = Ztop + Compartment[compi-1].Thickness;
+        while (layeri < Soil.NrSoilLayers && (Ztop + Zbot) / 2.0 > LayerBottom) {
+            ++layeri;
+            LayerBottom += soillayer[layeri-1].Thickness;
+        }
+        const SoilLayerIndividual& L = soillayer[layeri-1];
+        Compartment[compi-1].Layer = layeri;
+        Compartment[compi-1].theta = Rng.Uniform(L.WP, L.SAT) / 100.0;
+        Compartment[compi-1].fluxout = 0.0;
+        Compartment[compi-1].FCadj = L.FC;
+        Compartment[compi-1].Smax = 0.0;
+        Compartment[compi-1].DayAnaero = 0;
+        Compartment[compi-1].WFactor = 0.0;
+        for (int32_t celli = 1; celli <= max_SaltCells; ++celli) {
+            CompartmentSalt[compi-1].Salt[celli-1] = (celli <= L.SCP1) ? Rng.Uniform(0.0, 5.0) : 0.0;
+            CompartmentSalt[compi-1].Depo[celli-1] = 0.0;
+        }
+    }
+}
+
+void SetupSyntheticSeason(uint64_t Seed, int32_t DayNr1, int32_t NrDays)
+{
+    rep_SplitMix64 Rng{Seed ^ 0x5EA50ULL};
+
+    SetDefaultSimulParam();
+    InitializeSettings(false, false);
+    crop.Day1 = DayNr1;
+    crop.DayN = DayNr1 + NrDays - 1;
+    crop.CCx = Rng.Uniform(0.70, 0.95);
+    crop.CGC = Rng.Uniform(0.08, 0.18);
+    crop.RootMax = Rng.Uniform(0.6, 1.2);
+    crop.pActStom = crop.pdef;
+    SetupSyntheticProfile(Seed);
+
+    Management.Mulch = 0;
+    Management.EffectMulchInS = 50;
+    Management.FertilityStress = 0;
+    Management.BundHeight = 0.0;
+    Management.RunoffOn = true;
+    Management.CNcorrection = 0;
+    Management.WeedRC = 0;
+    Management.WeedShape = -0.01;
+
+    Simulation.FromDayNr = DayNr1;
+    Simulation.ToDayNr = crop.DayN;
+    Simulation.DelayedDays = 0;
+    Simulation.Germinate = false;
+    Simulation.SumGDD = 0.0;
+    Simulation.SumGDDfromDay1 = 0.0;
+    Simulation.EvapWCsurf = 0.0;
+    Simulation.SWCtopSoilConsidered = false;
+    Simulation.IrriECw = 0.0;
+    Simulation.EffectStress.RedCGC = 0;
+    Simulation.EffectStress.RedCCX = 0;
+    Simulation.EffectStress.RedWP = 0;
+    Simulation.EffectStress.CDecline = 0.0;
+    Simulation.EffectStress.RedKsSto = 0;
+    IrriECw.PreSeason = 0.0;
+    IrriECw.PostSeason = 0.0;
+    IrriMode_Val = IrriMode::NoIrri;
+    RainRecord.DataType = datatype::daily;
+
+    ZiAqua = undef_int;
+    ECiAqua = undef_int;
+    SurfaceStorage = 0.0;
+    ECstorage = 0.0;
+    DaySubmerged = 0;
+    PreDay = false;
+    Irrigation = 0.0;
+    RootingDepth = crop.RootMin;
+    CCiActual = 0.0;
+    SumWaBal = rep_sum{};
+
+    DetermineRunConstants(SyntheticCO2);
+    DetermineCropCalendar();
+}
+
+rep_SyntheticDay SyntheticWeather(rep_SplitMix64& Rng, int32_t DayOfYear)
+{
+    rep_SyntheticDay Day;
+    dp Season = std::sin(2.0 * PI * static_cast<dp>(DayOfYear - 105) / 365.0);
+
+    Day.Tmin = 8.0 + 8.0 * Season + Rng.Uniform(-3.0, 3.0);
+    Day.Tmax = Day.Tmin + Rng.Uniform(6.0, 14.0);
+    Day.ETo = std::max(0.3, 3.5 + 2.5 * Season + Rng.Uniform(-1.0, 1.0));
+    Day.Rain = (Rng.Uniform() < 0.25) ? -8.0 * std::log(1.0 - Rng.Uniform()) : 0.0;
+    return Day;
+}
+
+int32_t RunSyntheticSeason(uint64_t Seed, int32_t DayNr1, int32_t NrDays, BudgetModuleFn BudgetStep)
+{
+    rep_SplitMix64 Rng{Seed ^ 0x3EA7E4ULL};
+    dp StressLeaf = undef_int, StressSenescence = undef_int, TimeSenescence = 0.0, TESTVAL = 0.0;
+    bool NoMoreCrop = false;
+    int32_t Dayi, Monthi, Yeari, DayNrJan1, VirtualTimeCC;
+    dp GDDayi;
+    if (BudgetStep == nullptr) BudgetStep = SelectBudgetModule(CurrentBudgetConfig());
+
+    for (int32_t DayNr = DayNr1; DayNr < DayNr1 + NrDays; ++DayNr) {
+        DetermineDate(DayNr, Dayi, Monthi, Yeari);
+        DetermineDayNr(1, 1, Yeari, DayNrJan1);
+        rep_SyntheticDay Day = SyntheticWeather(Rng, DayNr - DayNrJan1 + 1);
+        Rain = Day.Rain;
+        ETo = Day.ETo;
+        GDDayi = DegreesDay(crop.Tbase, crop.Tupper, Day.Tmin, Day.Tmax, simulparam.GDDMethod);
+        Simulation.SumGDD += GDDayi;
+        Simulation.SumGDDfromDay1 += GDDayi;
+
+        // CalculateETpot is not ported yet: drive transpiration from the canopy
+        VirtualTimeCC = DayNr - crop.Day1 + 1;
+        Tpot = ETo * crop.KcTop * CCiActual;
+        RootingDepth = std::min(crop.RootMax, crop.RootMin
+            + (crop.RootMax - crop.RootMin) * static_cast<dp>(VirtualTimeCC) / static_cast<dp>(crop.DaysToMaxRooting));
+
+        BudgetStep(DayNr, undef_int, undef_int, VirtualTimeCC, 0, 0,
+            VirtualTimeCC, 0, 0, GDDayi, crop.CGC, crop.GDDCGC, SyntheticCO2,
+            crop.CCx, crop.CCo, crop.CDC, crop.GDDCDC, Simulation.SumGDDfromDay1,
+            0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0, false, false,
+            StressLeaf, StressSenescence, TimeSenescence, NoMoreCrop, TESTVAL);
+        PreDay = true;
+    }
+    return NrDays;
+}
+
+} // namespace AquaCrop
@@ -0,0 +1,42 @@
+# Generates the same workload twice, requires byte-identical files and runs
+# aquacrop_main on one copy:
+#   cmake -DGENERATE=<aquacrop_generate> -DMAIN=<aquacrop_main> -DOUT=<dir> -P generate_workload.cmake
+
+set(Fields 3)
+set(Years 2)
+file(REMOVE_RECURSE ${OUT})
+foreach(Copy a b)
+    execute_process(COMMAND ${GENERATE} --out ${OUT}/${Copy} --fields ${Fields} --years ${Years} --seed 5
+                            --observations
+                    RESULT_VARIABLE Result OUTPUT_QUIET)
+    if(NOT Result EQUAL 0)
+        message(FATAL_ERROR "aquacrop_generate failed: ${Result}")
+    endif()
+endforeach()
+
+file(GLOB_RECURSE FilesA RELATIVE ${OUT}/a ${OUT}/a/*)
+file(GLOB_RECURSE FilesB RELATIVE ${OUT}/b ${OUT}/b/*)
+if(NOT FilesA STREQUAL FilesB)
+    message(FATAL_ERROR "the two runs wrote different files")
+endif()
+foreach(File ${FilesA})
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUT}/a/${File} ${OUT}/b/${File}
+                    RESULT_VARIABLE Result)
+    if(NOT Result EQUAL 0)
+        message(FATAL_ERROR "${File} differs between the two runs")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${MAIN} WORKING_DIRECTORY ${OUT}/a
+                RESULT_VARIABLE Result OUTPUT_VARIABLE Output ERROR_VARIABLE Output)
+if(NOT Result EQUAL 0)
+    message(FATAL_ERROR "aquacrop_main failed on the generated workload: ${Result}")
+endif()
+string(REGEX MATCHALL "Running simulation [0-9]+ of ${Years}" Runs "${Output}")
+list(LENGTH Runs NrRuns)
+math(EXPR Expected "${Fields} * ${Years}")
+if(NOT NrRuns EQUAL Expected)
+    message(FATAL_ERROR "aquacrop_main simulated ${NrRuns} runs instead of ${Expected}")
+endif()
+list(LENGTH FilesA NrFiles)
+message(STATUS "${NrFiles} identical files, ${NrRuns} runs simulated")
@@ -0,0 +1,78 @@
+// Checks that the Budget_module variant selected for a run gives the same
+// state after every stage as the variant with all stages compiled, on
+// synthetic seasons without groundwater, with and without salt. Without
+// salt the selected variant leaves the salt cells as they are.
+#include "AquaCrop/GoldenState.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/StageProfile.h"
+#include "AquaCrop/Synthetic.h"
+#include "AquaCrop/Utils.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+std::vector<std::vector<dp>> StageStates;
+
+void RecordStage(int32_t, BudgetStage) {
+    StageStates.emplace_back();
+    CaptureGoldenState(StageStates.back());
+}
+
+// State after every stage of the season in the selected variant or in the
+// variant with all stages, with the initial salt removed when SaltFree
+std::vector<std::vector<dp>> SeasonStates(uint64_t Seed, int32_t DayNr1, bool SaltFree, bool AllStages,
+                                          rep_BudgetConfig& Selected) {
+    SetupSyntheticSeason(Seed, DayNr1, 30);
+    if (SaltFree) {
+        for (CompartmentSaltIndividual& CompSalt : CompartmentSalt) {
+            for (dp& Salt : CompSalt.Salt) Salt = 0.0;
+            for (dp& Depo : CompSalt.Depo) Depo = 0.0;
+        }
+    }
+    Selected = CurrentBudgetConfig();
+    rep_BudgetConfig Config = Selected;
+    if (AllStages) {
+        Config.Groundwater = true;
+        Config.Salinity = true;
+    }
+    StageStates.clear();
+    StageObserver = RecordStage;
+    RunSyntheticSeason(Seed, DayNr1, 30, SelectBudgetModule(Config));
+    StageObserver = nullptr;
+    return StageStates;
+}
+
+} // namespace
+
+int main() {
+    int32_t Failures = 0;
+    int32_t DayNr1;
+    DetermineDayNr(1, 4, 2001, DayNr1);
+    for (uint64_t Seed : {1, 7, 42}) {
+        for (bool SaltFree : {false, true}) {
+            rep_BudgetConfig Selected;
+            std::vector<std::vector<dp>> Reference = SeasonStates(Seed, DayNr1, SaltFree, true, Selected);
+            std::vector<std::vector<dp>> Candidate = SeasonStates(Seed, DayNr1, SaltFree, false, Selected);
+            if (Selected.Groundwater || Selected.Salinity == SaltFree) {
+                std::cerr << "seed " << Seed << (SaltFree ? " salt-free" : " saline")
+                          << ": unexpected configuration" << std::endl;
+                ++Failures;
+            }
+            if (Candidate != Reference) {
+                std::cerr << "seed " << Seed << (SaltFree ? " salt-free" : " saline")
+                          << ": states differ from the full variant" << std::endl;
+                ++Failures;
+            }
+        }
+    }
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "selected Budget_module variants match the full variant" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+// Runs the calibration optimizers on analytic functions, with the batches
+// evaluated on the thread pool as CalibrateProject does.
+#include "AquaCrop/Optimize.h"
+#include "AquaCrop/ThreadPool.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+dp Sphere(const std::vector<dp>& X) {
+    const dp Optimum[3] = {0.3, 0.7, 0.55};
+    dp Sum = 0.0;
+    for (size_t j = 0; j < X.size(); ++j) Sum += (X[j] - Optimum[j]) * (X[j] - Optimum[j]);
+    return Sum;
+}
+
+// Rosenbrock on [-2, 2]^2, minimum 0 at (1, 1) = (0.75, 0.75) in the cube
+dp Rosenbrock(const std::vector<dp>& U) {
+    dp x = 4.0 * U[0] - 2.0, y = 4.0 * U[1] - 2.0;
+    return 100.0 * (y - x * x) * (y - x * x) + (1.0 - x) * (1.0 - x);
+}
+
+void Minimize(ThreadPool& Pool, OptimMethod Method, const char* Name, int32_t NrDim,
+              dp (*Function)(const std::vector<dp>&), dp Limit) {
+    rep_OptimSettings Settings;
+    Settings.Method = Method;
+    Settings.MaxEvaluations = 4000;
+    Settings.Tolerance = 1.0e-12;
+    BatchObjective Objective = [&Pool, Function](const std::vector<std::vector<dp>>& Points, std::vector<dp>& Values) {
+        Pool.ParallelFor(static_cast<int32_t>(Points.size()), [&](int32_t Item) { Values[Item] = Function(Points[Item]); });
+    };
+    rep_OptimResult Result = MinimizeInUnitCube(NrDim, Objective, Settings);
+    if (!(Result.BestValue < Limit) || Result.NrEvaluations > Settings.MaxEvaluations) {
+        std::cerr << OptimMethodName(Method) << " on " << Name << ": " << Result.BestValue << " after "
+                  << Result.NrEvaluations << " evaluations" << std::endl;
+        ++Failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    ThreadPool Pool(4);
+
+    // every item exactly once, repeatedly
+    for (int32_t Round = 1; Round <= 50; ++Round) {
+        std::vector<std::atomic<int32_t>> Seen(Round);
+        Pool.ParallelFor(Round, [&Seen](int32_t Item) { ++Seen[Item]; });
+        for (int32_t i = 0; i < Round; ++i) {
+            if (Seen[i] != 1) {
+                std::cerr << "item " << i << " of " << Round << " ran " << Seen[i] << " times" << std::endl;
+                ++Failures;
+            }
+        }
+    }
+
+    for (OptimMethod Method : {OptimMethod::NelderMead, OptimMethod::DifferentialEvolution, OptimMethod::CMAES}) {
+        Minimize(Pool, Method, "sphere", 3, Sphere, 1.0e-6);
+        Minimize(Pool, Method, "rosenbrock", 2, Rosenbrock, 1.0e-4);
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "optimizers converge" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+// Checks CO2ForSimulationPeriod with the cached per-year series against the
+// sequential scan of the CO2 file it replaced, for every from/to year pair
+// (from 1901, the first calendar year) around and inside a file with
+// irregular record spacing.
+#include "AquaCrop/CO2Series.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Utils.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using namespace AquaCrop;
+
+namespace {
+
+uint64_t Bits(dp x) {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+void SplitInTwo(const std::string& Line, dp& Par1, dp& Par2) {
+    std::sscanf(Line.c_str(), "%lf %lf", &Par1, &Par2);
+}
+
+// The file scan of CO2ForSimulationPeriod before the series
+dp ScanCO2ForSimulationPeriod(const std::string& File, int32_t FromYi, int32_t ToYi) {
+    dp CO2From, CO2To, CO2a, CO2b, YearA, YearB;
+    std::string TempString;
+    if (FromYi == 1901 || ToYi == 1901) return CO2Ref;
+    std::ifstream fhandle(File);
+    std::string line;
+    for (int k = 0; k < 3; ++k) std::getline(fhandle, line);
+
+    std::getline(fhandle, TempString);
+    SplitInTwo(TempString, YearB, CO2b);
+    if (roundc(YearB, 1) >= FromYi) {
+        CO2From = CO2b;
+        YearA = YearB;
+        CO2a = CO2b;
+    } else {
+        do {
+            YearA = YearB;
+            CO2a = CO2b;
+            if (!std::getline(fhandle, TempString)) break;
+            SplitInTwo(TempString, YearB, CO2b);
+        } while (!(roundc(YearB, 1) >= FromYi));
+        if (FromYi > roundc(YearB, 1)) {
+            CO2From = CO2b;
+        } else {
+            CO2From = CO2a + (CO2b - CO2a) * static_cast<dp>(FromYi - static_cast<int32_t>(roundc(YearA, 1)))
+                / static_cast<dp>(static_cast<int32_t>(roundc(YearB, 1)) - static_cast<int32_t>(roundc(YearA, 1)));
+        }
+    }
+
+    CO2To = CO2From;
+    if (ToYi > FromYi && static_cast<dp>(ToYi) > roundc(YearA, 1)) {
+        if (roundc(YearB, 1) >= ToYi) {
+            CO2To = CO2a + (CO2b - CO2a) * static_cast<dp>(ToYi - static_cast<int32_t>(roundc(YearA, 1)))
+                / static_cast<dp>(static_cast<int32_t>(roundc(YearB, 1)) - static_cast<int32_t>(roundc(YearA, 1)));
+        } else if (fhandle.good()) {
+            do {
+                YearA = YearB;
+                CO2a = CO2b;
+                if (!std::getline(fhandle, TempString)) break;
+                SplitInTwo(TempString, YearB, CO2b);
+                if (roundc(YearB, 1) >= ToYi) break;
+            } while (fhandle.good());
+            if (ToYi > roundc(YearB, 1)) {
+                CO2To = CO2b;
+            } else {
+                CO2To = CO2a + (CO2b - CO2a) * static_cast<dp>(ToYi - static_cast<int32_t>(roundc(YearA, 1)))
+                    / static_cast<dp>(static_cast<int32_t>(roundc(YearB, 1)) - static_cast<int32_t>(roundc(YearA, 1)));
+            }
+        }
+    }
+    return (CO2From + CO2To) / 2.0;
+}
+
+} // namespace
+
+int main() {
+    char Name[] = "/tmp/aquacrop_co2XXXXXX";
+    int Fd = mkstemp(Name);
+    if (Fd < 0) {
+        std::cerr << "no temporary file" << std::endl;
+        return EXIT_FAILURE;
+    }
+    close(Fd);
+    {
+        std::ofstream Out(Name);
+        Out << "synthetic CO2 series\n"
+            << "Year     CO2 (ppm by volume)\n"
+            << "============================\n";
+        const int32_t Years[] = {1925, 1928, 1930, 1931, 1960, 1984, 1999, 2000, 2025, 2050, 2099};
+        dp CO2 = 297.4;
+        for (int32_t Year : Years) {
+            Out << Year << "  " << CO2 << "\n";
+            CO2 += 0.37 * static_cast<dp>(Year % 17) + 3.1;
+        }
+    }
+
+    CO2FileFull = Name;
+    int32_t Failures = 0;
+    for (int32_t FromYi = 1901; FromYi <= 2111; ++FromYi) {
+        for (int32_t ToYi = FromYi; ToYi <= 2111; ++ToYi) {
+            int32_t FromDayNr, ToDayNr;
+            DetermineDayNr(15, 3, FromYi, FromDayNr);
+            DetermineDayNr(20, 9, ToYi, ToDayNr);
+            dp Cached = CO2ForSimulationPeriod(FromDayNr, ToDayNr);
+            dp Scanned = ScanCO2ForSimulationPeriod(Name, FromYi, ToYi);
+            if (Bits(Cached) != Bits(Scanned)) {
+                if (Failures < 10) {
+                    std::cerr << FromYi << "-" << ToYi << ": " << Cached << " != " << Scanned << std::endl;
+                }
+                ++Failures;
+            }
+        }
+    }
+    if (GetCO2Series(Name) != GetCO2Series(Name)) {
+        std::cerr << "series parsed again for an unchanged file" << std::endl;
+        ++Failures;
+    }
+    std::remove(Name);
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "CO2 series matches the file scan" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+// Checks that the no-stress canopy cover from the crop calendar gives the
+// bits of CanopyCoverNoStressSF, also with delayed days and when more curves
+// are asked for than the calendar holds.
+#include "AquaCrop/CropCalendar.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace AquaCrop;
+
+namespace {
+
+uint64_t Bits(dp x) {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+} // namespace
+
+int main() {
+    int32_t Failures = 0;
+    DetermineCropCalendar();
+    // fertility stress levels of the reference curves, more than the calendar holds
+    const int8_t RedCGC[] = {0, 10, 25, 40, 0, 60};
+    const int8_t RedCCx[] = {0, 5, 20, 35, 0, 50};
+    for (int32_t Delayed : {0, 3}) {
+        Simulation.DelayedDays = Delayed;
+        for (int32_t s = 0; s < 6; ++s) {
+            for (int32_t DAP = -2; DAP <= 140; ++DAP) {
+                dp CC = CanopyCoverNoStressSFRun(DAP, 8, 95, 125, 80, 1200, 1600, 0.0675, 0.92, 0.118, 0.09,
+                                                 0.012, 0.008, 0.0, modeCycle::CalendarDays, RedCGC[s], RedCCx[s]);
+                dp Expected = CanopyCoverNoStressSF(DAP, 8, 95, 125, 80, 1200, 1600, 0.0675, 0.92, 0.118, 0.09,
+                                                    0.012, 0.008, 0.0, modeCycle::CalendarDays, RedCGC[s], RedCCx[s]);
+                if (Bits(CC) != Bits(Expected)) {
+                    if (Failures < 10) {
+                        std::cerr << "stress " << s << " delay " << Delayed << " DAP " << DAP << ": "
+                                  << CC << " != " << Expected << std::endl;
+                    }
+                    ++Failures;
+                }
+            }
+        }
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "crop calendar canopy cover matches" << std::endl;
+    return EXIT_SUCCESS;
+}
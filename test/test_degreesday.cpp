@@ -0,0 +1,81 @@
+// Checks that the batch DegreesDay kernels return exactly the bits of the
+// scalar DegreesDay for every method and every available instruction set.
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simd.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+uint64_t Bits(dp x) {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+// small deterministic generator (xorshift)
+uint32_t NextRandom(uint32_t& State) {
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    return State;
+}
+
+} // namespace
+
+int main() {
+    // Series with a length that leaves a tail for every vector width
+    const int32_t NrDays = 1003;
+    std::vector<sp> Tmin(NrDays), Tmax(NrDays);
+    uint32_t State = 2463534242u;
+    for (int32_t i = 0; i < NrDays; ++i) {
+        Tmin[i] = static_cast<sp>(static_cast<int32_t>(NextRandom(State) % 6000) - 2000) / 100.0f;
+        Tmax[i] = Tmin[i] + static_cast<sp>(NextRandom(State) % 2500) / 100.0f;
+    }
+    // values on the thresholds, signed zeros and missing data
+    Tmin[3] = 8.0f; Tmax[3] = 30.0f;
+    Tmin[4] = -0.0f; Tmax[4] = 0.0f;
+    Tmin[5] = std::numeric_limits<sp>::quiet_NaN(); Tmax[5] = 12.0f;
+    Tmin[6] = 5.0f; Tmax[6] = std::numeric_limits<sp>::quiet_NaN();
+
+    const dp Thresholds[][2] = {{8.0, 30.0}, {0.0, 25.0}, {10.0, 10.0}, {15.0, 5.0}};
+    const SimdLevel Levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+
+    int32_t Failures = 0;
+    std::vector<dp> GDD(NrDays);
+    for (SimdLevel Level : Levels) {
+        if (!SimdLevelAvailable(Level)) {
+            std::cout << SimdLevelName(Level) << ": not available, skipped" << std::endl;
+            continue;
+        }
+        for (const auto& T : Thresholds) {
+            for (int8_t Method = 1; Method <= 3; ++Method) {
+                DegreesDaySeriesAt(Level, T[0], T[1], Tmin.data(), Tmax.data(), NrDays, Method, GDD.data());
+                for (int32_t i = 0; i < NrDays; ++i) {
+                    dp Expected = DegreesDay(T[0], T[1], Tmin[i], Tmax[i], Method);
+                    if (Bits(GDD[i]) != Bits(Expected)) {
+                        if (Failures < 10) {
+                            std::cerr << SimdLevelName(Level) << " method " << static_cast<int>(Method)
+                                      << " day " << i << ": " << GDD[i] << " != " << Expected << std::endl;
+                        }
+                        ++Failures;
+                    }
+                }
+            }
+        }
+        std::cout << SimdLevelName(Level) << ": checked" << std::endl;
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "DegreesDaySeries bit-identical" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+// Checks the drainage function with the coefficients cached per layer: the
+// same bits as the formula on SAT, FC and tau, increasing in theta, and the
+// inverse recovering theta within a tolerance.
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/Synthetic.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+// calculate_delta_theta as written on the layer parameters
+dp DeltaThetaReference(dp theta, dp thetaAdjFC, const SoilLayerIndividual& Layer) {
+    dp theta_sat = Layer.SAT / 100.0;
+    dp theta_fc = Layer.FC / 100.0;
+    if (theta > theta_sat) theta = theta_sat;
+    if (theta <= thetaAdjFC) return 0.0;
+    dp DeltaX = Layer.tau * (theta_sat - theta_fc) * (std::exp(theta - theta_fc) - 1.0) / (std::exp(theta_sat - theta_fc) - 1.0);
+    if ((theta - DeltaX) < thetaAdjFC) DeltaX = theta - thetaAdjFC;
+    return DeltaX;
+}
+
+void Fail(const char* What, uint64_t Seed, int32_t layeri, dp theta, dp Value, dp Expected) {
+    if (Failures < 10) {
+        std::cerr << What << ": seed " << Seed << " layer " << layeri << " theta " << theta << ": "
+                  << Value << " != " << Expected << std::endl;
+    }
+    ++Failures;
+}
+
+} // namespace
+
+int main() {
+    const dp Tolerance = 1e-9;
+    for (uint64_t Seed = 1; Seed <= 20; ++Seed) {
+        SetupSyntheticSeason(Seed, 0, 1);
+        for (int32_t layeri = 1; layeri <= Soil.NrSoilLayers; ++layeri) {
+            const SoilLayerIndividual& Layer = soillayer[layeri - 1];
+            const dp ThetaFC = Layer.FC / 100.0, ThetaSat = Layer.SAT / 100.0;
+            dp Previous = 0.0;
+            for (int32_t i = 0; i <= 200; ++i) {
+                dp theta = ThetaFC + (ThetaSat + 0.02 - ThetaFC) * i / 200.0;
+                dp Delta = calculate_delta_theta(theta, ThetaFC, layeri);
+                dp Expected = DeltaThetaReference(theta, ThetaFC, Layer);
+                if (Delta != Expected) Fail("delta_theta", Seed, layeri, theta, Delta, Expected);
+                if (Delta < Previous) Fail("not increasing", Seed, layeri, theta, Delta, Previous);
+                Previous = Delta;
+                // the inverse where the drainage is not limited by FC
+                if (theta < ThetaSat && Delta > 1e-12 && theta - Delta > ThetaFC) {
+                    dp ThetaBack = calculate_theta_from_delta(Delta, ThetaFC, layeri);
+                    if (std::abs(ThetaBack - theta) > Tolerance) Fail("inverse", Seed, layeri, theta, ThetaBack, theta);
+                }
+            }
+        }
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "drainage function and inverse match" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+// Checks the streaming goodness-of-fit statistics against the two-pass
+// textbook formulas, and the evaluation of a run against a written
+// observation file: the rows read, the day index of the run and the
+// statistics of every variable worked out by hand.
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/Evaluation.h"
+#include "AquaCrop/EventTimeline.h"
+#include "AquaCrop/Utils.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void Check(const std::string& Name, dp Value, dp Expected) {
+    if (std::abs(Value - Expected) > 1.0e-12 * (1.0 + std::abs(Expected))) {
+        std::cerr << Name << ": " << Value << " != " << Expected << std::endl;
+        ++Failures;
+    }
+}
+
+void CheckStreamingStats() {
+    const std::vector<dp> Obs = {5.0, 20.0, 35.0, 60.0, 80.0, 85.0, 70.0};
+    const std::vector<dp> Sim = {3.5, 24.0, 31.0, 66.5, 77.0, 90.0, 61.0};
+    const dp N = static_cast<dp>(Obs.size());
+
+    // two passes: observed mean first, then the sums
+    dp Mean = 0.0;
+    for (dp O : Obs) Mean += O;
+    Mean /= N;
+    dp SumDiff = 0.0, SumDiff2 = 0.0, SumObsDev2 = 0.0, SumPotErr2 = 0.0;
+    for (size_t i = 0; i < Obs.size(); ++i) {
+        SumDiff += Sim[i] - Obs[i];
+        SumDiff2 += (Sim[i] - Obs[i]) * (Sim[i] - Obs[i]);
+        SumObsDev2 += (Obs[i] - Mean) * (Obs[i] - Mean);
+        SumPotErr2 += std::pow(std::abs(Sim[i] - Mean) + std::abs(Obs[i] - Mean), 2);
+    }
+
+    rep_FitAccumulator Fit;
+    Fit.Reset(Mean);
+    for (size_t i = 0; i < Obs.size(); ++i) Fit.Add(Obs[i], Sim[i]);
+    rep_FitStats S = Fit.Stats();
+
+    if (S.N != static_cast<int32_t>(Obs.size())) {
+        std::cerr << "N: " << S.N << std::endl;
+        ++Failures;
+    }
+    Check("RMSE", S.RMSE, std::sqrt(SumDiff2 / N));
+    Check("NRMSE", S.NRMSE, 100.0 * std::sqrt(SumDiff2 / N) / Mean);
+    Check("d", S.d, 1.0 - SumDiff2 / SumPotErr2);
+    Check("EF", S.EF, 1.0 - SumDiff2 / SumObsDev2);
+    Check("Bias", S.Bias, SumDiff / N);
+
+    // perfect agreement and an empty run
+    Fit.Reset(Mean);
+    for (dp O : Obs) Fit.Add(O, O);
+    S = Fit.Stats();
+    Check("perfect RMSE", S.RMSE, 0.0);
+    Check("perfect d", S.d, 1.0);
+    Check("perfect EF", S.EF, 1.0);
+    Fit.Reset(0.0);
+    S = Fit.Stats();
+    Check("empty RMSE", S.RMSE, undef_double);
+}
+
+void CheckFit(const std::string& Name, const rep_FitStats& S, int32_t N, dp RMSE, dp NRMSE, dp d, dp EF,
+              dp Bias) {
+    Check(Name + " N", S.N, N);
+    Check(Name + " RMSE", S.RMSE, RMSE);
+    Check(Name + " NRMSE", S.NRMSE, NRMSE);
+    Check(Name + " d", S.d, d);
+    Check(Name + " EF", S.EF, EF);
+    Check(Name + " Bias", S.Bias, Bias);
+}
+
+// A run of 20 days from 30 March 2001 with observations from 1 April: four
+// rows in the run, with missing (-9) values, and one row after it. Only the
+// observed values of the run count, also for the observed means.
+void CheckObservationFile() {
+    PrepareSimulationThread();
+    const std::string FileName = "evaluation_test.OBS";
+    {
+        std::ofstream out(FileName);
+        out << "Four days in the run and one after it\n"
+               "        7.1   : AquaCrop Version 7.1 (August 2023)\n"
+               "        0.30  : depth of sampled soil profile (m)\n"
+               "        1     : first day of observations\n"
+               "        4     : first month of observations\n"
+               "     2001     : first year of observations (1901 if not linked to a specific year)\n"
+               "\n"
+               "   Day    Canopy cover (%)     dry Biomass (ton/ha)    Soil water content (mm)\n"
+               "            Mean     Std          Mean      Std            Mean       Std\n"
+               "  =============================================================================\n"
+               "     1      10.0     2.0          -9.0     -9.0            60.0       3.0\n"
+               "     3      30.0     4.0           1.5      0.2            -9.0      -9.0\n"
+               "     4      -9.0    -9.0           2.0      0.3            70.0       4.0\n"
+               "     6      50.0     5.0          -9.0     -9.0            80.0       5.0\n"
+               "    40      90.0     5.0           9.0      1.0            90.0       5.0\n";
+        if (!out) {
+            std::cerr << "cannot write " << FileName << std::endl;
+            ++Failures;
+            return;
+        }
+    }
+    ObservationsFile = FileName;
+    ObservationsFilefull = FileName;
+    IrriFile = "(None)";
+    ManFile = "(None)";
+    GroundWaterFile = "(None)";
+    IrriMode_Val = IrriMode::NoIrri;
+    Cuttings.Considered = false;
+
+    int32_t FromDayNr, ToDayNr, ObsDayNr1;
+    DetermineDayNr(30, 3, 2001, FromDayNr);
+    ToDayNr = FromDayNr + 19;
+    DetermineDayNr(1, 4, 2001, ObsDayNr1);
+    BuildEventTimeline(FromDayNr, ToDayNr);
+    BeginRunEvaluation(FromDayNr, ToDayNr);
+    std::remove(FileName.c_str());
+
+    const std::vector<rep_ObsEvent>& Observations = EventTimeline.Observations;
+    Check("observation rows", static_cast<dp>(Observations.size()), 5);
+    const int32_t Days[] = {1, 3, 4, 6, 40};
+    for (size_t i = 0; i < Observations.size() && i < 5; ++i) {
+        const std::string Name = "row " + std::to_string(i + 1);
+        Check(Name + " day", Observations[i].DayNr, ObsDayNr1 + Days[i] - 1);
+        Check(Name + " Zeval", Observations[i].Zeval, 0.30);
+    }
+    Check("row 3 CC std", Observations.empty() ? 0.0 : Observations[2].CCstd, -9.0);
+    Check("row 4 SWC std", Observations.size() < 4 ? 0.0 : Observations[3].SWCstd, 5.0);
+
+    // 1, 3, 4 and 6 April are days 3, 5, 6 and 8 of the run
+    std::vector<int32_t> Expected(20, -1);
+    Expected[3-1] = 0;
+    Expected[5-1] = 1;
+    Expected[6-1] = 2;
+    Expected[8-1] = 3;
+    Check("indexed days", static_cast<dp>(RunEvaluation.ObsOfDay.size()), 20);
+    for (size_t Day = 0; Day < RunEvaluation.ObsOfDay.size() && Day < Expected.size(); ++Day) {
+        Check("observation of day " + std::to_string(Day + 1), RunEvaluation.ObsOfDay[Day], Expected[Day]);
+    }
+
+    // the top 0.30 m is three compartments of 0.1 m: SWC = 300 theta
+    NrCompartments = 12;
+    for (CompartmentIndividual& Comp : Compartment) {
+        Comp.Thickness = 0.1;
+        Comp.Layer = 1;
+    }
+    soillayer[0].GravelVol = 0.0;
+
+    // simulated CC (fraction), biomass and theta of every day; the values
+    // of the days and variables without observation would spoil every fit
+    for (int32_t DayNr = FromDayNr; DayNr <= ToDayNr; ++DayNr) {
+        dp CC = 0.99, Biomass = 99.0, Theta = 0.45;
+        switch (DayNr - ObsDayNr1 + 1) {
+        case 1: CC = 0.12; Theta = 0.21; break;
+        case 3: CC = 0.27; Biomass = 1.2; break;
+        case 4: Biomass = 2.4; Theta = 0.22; break;
+        case 6: CC = 0.56; Theta = 0.25; break;
+        default: break;
+        }
+        CCiActual = CC;
+        SumWaBal.Biomass = Biomass;
+        for (CompartmentIndividual& Comp : Compartment) Comp.theta = Theta;
+        EvaluateDay(DayNr);
+    }
+    rep_RunResult Result;
+    EndRunEvaluation(Result);
+
+    // CC: observed 10, 30, 50 (mean 30), simulated 12, 27, 56
+    CheckFit("CC", Result.Fit[static_cast<int32_t>(typeObsSim::ObsSimCC)], 3, std::sqrt(49.0 / 3.0),
+             100.0 * std::sqrt(49.0 / 3.0) / 30.0, 1.0 - 49.0 / 3569.0, 1.0 - 49.0 / 800.0, 5.0 / 3.0);
+    // biomass: observed 1.5, 2.0 (mean 1.75), simulated 1.2, 2.4
+    CheckFit("biomass", Result.Fit[static_cast<int32_t>(typeObsSim::ObsSimB)], 2, std::sqrt(0.125),
+             100.0 * std::sqrt(0.125) / 1.75, 1.0 - 0.25 / 1.45, -1.0, 0.05);
+    // SWC: observed 60, 70, 80 (mean 70), simulated 63, 66, 75
+    CheckFit("SWC", Result.Fit[static_cast<int32_t>(typeObsSim::ObsSimSWC)], 3, std::sqrt(50.0 / 3.0),
+             100.0 * std::sqrt(50.0 / 3.0) / 70.0, 1.0 - 50.0 / 530.0, 0.75, -2.0);
+}
+
+} // namespace
+
+int main() {
+    CheckStreamingStats();
+    CheckObservationFile();
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "fit statistics match, also on a written observation file" << std::endl;
+    return EXIT_SUCCESS;
+}
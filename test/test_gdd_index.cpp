@@ -0,0 +1,129 @@
+// Checks GrowingDegreeDays and SumCalendarDays on the cumulative GDD index
+// against day-by-day sums of DegreesDay over a synthetic Tmin/Tmax series,
+// for every GDD method, periods reaching before and beyond the series, and
+// GDD targets met exactly on a day (the lower_bound edge) or just after it.
+// Whole-degree temperatures keep all sums exact, so the results must match.
+#include "AquaCrop/Global.h"
+#include "AquaCrop/TempProcessing.h"
+#include "AquaCrop/Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+using namespace AquaCrop;
+
+namespace {
+
+constexpr int32_t FromDayNr = 1000;
+constexpr int32_t NrDays = 200;
+constexpr dp TDayMin = 12.0, TDayMax = 28.0;
+
+int32_t Failures = 0;
+
+uint32_t NextRandom(uint32_t& State) {
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    return State;
+}
+
+dp DayGDD(int32_t DayNr, dp Tbase, dp Tupper) {
+    int32_t i = DayNr - FromDayNr;
+    if (i < 0 || i >= NrDays) return DegreesDay(Tbase, Tupper, TDayMin, TDayMax, simulparam.GDDMethod);
+    return DegreesDay(Tbase, Tupper, TminRun[i], TmaxRun[i], simulparam.GDDMethod);
+}
+
+int32_t DirectGrowingDegreeDays(int32_t ValPeriod, int32_t FirstDayPeriod, dp Tbase, dp Tupper) {
+    if (ValPeriod <= 0) return 0;
+    dp Sum = 0.0;
+    for (int32_t DayNr = FirstDayPeriod; DayNr < FirstDayPeriod + ValPeriod; ++DayNr) Sum += DayGDD(DayNr, Tbase, Tupper);
+    return roundc(Sum, 1);
+}
+
+int32_t DirectSumCalendarDays(int32_t ValGDDays, int32_t FirstDayCrop, dp Tbase, dp Tupper) {
+    if (ValGDDays <= 0) return 0;
+    dp RefGDD = DegreesDay(Tbase, Tupper, TDayMin, TDayMax, simulparam.GDDMethod);
+    int32_t i0 = FirstDayCrop - FromDayNr;
+    if (i0 < 0 || i0 >= NrDays) return roundc(ValGDDays / RefGDD, 1);
+    dp Sum = 0.0;
+    for (int32_t DayNr = FirstDayCrop; DayNr < FromDayNr + NrDays; ++DayNr) {
+        Sum += DayGDD(DayNr, Tbase, Tupper);
+        if (Sum >= ValGDDays) return DayNr - FirstDayCrop + 1;
+    }
+    return (FromDayNr + NrDays - FirstDayCrop) + roundc((ValGDDays - Sum) / RefGDD, 1);
+}
+
+void CheckCalendarDays(int32_t ValGDDays, int32_t FirstDay, dp Tbase, dp Tupper) {
+    int32_t Indexed = SumCalendarDays(ValGDDays, FirstDay, Tbase, Tupper, TDayMin, TDayMax);
+    int32_t Direct = DirectSumCalendarDays(ValGDDays, FirstDay, Tbase, Tupper);
+    if (Indexed != Direct) {
+        if (Failures < 10) {
+            std::cerr << "SumCalendarDays method " << static_cast<int>(simulparam.GDDMethod) << " " << ValGDDays
+                      << " GDD from day " << FirstDay << ": " << Indexed << " != " << Direct << std::endl;
+        }
+        ++Failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    // whole degrees, with days below Tbase (no GDD) and above Tupper
+    TminRun.resize(NrDays);
+    TmaxRun.resize(NrDays);
+    uint32_t State = 2463534242u;
+    for (int32_t i = 0; i < NrDays; ++i) {
+        TminRun[i] = static_cast<sp>(static_cast<int32_t>(NextRandom(State) % 25) - 5);
+        TmaxRun[i] = TminRun[i] + static_cast<sp>(NextRandom(State) % 22);
+    }
+    TemperatureFile = "synthetic.TMP";
+    TemperatureRecord.NrObs = NrDays;
+
+    int32_t NrEdges = 0;
+    for (int8_t Method = 1; Method <= 3; ++Method) {
+        simulparam.GDDMethod = Method;
+        PrepareGDDIndex(FromDayNr, FromDayNr + NrDays - 1);
+        for (dp Tbase : {8.0, 10.0}) {
+            const dp Tupper = Tbase + 22.0;
+            for (int32_t FirstDay = FromDayNr - 15; FirstDay <= FromDayNr + NrDays + 5; ++FirstDay) {
+                for (int32_t ValPeriod = 0; ValPeriod <= NrDays + 40; ValPeriod += 3) {
+                    int32_t Indexed = GrowingDegreeDays(ValPeriod, FirstDay, Tbase, Tupper, TDayMin, TDayMax);
+                    int32_t Direct = DirectGrowingDegreeDays(ValPeriod, FirstDay, Tbase, Tupper);
+                    if (Indexed != Direct) {
+                        if (Failures < 10) {
+                            std::cerr << "GrowingDegreeDays method " << static_cast<int>(Method) << " " << ValPeriod
+                                      << " days from day " << FirstDay << ": " << Indexed << " != " << Direct << std::endl;
+                        }
+                        ++Failures;
+                    }
+                }
+                for (int32_t ValGDDays = 0; ValGDDays <= 2500; ValGDDays += 17) {
+                    CheckCalendarDays(ValGDDays, FirstDay, Tbase, Tupper);
+                }
+                // targets reached exactly at the end of a day, and one GDD later
+                dp Sum = 0.0;
+                for (int32_t DayNr = std::max(FirstDay, FromDayNr); DayNr < FromDayNr + NrDays && FirstDay >= FromDayNr; ++DayNr) {
+                    Sum += DayGDD(DayNr, Tbase, Tupper);
+                    if (Sum > 0.0 && Sum == std::floor(Sum)) {
+                        CheckCalendarDays(static_cast<int32_t>(Sum), FirstDay, Tbase, Tupper);
+                        CheckCalendarDays(static_cast<int32_t>(Sum) + 1, FirstDay, Tbase, Tupper);
+                        ++NrEdges;
+                    }
+                }
+            }
+        }
+    }
+
+    if (NrEdges == 0) {
+        std::cerr << "no exact GDD targets in the series" << std::endl;
+        ++Failures;
+    }
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "indexed GDD sums match the daily sums (" << NrEdges << " exact targets)" << std::endl;
+    return EXIT_SUCCESS;
+}
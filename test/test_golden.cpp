@@ -0,0 +1,160 @@
+// Golden-state regression test: compares the state after every Budget_module
+// stage of the synthetic corpus against test/golden/synthetic_seasons.golden.
+//
+//   test_golden <record>            compare this build against the record
+//   test_golden --record <record>   record this build as the new reference
+#include "AquaCrop/GoldenState.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Utils.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+std::vector<rep_GoldenCase> Corpus() {
+    std::vector<rep_GoldenCase> Cases;
+    const struct { const char* Name; uint64_t Seed; int32_t Day, Month, Year, NrDays; } Seasons[] = {
+        {"spring_1", 1, 1, 4, 2001, 30},
+        {"summer_7", 7, 15, 6, 2003, 30},
+        {"winter_42", 42, 1, 11, 2010, 30},
+    };
+    for (const auto& S : Seasons) {
+        int32_t DayNr1;
+        DetermineDayNr(S.Day, S.Month, S.Year, DayNr1);
+        Cases.push_back({S.Name, S.Seed, DayNr1, S.NrDays});
+    }
+    return Cases;
+}
+
+void Report(const rep_GoldenDivergence& D) {
+    std::cerr << "case " << D.Case << ": ";
+    if (D.Day == 0) {
+        std::cerr << "initial state";
+    } else {
+        std::cerr << "day " << D.Day << " (DayNr " << D.DayNr << ") after stage " << BudgetStageName(D.Stage);
+    }
+    std::cerr.precision(17);
+    std::cerr << ", " << D.Variable << " reference " << D.Reference << " candidate " << D.Candidate
+              << " (" << UlpDistance(D.Reference, D.Candidate) << " ulp)" << std::endl;
+}
+
+// Name of a new empty temporary file, unique to the process: the scalar and
+// the default runs of this test may run at the same time
+std::string TemporaryFile(const std::string& Prefix) {
+    std::string Name = "/tmp/" + Prefix + "XXXXXX";
+    int Fd = mkstemp(&Name[0]);
+    if (Fd < 0) return std::string();
+    close(Fd);
+    return Name;
+}
+
+// Alters one recorded value of day 5 and checks that the comparison points
+// to exactly that day, stage and variable, and that it is accepted once the
+// record's tolerance for the variable covers it
+bool DetectsPerturbation(const std::string& RecordFile) {
+    const std::string Perturbed = TemporaryFile("golden_perturbed");
+    const std::string Loosened = TemporaryFile("golden_loosened");
+    if (Perturbed.empty() || Loosened.empty()) {
+        std::cerr << "no temporary file" << std::endl;
+        std::remove(Perturbed.c_str());
+        std::remove(Loosened.c_str());
+        return false;
+    }
+    std::ifstream fin(RecordFile);
+    std::ofstream fout(Perturbed);
+    std::string Line;
+    int32_t ExpectedStage = -1;
+    size_t ExpectedVar = 0;
+    bool InFirstCase = false, Done = false;
+
+    while (std::getline(fin, Line)) {
+        if (Line.rfind("case ", 0) == 0) InFirstCase = !Done;
+        std::istringstream Fields(Line);
+        int32_t Day, Stage;
+        size_t Var;
+        std::string Value;
+        if (InFirstCase && !Done && (Fields >> Day >> Stage >> Var >> Value) && Day == 5
+            && GoldenVariables()[Var].Name.rfind("theta", 0) == 0) {
+            char Altered[40];
+            std::snprintf(Altered, sizeof(Altered), "%a", std::strtod(Value.c_str(), nullptr) * (1.0 + 1.0e-6));
+            Line = std::to_string(Day) + " " + std::to_string(Stage) + " " + std::to_string(Var) + " " + Altered;
+            ExpectedStage = Stage;
+            ExpectedVar = Var;
+            Done = true;
+        }
+        fout << Line << '\n';
+    }
+    fout.close();
+    if (!Done) {
+        std::cerr << "no theta change on day 5 to perturb" << std::endl;
+        std::remove(Perturbed.c_str());
+        std::remove(Loosened.c_str());
+        return false;
+    }
+
+    rep_GoldenDivergence D;
+    int64_t NrCompared;
+    bool Ok = CompareGoldenStates(Perturbed, D, NrCompared) && D.Found && D.Day == 5
+              && static_cast<int32_t>(D.Stage) == ExpectedStage && D.Variable == GoldenVariables()[ExpectedVar].Name;
+    if (!Ok) {
+        std::cerr << "perturbation of " << GoldenVariables()[ExpectedVar].Name << " on day 5 after stage "
+                  << BudgetStageName(static_cast<BudgetStage>(ExpectedStage)) << " not located" << std::endl;
+        if (D.Found) Report(D);
+    }
+
+    // the tolerance of the record covers the perturbation: no divergence
+    {
+        std::ifstream Record(Perturbed);
+        std::ofstream Out(Loosened);
+        size_t LineNr = 0;
+        while (std::getline(Record, Line)) {
+            if (LineNr++ == 2 + ExpectedVar) Line = GoldenVariables()[ExpectedVar].Name + " 1 64";
+            Out << Line << '\n';
+        }
+    }
+    if (!CompareGoldenStates(Loosened, D, NrCompared) || D.Found) {
+        std::cerr << "tolerance of " << GoldenVariables()[ExpectedVar].Name << " in the record not used" << std::endl;
+        if (D.Found) Report(D);
+        Ok = false;
+    }
+    std::remove(Perturbed.c_str());
+    std::remove(Loosened.c_str());
+    return Ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--record") {
+        if (!RecordGoldenStates(Corpus(), argv[2])) return EXIT_FAILURE;
+        std::cout << "recorded " << Corpus().size() << " cases in " << argv[2] << std::endl;
+        return EXIT_SUCCESS;
+    }
+    if (argc != 2) {
+        std::cerr << "usage: test_golden [--record] <record file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    rep_GoldenDivergence D;
+    int64_t NrCompared;
+    if (!CompareGoldenStates(argv[1], D, NrCompared)) return EXIT_FAILURE;
+    if (D.Found) {
+        std::cerr << "golden state diverges after " << NrCompared << " matching stage states" << std::endl;
+        Report(D);
+        return EXIT_FAILURE;
+    }
+    std::cout << NrCompared << " stage states match the record" << std::endl;
+
+    if (!DetectsPerturbation(argv[1])) return EXIT_FAILURE;
+    std::cout << "perturbation located" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+// Checks the rules of generated irrigation: the AllDepl and AllRAW decisions
+// and the depth of Calculate_irrigation on a synthetic soil against the root
+// zone depletion worked out here, and the days of the FixInt rule in the runs
+// of a generated project. Run in the directory written by aquacrop_generate.
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/Scheduling.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/StageProfile.h"
+#include "AquaCrop/Synthetic.h"
+#include "AquaCrop/Utils.h"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void Check(const std::string& Name, dp Value, dp Expected) {
+    if (std::abs(Value - Expected) > 1E-9) {
+        std::cerr << Name << ": " << Value << " != " << Expected << std::endl;
+        ++Failures;
+    }
+}
+
+// Irrigation of Calculate_irrigation for the rule (TimeInfo, DepthInfo)
+dp Generated(GenerateTimeMode TimeMode, GenerateDepthMode DepthMode, int32_t TimeInfo, int32_t DepthInfo,
+             int32_t& TargetTimeVal) {
+    GenerateTimeMode_Val = TimeMode;
+    GenerateDepthMode_Val = DepthMode;
+    TargetTimeVal = TimeInfo;
+    dp SubDrain = 0.0;
+    Irrigation = 0.0;
+    Calculate_irrigation(SubDrain, TargetTimeVal, DepthInfo);
+    return Irrigation;
+}
+
+void CheckRule(const std::string& Name, GenerateTimeMode TimeMode, int32_t TimeInfo, bool Irrigates,
+               dp Depletion) {
+    int32_t TargetTimeVal;
+    dp Depth = Generated(TimeMode, GenerateDepthMode::FixDepth, TimeInfo, 25, TargetTimeVal);
+    Check(Name + " decision", TargetTimeVal, Irrigates ? 1 : 0);
+    Check(Name + " fixed depth", Depth, Irrigates ? 25.0 : 0.0);
+    Depth = Generated(TimeMode, GenerateDepthMode::ToFC, TimeInfo, 10, TargetTimeVal);
+    Check(Name + " to field capacity", Depth, Irrigates ? Depletion + 10.0 : 0.0);
+}
+
+// Decisions on the root zone of a synthetic season on its first day
+void CheckDepletionRules() {
+    int32_t DayNr1;
+    DetermineDayNr(1, 4, 2001, DayNr1);
+    SetupSyntheticSeason(7, DayNr1, 30);
+    RootingDepth = crop.RootMax;
+    bool SWCtopSoilConsidered = Simulation.SWCtopSoilConsidered;
+    DetermineRootZoneWC(RootingDepth, SWCtopSoilConsidered);
+    const dp FC = RootZoneWC.FC;
+    const dp WP = RootZoneWC.WP;
+    const dp Actual = RootZoneWC.Actual;
+
+    // the root zone ends the day with 40 % of the readily available water
+    // depleted
+    const dp RAW = crop.pActStom * (FC - WP);
+    Rain = 2.0;
+    Runoff = 0.5;
+    Tpot = 1.0;
+    Epot = 0.4 * RAW - (FC - Actual) + Rain - Runoff - Tpot;
+    IrriSeasonCap = undef_double;
+    const dp Depletion = FC - (Actual - Epot - Tpot + Rain - Runoff);
+    if (!(Depletion > 1.0 && RAW > Depletion)) {
+        std::cerr << "synthetic root zone: depletion " << Depletion << " mm, RAW " << RAW << " mm" << std::endl;
+        ++Failures;
+        return;
+    }
+
+    // AllDepl: TimeInfo in mm of depletion
+    const int32_t Depl = static_cast<int32_t>(std::floor(Depletion));
+    CheckRule("AllDepl below the depletion", GenerateTimeMode::AllDepl, Depl, true, Depletion);
+    CheckRule("AllDepl above the depletion", GenerateTimeMode::AllDepl, Depl + 1, false, Depletion);
+
+    // AllRAW: TimeInfo in % of RAW
+    const int32_t Percent = static_cast<int32_t>(std::floor(100.0 * Depletion / RAW));
+    CheckRule("AllRAW below the depletion", GenerateTimeMode::AllRAW, Percent, true, Depletion);
+    CheckRule("AllRAW above the depletion", GenerateTimeMode::AllRAW, Percent + 1, false, Depletion);
+
+    // FixInt is decided before (GetIrriParam): the target is taken as it is
+    CheckRule("FixInt on the day", GenerateTimeMode::FixInt, 1, true, Depletion);
+    CheckRule("FixInt between", GenerateTimeMode::FixInt, 0, false, Depletion);
+
+    // season cap: what the run has not yet received
+    int32_t TargetTimeVal;
+    IrriSeasonCap = SumWaBal.Irrigation + 4.0;
+    Check("capped depth", Generated(GenerateTimeMode::AllDepl, GenerateDepthMode::FixDepth, Depl, 25,
+                                    TargetTimeVal), 4.0);
+    IrriSeasonCap = SumWaBal.Irrigation;
+    Check("exhausted cap", Generated(GenerateTimeMode::AllDepl, GenerateDepthMode::FixDepth, Depl, 25,
+                                     TargetTimeVal), 0.0);
+    IrriSeasonCap = undef_double;
+}
+
+std::vector<int32_t> IrrigationDays;
+std::vector<dp> IrrigationDepths;
+
+void RecordIrrigation(int32_t DayNr, BudgetStage Stage) {
+    if (Stage == BudgetStage::Infiltration && Irrigation > 0.0) {
+        IrrigationDays.push_back(DayNr);
+        IrrigationDepths.push_back(Irrigation);
+    }
+}
+
+// FixInt: the first irrigation Interval - 1 days after the rule starts on
+// the day of sowing, then every Interval days to the end of the crop cycle
+void CheckFixedInterval(const std::string& Project) {
+    const int32_t Interval = 6;
+    rep_IrriStrategy Strategy;
+    Strategy.TimeMode = GenerateTimeMode::FixInt;
+    Strategy.DepthMode = GenerateDepthMode::FixDepth;
+    Strategy.Stages = {{Interval, 25}};
+    SetIrrigationStrategy(&Strategy);
+    IrrigationDays.clear();
+    IrrigationDepths.clear();
+    StageObserver = RecordIrrigation;
+    std::vector<rep_RunResult> Runs = SimulateProject(Project, typeproject::typeprm, {}, {}, 1);
+    StageObserver = nullptr;
+    SetIrrigationStrategy(nullptr);
+    if (Runs.size() != 1) {
+        std::cerr << Project << ": not simulated" << std::endl;
+        ++Failures;
+        return;
+    }
+
+    std::vector<int32_t> Expected;
+    const int32_t LastDayNr = std::min(crop.DayN, Runs[0].ToDayNr);
+    for (int32_t DayNr = crop.Day1 + Interval - 1; DayNr <= LastDayNr; DayNr += Interval) {
+        Expected.push_back(DayNr);
+    }
+    if (Expected.empty()) {
+        std::cerr << Project << ": no FixInt irrigation in the crop cycle" << std::endl;
+        ++Failures;
+    }
+    Check(Project + " FixInt irrigations", static_cast<dp>(IrrigationDays.size()), static_cast<dp>(Expected.size()));
+    for (size_t i = 0; i < IrrigationDays.size() && i < Expected.size(); ++i) {
+        Check(Project + " FixInt day", IrrigationDays[i], Expected[i]);
+        Check(Project + " FixInt depth", IrrigationDepths[i], 25.0);
+    }
+}
+
+} // namespace
+
+int main() {
+    CheckDepletionRules();
+
+    std::ifstream List("PARAM/ListProjects.txt");
+    int32_t NrProjects = 0;
+    for (std::string Line; std::getline(List, Line);) {
+        if (Line.empty()) continue;
+        CheckFixedInterval(Line);
+        ++NrProjects;
+    }
+    if (NrProjects == 0) {
+        std::cerr << "no generated projects in PARAM/ListProjects.txt" << std::endl;
+        ++Failures;
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "AllDepl, AllRAW and FixInt irrigation on the days and depths of the rules" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+// Checks the fertility and salinity reference relationships: the fitted
+// quadratics follow the simulated stress levels, repeated calls are served
+// from the cache with the same bits (also from other threads and from the
+// on-disk cache), a fit on a pool worker gives the same bits, and a change of
+// an input is fitted anew.
+#include "AquaCrop/PrepareFertilitySalinity.h"
+#include "AquaCrop/Synthetic.h"
+#include "AquaCrop/ThreadPool.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_Relationships {
+    dp b0, b1, b2;
+    std::array<dp, 7> X;
+    dp b0Salt, b1Salt, b2Salt;
+    std::array<dp, 9> XSalt;
+};
+
+bool SameBits(dp a, dp b) {
+    return std::memcmp(&a, &b, sizeof(dp)) == 0;
+}
+
+bool SameBits(const rep_Relationships& a, const rep_Relationships& b) {
+    bool Same = SameBits(a.b0, b.b0) && SameBits(a.b1, b.b1) && SameBits(a.b2, b.b2)
+             && SameBits(a.b0Salt, b.b0Salt) && SameBits(a.b1Salt, b.b1Salt) && SameBits(a.b2Salt, b.b2Salt);
+    for (size_t i = 0; i < a.X.size(); ++i) Same = Same && SameBits(a.X[i], b.X[i]);
+    for (size_t i = 0; i < a.XSalt.size(); ++i) Same = Same && SameBits(a.XSalt[i], b.XSalt[i]);
+    return Same;
+}
+
+// A calendar-day grain crop; the thread's simulparam gives the GDD method
+rep_Relationships Relationships(dp CCx, int8_t CCsaltDistortion) {
+    SetDefaultSimulParam();
+    rep_Shapes StressResponse{50, 2.16, 0.79, 1.67, 1.0, true};
+    rep_Relationships R;
+    std::array<dp, 7>& X = R.X;
+    std::array<dp, 9>& XS = R.XSalt;
+    ReferenceStressBiomassRelationship(1, 14, 6, 74, 107, 126, 66, 13, 80, 1100, 1600, 1900,
+        100, 48, 0.05, CCx, 0.11, 0.008, 0.08, 0.006, 1.1, 0.3, 50.0, 8.0, 30.0, 12.0, 28.0, 11.1,
+        33.7, 1.2, 121, false, StressResponse, subkind::Grain, modeCycle::CalendarDays,
+        R.b0, R.b1, R.b2, X[0], X[1], X[2], X[3], X[4], X[5], X[6], 900, 180, 1700, plant::seed, 108);
+    ReferenceCCxSaltStressRelationship(1, 14, 6, 74, 107, 126, 66, 13, 900, 180, 80, 1100, 1600, 1900,
+        100, 48, 0.05, CCx, 0.11, 0.008, 0.08, 0.006, 1.1, 0.3, 50.0, 8.0, 30.0, 12.0, 28.0, 11.1,
+        33.7, 1.2, 121, false, subkind::Grain, modeCycle::CalendarDays, CCsaltDistortion,
+        R.b0Salt, R.b1Salt, R.b2Salt, XS[0], XS[1], XS[2], XS[3], XS[4], XS[5], XS[6], XS[7], XS[8],
+        1700, plant::seed, 108);
+    return R;
+}
+
+int32_t CheckFit(const char* Name, dp b0, dp b1, dp b2, const dp* X, int32_t NrX, bool XIsStress) {
+    int32_t Failures = 0;
+    dp Previous = 100.0;
+    for (int32_t i = 0; i < NrX; ++i) {
+        if (!(X[i] < Previous && X[i] > 0.0)) {
+            std::cerr << Name << ": relative biomass " << X[i] << " at level " << 10 * (i + 1)
+                      << " not below " << Previous << std::endl;
+            ++Failures;
+        }
+        Previous = X[i];
+        dp x = XIsStress ? 100.0 - X[i] : X[i];
+        dp Level = b0 + b1 * x + b2 * x * x;
+        if (std::abs(Level - 10.0 * (i + 1)) > 5.0) {
+            std::cerr << Name << ": fit gives " << Level << " at level " << 10 * (i + 1) << std::endl;
+            ++Failures;
+        }
+    }
+    return Failures;
+}
+
+} // namespace
+
+int main() {
+    int32_t Failures = 0;
+
+    int64_t Fits0 = NrReferenceRelationshipFits();
+    rep_Relationships R = Relationships(0.9, 25);
+    if (NrReferenceRelationshipFits() != Fits0 + 2) {
+        std::cerr << "first call did not fit both relationships" << std::endl;
+        ++Failures;
+    }
+    Failures += CheckFit("fertility", R.b0, R.b1, R.b2, R.X.data(), 7, false);
+    Failures += CheckFit("salinity", R.b0Salt, R.b1Salt, R.b2Salt, R.XSalt.data(), 9, true);
+
+    // in-process cache, on this and on other threads
+    if (!SameBits(Relationships(0.9, 25), R) || NrReferenceRelationshipFits() != Fits0 + 2) {
+        std::cerr << "repeated call not served from the cache" << std::endl;
+        ++Failures;
+    }
+    std::vector<rep_Relationships> Threaded(4);
+    std::vector<std::thread> Threads;
+    for (size_t i = 0; i < Threaded.size(); ++i) {
+        Threads.emplace_back([&Threaded, i] {
+            InitializeThreadState();
+            Threaded[i] = Relationships(0.9, 25);
+        });
+    }
+    for (std::thread& t : Threads) t.join();
+    for (const rep_Relationships& T : Threaded) {
+        if (!SameBits(T, R)) {
+            std::cerr << "other thread got other relationships" << std::endl;
+            ++Failures;
+        }
+    }
+
+    // a changed input: the salinity relationship is fitted anew, the
+    // fertility one does not read it
+    rep_Relationships Distorted = Relationships(0.9, 75);
+    if (NrReferenceRelationshipFits() != Fits0 + 3 || SameBits(Distorted.b1Salt, R.b1Salt)) {
+        std::cerr << "change of CCsaltDistortion not fitted anew" << std::endl;
+        ++Failures;
+    }
+
+    // fitted on a worker of a pool, which simulates the levels itself
+    ClearReferenceRelationshipCache();
+    int64_t FitsWorker = NrReferenceRelationshipFits();
+    rep_Relationships OnWorker;
+    ThreadPool Pool(2);
+    Pool.ParallelFor(1, [&](int32_t) { OnWorker = Relationships(0.9, 25); });
+    if (!SameBits(OnWorker, R) || NrReferenceRelationshipFits() != FitsWorker + 2) {
+        std::cerr << "fit on a pool worker differs" << std::endl;
+        ++Failures;
+    }
+
+    // on-disk cache
+    char Dir[] = "/tmp/aquacrop_refcacheXXXXXX";
+    if (mkdtemp(Dir) == nullptr) {
+        std::cerr << "no temporary directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+    setenv("AQUACROP_REFERENCE_CACHE", Dir, 1);
+    ClearReferenceRelationshipCache();
+    int64_t Fits1 = NrReferenceRelationshipFits();
+    rep_Relationships Written = Relationships(0.9, 25);
+    ClearReferenceRelationshipCache();
+    rep_Relationships Read = Relationships(0.9, 25);
+    if (NrReferenceRelationshipFits() != Fits1 + 2 || !SameBits(Written, R) || !SameBits(Read, R)) {
+        std::cerr << "on-disk cache did not return the fitted relationships" << std::endl;
+        ++Failures;
+    }
+    std::string Command = std::string("rm -rf ") + Dir;
+    if (std::system(Command.c_str()) != 0) std::cerr << "could not remove " << Dir << std::endl;
+
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "reference relationships fitted and cached" << std::endl;
+    return EXIT_SUCCESS;
+}
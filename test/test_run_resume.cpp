@@ -0,0 +1,143 @@
+// Simulates every run of a generated project straight through and in two
+// segments: stopped at a day of the season (SetRunStop, TakeRunState) and
+// continued from the kept state (SetRunResume). The watched state after
+// every Budget_module stage and the run results must have the same bits.
+// Run in the directory written by aquacrop_generate --observations.
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/GoldenState.h"
+#include "AquaCrop/Run.h"
+#include "AquaCrop/Scheduling.h"
+#include "AquaCrop/StageProfile.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+std::vector<std::vector<dp>> StageStates;
+
+void RecordStage(int32_t DayNr, BudgetStage Stage) {
+    StageStates.emplace_back();
+    CaptureGoldenState(StageStates.back());
+    StageStates.back().push_back(static_cast<dp>(DayNr));
+    StageStates.back().push_back(static_cast<dp>(Stage));
+}
+
+bool SameBits(const std::vector<dp>& a, const std::vector<dp>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(dp)) == 0;
+}
+
+bool SameBits(const rep_RunResult& a, const rep_RunResult& b) {
+    if (a.NrRun != b.NrRun || a.FromDayNr != b.FromDayNr || a.ToDayNr != b.ToDayNr
+        || std::memcmp(&a.Sums, &b.Sums, sizeof(rep_sum)) != 0) return false;
+    for (int32_t k = 1; k <= NrObsSim; ++k) {
+        const rep_FitStats& x = a.Fit[k-1];
+        const rep_FitStats& y = b.Fit[k-1];
+        const dp X[] = {x.RMSE, x.NRMSE, x.d, x.EF, x.Bias};
+        const dp Y[] = {y.RMSE, y.NRMSE, y.d, y.EF, y.Bias};
+        if (x.N != y.N || std::memcmp(X, Y, sizeof(X)) != 0) return false;
+    }
+    return true;
+}
+
+// Stage states and result of run Runi, stopped at the start of StopDayNr
+// (undef_int: straight through) or continued from Resume
+std::vector<rep_RunResult> Simulate(const std::string& Project, int32_t Runi, int32_t StopDayNr,
+                                    std::shared_ptr<const rep_RunState> Resume) {
+    StageStates.clear();
+    SetRunStop(StopDayNr);
+    SetRunResume(std::move(Resume));
+    StageObserver = RecordStage;
+    std::vector<rep_RunResult> Runs = SimulateProject(Project, typeproject::typeprm, {}, {}, Runi);
+    StageObserver = nullptr;
+    return Runs;
+}
+
+int32_t CheckRun(const std::string& Project, int32_t Runi) {
+    int32_t Failures = 0;
+    std::vector<rep_RunResult> Straight = Simulate(Project, Runi, undef_int, nullptr);
+    const std::vector<std::vector<dp>> StraightStates = StageStates;
+    if (Straight.size() != 1 || StraightStates.empty()) {
+        std::cerr << Project << " run " << Runi << ": not simulated" << std::endl;
+        return 1;
+    }
+    const int32_t FromDayNr = Straight[0].FromDayNr;
+    const int32_t NrDays = Straight[0].ToDayNr - FromDayNr + 1;
+    for (int32_t Part : {1, 2, 3}) {
+        const int32_t StopDayNr = FromDayNr + Part * NrDays / 4;
+        std::vector<rep_RunResult> First = Simulate(Project, Runi, StopDayNr, nullptr);
+        std::vector<std::vector<dp>> States = StageStates;
+        std::shared_ptr<const rep_RunState> State = TakeRunState();
+        if (!First.empty() || State == nullptr || RunStateDayNr(*State) != StopDayNr) {
+            std::cerr << Project << " run " << Runi << ": did not stop at day " << StopDayNr << std::endl;
+            ++Failures;
+            continue;
+        }
+        std::vector<rep_RunResult> Second = Simulate(Project, Runi, undef_int, State);
+        States.insert(States.end(), StageStates.begin(), StageStates.end());
+        if (TakeRunState() != nullptr || Second.size() != 1 || !SameBits(Second[0], Straight[0])) {
+            std::cerr << Project << " run " << Runi << " resumed at day " << StopDayNr
+                      << ": result differs from the straight run" << std::endl;
+            ++Failures;
+        }
+        bool Same = (States.size() == StraightStates.size());
+        for (size_t i = 0; Same && i < States.size(); ++i) {
+            if (!SameBits(States[i], StraightStates[i])) {
+                std::cerr << Project << " run " << Runi << " resumed at day " << StopDayNr
+                          << ": state differs on day " << StraightStates[i][StraightStates[i].size() - 2]
+                          << " after stage "
+                          << BudgetStageName(static_cast<BudgetStage>(StraightStates[i].back())) << std::endl;
+                Same = false;
+            }
+        }
+        if (!Same) ++Failures;
+    }
+    return Failures;
+}
+
+} // namespace
+
+int main() {
+    std::ifstream List("PARAM/ListProjects.txt");
+    std::vector<std::string> Projects;
+    for (std::string Line; std::getline(List, Line);) {
+        if (!Line.empty()) Projects.push_back(Line);
+    }
+    if (Projects.empty()) {
+        std::cerr << "no generated projects in PARAM/ListProjects.txt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the irrigation of the project, then generated irrigation, which keeps
+    // its interval and rule across the stop
+    rep_IrriStrategy FixedInterval;
+    FixedInterval.TimeMode = GenerateTimeMode::FixInt;
+    FixedInterval.DepthMode = GenerateDepthMode::FixDepth;
+    FixedInterval.Stages = {{5, 20}, {8, 30}};
+    int32_t Failures = 0;
+    int32_t NrRuns = 0;
+    for (const rep_IrriStrategy* Strategy : std::vector<const rep_IrriStrategy*>{nullptr, &FixedInterval}) {
+        SetIrrigationStrategy(Strategy);
+        for (const std::string& Project : Projects) {
+            const int32_t NrProjectRuns = static_cast<int32_t>(SimulateProject(Project, typeproject::typeprm, {}, {}).size());
+            for (int32_t Runi = 1; Runi <= NrProjectRuns; ++Runi) {
+                Failures += CheckRun(Project, Runi);
+                ++NrRuns;
+            }
+        }
+        SetIrrigationStrategy(nullptr);
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << NrRuns << " runs resumed at three days with the state of the straight run" << std::endl;
+    return EXIT_SUCCESS;
+}
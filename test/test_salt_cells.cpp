@@ -0,0 +1,101 @@
+// Checks that the salt cell kernels return exactly the bits of
+// SaltSolutionDeposit cell by cell and of the scalar Mixing chain for every
+// available instruction set.
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simd.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace AquaCrop;
+
+namespace {
+
+uint64_t Bits(dp x) {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+// small deterministic generator (xorshift)
+uint32_t NextRandom(uint32_t& State) {
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    return State;
+}
+
+int32_t Failures = 0;
+
+void CheckRow(const char* Name, SimdLevel Level, int32_t Row, const CompartmentSaltIndividual& Cells,
+              const CompartmentSaltIndividual& Expected) {
+    for (int32_t i = 0; i < SaltCellStride; ++i) {
+        if (Bits(Cells.Salt[i]) != Bits(Expected.Salt[i]) || Bits(Cells.Depo[i]) != Bits(Expected.Depo[i])) {
+            if (Failures < 10) {
+                std::cerr << SimdLevelName(Level) << " " << Name << " row " << Row << " cell " << i << ": "
+                          << Cells.Salt[i] << "/" << Cells.Depo[i] << " != "
+                          << Expected.Salt[i] << "/" << Expected.Depo[i] << std::endl;
+            }
+            ++Failures;
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    const int32_t NrRows = 500;
+    const SimdLevel Levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+    simulparam.SaltSolub = 5;
+
+    for (SimdLevel Level : Levels) {
+        if (!SimdLevelAvailable(Level)) {
+            std::cout << SimdLevelName(Level) << ": not available, skipped" << std::endl;
+            continue;
+        }
+        uint32_t State = 2463534242u;
+        for (int32_t Row = 0; Row < NrRows; ++Row) {
+            // rows of every length, with salt below and above the solubility
+            const int32_t NrCells = 1 + Row % max_SaltCells;
+            const dp mm = 10.0 + static_cast<dp>(NextRandom(State) % 2000) / 10.0;
+            CompartmentSaltIndividual Cells;
+            for (int32_t i = 0; i < NrCells; ++i) {
+                Cells.Salt[i] = static_cast<dp>(NextRandom(State) % 20000) / 10.0;
+                Cells.Depo[i] = (NextRandom(State) % 3 == 0) ? static_cast<dp>(NextRandom(State) % 5000) / 10.0 : 0.0;
+            }
+            if (Row == 7) {
+                Cells.Salt[0] = std::numeric_limits<dp>::quiet_NaN();
+                Cells.Salt[1] = static_cast<dp>(simulparam.SaltSolub) * mm;
+                Cells.Depo[1] = -0.0;
+            }
+
+            CompartmentSaltIndividual Expected = Cells;
+            for (int32_t i = 0; i < NrCells; ++i) SaltSolutionDeposit(mm, Expected.Salt[i], Expected.Depo[i]);
+            CompartmentSaltIndividual Deposited = Cells;
+            SaltSolutionDepositCellsAt(Level, mm, Deposited.Salt.data(), Deposited.Depo.data(), NrCells);
+            CheckRow("deposit", Level, Row, Deposited, Expected);
+
+            if (NrCells < 2) continue;
+            dp Dif[max_SaltCells], mm2[max_SaltCells];
+            for (int32_t i = 0; i < NrCells - 1; ++i) {
+                Dif[i] = static_cast<dp>(NextRandom(State) % 101) / 100.0;
+                mm2[i] = (NextRandom(State) % 2 == 0) ? mm : mm * static_cast<dp>(NextRandom(State) % 100) / 100.0 + 0.5;
+            }
+            Expected = Cells;
+            MixSaltCellsAt(SimdLevel::Scalar, NrCells - 1, Dif, mm, mm2, Expected.Salt.data(), Expected.Depo.data());
+            CompartmentSaltIndividual Mixed = Cells;
+            MixSaltCellsAt(Level, NrCells - 1, Dif, mm, mm2, Mixed.Salt.data(), Mixed.Depo.data());
+            CheckRow("mixing", Level, Row, Mixed, Expected);
+        }
+        std::cout << SimdLevelName(Level) << ": checked" << std::endl;
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "salt cell kernels bit-identical" << std::endl;
+    return EXIT_SUCCESS;
+}
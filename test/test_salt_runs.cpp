@@ -0,0 +1,96 @@
+// Runs a project whose first run is salt-free and whose second run irrigates
+// with saline water on the profile of the first (soil file "(None)"). The
+// second run must find the salt cells of every compartment, and only it
+// fits the salinity reference relationship. Run in the directory written by
+// aquacrop_generate --fields 1 --years 2; configure with
+// -DAQUACROP_SANITIZE=ON to have every access to the cells checked.
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/PrepareFertilitySalinity.h"
+#include "AquaCrop/Simul.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+// Replaces file and directory of the Occurrence-th section Header of a PRM
+bool SetSection(std::string& Project, const std::string& Header, int32_t Occurrence, const std::string& File,
+                const std::string& Dir) {
+    size_t Pos = std::string::npos;
+    for (int32_t i = 1; i <= Occurrence; ++i) {
+        Pos = Project.find(Header + "\n", (Pos == std::string::npos) ? 0 : Pos + 1);
+        if (Pos == std::string::npos) return false;
+    }
+    size_t Begin = Pos + Header.size() + 1;
+    size_t End = Project.find('\n', Project.find('\n', Begin) + 1);
+    if (End == std::string::npos) return false;
+    Project.replace(Begin, End - Begin, "   " + File + "\n   " + Dir);
+    return true;
+}
+
+bool WriteFile(const std::string& Name, const std::string& Content) {
+    std::ofstream out(Name);
+    out << Content;
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main() {
+    std::ifstream In("PARAM/shard_0000/field_0000000.PRM");
+    std::stringstream Buffer;
+    Buffer << In.rdbuf();
+    std::string Project = Buffer.str();
+    bool Ok = SetSection(Project, "-- 4. Irrigation management (IRR) file", 2, "saline.IRR", "DATA/")
+           && SetSection(Project, "-- 6. Soil profile (SOL) file", 2, "(None)", "(None)")
+           && WriteFile("PARAM/salt_runs.PRM", Project)
+           && WriteFile("DATA/saline.IRR",
+                        "Weekly irrigation of 30 mm with water of 3 dS/m\n7.1\n1\n100\n2\n1\n2\n\n"
+                        "   From day    Interval    Depth (mm)   ECw (dS/m)\n"
+                        " ================================================\n"
+                        "     1           7           30          3.0\n");
+    if (!Ok) {
+        std::cerr << "cannot derive the two-run project from the generated field" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int32_t Failures = 0;
+    ClearReferenceRelationshipCache();
+    int64_t Fits = NrReferenceRelationshipFits();
+    SimulateProject("salt_runs.PRM", typeproject::typeprm, {}, {}, 1);
+    const int64_t SaltFreeFits = NrReferenceRelationshipFits() - Fits;
+    if (CurrentBudgetConfig().Salinity) {
+        std::cerr << "first run is not salt-free" << std::endl;
+        ++Failures;
+    }
+    // the fertility relationship of the crop, and the salinity one
+    // for the saline run only
+    ClearReferenceRelationshipCache();
+    Fits = NrReferenceRelationshipFits();
+    std::vector<rep_RunResult> Runs = SimulateProject("salt_runs.PRM", typeproject::typeprm, {}, {});
+    if (NrReferenceRelationshipFits() - Fits != SaltFreeFits + 1) {
+        std::cerr << "salinity relationship fitted " << NrReferenceRelationshipFits() - Fits - SaltFreeFits
+                  << " times for one saline run" << std::endl;
+        ++Failures;
+    }
+    if (Runs.size() != 2 || !CurrentBudgetConfig().Salinity) {
+        std::cerr << "second run did not simulate salt" << std::endl;
+        ++Failures;
+    }
+    if (CompartmentSalt.size() != static_cast<size_t>(max_No_compartments)) {
+        std::cerr << "salt cells of " << CompartmentSalt.size() << " compartments after the saline run" << std::endl;
+        ++Failures;
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "saline run after a salt-free run has its salt cells" << std::endl;
+    return EXIT_SUCCESS;
+}
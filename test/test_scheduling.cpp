@@ -0,0 +1,69 @@
+// Checks the growth stages of a generated schedule and the Pareto front of
+// irrigation against the seasonal output.
+#include "AquaCrop/Scheduling.h"
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void Check(const char* Name, int32_t Value, int32_t Expected) {
+    if (Value != Expected) {
+        std::cerr << Name << ": " << Value << " != " << Expected << std::endl;
+        ++Failures;
+    }
+}
+
+void CheckFront(const char* Name, const std::vector<int32_t>& Front, const std::vector<int32_t>& Expected) {
+    Check(Name, static_cast<int32_t>(Front.size()), static_cast<int32_t>(Expected.size()));
+    for (size_t i = 0; i < Front.size() && i < Expected.size(); ++i) Check(Name, Front[i], Expected[i]);
+}
+
+} // namespace
+
+int main() {
+    crop.DaysToGermination = 10;
+    crop.DaysToFullCanopy = 50;
+    crop.DaysToSenescence = 90;
+    std::vector<int32_t> Starts = IrriStageStartDays(NrIrriStages);
+    Check("stages", static_cast<int32_t>(Starts.size()), NrIrriStages);
+    Check("initial", Starts[0], 1);
+    Check("development", Starts[1], 11);
+    Check("mid-season", Starts[2], 51);
+    Check("late", Starts[3], 91);
+    Check("one stage", static_cast<int32_t>(IrriStageStartDays(1).size()), 1);
+
+    // stages that would start together follow each other by a day
+    crop.DaysToGermination = 0;
+    crop.DaysToFullCanopy = 0;
+    Starts = IrriStageStartDays(NrIrriStages);
+    Check("empty initial", Starts[1], 2);
+    Check("empty development", Starts[2], 3);
+
+    // irrigation, output
+    const dp NaN = std::numeric_limits<dp>::quiet_NaN();
+    std::vector<rep_IrriCandidate> Candidates = {
+        {{}, 100.0, 5.0, 0.0},   // 0: dominated by 3
+        {{}, 0.0, 2.0, 0.0},     // 1: front
+        {{}, 200.0, 8.0, 0.0},   // 2: front
+        {{}, 80.0, 6.0, 0.0},    // 3: front
+        {{}, 80.0, 4.0, 0.0},    // 4: same irrigation as 3, lower output
+        {{}, 300.0, 8.0, 0.0},   // 5: no gain for more water
+        {{}, 50.0, NaN, 0.0},    // 6: no output
+    };
+    CheckFront("yield front", IrrigationParetoFront(Candidates, true), {1, 3, 2});
+    // lower is better: only the candidate without irrigation
+    CheckFront("fit front", IrrigationParetoFront(Candidates, false), {1});
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "irrigation stages and front match" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// Checks the streaming Morris and Sobol estimators on functions with known
+// indices.
+#include "AquaCrop/Sensitivity.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void Check(const char* Name, dp Value, dp Expected, dp Tolerance) {
+    if (!(std::abs(Value - Expected) <= Tolerance)) {
+        std::cerr << Name << ": " << Value << " != " << Expected << std::endl;
+        ++Failures;
+    }
+}
+
+BatchObjective Batch(dp (*Function)(const std::vector<dp>&)) {
+    return [Function](const std::vector<std::vector<dp>>& Points, std::vector<dp>& Values) {
+        for (size_t k = 0; k < Points.size(); ++k) Values[k] = Function(Points[k]);
+    };
+}
+
+// linear: every elementary effect equals the coefficient
+dp Linear(const std::vector<dp>& X) {
+    return 1000.0 + 3.0 * X[0] - 2.0 * X[1] + 0.0 * X[2];
+}
+
+// the same spread of effects on x1 with and without a large mean effect
+dp Interaction(const std::vector<dp>& X) {
+    return X[0] * X[1];
+}
+
+dp SteepInteraction(const std::vector<dp>& X) {
+    return 1.0e9 * X[0] + X[0] * X[1];
+}
+
+// Ishigami on [-pi, pi]^3 (a = 7, b = 0.1)
+dp Ishigami(const std::vector<dp>& U) {
+    dp x1 = PI * (2.0 * U[0] - 1.0), x2 = PI * (2.0 * U[1] - 1.0), x3 = PI * (2.0 * U[2] - 1.0);
+    return std::sin(x1) + 7.0 * std::sin(x2) * std::sin(x2) + 0.1 * std::pow(x3, 4) * std::sin(x1);
+}
+
+} // namespace
+
+int main() {
+    rep_SensSettings Settings;
+    rep_SensResult Result;
+
+    Settings.Method = SensMethod::Morris;
+    Settings.NrSamples = 50;
+    Settings.BatchRows = 7;
+    AnalyzeSensitivity(3, Batch(Linear), Settings, Result);
+    if (Result.NrEvaluations != 50 * 4) {
+        std::cerr << "Morris evaluations: " << Result.NrEvaluations << std::endl;
+        ++Failures;
+    }
+    Check("Morris mu x1", Result.Morris[0].Mu, 3.0, 1.0e-9);
+    Check("Morris mu* x2", Result.Morris[1].MuStar, 2.0, 1.0e-9);
+    Check("Morris sigma x2", Result.Morris[1].Sigma, 0.0, 1.0e-6);
+    Check("Morris mu* x3", Result.Morris[2].MuStar, 0.0, 1.0e-9);
+
+    // sigma must not drown in cancellation next to a large mu
+    Settings.NrSamples = 1000;
+    AnalyzeSensitivity(2, Batch(Interaction), Settings, Result);
+    const dp SigmaInteraction = Result.Morris[0].Sigma;
+    AnalyzeSensitivity(2, Batch(SteepInteraction), Settings, Result);
+    Check("Morris sigma steep x1", Result.Morris[0].Sigma, SigmaInteraction, 1.0e-4);
+
+    // analytic indices: S1 = (0.3139, 0.4424, 0), ST = (0.5576, 0.4424, 0.2437)
+    Settings.Method = SensMethod::Sobol;
+    Settings.NrSamples = 20000;
+    Settings.BatchRows = 256;
+    AnalyzeSensitivity(3, Batch(Ishigami), Settings, Result);
+    Check("Sobol variance", Result.Variance, 13.8446, 0.5);
+    Check("Sobol S1 x1", Result.Sobol[0].S1, 0.3139, 0.04);
+    Check("Sobol S1 x2", Result.Sobol[1].S1, 0.4424, 0.04);
+    Check("Sobol S1 x3", Result.Sobol[2].S1, 0.0, 0.04);
+    Check("Sobol ST x1", Result.Sobol[0].ST, 0.5576, 0.04);
+    Check("Sobol ST x2", Result.Sobol[1].ST, 0.4424, 0.04);
+    Check("Sobol ST x3", Result.Sobol[2].ST, 0.2437, 0.04);
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "sensitivity indices match" << std::endl;
+    return EXIT_SUCCESS;
+}
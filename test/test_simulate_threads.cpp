@@ -0,0 +1,123 @@
+// Simulates the projects of a generated workload on one worker and on
+// several: the results must have the same bits as those of a fresh worker
+// per project, whatever the worker ran before. Run in the directory written
+// by aquacrop_generate --observations.
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/ThreadPool.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_Task {
+    std::string ProjectFile;
+    dp CCx;   // NaN: file value
+};
+
+bool SameBits(dp a, dp b) {
+    return std::memcmp(&a, &b, sizeof(dp)) == 0;
+}
+
+bool SameBits(const rep_FitStats& a, const rep_FitStats& b) {
+    return a.N == b.N && SameBits(a.RMSE, b.RMSE) && SameBits(a.NRMSE, b.NRMSE) && SameBits(a.d, b.d)
+        && SameBits(a.EF, b.EF) && SameBits(a.Bias, b.Bias);
+}
+
+bool SameBits(const rep_sum& a, const rep_sum& b) {
+    const dp* x = &a.Epot;
+    const dp* y = &b.Epot;
+    for (size_t i = 0; i < sizeof(rep_sum) / sizeof(dp); ++i) {
+        if (!SameBits(x[i], y[i])) return false;
+    }
+    return true;
+}
+
+bool SameBits(const std::vector<rep_RunResult>& a, const std::vector<rep_RunResult>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t r = 0; r < a.size(); ++r) {
+        if (a[r].NrRun != b[r].NrRun || a[r].FromDayNr != b[r].FromDayNr || a[r].ToDayNr != b[r].ToDayNr
+            || !SameBits(a[r].Sums, b[r].Sums)) return false;
+        for (int32_t k = 1; k <= NrObsSim; ++k) {
+            if (!SameBits(a[r].Fit[k-1], b[r].Fit[k-1])) return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::vector<rep_RunResult>> SimulateTasks(const std::vector<rep_Task>& Tasks,
+                                                      const std::vector<rep_CalibParameter>& Parameters,
+                                                      int32_t NrThreads) {
+    std::vector<std::vector<rep_RunResult>> Results(Tasks.size());
+    ThreadPool Pool(NrThreads);
+    Pool.ParallelFor(static_cast<int32_t>(Tasks.size()), [&](int32_t Item) {
+        const rep_Task& Task = Tasks[Item];
+        Results[Item] = SimulateProject(Task.ProjectFile, typeproject::typeprm, Parameters, {Task.CCx});
+    });
+    return Results;
+}
+
+} // namespace
+
+int main() {
+    std::ifstream List("PARAM/ListProjects.txt");
+    std::vector<std::string> Projects;
+    for (std::string Line; std::getline(List, Line);) {
+        if (!Line.empty()) Projects.push_back(Line);
+    }
+    if (Projects.size() < 2) {
+        std::cerr << "no generated projects in PARAM/ListProjects.txt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // every project with its file CCx and with a lower one, so that a worker
+    // goes from project to project and from overridden runs to plain ones
+    rep_CalibParameter CCx;
+    if (!ParseCalibParameter("crop.CCx:0.5:0.99", CCx)) return EXIT_FAILURE;
+    std::vector<rep_Task> Tasks;
+    for (const std::string& Project : Projects) {
+        Tasks.push_back({Project, 0.6});
+        Tasks.push_back({Project, std::numeric_limits<dp>::quiet_NaN()});
+    }
+
+    std::vector<std::vector<rep_RunResult>> Fresh(Tasks.size());
+    for (size_t i = 0; i < Tasks.size(); ++i) {
+        Fresh[i] = SimulateTasks({Tasks[i]}, {CCx}, 1)[0];
+    }
+    int32_t Failures = 0;
+    for (size_t i = 0; i < Tasks.size(); ++i) {
+        const int32_t CC = static_cast<int32_t>(typeObsSim::ObsSimCC);
+        if (Fresh[i].empty() || Fresh[i][0].Fit[CC].N == 0 || Fresh[i][0].Fit[CC].RMSE <= 0.0) {
+            std::cerr << Tasks[i].ProjectFile << ": no canopy cover evaluated" << std::endl;
+            ++Failures;
+        }
+    }
+    if (SameBits(Fresh[0], Fresh[1])) {
+        std::cerr << Tasks[0].ProjectFile << ": CCx override has no effect" << std::endl;
+        ++Failures;
+    }
+    for (int32_t NrThreads : {1, 4}) {
+        std::vector<std::vector<rep_RunResult>> Shared = SimulateTasks(Tasks, {CCx}, NrThreads);
+        for (size_t i = 0; i < Tasks.size(); ++i) {
+            if (!SameBits(Shared[i], Fresh[i])) {
+                std::cerr << Tasks[i].ProjectFile << " (CCx " << Tasks[i].CCx << ") on " << NrThreads
+                          << " threads differs from a fresh worker" << std::endl;
+                ++Failures;
+            }
+        }
+    }
+
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << Tasks.size() << " simulations identical on fresh workers and on 1 and 4 threads" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+// Checks the loading of a soil profile: the header values of a SOL file that
+// carry a description, the layer of every compartment, the initial water at
+// field capacity and the completion of the profile, by hand for a written
+// file and for the profile of a generated run. Run in the directory written
+// by aquacrop_generate.
+#include "AquaCrop/Calibration.h"
+#include "AquaCrop/Global.h"
+#include "AquaCrop/InitialSettings.h"
+#include "AquaCrop/StartUnit.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void Check(const std::string& Name, dp Value, dp Expected) {
+    if (std::abs(Value - Expected) > 1E-9) {
+        std::cerr << Name << ": " << Value << " != " << Expected << std::endl;
+        ++Failures;
+    }
+}
+
+bool WriteFile(const std::string& Name, const std::string& Content) {
+    std::ofstream out(Name);
+    out << Content;
+    return static_cast<bool>(out);
+}
+
+// Layers of the 12 compartments of 0.1 m (DetermineNrandThicknessCompartments)
+void CheckLayers(const std::string& Name, const std::vector<int32_t>& Expected) {
+    Check(Name + " compartments", NrCompartments, static_cast<dp>(Expected.size()));
+    for (int32_t compi = 1; compi <= NrCompartments && compi <= static_cast<int32_t>(Expected.size()); ++compi) {
+        Check(Name + " layer of compartment " + std::to_string(compi), Compartment[compi-1].Layer,
+              Expected[compi-1]);
+    }
+}
+
+// Three layers whose bounds (0.22, 0.66 and 1.66 m) do not fall on the middle
+// of a compartment; every header value is followed by a description with
+// numbers in it
+void CheckWrittenProfile() {
+    PrepareSimulationThread();
+    const std::string FileName = "soil_profile_test.SOL";
+    if (!WriteFile(FileName,
+                   "Three layers\n"
+                   "        7.1                 : AquaCrop Version 7.1 (August 2023)\n"
+                   "       72                   : CN (Curve Number) of 60 to 90\n"
+                   "        9                   : Readily evaporable water from top layer (mm), 5 to 15\n"
+                   "        3                   : number of soil horizons (1 to 5)\n"
+                   "       -9                   : variable no longer applicable\n"
+                   "  Thickness  Sat   FC    WP     Ksat   Penetrability  Gravels  CRa       CRb           description\n"
+                   "  ---(m)-   ----(vol %)-----  (mm/day)      (%)        (%)    -----------------------------------------\n"
+                   "    0.22    46.0  31.0  15.0    250.0        100          5     -0.195740  -4.274354   loam\n"
+                   "    0.44    41.0  25.0  12.0     80.0         90          0     -0.310000   1.200000   sandyloam\n"
+                   "    1.00    38.0  18.0   8.0    500.0        100         10     -0.320000   0.500000   sand\n")) {
+        std::cerr << "cannot write " << FileName << std::endl;
+        ++Failures;
+        return;
+    }
+    LoadProfile(FileName);
+    std::remove(FileName.c_str());
+    Check("CN", Soil.CNvalue, 72);
+    Check("REW", Soil.REW, 9);
+    Check("layers", Soil.NrSoilLayers, 3);
+    const dp Thickness[] = {0.22, 0.44, 1.00};
+    const dp FC[] = {31.0, 25.0, 18.0};
+    const dp InfRate[] = {250.0, 80.0, 500.0};
+    const dp CRb[] = {-4.274354, 1.2, 0.5};
+    const char* Description[] = {"loam", "sandyloam", "sand"};
+    for (int32_t layeri = 1; layeri <= 3; ++layeri) {
+        const SoilLayerIndividual& Layer = soillayer[layeri-1];
+        const std::string Name = "layer " + std::to_string(layeri);
+        Check(Name + " thickness", Layer.Thickness, Thickness[layeri-1]);
+        Check(Name + " FC", Layer.FC, FC[layeri-1]);
+        Check(Name + " Ksat", Layer.InfRate, InfRate[layeri-1]);
+        Check(Name + " CRb", Layer.CRb, CRb[layeri-1]);
+        if (Layer.Description != Description[layeri-1]) {
+            std::cerr << Name << ": description " << Layer.Description << std::endl;
+            ++Failures;
+        }
+    }
+    Check("layer 2 penetrability", soillayer[1].Penetrability, 90);
+    Check("layer 3 gravel", soillayer[2].GravelMass, 10);
+
+    // the middles of the compartments are 0.05, 0.15, ... 1.15 m
+    soillayer[3].Thickness = 1.0;
+    soillayer[4].Thickness = 1.0;
+    Simulation.ResetIniSWC = false;
+    for (CompartmentSaltIndividual& CompSalt : CompartmentSalt) {
+        for (dp& Salt : CompSalt.Salt) Salt = 1.0;
+        for (dp& Depo : CompSalt.Depo) Depo = 1.0;
+    }
+    CompleteProfileDescription();
+    CheckLayers("three layers", {1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3});
+    Check("undefined layer 4", soillayer[3].Thickness, undef_double);
+    Check("undefined layer 5", soillayer[4].Thickness, undef_double);
+    if (!Simulation.ResetIniSWC || !Simulation.IniSWC.AtFC || Simulation.IniSWC.NrLoc != 3) {
+        std::cerr << "initial conditions not reset to field capacity" << std::endl;
+        ++Failures;
+    }
+
+    // field capacity, without salt: 62, 125 and 90 mm in the three layers
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        const std::string Name = "compartment " + std::to_string(compi);
+        const dp Theta = FC[Compartment[compi-1].Layer-1] / 100.0;
+        Check(Name + " theta", Compartment[compi-1].theta, Theta);
+        Check(Name + " initial theta", Simulation.ThetaIni[compi-1], Theta);
+        Check(Name + " FCadj", Compartment[compi-1].FCadj, FC[Compartment[compi-1].Layer-1]);
+        for (int32_t celli = 1; celli <= soillayer[Compartment[compi-1].Layer-1].SCP1; ++celli) {
+            Check(Name + " salt", CompartmentSalt[compi-1].Salt[celli-1], 0.0);
+            Check(Name + " deposit", CompartmentSalt[compi-1].Depo[celli-1], 0.0);
+        }
+    }
+    Check("water of layer 1", soillayer[0].WaterContent, 62.0);
+    Check("water of layer 2", soillayer[1].WaterContent, 125.0);
+    Check("water of layer 3", soillayer[2].WaterContent, 90.0);
+    Check("water of the profile", TotalWaterContent.BeginDay, 277.0);
+
+    // a profile that ends in compartment 3: the compartments below it are
+    // in the last layer
+    soillayer[0].Thickness = 0.12;
+    soillayer[1].Thickness = 0.20;
+    Soil.NrSoilLayers = 2;
+    CompleteProfileDescription();
+    CheckLayers("shallow profile", {1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2});
+    Check("undefined layer 3", soillayer[2].Thickness, undef_double);
+}
+
+// The profile of run 1 of every generated project is completed when it is
+// loaded: every compartment lies in a layer of the file and starts at its
+// field capacity
+void CheckGeneratedRuns() {
+    std::ifstream List("PARAM/ListProjects.txt");
+    int32_t NrProjects = 0;
+    for (std::string Project; std::getline(List, Project);) {
+        if (Project.empty()) continue;
+        ++NrProjects;
+        PrepareSimulationThread();
+        InitializeProject(1, Project, typeproject::typeprm);
+        for (int32_t compi = 1; compi <= max_No_compartments; ++compi) Compartment[compi-1].Layer = 0;
+        LoadSimulationRunProject(1);
+        for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+            const int32_t Layer = Compartment[compi-1].Layer;
+            if (Layer < 1 || Layer > Soil.NrSoilLayers) {
+                std::cerr << Project << ": compartment " << compi << " in layer " << Layer << std::endl;
+                ++Failures;
+                continue;
+            }
+            Check(Project + " initial theta of compartment " + std::to_string(compi), Simulation.ThetaIni[compi-1],
+                  soillayer[Layer-1].FC / 100.0);
+        }
+    }
+    if (NrProjects == 0) {
+        std::cerr << "no generated projects in PARAM/ListProjects.txt" << std::endl;
+        ++Failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    CheckWrittenProfile();
+    CheckGeneratedRuns();
+    if (Failures > 0) {
+        std::cerr << Failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "soil profiles loaded, layered and at field capacity" << std::endl;
+    return EXIT_SUCCESS;
+}
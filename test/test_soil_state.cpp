@@ -0,0 +1,109 @@
+// Checks that the derived soil state follows the groundwater depth and the
+// compartments: after every change it holds what the direct computation gives,
+// also where the capillary rise comes from the tables, and for the root zone.
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Simul.h"
+#include "AquaCrop/SoilState.h"
+#include "AquaCrop/Synthetic.h"
+#include "AquaCrop/Utils.h"
+#include <cstdlib>
+#include <iostream>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void CheckState(const char* Name, dp DepthGWTmeter, dp WeightDepth) {
+    UpdateGroundwaterState(DepthGWTmeter);
+    bool WaterTableInProfile;
+    CheckForWaterTableInProfile(DepthGWTmeter, Compartment, WaterTableInProfile);
+    if (DerivedSoil.WaterTableInProfile != WaterTableInProfile) {
+        std::cerr << Name << ": water table in profile " << DerivedSoil.WaterTableInProfile << std::endl;
+        ++Failures;
+    }
+    dp Ztop, Zbot = 0.0;
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        Ztop = Zbot;
+        Zbot = Ztop + Compartment[compi - 1].Thickness;
+        const SoilLayerIndividual& Layer = soillayer[Compartment[compi - 1].Layer - 1];
+        dp CRmax = MaxCRatDepth(Layer.CRa, Layer.CRb, (Layer.tau * 1000.0), (Ztop + Zbot) / 2.0, DepthGWTmeter);
+        if (DerivedSoil.CRmax[compi - 1] != CRmax) {
+            std::cerr << Name << ": CRmax of compartment " << compi << " " << DerivedSoil.CRmax[compi - 1]
+                      << " != " << CRmax << std::endl;
+            ++Failures;
+        }
+    }
+    const std::vector<dp>& WFactor = WeightingFactors(WeightDepth);
+    std::vector<CompartmentIndividual> Compartment_temp = Compartment;
+    calculate_weighting_factors(WeightDepth, Compartment_temp);
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) {
+        if (WFactor[compi - 1] != Compartment_temp[compi - 1].WFactor) {
+            std::cerr << Name << ": weighting factor of compartment " << compi << std::endl;
+            ++Failures;
+        }
+    }
+}
+
+// root zone water summed over the compartments (reference)
+void CheckRootZone(const char* Name, dp RootingDepth) {
+    dp Sums[4] = {0.0, 0.0, 0.0, 0.0};
+    dp Ztop, depthi = 0.0;
+    for (int32_t compi = 1; compi <= NrCompartments && depthi < RootingDepth; ++compi) {
+        const SoilLayerIndividual& Layer = soillayer[Compartment[compi - 1].Layer - 1];
+        Ztop = depthi;
+        depthi += Compartment[compi - 1].Thickness;
+        dp DZ = (depthi <= RootingDepth) ? Compartment[compi - 1].Thickness : RootingDepth - Ztop;
+        const dp Theta[4] = {Compartment[compi - 1].theta, Layer.FC / 100.0, Layer.WP / 100.0, Layer.SAT / 100.0};
+        for (int32_t i = 0; i < 4; ++i) Sums[i] += Theta[i] * 1000.0 * DZ * (1.0 - Layer.GravelVol / 100.0);
+    }
+    bool ZtopSWCconsidered = false;
+    DetermineRootZoneWC(RootingDepth, ZtopSWCconsidered);
+    if (RootZoneWC.Actual != Sums[0] || RootZoneWC.FC != Sums[1] || RootZoneWC.WP != Sums[2] || RootZoneWC.SAT != Sums[3]) {
+        std::cerr << Name << ": root zone of " << RootingDepth << " m " << RootZoneWC.Actual << " != " << Sums[0] << std::endl;
+        ++Failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    int32_t DayNr1;
+    DetermineDayNr(1, 4, 2001, DayNr1);
+    SetupSyntheticSeason(7, DayNr1, 30);
+
+    CheckState("no table", -0.09, 0.3);
+    CheckState("deep table", 3.5, 0.3);
+    CheckState("same table", 3.5, 0.3);
+    CheckState("table in profile", 0.6, 0.3);
+    CheckState("other weighting depth", 0.6, 0.15);
+
+    // a moving table: whole centimetres from the tables, others computed
+    for (int32_t Zcm = 1; Zcm <= 700; Zcm += 3) CheckState("moving table", Zcm / 100.0, 0.15);
+    CheckState("fractional centimetres", 0.6551, 0.15);
+
+    // a growing root zone while the soil dries, and the same depth twice
+    for (dp RootingDepth = 0.0; RootingDepth <= 2.0; RootingDepth += 0.07) {
+        CheckRootZone("growing roots", RootingDepth);
+        for (int32_t compi = 1; compi <= NrCompartments; ++compi) Compartment[compi - 1].theta *= 0.98;
+        CheckRootZone("drying soil", RootingDepth);
+    }
+
+    // thinner compartments at the same depths
+    for (int32_t compi = 1; compi <= NrCompartments; ++compi) Compartment[compi - 1].Thickness *= 0.5;
+    CheckState("thinner compartments", 0.6, 0.15);
+    CheckRootZone("thinner compartments", 0.5);
+
+    // a new profile with the same compartments
+    SetupSyntheticSeason(42, DayNr1, 30);
+    CheckState("new profile", 0.6, 0.15);
+    CheckRootZone("new profile", 0.5);
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "derived soil state follows its inputs" << std::endl;
+    return EXIT_SUCCESS;
+}
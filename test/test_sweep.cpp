@@ -0,0 +1,72 @@
+// Checks the sowing dates of a window and the shift of a loaded run to a new
+// sowing date.
+#include "AquaCrop/Sweep.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+int32_t Failures = 0;
+
+void Check(const char* Name, int32_t Value, int32_t Expected) {
+    if (Value != Expected) {
+        std::cerr << Name << ": " << Value << " != " << Expected << std::endl;
+        ++Failures;
+    }
+}
+
+int32_t DayNr(int32_t Day, int32_t Month, int32_t Year) {
+    int32_t Nr;
+    DetermineDayNr(Day, Month, Year, Nr);
+    return Nr;
+}
+
+} // namespace
+
+int main() {
+    rep_SowingWindow Window;
+    Window.FromDay = 1;
+    Window.FromMonth = 4;
+    Window.ToDay = 30;
+    Window.ToMonth = 6;
+    Window.StepDays = 7;
+    std::vector<int32_t> Dates = SowingDayNrs(Window, 2001);
+    Check("spring dates", static_cast<int32_t>(Dates.size()), 13);
+    Check("spring first", Dates.front(), DayNr(1, 4, 2001));
+    Check("spring last", Dates.back(), DayNr(24, 6, 2001));
+
+    // window across the new year
+    Window.FromDay = 1;
+    Window.FromMonth = 11;
+    Window.ToDay = 31;
+    Window.ToMonth = 1;
+    Window.StepDays = 10;
+    Dates = SowingDayNrs(Window, 2003);
+    Check("winter dates", static_cast<int32_t>(Dates.size()), 10);
+    Check("winter last", Dates.back(), DayNr(30, 1, 2004));
+
+    // the crop cycle and the simulation period move together
+    crop.Day1 = DayNr(15, 4, 2001);
+    crop.DayN = crop.Day1 + 120;
+    Simulation.FromDayNr = crop.Day1 - 10;
+    Simulation.ToDayNr = crop.DayN + 5;
+    SetSowingDate(DayNr(6, 5, 2001));
+    ApplySowingDate();
+    SetSowingDate(undef_int);
+    Check("Day1", crop.Day1, DayNr(6, 5, 2001));
+    Check("DayN", crop.DayN, DayNr(6, 5, 2001) + 120);
+    Check("FromDayNr", Simulation.FromDayNr, DayNr(6, 5, 2001) - 10);
+    Check("ToDayNr", Simulation.ToDayNr, DayNr(6, 5, 2001) + 125);
+    ApplySowingDate();
+    Check("no sowing date", crop.Day1, DayNr(6, 5, 2001));
+
+    if (Failures > 0) {
+        std::cerr << Failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "sowing dates match" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+// Parameter calibration for AquaCrop C++
+//
+// Fits crop and soil parameters of one project to the observations of its
+// observation file. Run it in the working directory of aquacrop_main:
+//   aquacrop_calibrate --project field.PRM --param crop.CGC:0.05:0.2 --param crop.CCx:0.7:0.99
+// Every candidate is a full simulation of the project; the candidates of a
+// simplex step or generation run in parallel, one simulation per thread.
+#include "AquaCrop/Calibration.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_CalibrateOptions {
+    std::string ProjectFile;
+    std::vector<rep_CalibParameter> Parameters;
+    rep_CalibSettings Settings;
+    bool ListParameters = false;
+};
+
+// comma separated weights of canopy cover, biomass and soil water
+bool ParseWeights(const std::string& Spec, rep_CalibObjective& Objective)
+{
+    size_t Begin = 0;
+    for (int32_t k = 1; k <= NrObsSim; ++k) {
+        size_t End = Spec.find(',', Begin);
+        if ((End == std::string::npos) != (k == NrObsSim)) return false;
+        Objective.Weight[k-1] = std::atof(Spec.substr(Begin, End - Begin).c_str());
+        Begin = End + 1;
+    }
+    return true;
+}
+
+bool ParseOptions(int argc, char* argv[], rep_CalibrateOptions& Opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        bool HasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--project") == 0 && HasValue) {
+            Opt.ProjectFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--param") == 0 && HasValue) {
+            rep_CalibParameter Parameter;
+            if (!ParseCalibParameter(argv[++i], Parameter)) {
+                std::cerr << "Invalid parameter (NAME:LOWER:UPPER, see --list): " << argv[i] << std::endl;
+                return false;
+            }
+            Opt.Parameters.push_back(Parameter);
+        } else if (std::strcmp(argv[i], "--method") == 0 && HasValue) {
+            if (!ParseOptimMethod(argv[++i], Opt.Settings.Optim.Method)) {
+                std::cerr << "Unknown method: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--metric") == 0 && HasValue) {
+            if (!ParseFitMetric(argv[++i], Opt.Settings.Objective.Metric)) {
+                std::cerr << "Unknown metric: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--weights") == 0 && HasValue) {
+            if (!ParseWeights(argv[++i], Opt.Settings.Objective)) {
+                std::cerr << "Invalid weights (CC,BIOMASS,SWC): " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--evals") == 0 && HasValue) {
+            Opt.Settings.Optim.MaxEvaluations = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--population") == 0 && HasValue) {
+            Opt.Settings.Optim.PopulationSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && HasValue) {
+            Opt.Settings.Optim.Seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && HasValue) {
+            Opt.Settings.NrThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            Opt.ListParameters = true;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (!Opt.ListParameters && (Opt.ProjectFile.empty() || Opt.Parameters.empty())) {
+        std::cerr << "Need a project and at least one parameter" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    rep_CalibrateOptions Opt;
+    if (!ParseOptions(argc, argv, Opt)) {
+        std::cerr << "Usage: aquacrop_calibrate --project FILE --param NAME:LOWER:UPPER [--param ...]"
+                  << " [--method nelder-mead|de|cmaes] [--metric rmse|nrmse|1-d|1-ef] [--weights CC,B,SWC]"
+                  << " [--evals N] [--population N] [--seed S] [--threads N] [--list]" << std::endl;
+        return 1;
+    }
+    if (Opt.ListParameters) {
+        for (const rep_ParamBinding& Binding : ParameterBindings()) {
+            std::cout << std::left << std::setw(30) << Binding.Name << Binding.Description << std::endl;
+        }
+        return 0;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    rep_CalibResult Result;
+    if (!CalibrateProject(Opt.ProjectFile, Opt.Parameters, Opt.Settings, Result)) return 1;
+    dp Seconds = std::chrono::duration<dp>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "Calibrated " << Opt.ProjectFile << " with " << OptimMethodName(Opt.Settings.Optim.Method)
+              << " on " << FitMetricName(Opt.Settings.Objective.Metric) << ": " << Result.NrEvaluations
+              << " simulations in " << Result.NrIterations << " iterations, "
+              << std::fixed << std::setprecision(1) << Seconds << " s" << std::endl;
+    std::cout << std::setprecision(6);
+    std::cout << "  " << std::left << std::setw(30) << "objective" << std::setw(14) << Result.StartObjective
+              << Result.BestObjective << std::endl;
+    for (size_t i = 0; i < Opt.Parameters.size(); ++i) {
+        std::cout << "  " << std::setw(30) << Opt.Parameters[i].Binding->Name << std::setw(14)
+                  << Result.StartValues[i] << Result.BestValues[i] << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,522 @@
+// Synthetic workload generator for AquaCrop C++
+//
+// Writes N fields x Y years of AquaCrop input in a directory that can be
+// used as working directory of aquacrop_main:
+//   PARAM/ListProjects.txt               one PRM per field
+//   PARAM/shard_SSSS/field_NNNNNNN.PRM   one run per year
+//   DATA/CLIM/  weather stations (CLI, Tnx, ETo, PLU) and the CO2 record
+//   DATA/SOIL/  soil profiles (SOL)
+//   DATA/CROP/  crop variants (CRO)
+//   DATA/OBS/   canopy cover observations per field (OBS, --observations)
+//   OUTP/, SIMUL/
+// Fields draw their station, soil and crop from fixed-size pools, so the
+// volume of weather and soil data does not grow with the number of fields.
+// Every object has its own splitmix64 stream derived from the seed and the
+// object index: the same seed always gives the same files.
+#include "AquaCrop/Global.h"
+#include "AquaCrop/Synthetic.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_GenerateOptions {
+    std::string OutDir = "synthetic";
+    int64_t NrFields = 10;
+    int32_t NrYears = 1;
+    uint64_t Seed = 1;
+    int32_t FirstYear = 2001;
+    int32_t NrStations = 0;      // 0: one station per 100 fields (1..10000)
+    int32_t NrSoils = 0;         // 0: one profile per 20 fields (1..10000)
+    int32_t FieldsPerShard = 1000;
+    bool Observations = false;   // canopy cover observations per field
+};
+
+enum class StreamKind : uint64_t {
+    Station = 1,
+    Soil,
+    Crop,
+    Field,
+    Observation,
+};
+
+constexpr int32_t NrCropVariants = 8;
+
+struct rep_CropTemplate {
+    const char* Name;
+    int32_t Subkind;             // 1 leafy, 2 grain, 3 tuber, 4 forage
+    dp Tbase, Tupper;
+    dp pLeafDefUL, pLeafDefLL, pdef, pSenescence;
+    dp KcTop, RootMin, RootMax;
+    dp CCx, CGC, CDC;
+    int32_t DaysToGermination, DaysToMaxRooting, DaysToSenescence, DaysToHarvest;
+    int32_t DaysToFlowering, LengthFlowering;
+    dp WP;                       // g/m2
+    int32_t HI;                  // %
+    int32_t PlantingDens;        // plants/ha
+    dp SizeSeedling;             // cm2
+    int32_t SowMonth, SowDay, SowWindow;
+};
+
+const rep_CropTemplate CropTemplates[] = {
+    {"maize",   2, 8.0, 30.0, 0.14, 0.72, 0.69, 0.69, 1.05, 0.30, 2.30, 0.96, 0.130, 0.106, 6, 108, 107, 132, 66, 13, 33.7, 48, 75000, 6.5, 4, 15, 30},
+    {"wheat",   2, 0.0, 26.0, 0.20, 0.65, 0.65, 0.70, 1.10, 0.30, 1.50, 0.96, 0.050, 0.070, 13, 93, 128, 158, 127, 15, 15.0, 48, 4500000, 1.5, 3, 1, 30},
+    {"soybean", 2, 5.0, 30.0, 0.15, 0.60, 0.60, 0.70, 1.10, 0.30, 1.70, 0.98, 0.110, 0.090, 7, 90, 110, 137, 62, 35, 15.0, 40, 333000, 5.0, 5, 1, 30},
+    {"potato",  3, 2.0, 26.0, 0.20, 0.60, 0.60, 0.70, 1.10, 0.30, 0.60, 0.92, 0.150, 0.130, 15, 60, 95, 120, 45, 35, 18.0, 75, 40000, 15.0, 4, 10, 40},
+};
+constexpr int32_t NrCropTemplates = sizeof(CropTemplates) / sizeof(CropTemplates[0]);
+
+// Independent stream for one object, so any object can be produced on its own
+rep_SplitMix64 ObjectStream(uint64_t Seed, StreamKind Kind, int64_t Index)
+{
+    rep_SplitMix64 Mix{Seed ^ (static_cast<uint64_t>(Kind) << 56)};
+    rep_SplitMix64 Stream{Mix.Next() ^ (static_cast<uint64_t>(Index) * 0xD1B54A32D192ED03ULL)};
+    Stream.Next();
+    return Stream;
+}
+
+std::string Format(const char* fmt, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return buf;
+}
+
+// Writes a file and counts what was written
+class rep_FileWriter {
+public:
+    int64_t NrFiles = 0;
+    int64_t NrBytes = 0;
+
+    bool Write(const fs::path& Path, const std::string& Content)
+    {
+        std::ofstream out(Path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Cannot write " << Path.string() << std::endl;
+            return false;
+        }
+        out << Content;
+        ++NrFiles;
+        NrBytes += static_cast<int64_t>(Content.size());
+        return true;
+    }
+};
+
+std::string StationName(int32_t Station) { return Format("station_%05d", Station); }
+std::string SoilName(int32_t Soil) { return Format("soil_%05d", Soil); }
+
+std::string CropName(int32_t Crop)
+{
+    return Format("%s_%02d", CropTemplates[Crop / NrCropVariants].Name, Crop % NrCropVariants);
+}
+
+// Header of a daily climate record starting on 1 January of FirstYear
+std::string ClimateHeader(const std::string& Description, int32_t FirstYear, const char* Columns)
+{
+    std::string s = Description + "\n";
+    s += "     1  : Daily records (1=daily, 2=10-daily and 3=monthly data)\n";
+    s += "     1  : First day of record (1, 11 or 21 for 10-day or 1 for months)\n";
+    s += "     1  : First month of record\n";
+    s += Format("  %4d  : First year of record (1901 if not linked to a specific year)\n", FirstYear);
+    s += "\n";
+    s += Columns;
+    s += "\n=======================\n";
+    return s;
+}
+
+bool WriteCO2(rep_FileWriter& Writer, const fs::path& ClimDir)
+{
+    std::string s = "Synthetic atmospheric CO2 concentration\n";
+    s += "Year     CO2 (ppm by volume)\n";
+    s += "============================\n";
+    for (int32_t Yeari = 1902; Yeari <= 2099; ++Yeari) {
+        dp CO2 = 297.4 + 0.0114 * std::pow(static_cast<dp>(Yeari - 1902), 2.0);
+        s += Format("  %4d  %.2f\n", Yeari, CO2);
+    }
+    return Writer.Write(ClimDir / "Synthetic.CO2", s);
+}
+
+bool WriteStation(rep_FileWriter& Writer, const fs::path& ClimDir, const rep_GenerateOptions& Opt, int32_t Station)
+{
+    rep_SplitMix64 Rng = ObjectStream(Opt.Seed, StreamKind::Station, Station);
+    std::string Name = StationName(Station);
+    dp ShiftT = Rng.Uniform(-4.0, 4.0);
+    dp RainFactor = Rng.Uniform(0.5, 1.8);
+    dp EToFactor = Rng.Uniform(0.8, 1.2);
+    int32_t LastYear = Opt.FirstYear + Opt.NrYears - 1;
+
+    std::string Desc = "Synthetic weather station " + std::to_string(Station);
+    std::string Tnx = ClimateHeader(Desc, Opt.FirstYear, "  Tmin (C)   TMax (C)");
+    std::string ETo = ClimateHeader(Desc, Opt.FirstYear, "  Average ETo (mm/day)");
+    std::string PLU = ClimateHeader(Desc, Opt.FirstYear, "  Total Rain (mm)");
+    int32_t DayNr1, DayNrN;
+    DetermineDayNr(1, 1, Opt.FirstYear, DayNr1);
+    DetermineDayNr(31, 12, LastYear, DayNrN);
+    for (int32_t DayNr = DayNr1; DayNr <= DayNrN; ++DayNr) {
+        int32_t Dayi, Monthi, Yeari, DayNrJan1;
+        DetermineDate(DayNr, Dayi, Monthi, Yeari);
+        DetermineDayNr(1, 1, Yeari, DayNrJan1);
+        rep_SyntheticDay Day = SyntheticWeather(Rng, DayNr - DayNrJan1 + 1);
+        Tnx += Format("%10.1f%10.1f\n", Day.Tmin + ShiftT, Day.Tmax + ShiftT);
+        ETo += Format("%10.1f\n", Day.ETo * EToFactor);
+        PLU += Format("%10.1f\n", Day.Rain * RainFactor);
+    }
+
+    std::string CLI = Desc + "\n";
+    CLI += " 7.1   : AquaCrop Version (August 2023)\n";
+    CLI += Name + ".Tnx\n" + Name + ".ETo\n" + Name + ".PLU\nSynthetic.CO2\n";
+
+    return Writer.Write(ClimDir / (Name + ".CLI"), CLI)
+        && Writer.Write(ClimDir / (Name + ".Tnx"), Tnx)
+        && Writer.Write(ClimDir / (Name + ".ETo"), ETo)
+        && Writer.Write(ClimDir / (Name + ".PLU"), PLU);
+}
+
+bool WriteSoil(rep_FileWriter& Writer, const fs::path& SoilDir, const rep_GenerateOptions& Opt, int32_t Soili)
+{
+    rep_SplitMix64 Rng = ObjectStream(Opt.Seed, StreamKind::Soil, Soili);
+    int32_t NrLayers = 1 + static_cast<int32_t>(Rng.Next() % max_SoilLayers);
+    int32_t CN = static_cast<int32_t>(Rng.Uniform(55.0, 85.0));
+    int32_t REW = static_cast<int32_t>(Rng.Uniform(5.0, 12.0));
+
+    std::string s = "Synthetic soil profile " + std::to_string(Soili) + "\n";
+    s += "        7.1                 : AquaCrop Version (August 2023)\n";
+    s += Format("       %2d                   : CN (Curve Number)\n", CN);
+    s += Format("       %2d                   : Readily evaporable water from top layer (mm)\n", REW);
+    s += Format("        %d                   : number of soil horizons\n", NrLayers);
+    s += "       -9                   : variable no longer applicable\n";
+    s += "  Thickness  Sat   FC    WP     Ksat   Penetrability  Gravels  CRa       CRb           description\n";
+    s += "  ---(m)-   ----(vol %)-----  (mm/day)      (%)        (%)    -----------------------------------------\n";
+    for (int32_t layeri = 1; layeri <= NrLayers; ++layeri) {
+        const rep_SoilTexture& T = SyntheticTextures[Rng.Next() % NrSyntheticTextures];
+        dp Thickness = (layeri < NrLayers) ? 0.05 * std::round(Rng.Uniform(0.2, 0.8) / 0.05) : Rng.Uniform(1.0, 3.0);
+        dp Ksat = T.InfRate * Rng.Uniform(0.8, 1.2);
+        int32_t Gravel = static_cast<int32_t>(Rng.Uniform(0.0, 15.0));
+        dp CRa, CRb;
+        DetermineParametersCR(NumberSoilClass(T.SAT, T.FC, T.WP, Ksat), Ksat, CRa, CRb);
+        s += Format("    %4.2f    %4.1f  %4.1f  %4.1f  %7.1f        100         %2d     %8.6f  %8.6f   %s\n",
+                    Thickness, T.SAT, T.FC, T.WP, Ksat, Gravel, CRa, CRb, T.Name);
+    }
+    return Writer.Write(SoilDir / (SoilName(Soili) + ".SOL"), s);
+}
+
+// Length of the crop cycle of a crop variant in calendar days
+int32_t CropCycleDays(const rep_GenerateOptions& Opt, int32_t Crop)
+{
+    rep_SplitMix64 Rng = ObjectStream(Opt.Seed, StreamKind::Crop, Crop);
+    return static_cast<int32_t>(std::lround(CropTemplates[Crop / NrCropVariants].DaysToHarvest * Rng.Uniform(0.9, 1.1)));
+}
+
+bool WriteCrop(rep_FileWriter& Writer, const fs::path& CropDir, const rep_GenerateOptions& Opt, int32_t Crop)
+{
+    const rep_CropTemplate& T = CropTemplates[Crop / NrCropVariants];
+    rep_SplitMix64 Rng = ObjectStream(Opt.Seed, StreamKind::Crop, Crop);
+    dp Length = Rng.Uniform(0.9, 1.1);  // first draw, shared with CropCycleDays
+    int32_t DaysToHarvest = static_cast<int32_t>(std::lround(T.DaysToHarvest * Length));
+    auto Days = [&](int32_t d) { return static_cast<int32_t>(std::lround(d * Length)); };
+    dp CCx = std::min(0.99, T.CCx * Rng.Uniform(0.92, 1.03));
+    dp CGC = T.CGC * Rng.Uniform(0.9, 1.1);
+    dp CDC = T.CDC * Rng.Uniform(0.9, 1.1);
+    dp WP = T.WP * Rng.Uniform(0.95, 1.05);
+    dp RootMax = T.RootMax * Rng.Uniform(0.85, 1.1);
+
+    std::string s = Format("Synthetic %s, variant %d\n", T.Name, Crop % NrCropVariants);
+    auto Line = [&](const std::string& Value, const char* Comment) {
+        s += Format("  %-12s: %s\n", Value.c_str(), Comment);
+    };
+    Line("7.1", "AquaCrop Version (August 2023)");
+    Line("1", "File not protected");
+    Line(std::to_string(T.Subkind), "Crop type (1 leafy, 2 fruit/grain, 3 root/tuber, 4 forage)");
+    Line("1", "Crop is sown");
+    Line("1", "Determination of crop cycle : by calendar days");
+    Line("1", "Soil water depletion factors (p) are adjusted by ETo");
+    Line(Format("%.1f", T.Tbase), "Base temperature (degC) below which crop development does not progress");
+    Line(Format("%.1f", T.Tupper), "Upper temperature (degC) above which crop development no longer increases");
+    Line("-9", "Total length of crop cycle in growing degree-days");
+    Line(Format("%.2f", T.pLeafDefUL), "Soil water depletion factor for canopy expansion - Upper threshold");
+    Line(Format("%.2f", T.pLeafDefLL), "Soil water depletion factor for canopy expansion - Lower threshold");
+    Line("2.9", "Shape factor for water stress coefficient for canopy expansion");
+    Line(Format("%.2f", T.pdef), "Soil water depletion fraction for stomatal control - Upper threshold");
+    Line("6.0", "Shape factor for water stress coefficient for stomatal control");
+    Line(Format("%.2f", T.pSenescence), "Soil water depletion factor for canopy senescence - Upper threshold");
+    Line("2.7", "Shape factor for water stress coefficient for canopy senescence");
+    Line("0", "Sum(ETo) during stress period to be exceeded before senescence is triggered");
+    Line("0.80", "Soil water depletion factor for pollination - Upper threshold");
+    Line("5", "Vol% for Anaerobiotic point");
+    Line("50", "Considered soil fertility stress for calibration of stress response (%)");
+    Line("25.00", "Shape factor for the response of canopy expansion to soil fertility stress");
+    Line("1.00", "Shape factor for the response of maximum canopy cover to soil fertility stress");
+    Line("1.00", "Shape factor for the response of crop Water Productivity to soil fertility stress");
+    Line("1.00", "Shape factor for the response of decline of canopy cover to soil fertility stress");
+    Line("-9", "dummy - Parameter no Longer required");
+    Line("8", "Minimum air temperature below which pollination starts to fail (degC)");
+    Line("40", "Maximum air temperature above which pollination starts to fail (degC)");
+    Line("12.0", "Minimum growing degrees required for full crop transpiration (degC - day)");
+    Line("2", "Electrical Conductivity of soil saturation extract at which crop starts to be affected (dS/m)");
+    Line("12", "Electrical Conductivity of soil saturation extract at which crop can no longer grow (dS/m)");
+    Line("-9", "Dummy - no longer applicable");
+    Line("25", "Calibrated distortion (%) of CC due to salinity stress");
+    Line("100", "Calibrated response (%) of stomata stress to ECsw");
+    Line(Format("%.2f", T.KcTop), "Crop coefficient when canopy is complete but prior to senescence");
+    Line("0.300", "Decline of crop coefficient (%/day) as a result of ageing, nitrogen deficiency, etc.");
+    Line(Format("%.2f", T.RootMin), "Minimum effective rooting depth (m)");
+    Line(Format("%.2f", RootMax), "Maximum effective rooting depth (m)");
+    Line("13", "Shape factor describing root zone expansion");
+    Line("0.045", "Maximum root water extraction (m3water/m3soil.day) in top quarter of root zone");
+    Line("0.011", "Maximum root water extraction (m3water/m3soil.day) in bottom quarter of root zone");
+    Line("50", "Effect of canopy cover in reducing soil evaporation in late season stage");
+    Line(Format("%.2f", T.SizeSeedling), "Soil surface covered by an individual seedling at 90 % emergence (cm2)");
+    Line(Format("%.2f", T.SizeSeedling), "Canopy size of individual plant (re-growth) at 1st day (cm2)");
+    Line(std::to_string(T.PlantingDens), "Number of plants per hectare");
+    Line(Format("%.5f", CGC), "Canopy growth coefficient (CGC): Increase in canopy cover (fraction soil cover per day)");
+    Line("-9", "Maximum decrease of Canopy Cover in subsequent years (% of CCx)");
+    Line("-9", "Number of years at which CCx declines to 90 % of its value due to self-thinning");
+    Line("-9", "Shape factor of the decline of CCx over the years due to self-thinning");
+    Line(Format("%.2f", CCx), "Maximum canopy cover (CCx) in fraction soil cover");
+    Line(Format("%.5f", CDC), "Canopy decline coefficient (CDC): Decrease in canopy cover (in fraction per day)");
+    Line(std::to_string(Days(T.DaysToGermination)), "Calendar Days: from sowing to emergence");
+    Line(std::to_string(Days(T.DaysToMaxRooting)), "Calendar Days: from sowing to maximum rooting depth");
+    Line(std::to_string(Days(T.DaysToSenescence)), "Calendar Days: from sowing to start senescence");
+    Line(std::to_string(DaysToHarvest), "Calendar Days: from sowing to maturity (length of crop cycle)");
+    Line(std::to_string(Days(T.DaysToFlowering)), "Calendar Days: from sowing to flowering");
+    Line(std::to_string(T.LengthFlowering), "Length of the flowering stage (days)");
+    Line("1", "Crop determinancy linked with flowering");
+    Line("50", "Excess of potential fruits (%)");
+    Line(std::to_string(DaysToHarvest - Days(T.DaysToFlowering) - 5), "Building up of Harvest Index starting at flowering (days)");
+    Line(Format("%.1f", WP), "Water Productivity normalized for ETo and CO2 (WP*) (gram/m2)");
+    Line("100", "Water Productivity normalized for ETo and CO2 during yield formation (as % WP*)");
+    Line("50", "Crop performance under elevated atmospheric CO2 concentration (%)");
+    Line(std::to_string(T.HI), "Reference Harvest Index (HIo) (%)");
+    Line("0", "Possible increase (%) of HI due to water stress before flowering");
+    Line("7.0", "Coefficient describing positive impact on HI of restricted vegetative growth during yield formation");
+    Line("3.0", "Coefficient describing negative impact on HI of stomatal closure during yield formation");
+    Line("15", "Allowable maximum increase (%) of specified HI");
+    for (int32_t k = 0; k < 9; ++k) {
+        Line("-9", "GDDays: not used for a crop cycle in calendar days");
+    }
+    Line("90", "dry matter content (%) of fresh yield");
+    Line(Format("%.2f", T.RootMin), "Minimum effective rooting depth (m) in first year");
+    Line("1", "Crop is sown in 1st year");
+    Line("0", "Transfer of assimilates from above ground parts to root system is NOT considered");
+    Line("0", "Number of days at end of season during which assimilates are stored in root system");
+    Line("0", "Percentage of assimilates transferred to root system at last day of season");
+    Line("0", "Percentage of stored assimilates transferred to above ground parts in next season");
+    return Writer.Write(CropDir / (CropName(Crop) + ".CRO"), s);
+}
+
+void Section(std::string& s, const char* Info, const std::string& File, const char* Dir)
+{
+    s += Info;
+    s += "\n";
+    if (File.empty()) {
+        s += "   (None)\n   (None)\n";
+    } else {
+        s += "   " + File + "\n   " + Dir + "\n";
+    }
+}
+
+std::string FieldName(int64_t Field) { return Format("field_%07lld", static_cast<long long>(Field)); }
+
+// Canopy cover observed every 10 days of the crop cycle: a rise to the
+// template CCx, a plateau and a decline over the last quarter, with noise
+void AddObservations(std::string& s, rep_SplitMix64& Rng, const rep_CropTemplate& T, int32_t Day1,
+                     int32_t CycleDays)
+{
+    for (int32_t d = 10; d < CycleDays; d += 10) {
+        dp f = static_cast<dp>(d) / CycleDays;
+        dp CC = 100.0 * T.CCx * std::min({1.0, 2.5 * f, 4.0 * (1.0 - f)});
+        CC = std::clamp(CC + Rng.Uniform(-5.0, 5.0), 0.0, 100.0);
+        s += Format("  %5d  %6.1f    5.0        -9.0    -9.0            -9.0    -9.0\n", Day1 + d, CC);
+    }
+}
+
+// One PRM with a run per year on a fixed station, soil and crop variant; with
+// Opt.Observations the observations of all its runs in Observations
+std::string FieldProject(const rep_GenerateOptions& Opt, int32_t NrStations, int32_t NrSoils, int64_t Field,
+                         std::string& Observations)
+{
+    rep_SplitMix64 Rng = ObjectStream(Opt.Seed, StreamKind::Field, Field);
+    int32_t Station = static_cast<int32_t>(Rng.Next() % NrStations);
+    int32_t Soili = static_cast<int32_t>(Rng.Next() % NrSoils);
+    int32_t Crop = static_cast<int32_t>(Rng.Next() % (NrCropTemplates * NrCropVariants));
+    const rep_CropTemplate& T = CropTemplates[Crop / NrCropVariants];
+    int32_t CycleDays = CropCycleDays(Opt, Crop);
+    std::string Name = StationName(Station);
+    rep_SplitMix64 ObsRng = ObjectStream(Opt.Seed, StreamKind::Observation, Field);
+    int32_t ObsDayNr1;
+    DetermineDayNr(1, 1, Opt.FirstYear, ObsDayNr1);
+    Observations = Format("Synthetic observations of field %lld\n", static_cast<long long>(Field));
+    Observations += "     7.1  : AquaCrop Version (August 2023)\n";
+    Observations += "     1.00 : depth of sampled soil profile\n";
+    Observations += "     1    : first day of observations\n";
+    Observations += "     1    : first month of observations\n";
+    Observations += Format("  %4d    : first year of observations (1901 if not linked to a specific year)\n\n",
+                           Opt.FirstYear);
+    Observations += "   Day    Canopy cover (%)    dry Biomass (ton/ha)    Soil water content (mm)\n";
+    Observations += "            Mean     Std         Mean     Std             Mean     Std\n";
+    Observations += " ===========================================================================\n";
+
+    std::string s = Format("Synthetic field %lld (%s, %s, %s)\n", static_cast<long long>(Field),
+                           Name.c_str(), SoilName(Soili).c_str(), CropName(Crop).c_str());
+    s += "      7.1       : AquaCrop Version (August 2023)\n";
+    for (int32_t y = 0; y < Opt.NrYears; ++y) {
+        int32_t Yeari = Opt.FirstYear + y;
+        int32_t Sowing, CropDayN, YearEnd;
+        DetermineDayNr(T.SowDay, T.SowMonth, Yeari, Sowing);
+        Sowing += static_cast<int32_t>(Rng.Next() % T.SowWindow);
+        CropDayN = Sowing + CycleDays - 1;
+        DetermineDayNr(31, 12, Opt.FirstYear + Opt.NrYears - 1, YearEnd);
+        CropDayN = std::min(CropDayN, YearEnd);
+        if (Opt.Observations) AddObservations(Observations, ObsRng, T, Sowing - ObsDayNr1, CropDayN - Sowing + 1);
+
+        s += Format("      %d         : Year number of cultivation (Seeding/planting year)\n", y + 1);
+        s += Format("  %d         : First day of simulation period\n", Sowing);
+        s += Format("  %d         : Last day of simulation period\n", CropDayN);
+        s += Format("  %d         : First day of cropping period\n", Sowing);
+        s += Format("  %d         : Last day of cropping period\n", CropDayN);
+        Section(s, "-- 1. Climate (CLI) file", Name + ".CLI", "DATA/CLIM/");
+        Section(s, "   1.1 Temperature (Tnx or TMP) file", Name + ".Tnx", "DATA/CLIM/");
+        Section(s, "   1.2 Reference ET (ETo) file", Name + ".ETo", "DATA/CLIM/");
+        Section(s, "   1.3 Rain (PLU) file", Name + ".PLU", "DATA/CLIM/");
+        Section(s, "   1.4 Atmospheric CO2 concentration (CO2) file", "Synthetic.CO2", "DATA/CLIM/");
+        Section(s, "-- 2. Calendar (CAL) file", "", "");
+        Section(s, "-- 3. Crop (CRO) file", CropName(Crop) + ".CRO", "DATA/CROP/");
+        Section(s, "-- 4. Irrigation management (IRR) file", "", "");
+        Section(s, "-- 5. Field management (MAN) file", "", "");
+        Section(s, "-- 6. Soil profile (SOL) file", SoilName(Soili) + ".SOL", "DATA/SOIL/");
+        Section(s, "-- 7. Groundwater table (GWT) file", "", "");
+        Section(s, "-- 8. Initial conditions (SW0) file", "", "");
+        Section(s, "-- 9. Off-season conditions (OFF) file", "", "");
+        Section(s, "-- 10. Field data (OBS) file", Opt.Observations ? FieldName(Field) + ".OBS" : "", "DATA/OBS/");
+    }
+    return s;
+}
+
+bool ParseOptions(int argc, char* argv[], rep_GenerateOptions& Opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        bool HasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--out") == 0 && HasValue) {
+            Opt.OutDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--fields") == 0 && HasValue) {
+            Opt.NrFields = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--years") == 0 && HasValue) {
+            Opt.NrYears = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && HasValue) {
+            Opt.Seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--first-year") == 0 && HasValue) {
+            Opt.FirstYear = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--stations") == 0 && HasValue) {
+            Opt.NrStations = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--soils") == 0 && HasValue) {
+            Opt.NrSoils = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--fields-per-shard") == 0 && HasValue) {
+            Opt.FieldsPerShard = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--observations") == 0) {
+            Opt.Observations = true;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (Opt.NrFields < 1 || Opt.NrYears < 1 || Opt.FieldsPerShard < 1
+        || Opt.FirstYear < 1902 || Opt.FirstYear + Opt.NrYears - 1 > 2099) {
+        std::cerr << "Invalid options: need fields >= 1, years >= 1, fields-per-shard >= 1 "
+                  << "and a period within 1902-2099" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    rep_GenerateOptions Opt;
+    if (!ParseOptions(argc, argv, Opt)) {
+        std::cerr << "Usage: aquacrop_generate [--out DIR] [--fields N] [--years Y] [--seed S]"
+                  << " [--first-year YYYY] [--stations K] [--soils K] [--fields-per-shard K]"
+                  << " [--observations]" << std::endl;
+        return 1;
+    }
+    int32_t NrStations = (Opt.NrStations > 0) ? Opt.NrStations
+        : static_cast<int32_t>(std::clamp<int64_t>(Opt.NrFields / 100, 1, 10000));
+    int32_t NrSoils = (Opt.NrSoils > 0) ? Opt.NrSoils
+        : static_cast<int32_t>(std::clamp<int64_t>(Opt.NrFields / 20, 1, 10000));
+
+    auto t0 = std::chrono::steady_clock::now();
+    fs::path Root(Opt.OutDir);
+    fs::path ClimDir = Root / "DATA" / "CLIM";
+    fs::path SoilDir = Root / "DATA" / "SOIL";
+    fs::path CropDir = Root / "DATA" / "CROP";
+    fs::path ObsDir = Root / "DATA" / "OBS";
+    std::error_code ec;
+    std::vector<fs::path> Dirs = {ClimDir, SoilDir, CropDir, Root / "PARAM", Root / "OUTP", Root / "SIMUL"};
+    if (Opt.Observations) Dirs.push_back(ObsDir);
+    for (const fs::path& Dir : Dirs) {
+        fs::create_directories(Dir, ec);
+        if (ec) {
+            std::cerr << "Cannot create " << Dir.string() << ": " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+
+    rep_FileWriter Writer;
+    bool ok = WriteCO2(Writer, ClimDir);
+    for (int32_t Station = 0; ok && Station < NrStations; ++Station) {
+        ok = WriteStation(Writer, ClimDir, Opt, Station);
+    }
+    for (int32_t Soili = 0; ok && Soili < NrSoils; ++Soili) {
+        ok = WriteSoil(Writer, SoilDir, Opt, Soili);
+    }
+    for (int32_t Crop = 0; ok && Crop < NrCropTemplates * NrCropVariants; ++Crop) {
+        ok = WriteCrop(Writer, CropDir, Opt, Crop);
+    }
+
+    std::ofstream List(Root / "PARAM" / "ListProjects.txt");
+    int64_t Shard = -1;
+    for (int64_t Field = 0; ok && Field < Opt.NrFields; ++Field) {
+        std::string ShardName = Format("shard_%04lld", static_cast<long long>(Field / Opt.FieldsPerShard));
+        if (Field / Opt.FieldsPerShard != Shard) {
+            Shard = Field / Opt.FieldsPerShard;
+            fs::create_directories(Root / "PARAM" / ShardName, ec);
+        }
+        std::string FieldFile = ShardName + "/" + FieldName(Field) + ".PRM";
+        std::string Observations;
+        ok = Writer.Write(Root / "PARAM" / FieldFile, FieldProject(Opt, NrStations, NrSoils, Field, Observations));
+        if (ok && Opt.Observations) ok = Writer.Write(ObsDir / (FieldName(Field) + ".OBS"), Observations);
+        List << FieldFile << "\n";
+    }
+    List.close();
+    if (!ok || !List) {
+        std::cerr << "Generation failed" << std::endl;
+        return 1;
+    }
+
+    dp Seconds = std::chrono::duration<dp>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("Generated %lld fields x %d years (seed %llu) in %s\n",
+                static_cast<long long>(Opt.NrFields), Opt.NrYears,
+                static_cast<unsigned long long>(Opt.Seed), Root.string().c_str());
+    std::printf("  %d stations, %d soils, %d crops, %lld shards\n", NrStations, NrSoils,
+                NrCropTemplates * NrCropVariants, static_cast<long long>(Shard + 1));
+    std::printf("  %lld files, %.1f MB in %.2f s\n", static_cast<long long>(Writer.NrFiles + 1),
+                static_cast<dp>(Writer.NrBytes) / 1.0e6, Seconds);
+    return 0;
+}
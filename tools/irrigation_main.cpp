@@ -0,0 +1,165 @@
+// Irrigation strategy search for AquaCrop C++
+//
+// Simulates the project with generated irrigation for every combination of
+// time and depth criteria (optionally per growth stage) under a seasonal cap
+// and prints the Pareto front of irrigation against the seasonal output. Run
+// it in the working directory of aquacrop_main:
+//   aquacrop_irrigation --project field.PRM --time-mode raw --times 40,70,100 --depths 0,10 --cap 300
+#include "AquaCrop/Scheduling.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_IrrigationOptions {
+    std::string ProjectFile;
+    rep_IrriSearchSettings Settings;
+};
+
+bool ParseLevels(const std::string& Text, std::vector<int32_t>& Levels)
+{
+    Levels.clear();
+    std::stringstream ss(Text);
+    std::string Item;
+    while (std::getline(ss, Item, ',')) {
+        char* End;
+        long Value = std::strtol(Item.c_str(), &End, 10);
+        if (Item.empty() || *End != '\0') return false;
+        Levels.push_back(static_cast<int32_t>(Value));
+    }
+    return !Levels.empty();
+}
+
+bool ParseTimeMode(const std::string& Name, GenerateTimeMode& Mode)
+{
+    if (Name == "interval") Mode = GenerateTimeMode::FixInt;
+    else if (Name == "depl") Mode = GenerateTimeMode::AllDepl;
+    else if (Name == "raw") Mode = GenerateTimeMode::AllRAW;
+    else if (Name == "bunds") Mode = GenerateTimeMode::WaterBetweenBunds;
+    else return false;
+    return true;
+}
+
+bool ParseOptions(int argc, char* argv[], rep_IrrigationOptions& Opt)
+{
+    rep_IrriSearchSettings& Settings = Opt.Settings;
+    for (int i = 1; i < argc; ++i) {
+        bool HasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--project") == 0 && HasValue) {
+            Opt.ProjectFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--time-mode") == 0 && HasValue) {
+            if (!ParseTimeMode(argv[++i], Settings.TimeMode)) {
+                std::cerr << "Unknown time mode: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--fixed-depth") == 0) {
+            Settings.DepthMode = GenerateDepthMode::FixDepth;
+        } else if (std::strcmp(argv[i], "--times") == 0 && HasValue) {
+            if (!ParseLevels(argv[++i], Settings.TimeLevels)) {
+                std::cerr << "Invalid levels: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--depths") == 0 && HasValue) {
+            if (!ParseLevels(argv[++i], Settings.DepthLevels)) {
+                std::cerr << "Invalid levels: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--per-stage") == 0) {
+            Settings.PerStage = true;
+        } else if (std::strcmp(argv[i], "--cap") == 0 && HasValue) {
+            Settings.SeasonCap = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && HasValue) {
+            if (!ParseSensOutput(argv[++i], Settings.Output)) {
+                std::cerr << "Unknown output: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--metric") == 0 && HasValue) {
+            if (!ParseFitMetric(argv[++i], Settings.Objective.Metric)) {
+                std::cerr << "Unknown metric: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--goal") == 0 && HasValue) {
+            std::string Goal = argv[++i];
+            if (Goal == "output") Settings.Goal = IrriGoal::Output;
+            else if (Goal == "wp") Settings.Goal = IrriGoal::WaterProductivity;
+            else {
+                std::cerr << "Unknown goal: " << Goal << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--no-reuse") == 0) {
+            Settings.ReuseSegments = false;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && HasValue) {
+            Settings.NrThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-candidates") == 0 && HasValue) {
+            Settings.MaxCandidates = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (Opt.ProjectFile.empty()) {
+        std::cerr << "Need a project" << std::endl;
+        return false;
+    }
+    if (Settings.Goal == IrriGoal::WaterProductivity && Settings.Output == SensOutput::FitObjective) {
+        std::cerr << "Water productivity needs a crop output, not fit" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string StagesText(const rep_IrriCandidate& Candidate)
+{
+    std::string Text;
+    for (const rep_IrriStageRule& Rule : Candidate.Stages) {
+        if (!Text.empty()) Text += " ";
+        Text += std::to_string(Rule.TimeInfo) + "/" + std::to_string(Rule.DepthInfo);
+    }
+    return Text;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    rep_IrrigationOptions Opt;
+    if (!ParseOptions(argc, argv, Opt)) {
+        std::cerr << "Usage: aquacrop_irrigation --project FILE [--time-mode interval|depl|raw|bunds] [--fixed-depth]"
+                  << " [--times T1,T2,..] [--depths D1,D2,..] [--per-stage] [--cap MM]"
+                  << " [--output biomass|yield|transpiration|fit] [--metric rmse|nrmse|1-d|1-ef]"
+                  << " [--goal output|wp] [--no-reuse] [--threads N] [--max-candidates N]" << std::endl;
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    rep_IrriSearchResult Result;
+    if (!OptimizeIrrigation(Opt.ProjectFile, Opt.Settings, Result)) return 1;
+    dp Seconds = std::chrono::duration<dp>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << Result.Candidates.size() << " schedules of " << Opt.ProjectFile << ": "
+              << Result.NrSimulatedDays << " days simulated for " << Result.NrCandidateDays
+              << " candidate days, " << std::fixed << std::setprecision(1) << Seconds << " s" << std::endl;
+    std::cout << "Pareto front (time/depth criterion per stage):" << std::endl;
+    std::cout << std::setw(12) << "irrigation" << std::setw(14) << SensOutputName(Opt.Settings.Output)
+              << "  schedule" << std::endl << std::setprecision(3);
+    for (int32_t i : Result.Front) {
+        const rep_IrriCandidate& Candidate = Result.Candidates[i];
+        std::cout << std::setw(12) << Candidate.Irrigation << std::setw(14) << Candidate.Output
+                  << "  " << StagesText(Candidate) << std::endl;
+    }
+    if (Result.Best >= 0) {
+        const rep_IrriCandidate& Best = Result.Candidates[Result.Best];
+        std::cout << "Best " << (Opt.Settings.Goal == IrriGoal::WaterProductivity ? "water productivity" : "output")
+                  << ": " << StagesText(Best) << " irrigation=" << Best.Irrigation << " "
+                  << SensOutputName(Opt.Settings.Output) << "=" << Best.Output << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Global sensitivity analysis for AquaCrop C++
+//
+// Screens (Morris) or decomposes the variance (Sobol) of a seasonal output of
+// one project over parameter ranges. Run it in the working directory of
+// aquacrop_main:
+//   aquacrop_sensitivity --project field.PRM --param crop.CGC:0.05:0.2 --param crop.WP:15:35 --method sobol
+// The simulations of a batch run in parallel, one simulation per thread.
+#include "AquaCrop/Sensitivity.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_SensitivityOptions {
+    std::string ProjectFile;
+    std::vector<rep_CalibParameter> Parameters;
+    rep_ProjectSensSettings Settings;
+};
+
+bool ParseOptions(int argc, char* argv[], rep_SensitivityOptions& Opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        bool HasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--project") == 0 && HasValue) {
+            Opt.ProjectFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--param") == 0 && HasValue) {
+            rep_CalibParameter Parameter;
+            if (!ParseCalibParameter(argv[++i], Parameter)) {
+                std::cerr << "Invalid parameter (NAME:LOWER:UPPER, see aquacrop_calibrate --list): "
+                          << argv[i] << std::endl;
+                return false;
+            }
+            Opt.Parameters.push_back(Parameter);
+        } else if (std::strcmp(argv[i], "--method") == 0 && HasValue) {
+            if (!ParseSensMethod(argv[++i], Opt.Settings.Sens.Method)) {
+                std::cerr << "Unknown method: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--output") == 0 && HasValue) {
+            if (!ParseSensOutput(argv[++i], Opt.Settings.Output)) {
+                std::cerr << "Unknown output: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--metric") == 0 && HasValue) {
+            if (!ParseFitMetric(argv[++i], Opt.Settings.Objective.Metric)) {
+                std::cerr << "Unknown metric: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--samples") == 0 && HasValue) {
+            Opt.Settings.Sens.NrSamples = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--levels") == 0 && HasValue) {
+            Opt.Settings.Sens.MorrisLevels = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--batch") == 0 && HasValue) {
+            Opt.Settings.Sens.BatchRows = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && HasValue) {
+            Opt.Settings.Sens.Seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && HasValue) {
+            Opt.Settings.NrThreads = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (Opt.ProjectFile.empty() || Opt.Parameters.empty() || Opt.Settings.Sens.NrSamples < 1) {
+        std::cerr << "Need a project, at least one parameter and samples >= 1" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    rep_SensitivityOptions Opt;
+    if (!ParseOptions(argc, argv, Opt)) {
+        std::cerr << "Usage: aquacrop_sensitivity --project FILE --param NAME:LOWER:UPPER [--param ...]"
+                  << " [--method morris|sobol] [--output biomass|yield|transpiration|fit]"
+                  << " [--metric rmse|nrmse|1-d|1-ef] [--samples N] [--levels P] [--batch N]"
+                  << " [--seed S] [--threads N]" << std::endl;
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    rep_SensResult Result;
+    if (!AnalyzeProjectSensitivity(Opt.ProjectFile, Opt.Parameters, Opt.Settings, Result)) return 1;
+    dp Seconds = std::chrono::duration<dp>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << SensMethodName(Opt.Settings.Sens.Method) << " analysis of " << SensOutputName(Opt.Settings.Output)
+              << " for " << Opt.ProjectFile << ": " << Result.NrEvaluations << " simulations, "
+              << std::fixed << std::setprecision(1) << Seconds << " s" << std::endl;
+    std::cout << std::setprecision(6) << "  mean " << Result.Mean << "  variance " << Result.Variance << std::endl;
+    if (Opt.Settings.Sens.Method == SensMethod::Morris) {
+        std::cout << "  " << std::left << std::setw(30) << "parameter" << std::right << std::setw(14) << "mu"
+                  << std::setw(14) << "mu*" << std::setw(14) << "sigma" << std::endl;
+        for (size_t i = 0; i < Opt.Parameters.size(); ++i) {
+            const rep_MorrisIndex& Index = Result.Morris[i];
+            std::cout << "  " << std::left << std::setw(30) << Opt.Parameters[i].Binding->Name << std::right
+                      << std::setw(14) << Index.Mu << std::setw(14) << Index.MuStar << std::setw(14) << Index.Sigma
+                      << std::endl;
+        }
+    } else {
+        std::cout << "  " << std::left << std::setw(30) << "parameter" << std::right << std::setw(14) << "S1"
+                  << std::setw(14) << "ST" << std::endl;
+        for (size_t i = 0; i < Opt.Parameters.size(); ++i) {
+            const rep_SobolIndex& Index = Result.Sobol[i];
+            std::cout << "  " << std::left << std::setw(30) << Opt.Parameters[i].Binding->Name << std::right
+                      << std::setw(14) << Index.S1 << std::setw(14) << Index.ST << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Sowing-date sweep for AquaCrop C++
+//
+// Simulates every run (year) of a project for every sowing date of a window
+// and prints the year x sowing date matrix of a seasonal output. Run it in the
+// working directory of aquacrop_main:
+//   aquacrop_sweep --project field.PRM --from 1/4 --to 30/6 --step 7 --output yield
+#include "AquaCrop/Sensitivity.h"
+#include "AquaCrop/Sweep.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace AquaCrop;
+
+namespace {
+
+struct rep_SweepOptions {
+    std::string ProjectFile;
+    rep_SweepSettings Settings;
+    SensOutput Output = SensOutput::Yield;
+    rep_CalibObjective Objective;
+};
+
+// DD/MM
+bool ParseDayMonth(const char* Text, int32_t& Day, int32_t& Month)
+{
+    return std::sscanf(Text, "%d/%d", &Day, &Month) == 2 && Day >= 1 && Day <= 31 && Month >= 1 && Month <= 12;
+}
+
+bool ParseOptions(int argc, char* argv[], rep_SweepOptions& Opt)
+{
+    rep_SowingWindow& Window = Opt.Settings.Window;
+    for (int i = 1; i < argc; ++i) {
+        bool HasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--project") == 0 && HasValue) {
+            Opt.ProjectFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--from") == 0 && HasValue) {
+            if (!ParseDayMonth(argv[++i], Window.FromDay, Window.FromMonth)) {
+                std::cerr << "Invalid date (DD/MM): " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--to") == 0 && HasValue) {
+            if (!ParseDayMonth(argv[++i], Window.ToDay, Window.ToMonth)) {
+                std::cerr << "Invalid date (DD/MM): " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--step") == 0 && HasValue) {
+            Window.StepDays = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && HasValue) {
+            if (!ParseSensOutput(argv[++i], Opt.Output)) {
+                std::cerr << "Unknown output: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--metric") == 0 && HasValue) {
+            if (!ParseFitMetric(argv[++i], Opt.Objective.Metric)) {
+                std::cerr << "Unknown metric: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && HasValue) {
+            Opt.Settings.NrThreads = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (Opt.ProjectFile.empty() || Window.StepDays < 1) {
+        std::cerr << "Need a project and step >= 1" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    rep_SweepOptions Opt;
+    if (!ParseOptions(argc, argv, Opt)) {
+        std::cerr << "Usage: aquacrop_sweep --project FILE [--from DD/MM] [--to DD/MM] [--step DAYS]"
+                  << " [--output biomass|yield|transpiration|fit] [--metric rmse|nrmse|1-d|1-ef]"
+                  << " [--threads N]" << std::endl;
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    rep_SweepResult Result;
+    if (!SweepSowingDates(Opt.ProjectFile, Opt.Settings, Result)) return 1;
+    dp Seconds = std::chrono::duration<dp>(std::chrono::steady_clock::now() - t0).count();
+
+    const int32_t NrYears = static_cast<int32_t>(Result.Years.size());
+    const int32_t NrDates = static_cast<int32_t>(Result.SowingOffsets.size());
+    std::cout << SensOutputName(Opt.Output) << " of " << Opt.ProjectFile << " by year and sowing date: "
+              << NrYears * NrDates << " simulations, " << std::fixed << std::setprecision(1) << Seconds << " s"
+              << std::endl;
+
+    // column headers: sowing dates in the first year
+    int32_t FirstDayNr;
+    DetermineDayNr(Opt.Settings.Window.FromDay, Opt.Settings.Window.FromMonth, Result.Years.front(), FirstDayNr);
+    std::cout << std::setw(6) << "year";
+    for (int32_t Datei = 1; Datei <= NrDates; ++Datei) {
+        int32_t Dayi, Monthi, Yeari;
+        DetermineDate(FirstDayNr + Result.SowingOffsets[Datei-1], Dayi, Monthi, Yeari);
+        std::cout << std::setw(9) << (std::to_string(Dayi) + "/" + std::to_string(Monthi));
+    }
+    std::cout << std::endl << std::setprecision(3);
+    for (int32_t Yeari = 1; Yeari <= NrYears; ++Yeari) {
+        std::cout << std::setw(6) << Result.Years[Yeari-1];
+        for (int32_t Datei = 1; Datei <= NrDates; ++Datei) {
+            std::cout << std::setw(9) << ProjectOutputValue({Result.Cell(Yeari, Datei)}, Opt.Output, Opt.Objective);
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}